@@ -0,0 +1,359 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glfw3.h"
+#include "glm/glm.hpp"
+
+#include "Camera.h"
+#include "CPUProfiler.h"
+#include "GPUProfiler.h"
+#include "GLInterceptor.h"
+#include "GLTrace.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//Benchmark mode shared by every demo: --benchmark[=frames] [--benchmark-out=file.json].
+//A run flies the camera along a scripted path on a fixed timestep, so two runs render the same frames no
+//matter how fast the machine is. The first warmupFrames are not measured (shader compiles, first uploads,
+//driver warm up), then frames are measured and a few more are drawn so the gpu timings of the last ones
+//resolve. The loop should stop once Finished() is true, the results are on disk by then:
+//	- cpu frame time (BeginFrame to EndFrame, so place those around poll and swap too) and gpu frame time,
+//	  mean and p50/p95/p99/max
+//	- cpu and gpu time of every profiler scope, per frame
+//	- gl calls, draws, primitives, dispatches, uploads, uniform bytes, bind changes, redundant binds and GLStateCache
+//	  calls per frame, and the busiest entry points (see GLInterceptor)
+//	- peak process memory and, on drivers with GL_NVX_gpu_memory_info, peak video memory in use
+//The GPUProfiler is owned here and runs in interactive mode as well, demos hang their pass scopes off it.
+//--gl-stats installs the GLInterceptor outside benchmark runs too and prints its per frame table once a second.
+class Benchmark
+{
+public:
+	struct CameraKey
+	{
+		glm::vec3 position;
+		glm::vec3 target;
+	};
+
+	struct Settings
+	{
+		std::string scene;
+		int frames = 0;				// 0 leaves benchmark mode off
+		int warmupFrames = 60;
+		float timestep = 1.0f / 60.0f;
+		std::string outputFile;		// benchmark_<scene>.json when empty
+		std::vector<CameraKey> path;	// closed loop, one lap over the measured frames
+		bool glStats = false;
+	};
+
+	static Settings ParseArgs(int argc, char** argv, const std::string& scene);
+	//circles target once, bobbing up and down a little
+	static std::vector<CameraKey> OrbitPath(const glm::vec3& target, float radius, float height);
+
+	Benchmark(const Settings& benchmarkSettings);
+
+	bool Active() const { return settings.frames > 0; }
+	bool Finished() const { return Active() && frame >= totalFrames(); }
+	float DeltaTime() const { return settings.timestep; }
+	//scene time on the fixed step, for animation that reads the clock
+	double Time() const { return frame * (double)settings.timestep; }
+	void UpdateCamera(Camera& camera) const;
+	GPUProfiler& Profiler() { return profiler; }
+	bool GLStats() const { return settings.glStats; }
+
+	void BeginFrame();
+	void EndFrame();
+
+private:
+	Settings settings;
+	GPUProfiler profiler;
+	int frame = 0;
+	std::chrono::steady_clock::time_point frameStart;
+	std::vector<float> cpuFrameMs;
+
+	GLInterceptor::Stats glTotals;
+	std::chrono::steady_clock::time_point lastGLStatsPrint;
+	unsigned int stateIssued = 0;
+	unsigned int stateSkipped = 0;
+	bool gpuMemoryQuery = false;
+	GLint gpuMemoryTotalKB = 0;
+	GLint gpuMemoryMinFreeKB = 0;
+
+private:
+	int totalFrames() const { return settings.warmupFrames + settings.frames + GPUProfiler::FRAME_LATENCY; }
+	bool measuring() const { return frame >= settings.warmupFrames && frame < settings.warmupFrames + settings.frames; }
+	void writeResults() const;
+
+	static size_t peakProcessMemory();
+	static void writeStats(std::ostream& out, const char* name, std::vector<float> values);
+};
+
+inline Benchmark::Settings Benchmark::ParseArgs(int argc, char** argv, const std::string& scene)
+{
+	Settings result;
+	result.scene = scene;
+	result.path = OrbitPath(glm::vec3(0.0f), 4.0f, 1.0f);
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--benchmark")
+			result.frames = 1000;
+		else if (arg.compare(0, 12, "--benchmark=") == 0)
+			result.frames = std::max(std::atoi(arg.c_str() + 12), 1);
+		else if (arg.compare(0, 16, "--benchmark-out=") == 0)
+			result.outputFile = arg.substr(16);
+		else if (arg == "--gl-stats")
+			result.glStats = true;
+	}
+	if (result.outputFile.empty())
+		result.outputFile = "benchmark_" + scene + ".json";
+	return result;
+}
+
+inline std::vector<Benchmark::CameraKey> Benchmark::OrbitPath(const glm::vec3& target, float radius, float height)
+{
+	std::vector<CameraKey> path;
+	const int keys = 8;
+	for (int i = 0; i < keys; ++i)
+	{
+		float angle = 6.2831853f * i / keys;
+		CameraKey key;
+		key.position = target + glm::vec3(radius * std::cos(angle), height * (1.0f + 0.5f * std::sin(2.0f * angle)), radius * std::sin(angle));
+		key.target = target;
+		path.push_back(key);
+	}
+	return path;
+}
+
+inline Benchmark::Benchmark(const Settings& benchmarkSettings)
+	:settings(benchmarkSettings)
+{
+	if (settings.glStats)
+		GLInterceptor::Install();
+	if (!Active())
+		return;
+
+	GLInterceptor::Install();
+	profiler.SetTotalsRange(settings.warmupFrames, settings.warmupFrames + settings.frames);
+	//vsync would measure the display, not the frame; a headless run has no glfw context to ask
+	if (glfwGetCurrentContext())
+		glfwSwapInterval(0);
+
+	GLint extensionNum = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionNum);
+	for (GLint i = 0; i < extensionNum; ++i)
+	{
+		if (std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_NVX_gpu_memory_info") == 0)
+			gpuMemoryQuery = true;
+	}
+	if (gpuMemoryQuery)
+	{
+		const GLenum GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX = 0x9048;
+		glGetIntegerv(GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &gpuMemoryTotalKB);
+		gpuMemoryMinFreeKB = gpuMemoryTotalKB;
+	}
+
+	std::cout << "Benchmark: " << settings.scene << ", " << settings.warmupFrames << " warm up and " << settings.frames
+		<< " measured frames" << std::endl;
+}
+
+inline void Benchmark::UpdateCamera(Camera& camera) const
+{
+	if (settings.path.empty())
+		return;
+
+	//catmull-rom through the keys, one lap over the measured frames
+	int keyNum = (int)settings.path.size();
+	float t = (float)std::max(frame - settings.warmupFrames, 0) / settings.frames * keyNum;
+	int i1 = (int)t;
+	float f = t - i1;
+	const CameraKey& k0 = settings.path[(i1 + keyNum - 1) % keyNum];
+	const CameraKey& k1 = settings.path[i1 % keyNum];
+	const CameraKey& k2 = settings.path[(i1 + 1) % keyNum];
+	const CameraKey& k3 = settings.path[(i1 + 2) % keyNum];
+	auto spline = [f](const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3)
+	{
+		return 0.5f * (2.0f * p1 + (p2 - p0) * f + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * f * f
+			+ (3.0f * p1 - p0 - 3.0f * p2 + p3) * f * f * f);
+	};
+	camera.LookAt(spline(k0.position, k1.position, k2.position, k3.position), spline(k0.target, k1.target, k2.target, k3.target));
+}
+
+inline void Benchmark::BeginFrame()
+{
+	if (Active() && frame == settings.warmupFrames)
+	{
+		GLStateCache::Get().ResetStats();
+	}
+	frameStart = std::chrono::steady_clock::now();
+	profiler.BeginFrame();
+}
+
+inline void Benchmark::EndFrame()
+{
+	profiler.EndFrame();
+	GLInterceptor::EndFrame();
+	GLTrace::EndFrame();
+	if (!Active())
+	{
+		++frame;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (settings.glStats && now - lastGLStatsPrint > std::chrono::seconds(1))
+		{
+			GLInterceptor::Print(std::cout, GLInterceptor::LastFrame());
+			lastGLStatsPrint = now;
+		}
+		return;
+	}
+
+	if (measuring())
+	{
+		cpuFrameMs.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+		glTotals.Add(GLInterceptor::LastFrame());
+		if (gpuMemoryQuery)
+		{
+			const GLenum GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX = 0x9049;
+			GLint freeKB = 0;
+			glGetIntegerv(GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &freeKB);
+			gpuMemoryMinFreeKB = std::min(gpuMemoryMinFreeKB, freeKB);
+		}
+	}
+	++frame;
+
+	//counters cover the measured frames only
+	if (frame == settings.warmupFrames + settings.frames)
+	{
+		stateIssued = GLStateCache::Get().GetStats().issued;
+		stateSkipped = GLStateCache::Get().GetStats().skipped;
+	}
+	if (frame == totalFrames())
+		writeResults();
+}
+
+inline void Benchmark::writeResults() const
+{
+	std::ofstream file(settings.outputFile);
+	if (!file)
+	{
+		std::cout << "Error: failed to write benchmark results " << settings.outputFile << std::endl;
+		return;
+	}
+
+	double frames = settings.frames;
+	char line[512];
+	file << "{\n";
+	file << "\t\"scene\": \"" << settings.scene << "\",\n";
+	file << "\t\"renderer\": \"" << (const char*)glGetString(GL_RENDERER) << "\",\n";
+	file << "\t\"version\": \"" << (const char*)glGetString(GL_VERSION) << "\",\n";
+	file << "\t\"frames\": " << settings.frames << ",\n";
+	file << "\t\"warmupFrames\": " << settings.warmupFrames << ",\n";
+	file << "\t\"timestep\": " << settings.timestep << ",\n";
+	writeStats(file, "cpuFrameMs", cpuFrameMs);
+	writeStats(file, "gpuFrameMs", profiler.TotalsFrameGpuMs());
+
+	file << "\t\"passes\": [";
+	bool first = true;
+	for (const GPUProfiler::Timing& timing : profiler.Timings())
+	{
+		if (timing.totalFrames == 0)
+			continue;
+		std::snprintf(line, sizeof(line), "%s\n\t\t{ \"name\": \"%s\", \"gpuMs\": %.4f, \"cpuMs\": %.4f, \"frames\": %d }",
+			first ? "" : ",", timing.path.c_str(), timing.gpuTotalMs / timing.totalFrames, timing.cpuTotalMs / timing.totalFrames, timing.totalFrames);
+		file << line;
+		first = false;
+	}
+	file << "\n\t],\n";
+
+	std::snprintf(line, sizeof(line), "\t\"perFrame\": { \"glCalls\": %.1f, \"draws\": %.1f, \"primitives\": %.1f, \"vertices\": %.1f, "
+		"\"dispatches\": %.1f, \"uploads\": %.1f, \"uploadBytes\": %.1f, \"uniformBytes\": %.1f, \"bindChanges\": %.1f, "
+		"\"redundantBinds\": %.1f, \"stateChanges\": %.1f, \"stateChangesSkipped\": %.1f },\n",
+		glTotals.calls / frames, glTotals.draws / frames, glTotals.primitives / frames, glTotals.vertices / frames,
+		glTotals.dispatches / frames, glTotals.uploads / frames, glTotals.uploadBytes / frames, glTotals.uniformBytes / frames,
+		glTotals.bindChanges / frames, glTotals.redundantBinds / frames, stateIssued / frames, stateSkipped / frames);
+	file << line;
+
+	//every entry point that was called, busiest first
+	std::vector<int> entryPoints;
+	for (int i = 0; i < GLInterceptor::ENTRY_POINT_COUNT; ++i)
+	{
+		if (glTotals.entries[i].calls)
+			entryPoints.push_back(i);
+	}
+	std::sort(entryPoints.begin(), entryPoints.end(),
+		[this](int a, int b) { return glTotals.entries[a].calls > glTotals.entries[b].calls; });
+	file << "\t\"entryPoints\": [";
+	first = true;
+	for (int i : entryPoints)
+	{
+		std::snprintf(line, sizeof(line), "%s\n\t\t{ \"name\": \"%s\", \"calls\": %.2f, \"redundant\": %.2f }", first ? "" : ",",
+			GLInterceptor::Name(i), glTotals.entries[i].calls / frames, glTotals.entries[i].redundant / frames);
+		file << line;
+		first = false;
+	}
+	file << "\n\t],\n";
+
+	file << "\t\"peakProcessBytes\": " << peakProcessMemory();
+	if (gpuMemoryQuery)
+		file << ",\n\t\"peakGpuMemoryKB\": " << gpuMemoryTotalKB - gpuMemoryMinFreeKB;
+	file << "\n}\n";
+
+	std::cout << "Benchmark: wrote " << settings.outputFile << std::endl;
+}
+
+inline void Benchmark::writeStats(std::ostream& out, const char* name, std::vector<float> values)
+{
+	char line[256];
+	if (values.empty())
+	{
+		std::snprintf(line, sizeof(line), "\t\"%s\": null,\n", name);
+		out << line;
+		return;
+	}
+
+	std::sort(values.begin(), values.end());
+	double sum = 0.0;
+	for (float v : values)
+		sum += v;
+	auto percentile = [&values](float p)
+	{
+		return values[std::min((size_t)(p * values.size()), values.size() - 1)];
+	};
+	std::snprintf(line, sizeof(line), "\t\"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+		name, sum / values.size(), percentile(0.5f), percentile(0.95f), percentile(0.99f), values.back());
+	out << line;
+}
+
+inline size_t Benchmark::peakProcessMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS memory;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)))
+		return memory.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+//glad is generated without extensions, GL_ARB_bindless_texture entry points are loaded here
+#ifndef GL_ARB_bindless_texture
+typedef GLuint64(APIENTRYP PFNGLGETTEXTUREHANDLEARBPROC)(GLuint texture);
+typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+#endif
+
+//Owns 64-bit texture handles for the GL_ARB_bindless_texture path and their residency.
+//Handles never change for a texture, only residency does: anything drawn marks its slot used,
+//EndFrame() makes handles that were not used for a few frames non-resident again so the driver
+//does not have to keep every texture ever seen in its residency list.
+class BindlessTextureManager
+{
+public:
+	BindlessTextureManager(unsigned int evictAfterFrames = 60)
+		:evictAfterFrames(evictAfterFrames)
+	{
+	}
+
+	~BindlessTextureManager();
+
+	//needs a 4.3+ context (material ssbo) and the extension, false means use the bound unit path
+	bool Init(GLADloadproc load);
+	bool Supported() const { return supported; }
+
+	//returns a slot for the texture, creating its handle on first use
+	unsigned int Acquire(GLuint texture);
+	GLuint64 Handle(unsigned int slot) const { return entries[slot].handle; }
+	//makes the handle resident if needed and records the use for this frame
+	void Touch(unsigned int slot);
+	void EndFrame();
+
+	unsigned int ResidentCount() const { return residentCount; }
+
+private:
+	struct Entry
+	{
+		GLuint64 handle;
+		unsigned long long lastUsedFrame;
+		bool resident;
+	};
+
+	bool supported = false;
+	unsigned int evictAfterFrames;
+	unsigned long long frame = 0;
+	unsigned int residentCount = 0;
+	std::vector<Entry> entries;
+	std::map<GLuint, unsigned int> slots;
+
+	PFNGLGETTEXTUREHANDLEARBPROC getTextureHandle = nullptr;
+	PFNGLMAKETEXTUREHANDLERESIDENTARBPROC makeResident = nullptr;
+	PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC makeNonResident = nullptr;
+};
+
+inline BindlessTextureManager::~BindlessTextureManager()
+{
+	if (!supported)
+		return;
+	for (Entry& entry : entries)
+	{
+		if (entry.resident)
+			makeNonResident(entry.handle);
+	}
+}
+
+inline bool BindlessTextureManager::Init(GLADloadproc load)
+{
+	supported = false;
+	if (!GLAD_GL_VERSION_4_3)
+	{
+		std::cout << "Bindless: context older than 4.3, using bound texture units" << std::endl;
+		return false;
+	}
+
+	bool hasExtension = false;
+	GLint extensionNum = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionNum);
+	for (GLint i = 0; i < extensionNum && !hasExtension; ++i)
+	{
+		const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		hasExtension = name && strcmp(name, "GL_ARB_bindless_texture") == 0;
+	}
+	if (!hasExtension)
+	{
+		std::cout << "Bindless: GL_ARB_bindless_texture missing, using bound texture units" << std::endl;
+		return false;
+	}
+
+	getTextureHandle = (PFNGLGETTEXTUREHANDLEARBPROC)load("glGetTextureHandleARB");
+	makeResident = (PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)load("glMakeTextureHandleResidentARB");
+	makeNonResident = (PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)load("glMakeTextureHandleNonResidentARB");
+	supported = getTextureHandle && makeResident && makeNonResident;
+	return supported;
+}
+
+inline unsigned int BindlessTextureManager::Acquire(GLuint texture)
+{
+	auto it = slots.find(texture);
+	if (it != slots.end())
+		return it->second;
+
+	//after this the texture's sampling state is frozen, set parameters before acquiring
+	Entry entry;
+	entry.handle = getTextureHandle(texture);
+	entry.lastUsedFrame = 0;
+	entry.resident = false;
+	entries.push_back(entry);
+
+	unsigned int slot = (unsigned int)entries.size() - 1;
+	slots[texture] = slot;
+	return slot;
+}
+
+inline void BindlessTextureManager::Touch(unsigned int slot)
+{
+	Entry& entry = entries[slot];
+	entry.lastUsedFrame = frame;
+	if (!entry.resident)
+	{
+		makeResident(entry.handle);
+		entry.resident = true;
+		++residentCount;
+	}
+}
+
+inline void BindlessTextureManager::EndFrame()
+{
+	for (Entry& entry : entries)
+	{
+		if (entry.resident && frame - entry.lastUsedFrame > evictAfterFrames)
+		{
+			makeNonResident(entry.handle);
+			entry.resident = false;
+			--residentCount;
+		}
+	}
+	++frame;
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_USE_RDTSC 1
+#endif
+
+//Zones are on in every build but one defining GIANT_PROFILER_DISABLED (release minimal), there they compile
+//to nothing. Names must outlive the capture, string literals are what the zones are meant for.
+#ifndef GIANT_PROFILER_DISABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) CPUProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) CPUProfiler::Get().SetThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+//Always-on cpu instrumentation.
+//A zone reads the cycle counter (rdtsc, steady_clock where there is none) when it opens and closes and then
+//writes one event into a ring owned by the calling thread: no lock, no allocation, no shared cache line, so
+//a zone costs a few tens of nanoseconds. A thread registers its ring under a mutex the first time it records.
+//Rings keep the last RING_CAPACITY events and overwrite the oldest. WriteTrace() copies them while the threads
+//keep recording and drops what got overwritten during the copy. Cycles become microseconds on the clock
+//GPUProfiler uses too, calibrated against steady_clock over the whole run (needs an invariant tsc, which
+//every x86 cpu of the last decade has), so cpu zones and gpu scopes line up in one Chrome trace.
+class CPUProfiler
+{
+public:
+	static const uint64_t RING_CAPACITY = 1 << 16;
+
+	struct Event
+	{
+		const char* name;
+		uint64_t begin;		// ticks
+		uint64_t end;
+	};
+
+	static CPUProfiler& Get();
+	//microseconds since the first profiler use
+	static double Now();
+	static uint64_t Ticks();
+
+	void Record(const char* name, uint64_t begin, uint64_t end);
+	void SetThreadName(const char* name);
+
+	//"X" events of every thread for a traceEvents array, each one preceded by ",\n"
+	void WriteTraceEvents(std::ostream& out) const;
+	bool WriteTrace(const std::string& path) const;
+	//text for inside a json string, the trace writers run zone and scope names through it
+	static std::string EscapeJson(const std::string& text);
+
+private:
+	struct ThreadBuffer
+	{
+		Event events[RING_CAPACITY];
+		std::atomic<uint64_t> head;		// events written so far, only the owning thread stores
+		int id;
+		const char* name;
+	};
+
+	mutable std::mutex registryMutex;
+	std::vector<ThreadBuffer*> buffers;
+	uint64_t startTicks;
+	double startMicroseconds;
+
+private:
+	CPUProfiler();
+	~CPUProfiler();
+	CPUProfiler(const CPUProfiler&) = delete;
+	CPUProfiler& operator=(const CPUProfiler&) = delete;
+
+	ThreadBuffer* threadBuffer();
+};
+
+//Records the enclosing block as one event, use it through PROFILE_ZONE.
+class CPUProfileZone
+{
+public:
+	CPUProfileZone(const char* zoneName) :name(zoneName), begin(CPUProfiler::Ticks()) {}
+	~CPUProfileZone() { CPUProfiler::Get().Record(name, begin, CPUProfiler::Ticks()); }
+
+private:
+	const char* name;
+	uint64_t begin;
+};
+
+inline CPUProfiler& CPUProfiler::Get()
+{
+	static CPUProfiler profiler;
+	return profiler;
+}
+
+inline double CPUProfiler::Now()
+{
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+inline uint64_t CPUProfiler::Ticks()
+{
+#ifdef PROFILER_USE_RDTSC
+	return __rdtsc();
+#else
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline CPUProfiler::CPUProfiler()
+{
+	startMicroseconds = Now();
+	startTicks = Ticks();
+}
+
+inline CPUProfiler::~CPUProfiler()
+{
+	for (ThreadBuffer* buffer : buffers)
+		delete buffer;
+}
+
+inline void CPUProfiler::Record(const char* name, uint64_t begin, uint64_t end)
+{
+	ThreadBuffer* buffer = threadBuffer();
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	Event& event = buffer->events[head & (RING_CAPACITY - 1)];
+	event.name = name;
+	event.begin = begin;
+	event.end = end;
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+inline void CPUProfiler::SetThreadName(const char* name)
+{
+	//registers the thread first, that takes the registry lock itself
+	ThreadBuffer* buffer = threadBuffer();
+	std::lock_guard<std::mutex> lock(registryMutex);
+	buffer->name = name;
+}
+
+inline CPUProfiler::ThreadBuffer* CPUProfiler::threadBuffer()
+{
+	static thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer)
+	{
+		buffer = new ThreadBuffer();
+		buffer->head.store(0, std::memory_order_relaxed);
+		buffer->name = nullptr;
+
+		std::lock_guard<std::mutex> lock(registryMutex);
+		buffer->id = (int)buffers.size() + 1;
+		buffers.push_back(buffer);
+	}
+	return buffer;
+}
+
+inline void CPUProfiler::WriteTraceEvents(std::ostream& out) const
+{
+	//calibrate over everything recorded so far
+	double elapsedMicroseconds = Now() - startMicroseconds;
+	uint64_t elapsedTicks = Ticks() - startTicks;
+	double ticksPerMicrosecond = elapsedMicroseconds > 0.0 ? elapsedTicks / elapsedMicroseconds : 1000.0;
+
+	std::vector<ThreadBuffer*> threads;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		threads = buffers;
+	}
+
+	char line[256];
+	std::vector<Event> events;
+	for (ThreadBuffer* buffer : threads)
+	{
+		std::string threadName = buffer->name ? buffer->name : "thread " + std::to_string(buffer->id);
+		std::snprintf(line, sizeof(line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			buffer->id, EscapeJson(threadName).c_str());
+		out << line;
+
+		uint64_t end = buffer->head.load(std::memory_order_acquire);
+		uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+		events.clear();
+		for (uint64_t i = begin; i < end; ++i)
+			events.push_back(buffer->events[i & (RING_CAPACITY - 1)]);
+
+		//the owner kept writing, whatever it wrapped over meanwhile and the slot it is on now are garbage
+		uint64_t after = buffer->head.load(std::memory_order_acquire);
+		size_t skip = after + 1 - begin > RING_CAPACITY ? (size_t)std::min<uint64_t>(after + 1 - begin - RING_CAPACITY, events.size()) : 0;
+
+		for (size_t i = skip; i < events.size(); ++i)
+		{
+			const Event& e = events[i];
+			double ts = startMicroseconds + (double)(int64_t)(e.begin - startTicks) / ticksPerMicrosecond;
+			double dur = (double)(e.end - e.begin) / ticksPerMicrosecond;
+			std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				EscapeJson(e.name).c_str(), buffer->id, ts, dur);
+			out << line;
+		}
+	}
+}
+
+inline std::string CPUProfiler::EscapeJson(const std::string& text)
+{
+	std::string result;
+	result.reserve(text.size());
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			result += '\\';
+		if ((unsigned char)c < 0x20)
+			result += ' ';
+		else
+			result += c;
+	}
+	return result;
+}
+
+inline bool CPUProfiler::WriteTrace(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "Error: failed to write cpu trace " << path << std::endl;
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"cpu\"}}";
+	WriteTraceEvents(file);
+	file << "\n]}\n";
+	std::cout << "CPUProfiler: wrote " << path << std::endl;
+	return true;
+}
@@ -1,7 +1,7 @@
 #pragma once
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 
 enum class CameraMovement
 {
@@ -113,6 +113,23 @@ public:
 			Fov = 45.0f;
 	}
 
+	//places the camera facing target, yaw and pitch follow so mouse look carries on from there
+	void LookAt(const glm::vec3& position, const glm::vec3& target)
+	{
+		Position = position;
+		glm::vec3 dir = glm::normalize(target - position);
+		Pitch = glm::degrees(asin(dir.y));
+		Yaw = glm::degrees(atan2(dir.z, dir.x));
+		updateCameraVectors();
+	}
+
+	void SetOrientation(float yaw, float pitch)
+	{
+		Yaw = yaw;
+		Pitch = pitch;
+		updateCameraVectors();
+	}
+
 private:
 	void updateCameraVectors()
 	{
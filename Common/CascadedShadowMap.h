@@ -0,0 +1,289 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//Anything that can cast a shadow, bounded by a sphere.
+//Bump version whenever the caster moves or changes shape, cached cascades compare it.
+struct ShadowCaster
+{
+	glm::vec3 center;
+	float radius;
+	unsigned int version;
+};
+
+//Cascaded shadow maps for one directional light.
+//The camera frustum up to shadowDistance is split with the practical split scheme (log/linear blend)
+//and every slice gets an orthographic map in one layer of a depth texture array.
+//	stable fit		each slice is bounded by a sphere, so the map size does not change when the camera turns,
+//					and the projection origin is snapped to whole texels so edges do not shimmer when it moves
+//	culling			casters are tested against each cascade's light space box, only overlapping ones are drawn
+//	caching			cascades from firstCachedCascade on are fitted with some slack and keep their projection
+//					until the camera leaves it; they are only re-rendered when that happens, the light turns,
+//					or the set/version of casters inside them changes
+class CascadedShadowMap
+{
+public:
+	static const int MAX_CASCADES = 4;
+
+	struct Stats
+	{
+		int cascadesRendered = 0;
+		int castersDrawn = 0;
+	};
+
+	CascadedShadowMap(const std::string& shaderDir, int cascadeNum = 4, int mapSize = 2048, float shadowDistance = 50.0f, int firstCachedCascade = 2);
+	~CascadedShadowMap();
+
+	//refit the cascades to the camera, call once per frame before Render
+	void Update(const glm::mat4& view, float fovY, float aspect, float nearPlane, const glm::vec3& lightDir);
+	//render the cascades that need it, draw(shader, casterIndex) sets the model matrix and draws one caster
+	void Render(const std::vector<ShadowCaster>& casters, const std::function<void(Shader&, unsigned int)>& draw);
+	//bind the map to a texture unit and set the lookup uniforms on a lit shader
+	void Bind(const Shader& shader, GLuint unit) const;
+
+	const Stats& GetStats() const { return stats; }
+
+private:
+	struct Cascade
+	{
+		float splitNear;
+		float splitFar;
+		float radius;
+		glm::vec3 lightCenter;		// snapped center in light space
+		glm::mat4 lightSpace;
+		bool valid = false;			// map content matches lightSpace and signature
+		unsigned long long signature = 0;
+		std::vector<unsigned int> visible;
+	};
+
+	Shader depthShader;
+	int cascadeNum;
+	int mapSize;
+	float shadowDistance;
+	int firstCachedCascade;
+	float splitLambda = 0.8f;
+	float cachedSlack = 1.3f;		// cached cascades cover this much more than their slice
+	float casterRange = 50.0f;		// how far toward the light casters are still picked up
+
+	Cascade cascades[MAX_CASCADES];
+	glm::vec3 lightDir = glm::vec3(0.0f);
+	glm::mat4 lightRotation;
+	Stats stats;
+
+	GLuint depthArray = 0;
+	GLuint fbo = 0;
+
+private:
+	void fitCascade(int index, const glm::mat4& invView, float tanX, float tanY);
+	bool casterInCascade(const Cascade& cascade, const ShadowCaster& caster) const;
+};
+
+inline CascadedShadowMap::CascadedShadowMap(const std::string& shaderDir, int cascadeNum, int mapSize, float shadowDistance, int firstCachedCascade)
+	:depthShader((shaderDir + "/depth_vert.glsl").c_str(), (shaderDir + "/depth_frag.glsl").c_str()),
+	cascadeNum(std::min(std::max(cascadeNum, 1), (int)MAX_CASCADES)), mapSize(mapSize), shadowDistance(shadowDistance),
+	firstCachedCascade(firstCachedCascade)
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	glGenTextures(1, &depthArray);
+	state.BindTexture(GL_TEXTURE_2D_ARRAY, depthArray);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, mapSize, mapSize, this->cascadeNum, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	//hardware 2x2 pcf through sampler2DArrayShadow
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	glGenFramebuffers(1, &fbo);
+	state.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: shadow cascade framebuffer is not complete" << std::endl;
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline CascadedShadowMap::~CascadedShadowMap()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.DeleteFramebuffer(fbo);
+	state.DeleteTexture(depthArray);
+}
+
+inline void CascadedShadowMap::Update(const glm::mat4& view, float fovY, float aspect, float nearPlane, const glm::vec3& dir)
+{
+	glm::vec3 newDir = glm::normalize(dir);
+	if (newDir != lightDir)
+	{
+		//every cached projection is relative to the old light orientation
+		lightDir = newDir;
+		glm::vec3 up = fabs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		lightRotation = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+		for (int i = 0; i < cascadeNum; ++i)
+			cascades[i].valid = false;
+	}
+
+	float farPlane = std::max(shadowDistance, nearPlane * 2.0f);
+	for (int i = 0; i < cascadeNum; ++i)
+	{
+		//practical split scheme
+		float t = (float)(i + 1) / cascadeNum;
+		float logSplit = nearPlane * pow(farPlane / nearPlane, t);
+		float linearSplit = nearPlane + (farPlane - nearPlane) * t;
+		cascades[i].splitNear = i == 0 ? nearPlane : cascades[i - 1].splitFar;
+		cascades[i].splitFar = splitLambda * logSplit + (1.0f - splitLambda) * linearSplit;
+	}
+
+	glm::mat4 invView = glm::inverse(view);
+	float tanY = tan(fovY * 0.5f);
+	float tanX = tanY * aspect;
+	for (int i = 0; i < cascadeNum; ++i)
+	{
+		fitCascade(i, invView, tanX, tanY);
+	}
+}
+
+inline void CascadedShadowMap::fitCascade(int index, const glm::mat4& invView, float tanX, float tanY)
+{
+	Cascade& cascade = cascades[index];
+
+	//slice corners in world space, the bounding sphere only depends on fov and splits so it is rotation stable
+	glm::vec3 corners[8];
+	glm::vec3 centroid(0.0f);
+	for (int i = 0; i < 8; ++i)
+	{
+		float z = (i & 4) ? cascade.splitFar : cascade.splitNear;
+		float x = ((i & 1) ? 1.0f : -1.0f) * tanX * z;
+		float y = ((i & 2) ? 1.0f : -1.0f) * tanY * z;
+		corners[i] = glm::vec3(invView * glm::vec4(x, y, -z, 1.0f));
+		centroid += corners[i] / 8.0f;
+	}
+	float radius = 0.0f;
+	for (int i = 0; i < 8; ++i)
+		radius = std::max(radius, glm::length(corners[i] - centroid));
+	radius = ceil(radius * 16.0f) / 16.0f;
+
+	bool cached = index >= firstCachedCascade;
+	glm::vec3 center = glm::vec3(lightRotation * glm::vec4(centroid, 1.0f));
+	if (cached && cascade.valid)
+	{
+		//keep the old projection while the slice still fits inside it
+		float distance = glm::length(glm::vec2(center - cascade.lightCenter));
+		if (distance + radius <= cascade.radius && fabs(center.z - cascade.lightCenter.z) + radius <= cascade.radius)
+			return;
+	}
+
+	cascade.radius = cached ? radius * cachedSlack : radius;
+	//snap the origin to whole texels of this cascade
+	float texel = 2.0f * cascade.radius / mapSize;
+	center.x = floor(center.x / texel) * texel;
+	center.y = floor(center.y / texel) * texel;
+	cascade.lightCenter = center;
+
+	//the light looks down -z of its view, casters up to casterRange in front of the slice still count
+	float r = cascade.radius;
+	glm::mat4 projection = glm::ortho(center.x - r, center.x + r, center.y - r, center.y + r,
+		-(center.z + r + casterRange), -(center.z - r));
+	cascade.lightSpace = projection * lightRotation;
+	cascade.valid = false;
+}
+
+inline bool CascadedShadowMap::casterInCascade(const Cascade& cascade, const ShadowCaster& caster) const
+{
+	glm::vec3 p = glm::vec3(lightRotation * glm::vec4(caster.center, 1.0f));
+	float r = cascade.radius + caster.radius;
+	return fabs(p.x - cascade.lightCenter.x) <= r
+		&& fabs(p.y - cascade.lightCenter.y) <= r
+		&& p.z <= cascade.lightCenter.z + cascade.radius + casterRange + caster.radius
+		&& p.z >= cascade.lightCenter.z - r;
+}
+
+inline void CascadedShadowMap::Render(const std::vector<ShadowCaster>& casters, const std::function<void(Shader&, unsigned int)>& draw)
+{
+	GLStateCache& state = GLStateCache::Get();
+	stats = Stats();
+
+	bool bound = false;
+	for (int i = 0; i < cascadeNum; ++i)
+	{
+		Cascade& cascade = cascades[i];
+
+		//per cascade culling, the signature doubles as the cache key
+		cascade.visible.clear();
+		unsigned long long signature = 1469598103934665603ull;
+		for (unsigned int c = 0; c < casters.size(); ++c)
+		{
+			if (!casterInCascade(cascade, casters[c]))
+				continue;
+			cascade.visible.push_back(c);
+			signature = (signature ^ c) * 1099511628211ull;
+			signature = (signature ^ casters[c].version) * 1099511628211ull;
+		}
+
+		bool cached = i >= firstCachedCascade;
+		if (cached && cascade.valid && cascade.signature == signature)
+			continue;
+
+		if (!bound)
+		{
+			state.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+			state.Viewport(0, 0, mapSize, mapSize);
+			state.Enable(GL_DEPTH_TEST);
+			state.DepthMask(GL_TRUE);
+			state.DepthFunc(GL_LESS);
+			state.Disable(GL_BLEND);
+			state.Enable(GL_POLYGON_OFFSET_FILL);
+			glPolygonOffset(2.0f, 4.0f);
+			depthShader.Use();
+			bound = true;
+		}
+
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, i);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		depthShader.SetMat4("lightSpaceMatrix", cascade.lightSpace);
+		for (unsigned int c : cascade.visible)
+		{
+			draw(depthShader, c);
+		}
+
+		cascade.signature = signature;
+		cascade.valid = true;
+		++stats.cascadesRendered;
+		stats.castersDrawn += (int)cascade.visible.size();
+	}
+
+	if (bound)
+	{
+		state.Disable(GL_POLYGON_OFFSET_FILL);
+		state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+inline void CascadedShadowMap::Bind(const Shader& shader, GLuint unit) const
+{
+	GLStateCache::Get().BindTextureUnit(unit, GL_TEXTURE_2D_ARRAY, depthArray);
+	shader.SetInt("shadowMap", unit);
+	shader.SetInt("cascadeCount", cascadeNum);
+	for (int i = 0; i < cascadeNum; ++i)
+	{
+		std::string index = "[" + std::to_string(i) + "]";
+		shader.SetMat4("lightSpaceMatrices" + index, cascades[i].lightSpace);
+		shader.SetFloat("cascadeSplits" + index, cascades[i].splitFar);
+		shader.SetFloat("cascadeTexelSize" + index, 2.0f * cascades[i].radius / mapSize);
+	}
+}
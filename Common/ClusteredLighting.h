@@ -0,0 +1,344 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "GLStateCache.h"
+#include "JobPool.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define CLUSTER_USE_SSE 1
+#endif
+
+//One point light as the clustered shader sees it, radius is where the light is cut off.
+struct ClusterLight
+{
+	glm::vec3 position;
+	float radius;
+	glm::vec3 ambient;
+	float constant;
+	glm::vec3 diffuse;
+	float linear;
+	glm::vec3 specular;
+	float quadratic;
+};
+
+//Clustered forward light culling.
+//The view frustum is split into froxels (screen tiles x exponential depth slices). Every frame the
+//lights are bucketed by depth slice, then each slice is handed to a JobPool worker that tests its
+//candidate lights against the froxel AABBs four at a time with SSE. The result goes to three texture
+//buffers so a 3.3 context is enough:
+//	lights		RGBA32F, 4 texels per light (ClusterLight layout)
+//	grid		RG32UI, (offset, count) per cluster into the index list
+//	indices		R32UI, light indices
+//The fragment shader finds its cluster from gl_FragCoord and view depth and loops only over that list.
+class ClusteredLighting
+{
+public:
+	ClusteredLighting(int tilesX = 16, int tilesY = 9, int slices = 24, int maxLightsPerCluster = 256);
+	~ClusteredLighting();
+
+	//recomputes the froxel AABBs, call when fov, aspect or clip planes change
+	void SetProjection(float fovY, float aspect, float nearPlane, float farPlane);
+	//cull and upload, lights are in world space
+	void Update(const std::vector<ClusterLight>& lights, const glm::mat4& view);
+	//bind the three buffers to texture units [firstUnit, firstUnit+2] and set the lookup uniforms
+	void Bind(const Shader& shader, GLuint firstUnit, int viewportWidth, int viewportHeight) const;
+
+	unsigned int ClusterNum() const { return (unsigned int)clusterAABBs.size(); }
+	unsigned int IndexNum() const { return (unsigned int)indices.size(); }
+
+private:
+	struct AABB
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	//lights of one slice in SoA form so four can be tested at once
+	struct SliceLights
+	{
+		std::vector<float> x, y, z, r;
+		std::vector<GLuint> index;
+	};
+
+	int tilesX, tilesY, slices;
+	int maxLightsPerCluster;
+	float nearPlane = 0.1f;
+	float farPlane = 100.0f;
+
+	std::vector<AABB> clusterAABBs;
+	std::vector<SliceLights> sliceLights;
+	std::vector<std::vector<GLuint>> sliceIndices;		// per slice, concatenated cluster lists
+	std::vector<std::vector<GLuint>> sliceGrid;			// per slice, (offset in slice, count) per cluster
+	std::vector<char> sliceCapped;						// per slice, a cluster stopped at maxLightsPerCluster
+	bool capReported = false;
+	std::vector<GLuint> grid;
+	std::vector<GLuint> indices;
+	std::vector<glm::vec4> lightTexels;
+
+	JobPool jobs;
+
+	GLuint lightBuffer = 0, lightTex = 0;
+	GLuint gridBuffer = 0, gridTex = 0;
+	GLuint indexBuffer = 0, indexTex = 0;
+
+private:
+	int sliceOfDepth(float depth) const;
+	void cullSlice(int slice);
+	static void uploadBuffer(GLuint buffer, const void* data, size_t size);
+};
+
+inline ClusteredLighting::ClusteredLighting(int tilesX, int tilesY, int slices, int maxLightsPerCluster)
+	:tilesX(tilesX), tilesY(tilesY), slices(slices), maxLightsPerCluster(maxLightsPerCluster)
+{
+	sliceLights.resize(slices);
+	sliceIndices.resize(slices);
+	sliceGrid.resize(slices);
+	sliceCapped.resize(slices);
+
+	GLStateCache& state = GLStateCache::Get();
+	GLuint* buffers[3] = { &lightBuffer, &gridBuffer, &indexBuffer };
+	GLuint* textures[3] = { &lightTex, &gridTex, &indexTex };
+	const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+	for (int i = 0; i < 3; ++i)
+	{
+		glGenBuffers(1, buffers[i]);
+		state.BindBuffer(GL_TEXTURE_BUFFER, *buffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+
+		glGenTextures(1, textures[i]);
+		state.BindTexture(GL_TEXTURE_BUFFER, *textures[i]);
+		glTexBuffer(GL_TEXTURE_BUFFER, formats[i], *buffers[i]);
+	}
+}
+
+inline ClusteredLighting::~ClusteredLighting()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.DeleteTexture(lightTex);
+	state.DeleteTexture(gridTex);
+	state.DeleteTexture(indexTex);
+	state.DeleteBuffer(lightBuffer);
+	state.DeleteBuffer(gridBuffer);
+	state.DeleteBuffer(indexBuffer);
+}
+
+inline void ClusteredLighting::SetProjection(float fovY, float aspect, float nearZ, float farZ)
+{
+	nearPlane = nearZ;
+	farPlane = farZ;
+
+	float tanY = tan(fovY * 0.5f);
+	float tanX = tanY * aspect;
+
+	clusterAABBs.resize(tilesX * tilesY * slices);
+	for (int k = 0; k < slices; ++k)
+	{
+		//exponential slicing keeps froxels roughly cubic along depth
+		float zNear = nearPlane * pow(farPlane / nearPlane, (float)k / slices);
+		float zFar = nearPlane * pow(farPlane / nearPlane, (float)(k + 1) / slices);
+		for (int j = 0; j < tilesY; ++j)
+		{
+			float y0 = -1.0f + 2.0f * j / tilesY;
+			float y1 = -1.0f + 2.0f * (j + 1) / tilesY;
+			for (int i = 0; i < tilesX; ++i)
+			{
+				float x0 = -1.0f + 2.0f * i / tilesX;
+				float x1 = -1.0f + 2.0f * (i + 1) / tilesX;
+
+				//view space looks down -z, the tile's side planes pass through the eye
+				float xs[4] = { x0 * tanX * zNear, x1 * tanX * zNear, x0 * tanX * zFar, x1 * tanX * zFar };
+				float ys[4] = { y0 * tanY * zNear, y1 * tanY * zNear, y0 * tanY * zFar, y1 * tanY * zFar };
+
+				AABB& box = clusterAABBs[(k * tilesY + j) * tilesX + i];
+				box.min = glm::vec3(*std::min_element(xs, xs + 4), *std::min_element(ys, ys + 4), -zFar);
+				box.max = glm::vec3(*std::max_element(xs, xs + 4), *std::max_element(ys, ys + 4), -zNear);
+			}
+		}
+	}
+}
+
+inline int ClusteredLighting::sliceOfDepth(float depth) const
+{
+	if (depth <= nearPlane)
+		return 0;
+	int slice = (int)floor(log(depth / nearPlane) / log(farPlane / nearPlane) * slices);
+	return std::min(std::max(slice, 0), slices - 1);
+}
+
+inline void ClusteredLighting::Update(const std::vector<ClusterLight>& lights, const glm::mat4& view)
+{
+	//bucket lights by the depth slices their sphere touches
+	for (SliceLights& slice : sliceLights)
+	{
+		slice.x.clear();
+		slice.y.clear();
+		slice.z.clear();
+		slice.r.clear();
+		slice.index.clear();
+	}
+
+	lightTexels.resize(lights.size() * 4);
+	for (unsigned int i = 0; i < lights.size(); ++i)
+	{
+		const ClusterLight& light = lights[i];
+		lightTexels[i * 4 + 0] = glm::vec4(light.position, light.radius);
+		lightTexels[i * 4 + 1] = glm::vec4(light.ambient, light.constant);
+		lightTexels[i * 4 + 2] = glm::vec4(light.diffuse, light.linear);
+		lightTexels[i * 4 + 3] = glm::vec4(light.specular, light.quadratic);
+
+		glm::vec3 p = glm::vec3(view * glm::vec4(light.position, 1.0f));
+		float depth = -p.z;
+		if (depth + light.radius < nearPlane || depth - light.radius > farPlane)
+			continue;
+
+		int first = sliceOfDepth(depth - light.radius);
+		int last = sliceOfDepth(depth + light.radius);
+		for (int k = first; k <= last; ++k)
+		{
+			SliceLights& slice = sliceLights[k];
+			slice.x.push_back(p.x);
+			slice.y.push_back(p.y);
+			slice.z.push_back(p.z);
+			slice.r.push_back(light.radius);
+			slice.index.push_back(i);
+		}
+	}
+
+	jobs.ParallelFor(slices, [this](int k) { cullSlice(k); });
+	if (!capReported && std::find(sliceCapped.begin(), sliceCapped.end(), 1) != sliceCapped.end())
+	{
+		std::cout << "ClusteredLighting: a cluster hit the cap of " << maxLightsPerCluster << " lights, lights past it are dropped" << std::endl;
+		capReported = true;
+	}
+
+	//stitch the per slice lists together
+	int clustersPerSlice = tilesX * tilesY;
+	grid.resize(clusterAABBs.size() * 2);
+	indices.clear();
+	for (int k = 0; k < slices; ++k)
+	{
+		GLuint base = (GLuint)indices.size();
+		for (int c = 0; c < clustersPerSlice; ++c)
+		{
+			grid[(k * clustersPerSlice + c) * 2 + 0] = base + sliceGrid[k][c * 2 + 0];
+			grid[(k * clustersPerSlice + c) * 2 + 1] = sliceGrid[k][c * 2 + 1];
+		}
+		indices.insert(indices.end(), sliceIndices[k].begin(), sliceIndices[k].end());
+	}
+	if (indices.empty())
+		indices.push_back(0);	// keep the buffer non-empty
+	if (lightTexels.empty())
+		lightTexels.push_back(glm::vec4(0.0f));
+
+	uploadBuffer(lightBuffer, &lightTexels[0], lightTexels.size() * sizeof(glm::vec4));
+	uploadBuffer(gridBuffer, &grid[0], grid.size() * sizeof(GLuint));
+	uploadBuffer(indexBuffer, &indices[0], indices.size() * sizeof(GLuint));
+}
+
+inline void ClusteredLighting::cullSlice(int k)
+{
+	const SliceLights& candidates = sliceLights[k];
+	std::vector<GLuint>& out = sliceIndices[k];
+	std::vector<GLuint>& outGrid = sliceGrid[k];
+	out.clear();
+	outGrid.assign(tilesX * tilesY * 2, 0);
+	sliceCapped[k] = 0;
+
+	int lightNum = (int)candidates.index.size();
+	for (int c = 0; c < tilesX * tilesY; ++c)
+	{
+		const AABB& box = clusterAABBs[k * tilesX * tilesY + c];
+		GLuint offset = (GLuint)out.size();
+		int count = 0;
+
+		int i = 0;
+#ifdef CLUSTER_USE_SSE
+		//sphere vs aabb for four lights: squared distance from center to box <= r^2
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 minX = _mm_set1_ps(box.min.x), maxX = _mm_set1_ps(box.max.x);
+		const __m128 minY = _mm_set1_ps(box.min.y), maxY = _mm_set1_ps(box.max.y);
+		const __m128 minZ = _mm_set1_ps(box.min.z), maxZ = _mm_set1_ps(box.max.z);
+		for (; i + 4 <= lightNum && count < maxLightsPerCluster; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(&candidates.x[i]);
+			__m128 y = _mm_loadu_ps(&candidates.y[i]);
+			__m128 z = _mm_loadu_ps(&candidates.z[i]);
+			__m128 r = _mm_loadu_ps(&candidates.r[i]);
+
+			__m128 dx = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)));
+			__m128 dy = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)));
+			__m128 dz = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)));
+			__m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(r, r)));
+
+			for (int lane = 0; lane < 4 && mask; ++lane, mask >>= 1)
+			{
+				if ((mask & 1) && count < maxLightsPerCluster)
+				{
+					out.push_back(candidates.index[i + lane]);
+					++count;
+				}
+				else if (mask & 1)
+				{
+					sliceCapped[k] = 1;
+				}
+			}
+		}
+#endif
+		for (; i < lightNum && count < maxLightsPerCluster; ++i)
+		{
+			glm::vec3 center(candidates.x[i], candidates.y[i], candidates.z[i]);
+			glm::vec3 d = glm::max(glm::vec3(0.0f), glm::max(box.min - center, center - box.max));
+			if (glm::dot(d, d) <= candidates.r[i] * candidates.r[i])
+			{
+				out.push_back(candidates.index[i]);
+				++count;
+			}
+		}
+
+		//candidates left untested, some of them may touch the cluster
+		if (i < lightNum)
+			sliceCapped[k] = 1;
+
+		outGrid[c * 2 + 0] = offset;
+		outGrid[c * 2 + 1] = (GLuint)count;
+	}
+}
+
+inline void ClusteredLighting::Bind(const Shader& shader, GLuint firstUnit, int viewportWidth, int viewportHeight) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindTextureUnit(firstUnit + 0, GL_TEXTURE_BUFFER, lightTex);
+	state.BindTextureUnit(firstUnit + 1, GL_TEXTURE_BUFFER, gridTex);
+	state.BindTextureUnit(firstUnit + 2, GL_TEXTURE_BUFFER, indexTex);
+
+	shader.SetInt("clusterLights", firstUnit + 0);
+	shader.SetInt("clusterGrid", firstUnit + 1);
+	shader.SetInt("clusterIndices", firstUnit + 2);
+
+	//slice = log(depth) * scale - bias, same mapping as sliceOfDepth
+	float logRatio = log(farPlane / nearPlane);
+	glUniform3i(glGetUniformLocation(shader.shaderProgram, "clusterDims"), tilesX, tilesY, slices);
+	shader.SetVec2("clusterTileSize", glm::vec2((float)viewportWidth / tilesX, (float)viewportHeight / tilesY));
+	shader.SetFloat("clusterSliceScale", slices / logRatio);
+	shader.SetFloat("clusterSliceBias", slices * log(nearPlane) / logRatio);
+	shader.SetFloat("clusterNear", nearPlane);
+	shader.SetFloat("clusterFar", farPlane);
+}
+
+inline void ClusteredLighting::uploadBuffer(GLuint buffer, const void* data, size_t size)
+{
+	//orphan then fill, the driver hands out fresh storage instead of waiting on last frame's draws
+	GLStateCache::Get().BindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+}
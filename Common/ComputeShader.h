@@ -0,0 +1,112 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+#include <string>
+
+//Single stage compute program, needs a 4.3 context (check GLAD_GL_VERSION_4_3 before creating one).
+//Dispatch() issues the work groups only, the caller places the glMemoryBarrier that matches how the
+//results are read next (texture fetch, image load, framebuffer, ...).
+class ComputeShader
+{
+public:
+	ComputeShader(const GLchar* compShaderPath);
+	static ComputeShader FromSource(const std::string& computeCode);
+
+	void Use();
+	void Dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ = 1) const;
+
+	void SetInt(const std::string& name, GLint value) const;
+	void SetUInt(const std::string& name, GLuint value) const;
+	void SetFloat(const std::string& name, GLfloat value) const;
+	void SetIVec2(const std::string& name, const glm::ivec2& value) const;
+	void SetFloatArray(const std::string& name, const GLfloat* values, GLsizei count) const;
+	GLuint shaderProgram = 0;
+
+private:
+	ComputeShader() = default;
+	void build(const std::string& computeCode);
+};
+
+inline ComputeShader::ComputeShader(const GLchar* compShaderPath)
+{
+	build(Shader::ReadFile(compShaderPath));
+}
+
+inline ComputeShader ComputeShader::FromSource(const std::string& computeCode)
+{
+	ComputeShader shader;
+	shader.build(computeCode);
+	return shader;
+}
+
+inline void ComputeShader::build(const std::string& computeCode)
+{
+	const char* cShaderCode = computeCode.c_str();
+
+	GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(computeShader, 1, &cShaderCode, nullptr);
+	glCompileShader(computeShader);
+
+	int success;
+	char infoLog[512];
+	glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(computeShader, 512, nullptr, infoLog);
+		std::cout << "Error: compute shader compile failed!\n " << infoLog << std::endl;
+	}
+
+	shaderProgram = glCreateProgram();
+	glAttachShader(shaderProgram, computeShader);
+	glLinkProgram(shaderProgram);
+
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
+		std::cout << "Error: compute program link failed!\n " << infoLog << std::endl;
+	}
+
+	glDeleteShader(computeShader);
+}
+
+inline void ComputeShader::Use()
+{
+	GLStateCache::Get().UseProgram(shaderProgram);
+}
+
+inline void ComputeShader::Dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ) const
+{
+	glDispatchCompute(groupsX, groupsY, groupsZ);
+}
+
+inline void ComputeShader::SetInt(const std::string& name, GLint value) const
+{
+	glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), value);
+}
+
+inline void ComputeShader::SetUInt(const std::string& name, GLuint value) const
+{
+	glUniform1ui(glGetUniformLocation(shaderProgram, name.c_str()), value);
+}
+
+inline void ComputeShader::SetFloat(const std::string& name, GLfloat value) const
+{
+	glUniform1f(glGetUniformLocation(shaderProgram, name.c_str()), value);
+}
+
+inline void ComputeShader::SetIVec2(const std::string& name, const glm::ivec2& value) const
+{
+	glUniform2iv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+}
+
+inline void ComputeShader::SetFloatArray(const std::string& name, const GLfloat* values, GLsizei count) const
+{
+	glUniform1fv(glGetUniformLocation(shaderProgram, name.c_str()), count, values);
+}
@@ -0,0 +1,404 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//Deferred shading with light volumes.
+//Geometry is drawn once into a compact G-buffer:
+//	RT0		RGBA8	albedo.rgb, specular intensity
+//	RT1		RG16F	octahedral encoded world normal
+//	depth	D24S8	texture, positions are rebuilt from it with the inverse view projection
+//Lighting goes to a separate target whose depth/stencil is a copy of the G-buffer depth, so the
+//G-buffer depth can be sampled while the light volumes are depth tested against the copy.
+//Point lights are instanced spheres and cost one stencil mark pass plus one shading pass for all lights:
+//	stencil	back faces behind the scene +1, front faces behind the scene -1, non zero = inside some volume
+//	shade	back faces with GEQUAL where stencil != 0, additive
+//so only pixels a light can actually reach run the lighting shader. The count is 8 bit, so the lights go in
+//batches of at most MAX_BATCH_LIGHTS: a pixel behind 256 volumes would wrap to 0 and go unlit.
+class DeferredRenderer
+{
+public:
+	//one stencil count per batch, no pixel can be behind more volumes than the stencil holds
+	static const int MAX_BATCH_LIGHTS = 255;
+
+	//shaderDir holds screen_vert/screen_frag, volume_vert/volume_frag and stencil_frag
+	DeferredRenderer(const std::string& shaderDir);
+	~DeferredRenderer();
+
+	//(re)creates the targets when the framebuffer size changes, cheap to call every frame
+	void Resize(int width, int height);
+
+	//bind the G-buffer, the caller draws opaque geometry with a shader writing gAlbedoSpec and gNormal
+	void BeginGeometry() const;
+	//copy depth to the lighting target and run the fullscreen pass, set dirLight/spotLight on ScreenShader() first
+	void LightScreen(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess);
+	//accumulate point lights through their volumes
+	void LightVolumes(const std::vector<ClusterLight>& lights, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess);
+	//lighting target with depth test on, for forward drawn things like lamps
+	void BeginForward() const;
+	//blit the lit image to the default framebuffer
+	void Present() const;
+
+	Shader& ScreenShader() { return screenShader; }
+
+private:
+	Shader screenShader;
+	Shader volumeShader;
+	Shader stencilShader;
+
+	int width = 0;
+	int height = 0;
+
+	GLuint gBufferFBO = 0;
+	GLuint albedoSpecTex = 0;
+	GLuint normalTex = 0;
+	GLuint depthTex = 0;
+
+	GLuint lightFBO = 0;
+	GLuint lightTex = 0;
+	GLuint lightDepthRBO = 0;
+
+	GLuint quadVAO = 0;
+	GLuint quadVBO = 0;
+
+	GLuint sphereVAO = 0;
+	GLuint sphereVBO = 0;
+	GLuint sphereEBO = 0;
+	GLuint instanceVBO = 0;
+	GLsizei sphereIndexNum = 0;
+
+private:
+	void setupQuad();
+	void setupSphere(int rings, int segments);
+	void releaseTargets();
+	GLuint createTarget(GLint internalFormat, GLenum format, GLenum type) const;
+	void bindGBuffer(Shader& shader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess);
+};
+
+inline DeferredRenderer::DeferredRenderer(const std::string& shaderDir)
+	:screenShader((shaderDir + "/screen_vert.glsl").c_str(), (shaderDir + "/screen_frag.glsl").c_str()),
+	volumeShader((shaderDir + "/volume_vert.glsl").c_str(), (shaderDir + "/volume_frag.glsl").c_str()),
+	stencilShader((shaderDir + "/volume_vert.glsl").c_str(), (shaderDir + "/stencil_frag.glsl").c_str())
+{
+	setupQuad();
+	setupSphere(12, 16);
+}
+
+inline DeferredRenderer::~DeferredRenderer()
+{
+	GLStateCache& state = GLStateCache::Get();
+	releaseTargets();
+	state.DeleteVertexArray(quadVAO);
+	state.DeleteBuffer(quadVBO);
+	state.DeleteVertexArray(sphereVAO);
+	state.DeleteBuffer(sphereVBO);
+	state.DeleteBuffer(sphereEBO);
+	state.DeleteBuffer(instanceVBO);
+}
+
+inline void DeferredRenderer::Resize(int w, int h)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (w == width && h == height)
+		return;
+
+	releaseTargets();
+	width = w;
+	height = h;
+	if (width <= 0 || height <= 0) // minimized
+		return;
+
+	albedoSpecTex = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+	normalTex = createTarget(GL_RG16F, GL_RG, GL_HALF_FLOAT);
+	depthTex = createTarget(GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8);
+	lightTex = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+
+	glGenRenderbuffers(1, &lightDepthRBO);
+	state.BindRenderbuffer(lightDepthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	state.BindRenderbuffer(0);
+
+	//geometry
+	glGenFramebuffers(1, &gBufferFBO);
+	state.BindFramebuffer(GL_FRAMEBUFFER, gBufferFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoSpecTex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTex, 0);
+	const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, drawBuffers);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: G-buffer framebuffer is not complete" << std::endl;
+
+	//lighting
+	glGenFramebuffers(1, &lightFBO);
+	state.BindFramebuffer(GL_FRAMEBUFFER, lightFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, lightTex, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, lightDepthRBO);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: deferred lighting framebuffer is not complete" << std::endl;
+
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void DeferredRenderer::BeginGeometry() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, gBufferFBO);
+	state.Disable(GL_BLEND);
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthMask(GL_TRUE);
+	state.DepthFunc(GL_LESS);
+
+	const GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	glClearBufferfv(GL_COLOR, 0, zero);
+	glClearBufferfv(GL_COLOR, 1, zero);
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+inline void DeferredRenderer::bindGBuffer(Shader& shader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess)
+{
+	GLStateCache& state = GLStateCache::Get();
+	shader.Use();
+	state.BindTextureUnit(0, GL_TEXTURE_2D, albedoSpecTex);
+	state.BindTextureUnit(1, GL_TEXTURE_2D, normalTex);
+	state.BindTextureUnit(2, GL_TEXTURE_2D, depthTex);
+	shader.SetInt("gAlbedoSpec", 0);
+	shader.SetInt("gNormal", 1);
+	shader.SetInt("gDepth", 2);
+	shader.SetMat4("view", view);
+	shader.SetMat4("projection", projection);
+	shader.SetMat4("invViewProjection", glm::inverse(projection * view));
+	shader.SetVec2("screenSize", glm::vec2((float)width, (float)height));
+	shader.SetVec3("viewPos", viewPos);
+	shader.SetFloat("shininess", shininess);
+}
+
+inline void DeferredRenderer::LightScreen(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess)
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	//the volumes are depth tested against this copy while the original is sampled
+	state.BindFramebuffer(GL_READ_FRAMEBUFFER, gBufferFBO);
+	state.BindFramebuffer(GL_DRAW_FRAMEBUFFER, lightFBO);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	state.BindFramebuffer(GL_FRAMEBUFFER, lightFBO);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	state.Disable(GL_DEPTH_TEST);
+	state.DepthMask(GL_FALSE);
+	bindGBuffer(screenShader, view, projection, viewPos, shininess);
+	state.BindVertexArray(quadVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+inline void DeferredRenderer::LightVolumes(const std::vector<ClusterLight>& lights, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos, float shininess)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (lights.empty())
+		return;
+
+	//orphan then fill, same as the cluster buffers
+	state.BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, lights.size() * sizeof(ClusterLight), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, lights.size() * sizeof(ClusterLight), &lights[0]);
+
+	state.BindFramebuffer(GL_FRAMEBUFFER, lightFBO);
+	state.BindVertexArray(sphereVAO);
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthMask(GL_FALSE);
+	state.Enable(GL_STENCIL_TEST);
+	state.Enable(GL_CULL_FACE);
+	stencilShader.Use();
+	stencilShader.SetMat4("view", view);
+	stencilShader.SetMat4("projection", projection);
+	bindGBuffer(volumeShader, view, projection, viewPos, shininess);
+	state.BlendFunc(GL_ONE, GL_ONE);
+
+	for (size_t first = 0; first < lights.size(); first += MAX_BATCH_LIGHTS)
+	{
+		GLsizei lightNum = (GLsizei)std::min(lights.size() - first, (size_t)MAX_BATCH_LIGHTS);
+		//no base instance before 4.2, the batch starts where the instance attributes point
+		for (int i = 0; i < 4; ++i)
+			glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, sizeof(ClusterLight), (void*)(first * sizeof(ClusterLight) + i * sizeof(glm::vec4)));
+
+		state.StencilMask(0xFF);
+		glClear(GL_STENCIL_BUFFER_BIT);
+
+		//mark pixels whose surface lies inside at least one volume of the batch
+		stencilShader.Use();
+		state.Disable(GL_BLEND);
+		state.ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		state.DepthFunc(GL_LESS);
+		state.StencilFunc(GL_ALWAYS, 0, 0xFF);
+		state.CullFace(GL_FRONT);
+		state.StencilOp(GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+		glDrawElementsInstanced(GL_TRIANGLES, sphereIndexNum, GL_UNSIGNED_INT, 0, lightNum);
+		state.CullFace(GL_BACK);
+		state.StencilOp(GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+		glDrawElementsInstanced(GL_TRIANGLES, sphereIndexNum, GL_UNSIGNED_INT, 0, lightNum);
+
+		//shade the back faces, GEQUAL rejects surfaces behind each light on its own
+		volumeShader.Use();
+		state.ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		state.StencilMask(0x00);
+		state.StencilFunc(GL_NOTEQUAL, 0, 0xFF);
+		state.StencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		state.DepthFunc(GL_GEQUAL);
+		state.CullFace(GL_FRONT);
+		state.Enable(GL_BLEND);
+		glDrawElementsInstanced(GL_TRIANGLES, sphereIndexNum, GL_UNSIGNED_INT, 0, lightNum);
+	}
+
+	state.Disable(GL_BLEND);
+	state.CullFace(GL_BACK);
+	state.Disable(GL_CULL_FACE);
+	state.DepthFunc(GL_LESS);
+	state.StencilMask(0xFF);
+	state.Disable(GL_STENCIL_TEST);
+}
+
+inline void DeferredRenderer::BeginForward() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, lightFBO);
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthMask(GL_TRUE);
+	state.DepthFunc(GL_LESS);
+}
+
+inline void DeferredRenderer::Present() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_READ_FRAMEBUFFER, lightFBO);
+	state.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void DeferredRenderer::setupQuad()
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLfloat quadVertices[] = { // coord in ndc
+		// positions   // texCoords
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		-1.0f, -1.0f,  0.0f, 0.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+		 1.0f,  1.0f,  1.0f, 1.0f
+	};
+
+	glGenVertexArrays(1, &quadVAO);
+	state.BindVertexArray(quadVAO);
+
+	glGenBuffers(1, &quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	state.BindVertexArray(0);
+}
+
+inline void DeferredRenderer::setupSphere(int rings, int segments)
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	//unit uv sphere pushed out so the flat faces still enclose the real sphere
+	const float pi = 3.14159265f;
+	float scale = 1.0f / (cos(pi / rings) * cos(pi / segments));
+	std::vector<glm::vec3> vertices;
+	for (int r = 0; r <= rings; ++r)
+	{
+		float phi = pi * r / rings;
+		for (int s = 0; s <= segments; ++s)
+		{
+			float theta = 2.0f * pi * s / segments;
+			vertices.push_back(glm::vec3(sin(phi) * cos(theta), cos(phi), sin(phi) * sin(theta)) * scale);
+		}
+	}
+
+	//counter clockwise seen from outside
+	std::vector<GLuint> indices;
+	for (int r = 0; r < rings; ++r)
+	{
+		for (int s = 0; s < segments; ++s)
+		{
+			GLuint a = r * (segments + 1) + s;
+			GLuint b = a + segments + 1;
+			indices.push_back(a);
+			indices.push_back(a + 1);
+			indices.push_back(b);
+			indices.push_back(a + 1);
+			indices.push_back(b + 1);
+			indices.push_back(b);
+		}
+	}
+	sphereIndexNum = (GLsizei)indices.size();
+
+	glGenVertexArrays(1, &sphereVAO);
+	state.BindVertexArray(sphereVAO);
+
+	glGenBuffers(1, &sphereVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, sphereVBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), &vertices[0], GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glGenBuffers(1, &sphereEBO);
+	state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+
+	//one ClusterLight per instance, four vec4s
+	glGenBuffers(1, &instanceVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	for (int i = 0; i < 4; ++i)
+	{
+		glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, sizeof(ClusterLight), (void*)(i * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(1 + i);
+		glVertexAttribDivisor(1 + i, 1);
+	}
+
+	state.BindVertexArray(0);
+}
+
+inline void DeferredRenderer::releaseTargets()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.DeleteFramebuffer(gBufferFBO);
+	state.DeleteFramebuffer(lightFBO);
+	state.DeleteTexture(albedoSpecTex);
+	state.DeleteTexture(normalTex);
+	state.DeleteTexture(depthTex);
+	state.DeleteTexture(lightTex);
+	state.DeleteRenderbuffer(lightDepthRBO);
+	gBufferFBO = lightFBO = albedoSpecTex = normalTex = depthTex = lightTex = lightDepthRBO = 0;
+}
+
+inline GLuint DeferredRenderer::createTarget(GLint internalFormat, GLenum format, GLenum type) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLuint tex;
+	glGenTextures(1, &tex);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, tex);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return tex;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glfw3.h"
+
+#include "Camera.h"
+#include "CPUProfiler.h"
+#include "GLContext.h"
+#include "GLTrace.h"
+#include "Benchmark.h"
+#include "InputRecorder.h"
+#include "FrameClock.h"
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+//The frame loop every demo shares, set up from the command line in one place:
+//	- the GL context (GLContext), a window or --headless[=frames], --gl-trace capture right after it exists
+//	- --benchmark[=frames], a scripted camera on a fixed step that also ends the run (Benchmark)
+//	- --record=file.input / --replay=file.input (InputRecorder)
+//	- --pacing=vsync|capped|uncapped|on-demand, --fps=N, --frames-in-flight=N, --refresh-hz=N (FrameClock)
+//Construct it first in main and return when it is not Valid(), then AttachInput() and load the scene:
+//	while (loop.BeginFrame(camera, deltaTime, processInput))
+//	{
+//		...draw...
+//		loop.EndFrame();
+//	}
+//BeginFrame() waits for the frame slot and polls input as late as the pacing allows, then the camera follows
+//the benchmark path, the replayed frame or the live input through processInput, and on demand pacing watches
+//it. It returns false once the window closed, the benchmark finished or the replay ran out. The clock starts
+//with the first frame, so loading counts into neither Time() nor the frame times.
+//Benchmark and replay runs keep a headless context going until they are done, and headless frames stay on
+//the fixed 60 Hz step so batch renders match.
+class DemoLoop
+{
+public:
+	typedef void (*InputFunc)(GLFWwindow* window);
+
+	struct Settings
+	{
+		GLContext::Settings context;
+		std::string scene;								// names the benchmark and its results
+		std::vector<Benchmark::CameraKey> benchmarkPath;	// the default orbit when empty
+		double settleSeconds = 0.0;						// on demand pacing keeps drawing this long after the camera stopped
+	};
+
+	DemoLoop(int argc, char** argv, const Settings& loopSettings);
+
+	bool Valid() const { return context.Valid(); }
+	GLContext& Context() { return context; }
+	//nullptr when headless
+	GLFWwindow* Window() const { return context.Window(); }
+
+	//captures the cursor and puts the recorder between glfw and the callbacks, any of them may be nullptr
+	void AttachInput(GLFWcursorposfun cursor, GLFWscrollfun scroll, GLFWkeyfun key);
+
+	//deltaTime is the demo's, processInput reads it
+	bool BeginFrame(Camera& camera, float& deltaTime, InputFunc processInput);
+	//swaps, then closes the frame for the clock and the benchmark
+	void EndFrame();
+
+	//seconds, on the benchmark's or the recording's clock when one of them drives the frame
+	double Time() const { return time; }
+	//the camera follows a benchmark path or a recording, live input must not move it
+	bool Scripted() const { return benchmark->Active() || input.Replaying(); }
+	FrameClock& Clock() { return *clock; }
+	GPUProfiler& Profiler() { return benchmark->Profiler(); }
+	//--gl-stats, demos print their own periodic stats next to the GLInterceptor table
+	bool GLStats() const { return benchmark->GLStats(); }
+
+private:
+	Settings settings;
+	FrameClock::Settings clockSettings;
+	GLContext context;
+	InputRecorder input;
+	std::unique_ptr<Benchmark> benchmark;
+	std::unique_ptr<FrameClock> clock;
+	double time = 0.0;
+
+private:
+	static GLContext::Settings contextSettings(int argc, char** argv, const Settings& loopSettings);
+};
+
+inline GLContext::Settings DemoLoop::contextSettings(int argc, char** argv, const Settings& loopSettings)
+{
+	GLContext::Settings result = GLContext::ParseArgs(argc, argv, loopSettings.context);
+	//a scripted run decides itself when it is over
+	if (Benchmark::ParseArgs(argc, argv, loopSettings.scene).frames > 0 || InputRecorder::ParseArgs(argc, argv).mode == InputRecorder::Mode::REPLAY)
+		result.headlessFrames = std::numeric_limits<int>::max();
+	return result;
+}
+
+inline DemoLoop::DemoLoop(int argc, char** argv, const Settings& loopSettings)
+	:settings(loopSettings),
+	clockSettings(FrameClock::ParseArgs(argc, argv)),
+	context(contextSettings(argc, argv, loopSettings)),
+	input(InputRecorder::ParseArgs(argc, argv))
+{
+	if (!context.Valid())
+		return;
+
+	//records every GL call from here on for TraceReplay
+	GLTrace::Capture(GLTrace::ParseArgs(argc, argv));
+
+	Benchmark::Settings benchmarkSettings = Benchmark::ParseArgs(argc, argv, settings.scene);
+	if (!settings.benchmarkPath.empty())
+		benchmarkSettings.path = settings.benchmarkPath;
+	benchmark.reset(new Benchmark(benchmarkSettings));
+
+	if (context.Headless())
+		clockSettings.fixedTimestep = 1.0 / 60.0;
+}
+
+inline void DemoLoop::AttachInput(GLFWcursorposfun cursor, GLFWscrollfun scroll, GLFWkeyfun key)
+{
+	GLFWwindow* window = context.Window();
+	if (window)
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	input.Attach(window, cursor, scroll, key);
+}
+
+inline bool DemoLoop::BeginFrame(Camera& camera, float& deltaTime, InputFunc processInput)
+{
+	PROFILE_ZONE("DemoLoop::BeginFrame");
+	if (context.ShouldClose() || benchmark->Finished() || input.Finished())
+		return false;
+	if (!clock)
+		clock.reset(new FrameClock(clockSettings));
+
+	clock->BeginFrame();
+	//the benchmark's cpu frame time spans poll through swap, the wait for the frame slot stays out
+	benchmark->BeginFrame();
+	context.PollEvents();
+	time = clock->Time();
+	deltaTime = clock->DeltaTime();
+
+	if (benchmark->Active())
+	{
+		time = benchmark->Time();
+		deltaTime = benchmark->DeltaTime();
+		benchmark->UpdateCamera(camera);
+	}
+	else if (context.Window() || input.Replaying())
+	{
+		input.BeginFrame(camera, time, deltaTime);
+		if (processInput)
+			processInput(context.Window());
+	}
+	//on demand pacing draws the next frame only while something changes
+	clock->WatchCamera(camera, settings.settleSeconds);
+	return true;
+}
+
+inline void DemoLoop::EndFrame()
+{
+	{
+		PROFILE_ZONE("present");
+		context.SwapBuffers();
+		clock->EndFrame();
+	}
+	benchmark->EndFrame();
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+#include <string>
+
+enum class PrepassMode
+{
+	OFF,
+	ON,
+	AUTO,		// on while the measured overdraw is high
+};
+
+//Optional depth-only prepass in front of an expensive color pass.
+//The depth pass lays down depth with color writes off and a trivial program, the color pass then runs
+//with GL_EQUAL and no depth writes so every pixel is shaded once. Both vertex shaders must compute
+//gl_Position the same way (and declare it invariant) for EQUAL to hold.
+//Overdraw is measured with GL_SAMPLES_PASSED on whichever pass depth tests with LESS (the prepass when
+//on, the color pass when off) and GL_TIME_ELAPSED times both passes. Queries live in a small ring and are
+//read a few frames later, only when available, so measuring never stalls the pipeline.
+class DepthPrepass
+{
+public:
+	struct Stats
+	{
+		float overdraw = 0.0f;		// fragments passing LESS per pixel
+		float depthMs = 0.0f;
+		float colorMs = 0.0f;
+	};
+
+	DepthPrepass(const GLchar* depthVertPath, const GLchar* depthFragPath);
+	~DepthPrepass();
+
+	void SetMode(PrepassMode newMode) { mode = newMode; }
+	PrepassMode GetMode() const { return mode; }
+	bool Enabled() const { return enabled; }
+	const Stats& GetStats() const { return stats; }
+	Shader& DepthShader() { return depthShader; }
+
+	//collect old query results and decide for this frame, returns whether the prepass runs
+	bool BeginFrame(int width, int height);
+	//depth only state, the caller draws occluders with DepthShader() and a position only stream
+	Shader& BeginDepth();
+	void EndDepth();
+	//EQUAL and no depth writes when the prepass ran, the usual LESS otherwise
+	void BeginColor();
+	void EndColor();
+
+private:
+	static const int RING = 3;
+
+	struct FrameQueries
+	{
+		GLuint samples;
+		GLuint depthTime;
+		GLuint colorTime;
+		bool issued = false;
+		bool prepass = false;
+	};
+
+	Shader depthShader;
+	PrepassMode mode = PrepassMode::AUTO;
+	bool enabled = false;
+	Stats stats;
+
+	float enableAbove = 1.6f;		// overdraw hysteresis for AUTO
+	float disableBelow = 1.25f;
+
+	FrameQueries frames[RING];
+	int frame = 0;
+	int pixels = 1;
+
+private:
+	FrameQueries& current() { return frames[frame % RING]; }
+	static bool available(GLuint query);
+};
+
+inline DepthPrepass::DepthPrepass(const GLchar* depthVertPath, const GLchar* depthFragPath)
+	:depthShader(depthVertPath, depthFragPath)
+{
+	for (FrameQueries& queries : frames)
+	{
+		glGenQueries(1, &queries.samples);
+		glGenQueries(1, &queries.depthTime);
+		glGenQueries(1, &queries.colorTime);
+	}
+}
+
+inline DepthPrepass::~DepthPrepass()
+{
+	for (FrameQueries& queries : frames)
+	{
+		glDeleteQueries(1, &queries.samples);
+		glDeleteQueries(1, &queries.depthTime);
+		glDeleteQueries(1, &queries.colorTime);
+	}
+}
+
+inline bool DepthPrepass::available(GLuint query)
+{
+	GLuint ready = GL_FALSE;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &ready);
+	return ready == GL_TRUE;
+}
+
+inline bool DepthPrepass::BeginFrame(int width, int height)
+{
+	++frame;
+	pixels = width * height > 0 ? width * height : 1;
+
+	//this slot was issued RING frames ago, use it if the gpu is done with it
+	FrameQueries& queries = current();
+	if (queries.issued && available(queries.samples) && available(queries.colorTime)
+		&& (!queries.prepass || available(queries.depthTime)))
+	{
+		GLuint samples = 0;
+		GLuint64 colorNs = 0, depthNs = 0;
+		glGetQueryObjectuiv(queries.samples, GL_QUERY_RESULT, &samples);
+		glGetQueryObjectui64v(queries.colorTime, GL_QUERY_RESULT, &colorNs);
+		if (queries.prepass)
+			glGetQueryObjectui64v(queries.depthTime, GL_QUERY_RESULT, &depthNs);
+
+		//smoothed so one odd frame does not flip the mode
+		stats.overdraw = stats.overdraw * 0.9f + (float)samples / pixels * 0.1f;
+		stats.colorMs = stats.colorMs * 0.9f + colorNs / 1.0e6f * 0.1f;
+		stats.depthMs = stats.depthMs * 0.9f + depthNs / 1.0e6f * 0.1f;
+	}
+	queries.issued = false;
+
+	switch (mode)
+	{
+	case PrepassMode::OFF:
+		enabled = false;
+		break;
+	case PrepassMode::ON:
+		enabled = true;
+		break;
+	case PrepassMode::AUTO:
+		if (!enabled && stats.overdraw > enableAbove)
+			enabled = true;
+		else if (enabled && stats.overdraw < disableBelow)
+			enabled = false;
+		break;
+	}
+	queries.prepass = enabled;
+	return enabled;
+}
+
+inline Shader& DepthPrepass::BeginDepth()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthFunc(GL_LESS);
+	state.DepthMask(GL_TRUE);
+	state.ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+	FrameQueries& queries = current();
+	glBeginQuery(GL_TIME_ELAPSED, queries.depthTime);
+	glBeginQuery(GL_SAMPLES_PASSED, queries.samples);
+	depthShader.Use();
+	return depthShader;
+}
+
+inline void DepthPrepass::EndDepth()
+{
+	glEndQuery(GL_SAMPLES_PASSED);
+	glEndQuery(GL_TIME_ELAPSED);
+	GLStateCache::Get().ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+inline void DepthPrepass::BeginColor()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.Enable(GL_DEPTH_TEST);
+	FrameQueries& queries = current();
+	if (enabled)
+	{
+		state.DepthFunc(GL_EQUAL);
+		state.DepthMask(GL_FALSE);
+	}
+	else
+	{
+		state.DepthFunc(GL_LESS);
+		state.DepthMask(GL_TRUE);
+		glBeginQuery(GL_SAMPLES_PASSED, queries.samples);
+	}
+	glBeginQuery(GL_TIME_ELAPSED, queries.colorTime);
+}
+
+inline void DepthPrepass::EndColor()
+{
+	GLStateCache& state = GLStateCache::Get();
+	glEndQuery(GL_TIME_ELAPSED);
+	if (!enabled)
+		glEndQuery(GL_SAMPLES_PASSED);
+	current().issued = true;
+
+	state.DepthFunc(GL_LESS);
+	state.DepthMask(GL_TRUE);
+}
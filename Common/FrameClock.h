@@ -0,0 +1,440 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glfw3.h"
+
+#include "Camera.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+//Frame clock and pacer shared by the demos: --pacing=vsync|capped|uncapped|on-demand, --fps=N,
+//--frames-in-flight=N, --refresh-hz=N.
+//Time comes from steady_clock, 64 bit and monotonic, and is kept in double seconds since the clock started,
+//so DeltaTime() stays exact however long the demo runs (a float glfwGetTime() is down to 1/64 s steps after
+//three days). The demos keep it a double too, and wrap periodic animation in double before it becomes a float.
+//BeginFrame() waits until the frame may start and samples the clock, poll input right after it so the frame
+//works on the freshest input the pacing allows. EndFrame(), right after the swap, puts a fence and a
+//GL_TIMESTAMP query behind the frame:
+//	- at most framesInFlight frames are queued on the gpu, BeginFrame() blocks on the fence of the oldest
+//	  one before starting another, which bounds how far the cpu runs ahead and with it the latency
+//	- vsync paces on the swap, capped sleeps to the next frame slot and spins out the last spinMs (sleep
+//	  overshoots by a scheduler tick), uncapped only keeps the frames in flight bound
+//	- on demand sleeps in glfwWaitEvents until there is something to draw: an event (input, resize, a Wake()
+//	  from another thread), an Invalidate(), a camera WatchCamera() saw move, or the refreshHz tick that
+//	  progressive effects can ask for. Demos that animate invalidate every frame while they do. Idle time
+//	  counts neither into DeltaTime() nor into the frame times. Needs a window, benchmark and replay runs
+//	  fall back to their usual pacing
+//	- latency runs from the input sample in BeginFrame() to the gpu passing the swap, the closest to present
+//	  GL can see, both ends on the gpu clock; it resolves once the fence has signalled
+//fixedTimestep replaces the wall clock for Time() and DeltaTime() (headless runs), pacing stays real time.
+//Frame time, jitter, latency and the time spent blocked on the gpu are printed when the clock goes away.
+class FrameClock
+{
+public:
+	enum class Pacing
+	{
+		VSYNC,
+		CAPPED,
+		UNCAPPED,
+		ON_DEMAND
+	};
+
+	struct Settings
+	{
+		Pacing pacing = Pacing::VSYNC;
+		double targetFps = 60.0;		// capped only
+		int framesInFlight = 2;			// 0 leaves the cpu unbounded
+		double spinMs = 2.0;
+		double fixedTimestep = 0.0;		// seconds, 0 runs on the wall clock
+		double refreshHz = 0.0;			// on demand only, draws at least this often when above 0
+	};
+
+	static const int MAX_FRAMES_IN_FLIGHT = 8;
+
+	//a --benchmark run defaults to uncapped, it measures the frame and not the display
+	static Settings ParseArgs(int argc, char** argv);
+	static const char* PacingName(Pacing pacing);
+
+	//needs the GL context current, sets the swap interval of a glfw context to match the pacing
+	FrameClock(const Settings& clockSettings);
+	~FrameClock();
+
+	void BeginFrame();
+	void EndFrame();
+
+	//on demand: draw the next frame, and keep drawing for seconds when above 0
+	void Invalidate(double seconds = 0.0);
+	//on demand: invalidates while the camera moves, and for settleSeconds after it stopped
+	void WatchCamera(const Camera& camera, double settleSeconds = 0.0);
+	//from any thread (a streaming loader): invalidates and wakes a BeginFrame() waiting for events
+	void Wake();
+
+	//seconds since the clock started, as sampled by the last BeginFrame()
+	double Time() const { return time; }
+	float DeltaTime() const { return deltaTime; }
+	int Frame() const { return frame; }
+	//of the newest frame the gpu has finished, 0 before the first one
+	float LatencyMs() const { return lastLatencyMs; }
+
+	void Print(std::ostream& out) const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct InFlight
+	{
+		GLsync fence;
+		GLuint query;
+		GLint64 sampled;	// gpu clock, ns
+	};
+
+	Settings settings;
+	Clock::time_point start;
+	Clock::time_point lastSample;
+	Clock::time_point nextFrame;
+	double time = 0.0;
+	float deltaTime = 0.0f;
+	int frame = 0;
+	GLint64 gpuSample = 0;
+
+	InFlight inFlight[MAX_FRAMES_IN_FLIGHT];
+	GLuint queries[MAX_FRAMES_IN_FLIGHT];
+	int inFlightFirst = 0;
+	int inFlightCount = 0;
+
+	int frameSamples = 0;
+	double frameMsSum = 0.0;
+	double frameMsSquares = 0.0;
+	double frameMsMax = 0.0;
+	int latencySamples = 0;
+	double latencyMsSum = 0.0;
+	double latencyMsMax = 0.0;
+	float lastLatencyMs = 0.0f;
+	double gpuWaitMs = 0.0;
+
+	bool redraw = true;
+	Clock::time_point redrawUntil;
+	std::atomic<bool> woken;
+	bool watching = false;
+	glm::vec3 watchedPosition;
+	float watchedYaw = 0.0f;
+	float watchedPitch = 0.0f;
+	float watchedFov = 0.0f;
+	double idleMs = 0.0;
+
+private:
+	//on demand: returns once there is something to draw
+	void waitForWork();
+	//retires the oldest frames the gpu is done with, wait blocks until the oldest one is
+	void retire(bool wait);
+	void waitUntil(Clock::time_point target) const;
+	static double milliseconds(Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); }
+};
+
+inline FrameClock::Settings FrameClock::ParseArgs(int argc, char** argv)
+{
+	Settings result;
+	bool pacingGiven = false;
+	bool benchmark = false;
+	bool replay = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 9, "--pacing=") == 0)
+		{
+			std::string name = arg.substr(9);
+			pacingGiven = true;
+			if (name == "vsync")
+				result.pacing = Pacing::VSYNC;
+			else if (name == "capped")
+				result.pacing = Pacing::CAPPED;
+			else if (name == "uncapped")
+				result.pacing = Pacing::UNCAPPED;
+			else if (name == "on-demand")
+				result.pacing = Pacing::ON_DEMAND;
+			else
+			{
+				std::cout << "Error: unknown pacing " << name << ", use vsync, capped, uncapped or on-demand" << std::endl;
+				pacingGiven = false;
+			}
+		}
+		else if (arg.compare(0, 6, "--fps=") == 0)
+		{
+			double fps = std::atof(arg.c_str() + 6);
+			if (fps > 0.0)
+			{
+				result.targetFps = fps;
+				result.pacing = Pacing::CAPPED;
+				pacingGiven = true;
+			}
+		}
+		else if (arg.compare(0, 19, "--frames-in-flight=") == 0)
+			result.framesInFlight = std::min(std::max(std::atoi(arg.c_str() + 19), 0), (int)MAX_FRAMES_IN_FLIGHT);
+		else if (arg.compare(0, 13, "--refresh-hz=") == 0)
+			result.refreshHz = std::max(std::atof(arg.c_str() + 13), 0.0);
+		else if (arg.compare(0, 11, "--benchmark") == 0 && arg.compare(0, 15, "--benchmark-out") != 0)
+			benchmark = true;
+		else if (arg.compare(0, 9, "--replay=") == 0)
+			replay = true;
+	}
+	//a scripted camera holds still through the warm up and replayed input arrives without events,
+	//on demand would sleep through both
+	if (benchmark && (!pacingGiven || result.pacing == Pacing::ON_DEMAND))
+		result.pacing = Pacing::UNCAPPED;
+	else if (replay && result.pacing == Pacing::ON_DEMAND)
+		result.pacing = Pacing::VSYNC;
+	return result;
+}
+
+inline const char* FrameClock::PacingName(Pacing pacing)
+{
+	switch (pacing)
+	{
+	case Pacing::VSYNC: return "vsync";
+	case Pacing::CAPPED: return "capped";
+	case Pacing::ON_DEMAND: return "on demand";
+	default: return "uncapped";
+	}
+}
+
+inline FrameClock::FrameClock(const Settings& clockSettings)
+	:settings(clockSettings), woken(false)
+{
+	settings.framesInFlight = std::min(std::max(settings.framesInFlight, 0), (int)MAX_FRAMES_IN_FLIGHT);
+	if (settings.targetFps <= 0.0)
+		settings.targetFps = 60.0;
+
+	//a headless context has no swap to sync to, and no events to wait for
+	if (glfwGetCurrentContext())
+		glfwSwapInterval(settings.pacing == Pacing::VSYNC || settings.pacing == Pacing::ON_DEMAND ? 1 : 0);
+	else if (settings.pacing == Pacing::ON_DEMAND)
+		settings.pacing = Pacing::UNCAPPED;
+#if defined(_WIN32)
+	//sleep_for rounds up to the 15.6 ms scheduler tick otherwise
+	if (settings.pacing == Pacing::CAPPED)
+		timeBeginPeriod(1);
+#endif
+
+	glGenQueries(MAX_FRAMES_IN_FLIGHT, queries);
+	start = Clock::now();
+	lastSample = start;
+	nextFrame = start;
+}
+
+inline FrameClock::~FrameClock()
+{
+	for (int i = 0; i < inFlightCount; ++i)
+		glDeleteSync(inFlight[(inFlightFirst + i) % MAX_FRAMES_IN_FLIGHT].fence);
+	glDeleteQueries(MAX_FRAMES_IN_FLIGHT, queries);
+#if defined(_WIN32)
+	if (settings.pacing == Pacing::CAPPED)
+		timeEndPeriod(1);
+#endif
+	if (frame > 0)
+		Print(std::cout);
+}
+
+inline void FrameClock::BeginFrame()
+{
+	if (settings.pacing == Pacing::ON_DEMAND && frame > 0)
+		waitForWork();
+
+	//bound the frames in flight before pacing, a slot that opens while the gpu is still busy is no use
+	retire(false);
+	if (settings.framesInFlight > 0 && inFlightCount >= settings.framesInFlight)
+	{
+		Clock::time_point waitStart = Clock::now();
+		while (inFlightCount >= settings.framesInFlight)
+			retire(true);
+		gpuWaitMs += milliseconds(Clock::now() - waitStart);
+	}
+
+	if (settings.pacing == Pacing::CAPPED)
+	{
+		waitUntil(nextFrame);
+		Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / settings.targetFps));
+		nextFrame += period;
+		//already past the next slot: start over from now instead of rushing frames out to catch up
+		Clock::time_point now = Clock::now();
+		if (nextFrame < now)
+			nextFrame = now + period;
+	}
+
+	Clock::time_point now = Clock::now();
+	glGetInteger64v(GL_TIMESTAMP, &gpuSample);
+	if (frame > 0)
+	{
+		double frameMs = milliseconds(now - lastSample);
+		++frameSamples;
+		frameMsSum += frameMs;
+		frameMsSquares += frameMs * frameMs;
+		frameMsMax = std::max(frameMsMax, frameMs);
+	}
+
+	if (settings.fixedTimestep > 0.0)
+	{
+		time = frame * settings.fixedTimestep;
+		deltaTime = frame > 0 ? (float)settings.fixedTimestep : 0.0f;
+	}
+	else
+	{
+		time = std::chrono::duration<double>(now - start).count();
+		deltaTime = frame > 0 ? (float)std::chrono::duration<double>(now - lastSample).count() : 0.0f;
+	}
+	lastSample = now;
+	++frame;
+	redraw = false;
+}
+
+inline void FrameClock::EndFrame()
+{
+	//unbounded runs still sample latency, the oldest frame is dropped when the ring is full
+	if (inFlightCount == MAX_FRAMES_IN_FLIGHT)
+	{
+		glDeleteSync(inFlight[inFlightFirst].fence);
+		inFlightFirst = (inFlightFirst + 1) % MAX_FRAMES_IN_FLIGHT;
+		--inFlightCount;
+	}
+
+	int slot = (inFlightFirst + inFlightCount) % MAX_FRAMES_IN_FLIGHT;
+	InFlight& entry = inFlight[slot];
+	entry.query = queries[slot];
+	entry.sampled = gpuSample;
+	glQueryCounter(entry.query, GL_TIMESTAMP);
+	entry.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	++inFlightCount;
+}
+
+inline void FrameClock::Invalidate(double seconds)
+{
+	redraw = true;
+	if (seconds > 0.0)
+		redrawUntil = std::max(redrawUntil, Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+inline void FrameClock::WatchCamera(const Camera& camera, double settleSeconds)
+{
+	bool moved = !watching || camera.Position != watchedPosition || camera.Yaw != watchedYaw
+		|| camera.Pitch != watchedPitch || camera.Fov != watchedFov;
+	watching = true;
+	watchedPosition = camera.Position;
+	watchedYaw = camera.Yaw;
+	watchedPitch = camera.Pitch;
+	watchedFov = camera.Fov;
+	//the frame after the last move has to show where the camera stopped
+	if (moved)
+		Invalidate(settleSeconds);
+}
+
+inline void FrameClock::Wake()
+{
+	woken = true;
+	glfwPostEmptyEvent();
+}
+
+inline void FrameClock::waitForWork()
+{
+	Clock::time_point waitStart = Clock::now();
+	bool refresh = settings.refreshHz > 0.0;
+	Clock::time_point refreshDue = lastSample + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(refresh ? 1.0 / settings.refreshHz : 0.0));
+	if (redraw || woken.exchange(false) || waitStart < redrawUntil || (refresh && waitStart >= refreshDue))
+		return;
+
+	//whatever woke the wait, input, a resize or a posted Wake(), gets a frame; a timeout is the refresh tick
+	if (refresh)
+		glfwWaitEventsTimeout(std::chrono::duration<double>(refreshDue - waitStart).count());
+	else
+		glfwWaitEvents();
+	woken = false;
+
+	//the wait is not frame time, the next DeltaTime() starts from the wake up
+	Clock::duration waited = Clock::now() - waitStart;
+	lastSample += waited;
+	nextFrame += waited;
+	idleMs += milliseconds(waited);
+}
+
+inline void FrameClock::retire(bool wait)
+{
+	while (inFlightCount > 0)
+	{
+		InFlight& entry = inFlight[inFlightFirst];
+		GLenum status = glClientWaitSync(entry.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 100000000 : 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+		{
+			if (!wait)
+				return;
+			continue;
+		}
+
+		if (status != GL_WAIT_FAILED)
+		{
+			GLuint64 presented = 0;
+			glGetQueryObjectui64v(entry.query, GL_QUERY_RESULT, &presented);
+			double latencyMs = ((GLint64)presented - entry.sampled) / 1000000.0;
+			if (latencyMs >= 0.0)
+			{
+				lastLatencyMs = (float)latencyMs;
+				++latencySamples;
+				latencyMsSum += latencyMs;
+				latencyMsMax = std::max(latencyMsMax, latencyMs);
+			}
+		}
+		glDeleteSync(entry.fence);
+		inFlightFirst = (inFlightFirst + 1) % MAX_FRAMES_IN_FLIGHT;
+		--inFlightCount;
+		if (wait)
+			return;
+	}
+}
+
+inline void FrameClock::waitUntil(Clock::time_point target) const
+{
+	Clock::duration spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(settings.spinMs));
+	Clock::time_point now = Clock::now();
+	if (target - now > spin)
+		std::this_thread::sleep_for(target - now - spin);
+	while (Clock::now() < target)
+		std::this_thread::yield();
+}
+
+inline void FrameClock::Print(std::ostream& out) const
+{
+	out << "FrameClock: " << frame << " frames, " << PacingName(settings.pacing);
+	if (settings.pacing == Pacing::CAPPED)
+		out << " at " << settings.targetFps << " fps";
+	out << ", " << settings.framesInFlight << " frames in flight" << std::endl;
+	if (frameSamples > 0)
+	{
+		double mean = frameMsSum / frameSamples;
+		double jitter = std::sqrt(std::max(frameMsSquares / frameSamples - mean * mean, 0.0));
+		out << "  frame " << mean << " ms mean, " << jitter << " ms jitter, " << frameMsMax << " ms max" << std::endl;
+	}
+	if (latencySamples > 0)
+		out << "  input to present " << latencyMsSum / latencySamples << " ms mean, " << latencyMsMax << " ms max" << std::endl;
+	out << "  blocked on the gpu " << gpuWaitMs << " ms" << std::endl;
+	if (settings.pacing == Pacing::ON_DEMAND)
+	{
+		double runMs = milliseconds(Clock::now() - start);
+		out << "  idle " << idleMs << " ms, " << (runMs > 0.0 ? 100.0 * idleMs / runMs : 0.0) << "% of the run" << std::endl;
+	}
+}
@@ -0,0 +1,402 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glfw3.h"
+
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+//no Xlib types leaking into every demo
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GLCONTEXT_HAS_EGL 1
+#endif
+
+//Where the demos get their GL context from, a glfw window or a headless EGL context.
+//Headless (Linux only, link against libEGL) prefers a surfaceless display (EGL_MESA_platform_surfaceless,
+//what Mesa's llvmpipe offers on machines without a display) and falls back to the default display with a
+//pbuffer. Either way the frame goes to an offscreen framebuffer that GLStateCache binds whenever code asks
+//for framebuffer 0, so the render code does not know which backend it runs on. A headless run renders a
+//fixed number of frames on a fixed 60 Hz clock, which keeps batch renders and golden images reproducible,
+//and can write its last frame out as a .ppm.
+//Both backends try a core context of the version in Settings (4.3 unless the demo asks for another) first
+//and settle for 3.3.
+class GLContext
+{
+public:
+	enum class Backend
+	{
+		WINDOW,
+		HEADLESS
+	};
+
+	struct Settings
+	{
+		int width = 800;
+		int height = 600;
+		std::string title = "GiantOpenGL";
+		Backend backend = Backend::WINDOW;
+		int headlessFrames = 1;
+		std::string captureFile;		// headless only, last frame as .ppm
+		int majorVersion = 4;			// first choice, 3.3 is the fallback
+		int minorVersion = 3;
+	};
+
+	//--headless[=frames] and --capture=file.ppm, GIANT_HEADLESS=frames in the environment works too
+	static Settings ParseArgs(int argc, char** argv, const Settings& defaults);
+
+	GLContext(const Settings& contextSettings);
+	~GLContext();
+
+	bool Valid() const { return valid; }
+	bool Headless() const { return settings.backend == Backend::HEADLESS; }
+	//nullptr when headless, input and callbacks only exist with a window
+	GLFWwindow* Window() const { return window; }
+	//for loaders of extension entry points glad does not cover
+	GLADloadproc ProcAddress() const;
+
+	bool ShouldClose() const;
+	void SetShouldClose();
+	void PollEvents();
+	void SwapBuffers();
+	//seconds, counts frames when headless
+	double Time() const;
+	void GetFramebufferSize(int& width, int& height) const;
+
+	//the default framebuffer as a binary .ppm
+	bool SaveFrame(const std::string& path) const;
+
+private:
+	Settings settings;
+	bool valid = false;
+	GLFWwindow* window = nullptr;
+
+	int frame = 0;
+	bool closeRequested = false;
+	GLuint offscreenFBO = 0;
+	GLuint offscreenColor = 0;
+	GLuint offscreenDepth = 0;
+
+#ifdef GLCONTEXT_HAS_EGL
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+	EGLContext eglContext = EGL_NO_CONTEXT;
+	EGLSurface eglSurface = EGL_NO_SURFACE;
+#endif
+
+private:
+	bool createWindow();
+	bool createHeadless();
+	void createOffscreenTarget();
+};
+
+inline GLContext::Settings GLContext::ParseArgs(int argc, char** argv, const Settings& defaults)
+{
+	Settings result = defaults;
+	const char* env = std::getenv("GIANT_HEADLESS");
+	if (env && *env)
+	{
+		result.backend = Backend::HEADLESS;
+		result.headlessFrames = std::max(std::atoi(env), 1);
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+		{
+			result.backend = Backend::HEADLESS;
+		}
+		else if (arg.compare(0, 11, "--headless=") == 0)
+		{
+			result.backend = Backend::HEADLESS;
+			result.headlessFrames = std::max(std::atoi(arg.c_str() + 11), 1);
+		}
+		else if (arg.compare(0, 10, "--capture=") == 0)
+		{
+			result.captureFile = arg.substr(10);
+		}
+	}
+	return result;
+}
+
+inline GLContext::GLContext(const Settings& contextSettings)
+	:settings(contextSettings)
+{
+	valid = Headless() ? createHeadless() : createWindow();
+}
+
+inline GLContext::~GLContext()
+{
+	if (Headless())
+	{
+#ifdef GLCONTEXT_HAS_EGL
+		if (offscreenFBO)
+		{
+			GLStateCache& state = GLStateCache::Get();
+			state.SetDefaultFramebuffer(0);
+			state.DeleteFramebuffer(offscreenFBO);
+			state.DeleteRenderbuffer(offscreenColor);
+			state.DeleteRenderbuffer(offscreenDepth);
+		}
+		if (eglDisplay != EGL_NO_DISPLAY)
+		{
+			eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (eglSurface != EGL_NO_SURFACE)
+				eglDestroySurface(eglDisplay, eglSurface);
+			if (eglContext != EGL_NO_CONTEXT)
+				eglDestroyContext(eglDisplay, eglContext);
+			eglTerminate(eglDisplay);
+		}
+#endif
+	}
+	else
+	{
+		glfwTerminate();
+	}
+}
+
+inline bool GLContext::createWindow()
+{
+	glfwInit();
+
+	//the version the demo asked for first, every demo still runs on 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, settings.majorVersion);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, settings.minorVersion);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	window = glfwCreateWindow(settings.width, settings.height, settings.title.c_str(), nullptr, nullptr);
+	if (!window)
+	{
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		window = glfwCreateWindow(settings.width, settings.height, settings.title.c_str(), nullptr, nullptr);
+	}
+	if (!window)
+	{
+		std::cout << "Failed to create glfw window" << std::endl;
+		return false;
+	}
+
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "Failed to init glad" << std::endl;
+		return false;
+	}
+
+	glfwSetFramebufferSizeCallback(window,
+		[](GLFWwindow* /*window*/, int width, int height)
+	{
+		GLStateCache::Get().Viewport(0, 0, width, height);
+	});
+	return true;
+}
+
+inline bool GLContext::createHeadless()
+{
+#ifdef GLCONTEXT_HAS_EGL
+	//surfaceless needs no display server at all, the default display may still want one
+	bool surfaceless = false;
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay && clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+	{
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		surfaceless = eglDisplay != EGL_NO_DISPLAY;
+	}
+	if (eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major, minor;
+	if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+	{
+		std::cout << "Error: no EGL display for headless rendering" << std::endl;
+		return false;
+	}
+	const char* displayExtensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+	if (surfaceless && !(displayExtensions && std::strstr(displayExtensions, "EGL_KHR_surfaceless_context")))
+		surfaceless = false;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cout << "Error: EGL display has no desktop GL" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configNum = 0;
+	if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configNum) || configNum == 0)
+	{
+		std::cout << "Error: no matching EGL config" << std::endl;
+		return false;
+	}
+
+	const EGLint versions[2][2] = { { settings.majorVersion, settings.minorVersion }, { 3, 3 } };
+	for (const EGLint* version : versions)
+	{
+		const EGLint contextAttribs[] = {
+			EGL_CONTEXT_MAJOR_VERSION, version[0],
+			EGL_CONTEXT_MINOR_VERSION, version[1],
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+		if (eglContext != EGL_NO_CONTEXT)
+			break;
+	}
+	if (eglContext == EGL_NO_CONTEXT)
+	{
+		std::cout << "Error: failed to create an EGL context" << std::endl;
+		return false;
+	}
+
+	if (!surfaceless)
+	{
+		const EGLint pbufferAttribs[] = { EGL_WIDTH, settings.width, EGL_HEIGHT, settings.height, EGL_NONE };
+		eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+	}
+	if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext))
+	{
+		std::cout << "Error: failed to make the EGL context current" << std::endl;
+		return false;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+	{
+		std::cout << "Failed to init glad" << std::endl;
+		return false;
+	}
+
+	createOffscreenTarget();
+	std::cout << "GLContext: headless " << (surfaceless ? "surfaceless" : "pbuffer") << " EGL " << major << "." << minor
+		<< ", " << glGetString(GL_RENDERER) << std::endl;
+	return true;
+#else
+	std::cout << "Error: headless rendering needs EGL, only Linux builds have it" << std::endl;
+	return false;
+#endif
+}
+
+inline void GLContext::createOffscreenTarget()
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	glGenRenderbuffers(1, &offscreenColor);
+	state.BindRenderbuffer(offscreenColor);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, settings.width, settings.height);
+	glGenRenderbuffers(1, &offscreenDepth);
+	state.BindRenderbuffer(offscreenDepth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, settings.width, settings.height);
+
+	glGenFramebuffers(1, &offscreenFBO);
+	state.BindFramebuffer(GL_FRAMEBUFFER, offscreenFBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColor);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: headless framebuffer is not complete" << std::endl;
+
+	state.SetDefaultFramebuffer(offscreenFBO);
+	state.Viewport(0, 0, settings.width, settings.height);
+}
+
+inline bool GLContext::ShouldClose() const
+{
+	if (Headless())
+		return closeRequested || frame >= settings.headlessFrames;
+	return glfwWindowShouldClose(window) != 0;
+}
+
+inline void GLContext::SetShouldClose()
+{
+	closeRequested = true;
+	if (window)
+		glfwSetWindowShouldClose(window, true);
+}
+
+inline void GLContext::PollEvents()
+{
+	if (window)
+		glfwPollEvents();
+}
+
+inline void GLContext::SwapBuffers()
+{
+	if (window)
+	{
+		glfwSwapBuffers(window);
+		return;
+	}
+
+	++frame;
+	if (frame == settings.headlessFrames && !settings.captureFile.empty())
+		SaveFrame(settings.captureFile);
+}
+
+inline GLADloadproc GLContext::ProcAddress() const
+{
+#ifdef GLCONTEXT_HAS_EGL
+	if (Headless())
+		return (GLADloadproc)eglGetProcAddress;
+#endif
+	return (GLADloadproc)glfwGetProcAddress;
+}
+
+inline double GLContext::Time() const
+{
+	return window ? glfwGetTime() : frame / 60.0;
+}
+
+inline void GLContext::GetFramebufferSize(int& width, int& height) const
+{
+	if (window)
+	{
+		glfwGetFramebufferSize(window, &width, &height);
+		return;
+	}
+	width = settings.width;
+	height = settings.height;
+}
+
+inline bool GLContext::SaveFrame(const std::string& path) const
+{
+	int width, height;
+	GetFramebufferSize(width, height);
+	std::vector<unsigned char> pixels(width * height * 3);
+
+	GLStateCache::Get().BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Error: failed to write frame " << path << std::endl;
+		return false;
+	}
+
+	//ppm rows go top down, GL rows bottom up
+	file << "P6\n" << width << " " << height << "\n255\n";
+	for (int y = height - 1; y >= 0; --y)
+		file.write((const char*)&pixels[y * width * 3], width * 3);
+	std::cout << "GLContext: wrote " << path << std::endl;
+	return true;
+}
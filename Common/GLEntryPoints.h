@@ -0,0 +1,704 @@
+//Every entry point glad loads (core GL 1.0 to 4.6), one GL_ENTRY_POINT(name) per line for X-macro use:
+//define GL_ENTRY_POINT, include this file, undefine it again. No include guard on purpose.
+//Keep in step with glad/glad.h when glad is regenerated, the names are the ones
+//	grep -o "^GLAPI PFN[A-Z0-9_]*PROC glad_gl[A-Za-z0-9_]*" glad/glad.h
+
+GL_ENTRY_POINT(glCullFace)
+GL_ENTRY_POINT(glFrontFace)
+GL_ENTRY_POINT(glHint)
+GL_ENTRY_POINT(glLineWidth)
+GL_ENTRY_POINT(glPointSize)
+GL_ENTRY_POINT(glPolygonMode)
+GL_ENTRY_POINT(glScissor)
+GL_ENTRY_POINT(glTexParameterf)
+GL_ENTRY_POINT(glTexParameterfv)
+GL_ENTRY_POINT(glTexParameteri)
+GL_ENTRY_POINT(glTexParameteriv)
+GL_ENTRY_POINT(glTexImage1D)
+GL_ENTRY_POINT(glTexImage2D)
+GL_ENTRY_POINT(glDrawBuffer)
+GL_ENTRY_POINT(glClear)
+GL_ENTRY_POINT(glClearColor)
+GL_ENTRY_POINT(glClearStencil)
+GL_ENTRY_POINT(glClearDepth)
+GL_ENTRY_POINT(glStencilMask)
+GL_ENTRY_POINT(glColorMask)
+GL_ENTRY_POINT(glDepthMask)
+GL_ENTRY_POINT(glDisable)
+GL_ENTRY_POINT(glEnable)
+GL_ENTRY_POINT(glFinish)
+GL_ENTRY_POINT(glFlush)
+GL_ENTRY_POINT(glBlendFunc)
+GL_ENTRY_POINT(glLogicOp)
+GL_ENTRY_POINT(glStencilFunc)
+GL_ENTRY_POINT(glStencilOp)
+GL_ENTRY_POINT(glDepthFunc)
+GL_ENTRY_POINT(glPixelStoref)
+GL_ENTRY_POINT(glPixelStorei)
+GL_ENTRY_POINT(glReadBuffer)
+GL_ENTRY_POINT(glReadPixels)
+GL_ENTRY_POINT(glGetBooleanv)
+GL_ENTRY_POINT(glGetDoublev)
+GL_ENTRY_POINT(glGetError)
+GL_ENTRY_POINT(glGetFloatv)
+GL_ENTRY_POINT(glGetIntegerv)
+GL_ENTRY_POINT(glGetString)
+GL_ENTRY_POINT(glGetTexImage)
+GL_ENTRY_POINT(glGetTexParameterfv)
+GL_ENTRY_POINT(glGetTexParameteriv)
+GL_ENTRY_POINT(glGetTexLevelParameterfv)
+GL_ENTRY_POINT(glGetTexLevelParameteriv)
+GL_ENTRY_POINT(glIsEnabled)
+GL_ENTRY_POINT(glDepthRange)
+GL_ENTRY_POINT(glViewport)
+GL_ENTRY_POINT(glDrawArrays)
+GL_ENTRY_POINT(glDrawElements)
+GL_ENTRY_POINT(glPolygonOffset)
+GL_ENTRY_POINT(glCopyTexImage1D)
+GL_ENTRY_POINT(glCopyTexImage2D)
+GL_ENTRY_POINT(glCopyTexSubImage1D)
+GL_ENTRY_POINT(glCopyTexSubImage2D)
+GL_ENTRY_POINT(glTexSubImage1D)
+GL_ENTRY_POINT(glTexSubImage2D)
+GL_ENTRY_POINT(glBindTexture)
+GL_ENTRY_POINT(glDeleteTextures)
+GL_ENTRY_POINT(glGenTextures)
+GL_ENTRY_POINT(glIsTexture)
+GL_ENTRY_POINT(glDrawRangeElements)
+GL_ENTRY_POINT(glTexImage3D)
+GL_ENTRY_POINT(glTexSubImage3D)
+GL_ENTRY_POINT(glCopyTexSubImage3D)
+GL_ENTRY_POINT(glActiveTexture)
+GL_ENTRY_POINT(glSampleCoverage)
+GL_ENTRY_POINT(glCompressedTexImage3D)
+GL_ENTRY_POINT(glCompressedTexImage2D)
+GL_ENTRY_POINT(glCompressedTexImage1D)
+GL_ENTRY_POINT(glCompressedTexSubImage3D)
+GL_ENTRY_POINT(glCompressedTexSubImage2D)
+GL_ENTRY_POINT(glCompressedTexSubImage1D)
+GL_ENTRY_POINT(glGetCompressedTexImage)
+GL_ENTRY_POINT(glBlendFuncSeparate)
+GL_ENTRY_POINT(glMultiDrawArrays)
+GL_ENTRY_POINT(glMultiDrawElements)
+GL_ENTRY_POINT(glPointParameterf)
+GL_ENTRY_POINT(glPointParameterfv)
+GL_ENTRY_POINT(glPointParameteri)
+GL_ENTRY_POINT(glPointParameteriv)
+GL_ENTRY_POINT(glBlendColor)
+GL_ENTRY_POINT(glBlendEquation)
+GL_ENTRY_POINT(glGenQueries)
+GL_ENTRY_POINT(glDeleteQueries)
+GL_ENTRY_POINT(glIsQuery)
+GL_ENTRY_POINT(glBeginQuery)
+GL_ENTRY_POINT(glEndQuery)
+GL_ENTRY_POINT(glGetQueryiv)
+GL_ENTRY_POINT(glGetQueryObjectiv)
+GL_ENTRY_POINT(glGetQueryObjectuiv)
+GL_ENTRY_POINT(glBindBuffer)
+GL_ENTRY_POINT(glDeleteBuffers)
+GL_ENTRY_POINT(glGenBuffers)
+GL_ENTRY_POINT(glIsBuffer)
+GL_ENTRY_POINT(glBufferData)
+GL_ENTRY_POINT(glBufferSubData)
+GL_ENTRY_POINT(glGetBufferSubData)
+GL_ENTRY_POINT(glMapBuffer)
+GL_ENTRY_POINT(glUnmapBuffer)
+GL_ENTRY_POINT(glGetBufferParameteriv)
+GL_ENTRY_POINT(glGetBufferPointerv)
+GL_ENTRY_POINT(glBlendEquationSeparate)
+GL_ENTRY_POINT(glDrawBuffers)
+GL_ENTRY_POINT(glStencilOpSeparate)
+GL_ENTRY_POINT(glStencilFuncSeparate)
+GL_ENTRY_POINT(glStencilMaskSeparate)
+GL_ENTRY_POINT(glAttachShader)
+GL_ENTRY_POINT(glBindAttribLocation)
+GL_ENTRY_POINT(glCompileShader)
+GL_ENTRY_POINT(glCreateProgram)
+GL_ENTRY_POINT(glCreateShader)
+GL_ENTRY_POINT(glDeleteProgram)
+GL_ENTRY_POINT(glDeleteShader)
+GL_ENTRY_POINT(glDetachShader)
+GL_ENTRY_POINT(glDisableVertexAttribArray)
+GL_ENTRY_POINT(glEnableVertexAttribArray)
+GL_ENTRY_POINT(glGetActiveAttrib)
+GL_ENTRY_POINT(glGetActiveUniform)
+GL_ENTRY_POINT(glGetAttachedShaders)
+GL_ENTRY_POINT(glGetAttribLocation)
+GL_ENTRY_POINT(glGetProgramiv)
+GL_ENTRY_POINT(glGetProgramInfoLog)
+GL_ENTRY_POINT(glGetShaderiv)
+GL_ENTRY_POINT(glGetShaderInfoLog)
+GL_ENTRY_POINT(glGetShaderSource)
+GL_ENTRY_POINT(glGetUniformLocation)
+GL_ENTRY_POINT(glGetUniformfv)
+GL_ENTRY_POINT(glGetUniformiv)
+GL_ENTRY_POINT(glGetVertexAttribdv)
+GL_ENTRY_POINT(glGetVertexAttribfv)
+GL_ENTRY_POINT(glGetVertexAttribiv)
+GL_ENTRY_POINT(glGetVertexAttribPointerv)
+GL_ENTRY_POINT(glIsProgram)
+GL_ENTRY_POINT(glIsShader)
+GL_ENTRY_POINT(glLinkProgram)
+GL_ENTRY_POINT(glShaderSource)
+GL_ENTRY_POINT(glUseProgram)
+GL_ENTRY_POINT(glUniform1f)
+GL_ENTRY_POINT(glUniform2f)
+GL_ENTRY_POINT(glUniform3f)
+GL_ENTRY_POINT(glUniform4f)
+GL_ENTRY_POINT(glUniform1i)
+GL_ENTRY_POINT(glUniform2i)
+GL_ENTRY_POINT(glUniform3i)
+GL_ENTRY_POINT(glUniform4i)
+GL_ENTRY_POINT(glUniform1fv)
+GL_ENTRY_POINT(glUniform2fv)
+GL_ENTRY_POINT(glUniform3fv)
+GL_ENTRY_POINT(glUniform4fv)
+GL_ENTRY_POINT(glUniform1iv)
+GL_ENTRY_POINT(glUniform2iv)
+GL_ENTRY_POINT(glUniform3iv)
+GL_ENTRY_POINT(glUniform4iv)
+GL_ENTRY_POINT(glUniformMatrix2fv)
+GL_ENTRY_POINT(glUniformMatrix3fv)
+GL_ENTRY_POINT(glUniformMatrix4fv)
+GL_ENTRY_POINT(glValidateProgram)
+GL_ENTRY_POINT(glVertexAttrib1d)
+GL_ENTRY_POINT(glVertexAttrib1dv)
+GL_ENTRY_POINT(glVertexAttrib1f)
+GL_ENTRY_POINT(glVertexAttrib1fv)
+GL_ENTRY_POINT(glVertexAttrib1s)
+GL_ENTRY_POINT(glVertexAttrib1sv)
+GL_ENTRY_POINT(glVertexAttrib2d)
+GL_ENTRY_POINT(glVertexAttrib2dv)
+GL_ENTRY_POINT(glVertexAttrib2f)
+GL_ENTRY_POINT(glVertexAttrib2fv)
+GL_ENTRY_POINT(glVertexAttrib2s)
+GL_ENTRY_POINT(glVertexAttrib2sv)
+GL_ENTRY_POINT(glVertexAttrib3d)
+GL_ENTRY_POINT(glVertexAttrib3dv)
+GL_ENTRY_POINT(glVertexAttrib3f)
+GL_ENTRY_POINT(glVertexAttrib3fv)
+GL_ENTRY_POINT(glVertexAttrib3s)
+GL_ENTRY_POINT(glVertexAttrib3sv)
+GL_ENTRY_POINT(glVertexAttrib4Nbv)
+GL_ENTRY_POINT(glVertexAttrib4Niv)
+GL_ENTRY_POINT(glVertexAttrib4Nsv)
+GL_ENTRY_POINT(glVertexAttrib4Nub)
+GL_ENTRY_POINT(glVertexAttrib4Nubv)
+GL_ENTRY_POINT(glVertexAttrib4Nuiv)
+GL_ENTRY_POINT(glVertexAttrib4Nusv)
+GL_ENTRY_POINT(glVertexAttrib4bv)
+GL_ENTRY_POINT(glVertexAttrib4d)
+GL_ENTRY_POINT(glVertexAttrib4dv)
+GL_ENTRY_POINT(glVertexAttrib4f)
+GL_ENTRY_POINT(glVertexAttrib4fv)
+GL_ENTRY_POINT(glVertexAttrib4iv)
+GL_ENTRY_POINT(glVertexAttrib4s)
+GL_ENTRY_POINT(glVertexAttrib4sv)
+GL_ENTRY_POINT(glVertexAttrib4ubv)
+GL_ENTRY_POINT(glVertexAttrib4uiv)
+GL_ENTRY_POINT(glVertexAttrib4usv)
+GL_ENTRY_POINT(glVertexAttribPointer)
+GL_ENTRY_POINT(glUniformMatrix2x3fv)
+GL_ENTRY_POINT(glUniformMatrix3x2fv)
+GL_ENTRY_POINT(glUniformMatrix2x4fv)
+GL_ENTRY_POINT(glUniformMatrix4x2fv)
+GL_ENTRY_POINT(glUniformMatrix3x4fv)
+GL_ENTRY_POINT(glUniformMatrix4x3fv)
+GL_ENTRY_POINT(glColorMaski)
+GL_ENTRY_POINT(glGetBooleani_v)
+GL_ENTRY_POINT(glGetIntegeri_v)
+GL_ENTRY_POINT(glEnablei)
+GL_ENTRY_POINT(glDisablei)
+GL_ENTRY_POINT(glIsEnabledi)
+GL_ENTRY_POINT(glBeginTransformFeedback)
+GL_ENTRY_POINT(glEndTransformFeedback)
+GL_ENTRY_POINT(glBindBufferRange)
+GL_ENTRY_POINT(glBindBufferBase)
+GL_ENTRY_POINT(glTransformFeedbackVaryings)
+GL_ENTRY_POINT(glGetTransformFeedbackVarying)
+GL_ENTRY_POINT(glClampColor)
+GL_ENTRY_POINT(glBeginConditionalRender)
+GL_ENTRY_POINT(glEndConditionalRender)
+GL_ENTRY_POINT(glVertexAttribIPointer)
+GL_ENTRY_POINT(glGetVertexAttribIiv)
+GL_ENTRY_POINT(glGetVertexAttribIuiv)
+GL_ENTRY_POINT(glVertexAttribI1i)
+GL_ENTRY_POINT(glVertexAttribI2i)
+GL_ENTRY_POINT(glVertexAttribI3i)
+GL_ENTRY_POINT(glVertexAttribI4i)
+GL_ENTRY_POINT(glVertexAttribI1ui)
+GL_ENTRY_POINT(glVertexAttribI2ui)
+GL_ENTRY_POINT(glVertexAttribI3ui)
+GL_ENTRY_POINT(glVertexAttribI4ui)
+GL_ENTRY_POINT(glVertexAttribI1iv)
+GL_ENTRY_POINT(glVertexAttribI2iv)
+GL_ENTRY_POINT(glVertexAttribI3iv)
+GL_ENTRY_POINT(glVertexAttribI4iv)
+GL_ENTRY_POINT(glVertexAttribI1uiv)
+GL_ENTRY_POINT(glVertexAttribI2uiv)
+GL_ENTRY_POINT(glVertexAttribI3uiv)
+GL_ENTRY_POINT(glVertexAttribI4uiv)
+GL_ENTRY_POINT(glVertexAttribI4bv)
+GL_ENTRY_POINT(glVertexAttribI4sv)
+GL_ENTRY_POINT(glVertexAttribI4ubv)
+GL_ENTRY_POINT(glVertexAttribI4usv)
+GL_ENTRY_POINT(glGetUniformuiv)
+GL_ENTRY_POINT(glBindFragDataLocation)
+GL_ENTRY_POINT(glGetFragDataLocation)
+GL_ENTRY_POINT(glUniform1ui)
+GL_ENTRY_POINT(glUniform2ui)
+GL_ENTRY_POINT(glUniform3ui)
+GL_ENTRY_POINT(glUniform4ui)
+GL_ENTRY_POINT(glUniform1uiv)
+GL_ENTRY_POINT(glUniform2uiv)
+GL_ENTRY_POINT(glUniform3uiv)
+GL_ENTRY_POINT(glUniform4uiv)
+GL_ENTRY_POINT(glTexParameterIiv)
+GL_ENTRY_POINT(glTexParameterIuiv)
+GL_ENTRY_POINT(glGetTexParameterIiv)
+GL_ENTRY_POINT(glGetTexParameterIuiv)
+GL_ENTRY_POINT(glClearBufferiv)
+GL_ENTRY_POINT(glClearBufferuiv)
+GL_ENTRY_POINT(glClearBufferfv)
+GL_ENTRY_POINT(glClearBufferfi)
+GL_ENTRY_POINT(glGetStringi)
+GL_ENTRY_POINT(glIsRenderbuffer)
+GL_ENTRY_POINT(glBindRenderbuffer)
+GL_ENTRY_POINT(glDeleteRenderbuffers)
+GL_ENTRY_POINT(glGenRenderbuffers)
+GL_ENTRY_POINT(glRenderbufferStorage)
+GL_ENTRY_POINT(glGetRenderbufferParameteriv)
+GL_ENTRY_POINT(glIsFramebuffer)
+GL_ENTRY_POINT(glBindFramebuffer)
+GL_ENTRY_POINT(glDeleteFramebuffers)
+GL_ENTRY_POINT(glGenFramebuffers)
+GL_ENTRY_POINT(glCheckFramebufferStatus)
+GL_ENTRY_POINT(glFramebufferTexture1D)
+GL_ENTRY_POINT(glFramebufferTexture2D)
+GL_ENTRY_POINT(glFramebufferTexture3D)
+GL_ENTRY_POINT(glFramebufferRenderbuffer)
+GL_ENTRY_POINT(glGetFramebufferAttachmentParameteriv)
+GL_ENTRY_POINT(glGenerateMipmap)
+GL_ENTRY_POINT(glBlitFramebuffer)
+GL_ENTRY_POINT(glRenderbufferStorageMultisample)
+GL_ENTRY_POINT(glFramebufferTextureLayer)
+GL_ENTRY_POINT(glMapBufferRange)
+GL_ENTRY_POINT(glFlushMappedBufferRange)
+GL_ENTRY_POINT(glBindVertexArray)
+GL_ENTRY_POINT(glDeleteVertexArrays)
+GL_ENTRY_POINT(glGenVertexArrays)
+GL_ENTRY_POINT(glIsVertexArray)
+GL_ENTRY_POINT(glDrawArraysInstanced)
+GL_ENTRY_POINT(glDrawElementsInstanced)
+GL_ENTRY_POINT(glTexBuffer)
+GL_ENTRY_POINT(glPrimitiveRestartIndex)
+GL_ENTRY_POINT(glCopyBufferSubData)
+GL_ENTRY_POINT(glGetUniformIndices)
+GL_ENTRY_POINT(glGetActiveUniformsiv)
+GL_ENTRY_POINT(glGetActiveUniformName)
+GL_ENTRY_POINT(glGetUniformBlockIndex)
+GL_ENTRY_POINT(glGetActiveUniformBlockiv)
+GL_ENTRY_POINT(glGetActiveUniformBlockName)
+GL_ENTRY_POINT(glUniformBlockBinding)
+GL_ENTRY_POINT(glDrawElementsBaseVertex)
+GL_ENTRY_POINT(glDrawRangeElementsBaseVertex)
+GL_ENTRY_POINT(glDrawElementsInstancedBaseVertex)
+GL_ENTRY_POINT(glMultiDrawElementsBaseVertex)
+GL_ENTRY_POINT(glProvokingVertex)
+GL_ENTRY_POINT(glFenceSync)
+GL_ENTRY_POINT(glIsSync)
+GL_ENTRY_POINT(glDeleteSync)
+GL_ENTRY_POINT(glClientWaitSync)
+GL_ENTRY_POINT(glWaitSync)
+GL_ENTRY_POINT(glGetInteger64v)
+GL_ENTRY_POINT(glGetSynciv)
+GL_ENTRY_POINT(glGetInteger64i_v)
+GL_ENTRY_POINT(glGetBufferParameteri64v)
+GL_ENTRY_POINT(glFramebufferTexture)
+GL_ENTRY_POINT(glTexImage2DMultisample)
+GL_ENTRY_POINT(glTexImage3DMultisample)
+GL_ENTRY_POINT(glGetMultisamplefv)
+GL_ENTRY_POINT(glSampleMaski)
+GL_ENTRY_POINT(glBindFragDataLocationIndexed)
+GL_ENTRY_POINT(glGetFragDataIndex)
+GL_ENTRY_POINT(glGenSamplers)
+GL_ENTRY_POINT(glDeleteSamplers)
+GL_ENTRY_POINT(glIsSampler)
+GL_ENTRY_POINT(glBindSampler)
+GL_ENTRY_POINT(glSamplerParameteri)
+GL_ENTRY_POINT(glSamplerParameteriv)
+GL_ENTRY_POINT(glSamplerParameterf)
+GL_ENTRY_POINT(glSamplerParameterfv)
+GL_ENTRY_POINT(glSamplerParameterIiv)
+GL_ENTRY_POINT(glSamplerParameterIuiv)
+GL_ENTRY_POINT(glGetSamplerParameteriv)
+GL_ENTRY_POINT(glGetSamplerParameterIiv)
+GL_ENTRY_POINT(glGetSamplerParameterfv)
+GL_ENTRY_POINT(glGetSamplerParameterIuiv)
+GL_ENTRY_POINT(glQueryCounter)
+GL_ENTRY_POINT(glGetQueryObjecti64v)
+GL_ENTRY_POINT(glGetQueryObjectui64v)
+GL_ENTRY_POINT(glVertexAttribDivisor)
+GL_ENTRY_POINT(glVertexAttribP1ui)
+GL_ENTRY_POINT(glVertexAttribP1uiv)
+GL_ENTRY_POINT(glVertexAttribP2ui)
+GL_ENTRY_POINT(glVertexAttribP2uiv)
+GL_ENTRY_POINT(glVertexAttribP3ui)
+GL_ENTRY_POINT(glVertexAttribP3uiv)
+GL_ENTRY_POINT(glVertexAttribP4ui)
+GL_ENTRY_POINT(glVertexAttribP4uiv)
+GL_ENTRY_POINT(glVertexP2ui)
+GL_ENTRY_POINT(glVertexP2uiv)
+GL_ENTRY_POINT(glVertexP3ui)
+GL_ENTRY_POINT(glVertexP3uiv)
+GL_ENTRY_POINT(glVertexP4ui)
+GL_ENTRY_POINT(glVertexP4uiv)
+GL_ENTRY_POINT(glTexCoordP1ui)
+GL_ENTRY_POINT(glTexCoordP1uiv)
+GL_ENTRY_POINT(glTexCoordP2ui)
+GL_ENTRY_POINT(glTexCoordP2uiv)
+GL_ENTRY_POINT(glTexCoordP3ui)
+GL_ENTRY_POINT(glTexCoordP3uiv)
+GL_ENTRY_POINT(glTexCoordP4ui)
+GL_ENTRY_POINT(glTexCoordP4uiv)
+GL_ENTRY_POINT(glMultiTexCoordP1ui)
+GL_ENTRY_POINT(glMultiTexCoordP1uiv)
+GL_ENTRY_POINT(glMultiTexCoordP2ui)
+GL_ENTRY_POINT(glMultiTexCoordP2uiv)
+GL_ENTRY_POINT(glMultiTexCoordP3ui)
+GL_ENTRY_POINT(glMultiTexCoordP3uiv)
+GL_ENTRY_POINT(glMultiTexCoordP4ui)
+GL_ENTRY_POINT(glMultiTexCoordP4uiv)
+GL_ENTRY_POINT(glNormalP3ui)
+GL_ENTRY_POINT(glNormalP3uiv)
+GL_ENTRY_POINT(glColorP3ui)
+GL_ENTRY_POINT(glColorP3uiv)
+GL_ENTRY_POINT(glColorP4ui)
+GL_ENTRY_POINT(glColorP4uiv)
+GL_ENTRY_POINT(glSecondaryColorP3ui)
+GL_ENTRY_POINT(glSecondaryColorP3uiv)
+GL_ENTRY_POINT(glMinSampleShading)
+GL_ENTRY_POINT(glBlendEquationi)
+GL_ENTRY_POINT(glBlendEquationSeparatei)
+GL_ENTRY_POINT(glBlendFunci)
+GL_ENTRY_POINT(glBlendFuncSeparatei)
+GL_ENTRY_POINT(glDrawArraysIndirect)
+GL_ENTRY_POINT(glDrawElementsIndirect)
+GL_ENTRY_POINT(glUniform1d)
+GL_ENTRY_POINT(glUniform2d)
+GL_ENTRY_POINT(glUniform3d)
+GL_ENTRY_POINT(glUniform4d)
+GL_ENTRY_POINT(glUniform1dv)
+GL_ENTRY_POINT(glUniform2dv)
+GL_ENTRY_POINT(glUniform3dv)
+GL_ENTRY_POINT(glUniform4dv)
+GL_ENTRY_POINT(glUniformMatrix2dv)
+GL_ENTRY_POINT(glUniformMatrix3dv)
+GL_ENTRY_POINT(glUniformMatrix4dv)
+GL_ENTRY_POINT(glUniformMatrix2x3dv)
+GL_ENTRY_POINT(glUniformMatrix2x4dv)
+GL_ENTRY_POINT(glUniformMatrix3x2dv)
+GL_ENTRY_POINT(glUniformMatrix3x4dv)
+GL_ENTRY_POINT(glUniformMatrix4x2dv)
+GL_ENTRY_POINT(glUniformMatrix4x3dv)
+GL_ENTRY_POINT(glGetUniformdv)
+GL_ENTRY_POINT(glGetSubroutineUniformLocation)
+GL_ENTRY_POINT(glGetSubroutineIndex)
+GL_ENTRY_POINT(glGetActiveSubroutineUniformiv)
+GL_ENTRY_POINT(glGetActiveSubroutineUniformName)
+GL_ENTRY_POINT(glGetActiveSubroutineName)
+GL_ENTRY_POINT(glUniformSubroutinesuiv)
+GL_ENTRY_POINT(glGetUniformSubroutineuiv)
+GL_ENTRY_POINT(glGetProgramStageiv)
+GL_ENTRY_POINT(glPatchParameteri)
+GL_ENTRY_POINT(glPatchParameterfv)
+GL_ENTRY_POINT(glBindTransformFeedback)
+GL_ENTRY_POINT(glDeleteTransformFeedbacks)
+GL_ENTRY_POINT(glGenTransformFeedbacks)
+GL_ENTRY_POINT(glIsTransformFeedback)
+GL_ENTRY_POINT(glPauseTransformFeedback)
+GL_ENTRY_POINT(glResumeTransformFeedback)
+GL_ENTRY_POINT(glDrawTransformFeedback)
+GL_ENTRY_POINT(glDrawTransformFeedbackStream)
+GL_ENTRY_POINT(glBeginQueryIndexed)
+GL_ENTRY_POINT(glEndQueryIndexed)
+GL_ENTRY_POINT(glGetQueryIndexediv)
+GL_ENTRY_POINT(glReleaseShaderCompiler)
+GL_ENTRY_POINT(glShaderBinary)
+GL_ENTRY_POINT(glGetShaderPrecisionFormat)
+GL_ENTRY_POINT(glDepthRangef)
+GL_ENTRY_POINT(glClearDepthf)
+GL_ENTRY_POINT(glGetProgramBinary)
+GL_ENTRY_POINT(glProgramBinary)
+GL_ENTRY_POINT(glProgramParameteri)
+GL_ENTRY_POINT(glUseProgramStages)
+GL_ENTRY_POINT(glActiveShaderProgram)
+GL_ENTRY_POINT(glCreateShaderProgramv)
+GL_ENTRY_POINT(glBindProgramPipeline)
+GL_ENTRY_POINT(glDeleteProgramPipelines)
+GL_ENTRY_POINT(glGenProgramPipelines)
+GL_ENTRY_POINT(glIsProgramPipeline)
+GL_ENTRY_POINT(glGetProgramPipelineiv)
+GL_ENTRY_POINT(glProgramUniform1i)
+GL_ENTRY_POINT(glProgramUniform1iv)
+GL_ENTRY_POINT(glProgramUniform1f)
+GL_ENTRY_POINT(glProgramUniform1fv)
+GL_ENTRY_POINT(glProgramUniform1d)
+GL_ENTRY_POINT(glProgramUniform1dv)
+GL_ENTRY_POINT(glProgramUniform1ui)
+GL_ENTRY_POINT(glProgramUniform1uiv)
+GL_ENTRY_POINT(glProgramUniform2i)
+GL_ENTRY_POINT(glProgramUniform2iv)
+GL_ENTRY_POINT(glProgramUniform2f)
+GL_ENTRY_POINT(glProgramUniform2fv)
+GL_ENTRY_POINT(glProgramUniform2d)
+GL_ENTRY_POINT(glProgramUniform2dv)
+GL_ENTRY_POINT(glProgramUniform2ui)
+GL_ENTRY_POINT(glProgramUniform2uiv)
+GL_ENTRY_POINT(glProgramUniform3i)
+GL_ENTRY_POINT(glProgramUniform3iv)
+GL_ENTRY_POINT(glProgramUniform3f)
+GL_ENTRY_POINT(glProgramUniform3fv)
+GL_ENTRY_POINT(glProgramUniform3d)
+GL_ENTRY_POINT(glProgramUniform3dv)
+GL_ENTRY_POINT(glProgramUniform3ui)
+GL_ENTRY_POINT(glProgramUniform3uiv)
+GL_ENTRY_POINT(glProgramUniform4i)
+GL_ENTRY_POINT(glProgramUniform4iv)
+GL_ENTRY_POINT(glProgramUniform4f)
+GL_ENTRY_POINT(glProgramUniform4fv)
+GL_ENTRY_POINT(glProgramUniform4d)
+GL_ENTRY_POINT(glProgramUniform4dv)
+GL_ENTRY_POINT(glProgramUniform4ui)
+GL_ENTRY_POINT(glProgramUniform4uiv)
+GL_ENTRY_POINT(glProgramUniformMatrix2fv)
+GL_ENTRY_POINT(glProgramUniformMatrix3fv)
+GL_ENTRY_POINT(glProgramUniformMatrix4fv)
+GL_ENTRY_POINT(glProgramUniformMatrix2dv)
+GL_ENTRY_POINT(glProgramUniformMatrix3dv)
+GL_ENTRY_POINT(glProgramUniformMatrix4dv)
+GL_ENTRY_POINT(glProgramUniformMatrix2x3fv)
+GL_ENTRY_POINT(glProgramUniformMatrix3x2fv)
+GL_ENTRY_POINT(glProgramUniformMatrix2x4fv)
+GL_ENTRY_POINT(glProgramUniformMatrix4x2fv)
+GL_ENTRY_POINT(glProgramUniformMatrix3x4fv)
+GL_ENTRY_POINT(glProgramUniformMatrix4x3fv)
+GL_ENTRY_POINT(glProgramUniformMatrix2x3dv)
+GL_ENTRY_POINT(glProgramUniformMatrix3x2dv)
+GL_ENTRY_POINT(glProgramUniformMatrix2x4dv)
+GL_ENTRY_POINT(glProgramUniformMatrix4x2dv)
+GL_ENTRY_POINT(glProgramUniformMatrix3x4dv)
+GL_ENTRY_POINT(glProgramUniformMatrix4x3dv)
+GL_ENTRY_POINT(glValidateProgramPipeline)
+GL_ENTRY_POINT(glGetProgramPipelineInfoLog)
+GL_ENTRY_POINT(glVertexAttribL1d)
+GL_ENTRY_POINT(glVertexAttribL2d)
+GL_ENTRY_POINT(glVertexAttribL3d)
+GL_ENTRY_POINT(glVertexAttribL4d)
+GL_ENTRY_POINT(glVertexAttribL1dv)
+GL_ENTRY_POINT(glVertexAttribL2dv)
+GL_ENTRY_POINT(glVertexAttribL3dv)
+GL_ENTRY_POINT(glVertexAttribL4dv)
+GL_ENTRY_POINT(glVertexAttribLPointer)
+GL_ENTRY_POINT(glGetVertexAttribLdv)
+GL_ENTRY_POINT(glViewportArrayv)
+GL_ENTRY_POINT(glViewportIndexedf)
+GL_ENTRY_POINT(glViewportIndexedfv)
+GL_ENTRY_POINT(glScissorArrayv)
+GL_ENTRY_POINT(glScissorIndexed)
+GL_ENTRY_POINT(glScissorIndexedv)
+GL_ENTRY_POINT(glDepthRangeArrayv)
+GL_ENTRY_POINT(glDepthRangeIndexed)
+GL_ENTRY_POINT(glGetFloati_v)
+GL_ENTRY_POINT(glGetDoublei_v)
+GL_ENTRY_POINT(glDrawArraysInstancedBaseInstance)
+GL_ENTRY_POINT(glDrawElementsInstancedBaseInstance)
+GL_ENTRY_POINT(glDrawElementsInstancedBaseVertexBaseInstance)
+GL_ENTRY_POINT(glGetInternalformativ)
+GL_ENTRY_POINT(glGetActiveAtomicCounterBufferiv)
+GL_ENTRY_POINT(glBindImageTexture)
+GL_ENTRY_POINT(glMemoryBarrier)
+GL_ENTRY_POINT(glTexStorage1D)
+GL_ENTRY_POINT(glTexStorage2D)
+GL_ENTRY_POINT(glTexStorage3D)
+GL_ENTRY_POINT(glDrawTransformFeedbackInstanced)
+GL_ENTRY_POINT(glDrawTransformFeedbackStreamInstanced)
+GL_ENTRY_POINT(glClearBufferData)
+GL_ENTRY_POINT(glClearBufferSubData)
+GL_ENTRY_POINT(glDispatchCompute)
+GL_ENTRY_POINT(glDispatchComputeIndirect)
+GL_ENTRY_POINT(glCopyImageSubData)
+GL_ENTRY_POINT(glFramebufferParameteri)
+GL_ENTRY_POINT(glGetFramebufferParameteriv)
+GL_ENTRY_POINT(glGetInternalformati64v)
+GL_ENTRY_POINT(glInvalidateTexSubImage)
+GL_ENTRY_POINT(glInvalidateTexImage)
+GL_ENTRY_POINT(glInvalidateBufferSubData)
+GL_ENTRY_POINT(glInvalidateBufferData)
+GL_ENTRY_POINT(glInvalidateFramebuffer)
+GL_ENTRY_POINT(glInvalidateSubFramebuffer)
+GL_ENTRY_POINT(glMultiDrawArraysIndirect)
+GL_ENTRY_POINT(glMultiDrawElementsIndirect)
+GL_ENTRY_POINT(glGetProgramInterfaceiv)
+GL_ENTRY_POINT(glGetProgramResourceIndex)
+GL_ENTRY_POINT(glGetProgramResourceName)
+GL_ENTRY_POINT(glGetProgramResourceiv)
+GL_ENTRY_POINT(glGetProgramResourceLocation)
+GL_ENTRY_POINT(glGetProgramResourceLocationIndex)
+GL_ENTRY_POINT(glShaderStorageBlockBinding)
+GL_ENTRY_POINT(glTexBufferRange)
+GL_ENTRY_POINT(glTexStorage2DMultisample)
+GL_ENTRY_POINT(glTexStorage3DMultisample)
+GL_ENTRY_POINT(glTextureView)
+GL_ENTRY_POINT(glBindVertexBuffer)
+GL_ENTRY_POINT(glVertexAttribFormat)
+GL_ENTRY_POINT(glVertexAttribIFormat)
+GL_ENTRY_POINT(glVertexAttribLFormat)
+GL_ENTRY_POINT(glVertexAttribBinding)
+GL_ENTRY_POINT(glVertexBindingDivisor)
+GL_ENTRY_POINT(glDebugMessageControl)
+GL_ENTRY_POINT(glDebugMessageInsert)
+GL_ENTRY_POINT(glDebugMessageCallback)
+GL_ENTRY_POINT(glGetDebugMessageLog)
+GL_ENTRY_POINT(glPushDebugGroup)
+GL_ENTRY_POINT(glPopDebugGroup)
+GL_ENTRY_POINT(glObjectLabel)
+GL_ENTRY_POINT(glGetObjectLabel)
+GL_ENTRY_POINT(glObjectPtrLabel)
+GL_ENTRY_POINT(glGetObjectPtrLabel)
+GL_ENTRY_POINT(glGetPointerv)
+GL_ENTRY_POINT(glBufferStorage)
+GL_ENTRY_POINT(glClearTexImage)
+GL_ENTRY_POINT(glClearTexSubImage)
+GL_ENTRY_POINT(glBindBuffersBase)
+GL_ENTRY_POINT(glBindBuffersRange)
+GL_ENTRY_POINT(glBindTextures)
+GL_ENTRY_POINT(glBindSamplers)
+GL_ENTRY_POINT(glBindImageTextures)
+GL_ENTRY_POINT(glBindVertexBuffers)
+GL_ENTRY_POINT(glClipControl)
+GL_ENTRY_POINT(glCreateTransformFeedbacks)
+GL_ENTRY_POINT(glTransformFeedbackBufferBase)
+GL_ENTRY_POINT(glTransformFeedbackBufferRange)
+GL_ENTRY_POINT(glGetTransformFeedbackiv)
+GL_ENTRY_POINT(glGetTransformFeedbacki_v)
+GL_ENTRY_POINT(glGetTransformFeedbacki64_v)
+GL_ENTRY_POINT(glCreateBuffers)
+GL_ENTRY_POINT(glNamedBufferStorage)
+GL_ENTRY_POINT(glNamedBufferData)
+GL_ENTRY_POINT(glNamedBufferSubData)
+GL_ENTRY_POINT(glCopyNamedBufferSubData)
+GL_ENTRY_POINT(glClearNamedBufferData)
+GL_ENTRY_POINT(glClearNamedBufferSubData)
+GL_ENTRY_POINT(glMapNamedBuffer)
+GL_ENTRY_POINT(glMapNamedBufferRange)
+GL_ENTRY_POINT(glUnmapNamedBuffer)
+GL_ENTRY_POINT(glFlushMappedNamedBufferRange)
+GL_ENTRY_POINT(glGetNamedBufferParameteriv)
+GL_ENTRY_POINT(glGetNamedBufferParameteri64v)
+GL_ENTRY_POINT(glGetNamedBufferPointerv)
+GL_ENTRY_POINT(glGetNamedBufferSubData)
+GL_ENTRY_POINT(glCreateFramebuffers)
+GL_ENTRY_POINT(glNamedFramebufferRenderbuffer)
+GL_ENTRY_POINT(glNamedFramebufferParameteri)
+GL_ENTRY_POINT(glNamedFramebufferTexture)
+GL_ENTRY_POINT(glNamedFramebufferTextureLayer)
+GL_ENTRY_POINT(glNamedFramebufferDrawBuffer)
+GL_ENTRY_POINT(glNamedFramebufferDrawBuffers)
+GL_ENTRY_POINT(glNamedFramebufferReadBuffer)
+GL_ENTRY_POINT(glInvalidateNamedFramebufferData)
+GL_ENTRY_POINT(glInvalidateNamedFramebufferSubData)
+GL_ENTRY_POINT(glClearNamedFramebufferiv)
+GL_ENTRY_POINT(glClearNamedFramebufferuiv)
+GL_ENTRY_POINT(glClearNamedFramebufferfv)
+GL_ENTRY_POINT(glClearNamedFramebufferfi)
+GL_ENTRY_POINT(glBlitNamedFramebuffer)
+GL_ENTRY_POINT(glCheckNamedFramebufferStatus)
+GL_ENTRY_POINT(glGetNamedFramebufferParameteriv)
+GL_ENTRY_POINT(glGetNamedFramebufferAttachmentParameteriv)
+GL_ENTRY_POINT(glCreateRenderbuffers)
+GL_ENTRY_POINT(glNamedRenderbufferStorage)
+GL_ENTRY_POINT(glNamedRenderbufferStorageMultisample)
+GL_ENTRY_POINT(glGetNamedRenderbufferParameteriv)
+GL_ENTRY_POINT(glCreateTextures)
+GL_ENTRY_POINT(glTextureBuffer)
+GL_ENTRY_POINT(glTextureBufferRange)
+GL_ENTRY_POINT(glTextureStorage1D)
+GL_ENTRY_POINT(glTextureStorage2D)
+GL_ENTRY_POINT(glTextureStorage3D)
+GL_ENTRY_POINT(glTextureStorage2DMultisample)
+GL_ENTRY_POINT(glTextureStorage3DMultisample)
+GL_ENTRY_POINT(glTextureSubImage1D)
+GL_ENTRY_POINT(glTextureSubImage2D)
+GL_ENTRY_POINT(glTextureSubImage3D)
+GL_ENTRY_POINT(glCompressedTextureSubImage1D)
+GL_ENTRY_POINT(glCompressedTextureSubImage2D)
+GL_ENTRY_POINT(glCompressedTextureSubImage3D)
+GL_ENTRY_POINT(glCopyTextureSubImage1D)
+GL_ENTRY_POINT(glCopyTextureSubImage2D)
+GL_ENTRY_POINT(glCopyTextureSubImage3D)
+GL_ENTRY_POINT(glTextureParameterf)
+GL_ENTRY_POINT(glTextureParameterfv)
+GL_ENTRY_POINT(glTextureParameteri)
+GL_ENTRY_POINT(glTextureParameterIiv)
+GL_ENTRY_POINT(glTextureParameterIuiv)
+GL_ENTRY_POINT(glTextureParameteriv)
+GL_ENTRY_POINT(glGenerateTextureMipmap)
+GL_ENTRY_POINT(glBindTextureUnit)
+GL_ENTRY_POINT(glGetTextureImage)
+GL_ENTRY_POINT(glGetCompressedTextureImage)
+GL_ENTRY_POINT(glGetTextureLevelParameterfv)
+GL_ENTRY_POINT(glGetTextureLevelParameteriv)
+GL_ENTRY_POINT(glGetTextureParameterfv)
+GL_ENTRY_POINT(glGetTextureParameterIiv)
+GL_ENTRY_POINT(glGetTextureParameterIuiv)
+GL_ENTRY_POINT(glGetTextureParameteriv)
+GL_ENTRY_POINT(glCreateVertexArrays)
+GL_ENTRY_POINT(glDisableVertexArrayAttrib)
+GL_ENTRY_POINT(glEnableVertexArrayAttrib)
+GL_ENTRY_POINT(glVertexArrayElementBuffer)
+GL_ENTRY_POINT(glVertexArrayVertexBuffer)
+GL_ENTRY_POINT(glVertexArrayVertexBuffers)
+GL_ENTRY_POINT(glVertexArrayAttribBinding)
+GL_ENTRY_POINT(glVertexArrayAttribFormat)
+GL_ENTRY_POINT(glVertexArrayAttribIFormat)
+GL_ENTRY_POINT(glVertexArrayAttribLFormat)
+GL_ENTRY_POINT(glVertexArrayBindingDivisor)
+GL_ENTRY_POINT(glGetVertexArrayiv)
+GL_ENTRY_POINT(glGetVertexArrayIndexediv)
+GL_ENTRY_POINT(glGetVertexArrayIndexed64iv)
+GL_ENTRY_POINT(glCreateSamplers)
+GL_ENTRY_POINT(glCreateProgramPipelines)
+GL_ENTRY_POINT(glCreateQueries)
+GL_ENTRY_POINT(glGetQueryBufferObjecti64v)
+GL_ENTRY_POINT(glGetQueryBufferObjectiv)
+GL_ENTRY_POINT(glGetQueryBufferObjectui64v)
+GL_ENTRY_POINT(glGetQueryBufferObjectuiv)
+GL_ENTRY_POINT(glMemoryBarrierByRegion)
+GL_ENTRY_POINT(glGetTextureSubImage)
+GL_ENTRY_POINT(glGetCompressedTextureSubImage)
+GL_ENTRY_POINT(glGetGraphicsResetStatus)
+GL_ENTRY_POINT(glGetnCompressedTexImage)
+GL_ENTRY_POINT(glGetnTexImage)
+GL_ENTRY_POINT(glGetnUniformdv)
+GL_ENTRY_POINT(glGetnUniformfv)
+GL_ENTRY_POINT(glGetnUniformiv)
+GL_ENTRY_POINT(glGetnUniformuiv)
+GL_ENTRY_POINT(glReadnPixels)
+GL_ENTRY_POINT(glGetnMapdv)
+GL_ENTRY_POINT(glGetnMapfv)
+GL_ENTRY_POINT(glGetnMapiv)
+GL_ENTRY_POINT(glGetnPixelMapfv)
+GL_ENTRY_POINT(glGetnPixelMapuiv)
+GL_ENTRY_POINT(glGetnPixelMapusv)
+GL_ENTRY_POINT(glGetnPolygonStipple)
+GL_ENTRY_POINT(glGetnColorTable)
+GL_ENTRY_POINT(glGetnConvolutionFilter)
+GL_ENTRY_POINT(glGetnSeparableFilter)
+GL_ENTRY_POINT(glGetnHistogram)
+GL_ENTRY_POINT(glGetnMinmax)
+GL_ENTRY_POINT(glTextureBarrier)
+GL_ENTRY_POINT(glSpecializeShader)
+GL_ENTRY_POINT(glMultiDrawArraysIndirectCount)
+GL_ENTRY_POINT(glMultiDrawElementsIndirectCount)
+GL_ENTRY_POINT(glPolygonOffsetClamp)
@@ -0,0 +1,743 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+//Optional interception layer over glad: Install() swaps every entry point glad loaded (GLEntryPoints.h) for
+//a wrapper that counts the call and forwards to the driver, so everything is seen whether it goes through
+//GLStateCache or not. Nothing is hooked until Install() is called, a run that never installs it pays nothing.
+//Per frame (EndFrame() closes one) it keeps:
+//	- calls per entry point
+//	- draws and primitives (indirect draws count as draws, their primitives are on the gpu and not known)
+//	- dispatches
+//	- uploads and their bytes, buffer and texture data from client memory (a null pointer only allocates and is
+//	  not counted) and glUniform* / glProgramUniform* values
+//	- bind changes, and redundant binds: a bind of the object that is already bound there, per entry point.
+//	  Buffers, buffer bases, vertex arrays, programs, framebuffers, renderbuffers, textures (per unit and target)
+//	  and samplers are tracked; deleting an object forgets where it was bound, changing the vertex array
+//	  forgets the element array buffer, which belongs to it
+//The bind tracking mirrors one context and assumes everything after Install() goes through glad.
+class GLInterceptor
+{
+public:
+	enum EntryPoint
+	{
+#define GL_ENTRY_POINT(name) EP_##name,
+#include "GLEntryPoints.h"
+#undef GL_ENTRY_POINT
+		ENTRY_POINT_COUNT
+	};
+
+	struct EntryStats
+	{
+		uint64_t calls = 0;
+		uint64_t redundant = 0;
+	};
+
+	struct Stats
+	{
+		uint64_t calls = 0;
+		uint64_t draws = 0;
+		uint64_t primitives = 0;
+		uint64_t vertices = 0;		// vertices or indices submitted, times instances
+		uint64_t dispatches = 0;
+		uint64_t uploads = 0;
+		uint64_t uploadBytes = 0;	// buffers and textures
+		uint64_t uniformBytes = 0;
+		uint64_t bindChanges = 0;
+		uint64_t redundantBinds = 0;
+		EntryStats entries[ENTRY_POINT_COUNT];
+
+		void Add(const Stats& other);
+	};
+
+	static void Install();
+	static bool Installed() { return installed(); }
+
+	//the frame being counted
+	static const Stats& Frame() { return current(); }
+	//the frame closed by the last EndFrame()
+	static const Stats& LastFrame() { return last(); }
+	static void EndFrame();
+
+	static const char* Name(int entryPoint);
+	//totals and the busiest entry points of stats, averaged over frames
+	static void Print(std::ostream& out, const Stats& stats, int frames = 1, int top = 12);
+
+private:
+	template<int Id, typename F> friend struct GLInterceptorHook;
+	//GLTrace sizes uniform and pixel data the same way
+	friend class GLTrace;
+
+	enum BindKind : uint64_t
+	{
+		BIND_BUFFER,
+		BIND_BUFFER_BASE,
+		BIND_VERTEX_ARRAY,
+		BIND_PROGRAM,
+		BIND_FRAMEBUFFER,
+		BIND_RENDERBUFFER,
+		BIND_TEXTURE,
+		BIND_SAMPLER
+	};
+
+	struct UniformLayout
+	{
+		int bytes = 0;			// per element, 0 for anything that is not a uniform upload
+		int countArg = -1;		// argument holding the element count, -1 for a single element
+	};
+
+	static bool& installed() { static bool i = false; return i; }
+	static Stats& current() { static Stats s; return s; }
+	static Stats& last() { static Stats s; return s; }
+	static UniformLayout* uniformLayouts() { static UniformLayout layouts[ENTRY_POINT_COUNT]; return layouts; }
+	static std::unordered_map<uint64_t, GLuint>& bindings() { static std::unordered_map<uint64_t, GLuint> b; return b; }
+	static GLuint& activeUnit() { static GLuint unit = 0; return unit; }
+
+	static UniformLayout uniformLayout(const char* name);
+	static void installOverrides();
+	static uint64_t slot(BindKind kind, GLenum target, GLuint index) { return (uint64_t)kind << 56 | (uint64_t)target << 24 | index; }
+	//records object in slot, false when it was already there
+	static bool setBinding(uint64_t slot, GLuint object);
+	static void countBind(int entryPoint, bool changed);
+	static void bind(int entryPoint, BindKind kind, GLenum target, GLuint index, GLuint object) { countBind(entryPoint, setBinding(slot(kind, target, index), object)); }
+	static void forget(uint64_t kindMask, GLsizei n, const GLuint* objects);
+	static void draw(GLenum mode, uint64_t count, uint64_t instances);
+	static void upload(uint64_t bytes);
+	static uint64_t pixelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type);
+
+	static int64_t asCount(GLsizei value) { return value; }
+	template<typename T> static int64_t asCount(T) { return 0; }
+
+	static void APIENTRY drawArrays(GLenum mode, GLint first, GLsizei count);
+	static void APIENTRY drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+	static void APIENTRY drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+	static void APIENTRY drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances);
+	static void APIENTRY drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex);
+	static void APIENTRY drawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices,
+		GLsizei instances, GLint baseVertex);
+	static void APIENTRY drawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void* indices);
+	static void APIENTRY drawArraysIndirect(GLenum mode, const void* indirect);
+	static void APIENTRY drawElementsIndirect(GLenum mode, GLenum type, const void* indirect);
+	static void APIENTRY multiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawCount, GLsizei stride);
+	static void APIENTRY multiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride);
+	static void APIENTRY dispatchCompute(GLuint x, GLuint y, GLuint z);
+	static void APIENTRY dispatchComputeIndirect(GLintptr indirect);
+
+	static void APIENTRY bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+	static void APIENTRY bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+	static void APIENTRY namedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+	static void APIENTRY namedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+	static void APIENTRY texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+		GLint border, GLenum format, GLenum type, const void* pixels);
+	static void APIENTRY texSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, const void* pixels);
+	static void APIENTRY texImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+		GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels);
+	static void APIENTRY texSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height,
+		GLsizei depth, GLenum format, GLenum type, const void* pixels);
+
+	static void APIENTRY bindBuffer(GLenum target, GLuint buffer);
+	static void APIENTRY bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	static void APIENTRY bindVertexArray(GLuint vao);
+	static void APIENTRY useProgram(GLuint program);
+	static void APIENTRY bindFramebuffer(GLenum target, GLuint framebuffer);
+	static void APIENTRY bindRenderbuffer(GLenum target, GLuint renderbuffer);
+	static void APIENTRY activeTexture(GLenum unit);
+	static void APIENTRY bindTexture(GLenum target, GLuint texture);
+	static void APIENTRY bindSampler(GLuint unit, GLuint sampler);
+
+	static void APIENTRY deleteBuffers(GLsizei n, const GLuint* buffers);
+	static void APIENTRY deleteVertexArrays(GLsizei n, const GLuint* vaos);
+	static void APIENTRY deleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+	static void APIENTRY deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+	static void APIENTRY deleteTextures(GLsizei n, const GLuint* textures);
+	static void APIENTRY deleteSamplers(GLsizei n, const GLuint* samplers);
+};
+
+//one instance per entry point: Call counts and forwards to the driver's pointer kept in next
+template<int Id, typename F> struct GLInterceptorHook;
+
+template<int Id, typename R, typename... A>
+struct GLInterceptorHook<Id, R (APIENTRYP)(A...)>
+{
+	static R (APIENTRYP next)(A...);
+
+	static R APIENTRY Call(A... args)
+	{
+		GLInterceptor::Stats& stats = GLInterceptor::current();
+		++stats.calls;
+		++stats.entries[Id].calls;
+		const GLInterceptor::UniformLayout& layout = GLInterceptor::uniformLayouts()[Id];
+		if (layout.bytes)
+		{
+			int64_t values[sizeof...(A) + 1] = { GLInterceptor::asCount(args)... };
+			stats.uniformBytes += (uint64_t)layout.bytes * (layout.countArg < 0 ? 1 : values[layout.countArg]);
+		}
+		return next(args...);
+	}
+};
+
+template<int Id, typename R, typename... A>
+R (APIENTRYP GLInterceptorHook<Id, R (APIENTRYP)(A...)>::next)(A...) = nullptr;
+
+//the counting wrapper of an entry point, what the overrides below forward to
+#define GL_INTERCEPTED(name) GLInterceptorHook<GLInterceptor::EP_##name, decltype(glad_##name)>::Call
+
+inline void GLInterceptor::Stats::Add(const Stats& other)
+{
+	calls += other.calls;
+	draws += other.draws;
+	primitives += other.primitives;
+	vertices += other.vertices;
+	dispatches += other.dispatches;
+	uploads += other.uploads;
+	uploadBytes += other.uploadBytes;
+	uniformBytes += other.uniformBytes;
+	bindChanges += other.bindChanges;
+	redundantBinds += other.redundantBinds;
+	for (int i = 0; i < ENTRY_POINT_COUNT; ++i)
+	{
+		entries[i].calls += other.entries[i].calls;
+		entries[i].redundant += other.entries[i].redundant;
+	}
+}
+
+inline void GLInterceptor::Install()
+{
+	if (installed())
+		return;
+	installed() = true;
+
+	//entry points the context does not have stay null
+#define GL_ENTRY_POINT(name) \
+	if (glad_##name) \
+	{ \
+		GLInterceptorHook<EP_##name, decltype(glad_##name)>::next = glad_##name; \
+		glad_##name = GLInterceptorHook<EP_##name, decltype(glad_##name)>::Call; \
+		uniformLayouts()[EP_##name] = uniformLayout(#name); \
+	}
+#include "GLEntryPoints.h"
+#undef GL_ENTRY_POINT
+
+	installOverrides();
+}
+
+inline void GLInterceptor::installOverrides()
+{
+	//the ones that need their arguments looked at, they count through GL_INTERCEPTED like every other call
+#define GL_OVERRIDE(name, wrapper) \
+	if (glad_##name) \
+		glad_##name = wrapper;
+	GL_OVERRIDE(glDrawArrays, drawArrays)
+	GL_OVERRIDE(glDrawElements, drawElements)
+	GL_OVERRIDE(glDrawArraysInstanced, drawArraysInstanced)
+	GL_OVERRIDE(glDrawElementsInstanced, drawElementsInstanced)
+	GL_OVERRIDE(glDrawElementsBaseVertex, drawElementsBaseVertex)
+	GL_OVERRIDE(glDrawElementsInstancedBaseVertex, drawElementsInstancedBaseVertex)
+	GL_OVERRIDE(glDrawRangeElements, drawRangeElements)
+	GL_OVERRIDE(glDrawArraysIndirect, drawArraysIndirect)
+	GL_OVERRIDE(glDrawElementsIndirect, drawElementsIndirect)
+	GL_OVERRIDE(glMultiDrawArraysIndirect, multiDrawArraysIndirect)
+	GL_OVERRIDE(glMultiDrawElementsIndirect, multiDrawElementsIndirect)
+	GL_OVERRIDE(glDispatchCompute, dispatchCompute)
+	GL_OVERRIDE(glDispatchComputeIndirect, dispatchComputeIndirect)
+	GL_OVERRIDE(glBufferData, bufferData)
+	GL_OVERRIDE(glBufferSubData, bufferSubData)
+	GL_OVERRIDE(glNamedBufferData, namedBufferData)
+	GL_OVERRIDE(glNamedBufferSubData, namedBufferSubData)
+	GL_OVERRIDE(glTexImage2D, texImage2D)
+	GL_OVERRIDE(glTexSubImage2D, texSubImage2D)
+	GL_OVERRIDE(glTexImage3D, texImage3D)
+	GL_OVERRIDE(glTexSubImage3D, texSubImage3D)
+	GL_OVERRIDE(glBindBuffer, bindBuffer)
+	GL_OVERRIDE(glBindBufferBase, bindBufferBase)
+	GL_OVERRIDE(glBindVertexArray, bindVertexArray)
+	GL_OVERRIDE(glUseProgram, useProgram)
+	GL_OVERRIDE(glBindFramebuffer, bindFramebuffer)
+	GL_OVERRIDE(glBindRenderbuffer, bindRenderbuffer)
+	GL_OVERRIDE(glActiveTexture, activeTexture)
+	GL_OVERRIDE(glBindTexture, bindTexture)
+	GL_OVERRIDE(glBindSampler, bindSampler)
+	GL_OVERRIDE(glDeleteBuffers, deleteBuffers)
+	GL_OVERRIDE(glDeleteVertexArrays, deleteVertexArrays)
+	GL_OVERRIDE(glDeleteFramebuffers, deleteFramebuffers)
+	GL_OVERRIDE(glDeleteRenderbuffers, deleteRenderbuffers)
+	GL_OVERRIDE(glDeleteTextures, deleteTextures)
+	GL_OVERRIDE(glDeleteSamplers, deleteSamplers)
+#undef GL_OVERRIDE
+}
+
+inline void GLInterceptor::EndFrame()
+{
+	if (!installed())
+		return;
+	last() = current();
+	current() = Stats();
+}
+
+inline const char* GLInterceptor::Name(int entryPoint)
+{
+	static const char* names[ENTRY_POINT_COUNT + 1] =
+	{
+#define GL_ENTRY_POINT(name) #name,
+#include "GLEntryPoints.h"
+#undef GL_ENTRY_POINT
+		""
+	};
+	return entryPoint >= 0 && entryPoint < ENTRY_POINT_COUNT ? names[entryPoint] : "";
+}
+
+inline void GLInterceptor::Print(std::ostream& out, const Stats& stats, int frames, int top)
+{
+	double n = std::max(frames, 1);
+	char line[256];
+	std::snprintf(line, sizeof(line), "gl calls %.0f, draws %.0f, primitives %.0f, dispatches %.0f, uploads %.0f (%.1f KB), uniforms %.1f KB, "
+		"binds %.0f + %.0f redundant\n", stats.calls / n, stats.draws / n, stats.primitives / n, stats.dispatches / n, stats.uploads / n,
+		stats.uploadBytes / n / 1024.0, stats.uniformBytes / n / 1024.0, stats.bindChanges / n, stats.redundantBinds / n);
+	out << line;
+
+	std::vector<int> order;
+	for (int i = 0; i < ENTRY_POINT_COUNT; ++i)
+	{
+		if (stats.entries[i].calls)
+			order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [&stats](int a, int b) { return stats.entries[a].calls > stats.entries[b].calls; });
+	if ((int)order.size() > top)
+		order.resize(top);
+	for (int i : order)
+	{
+		const EntryStats& entry = stats.entries[i];
+		if (entry.redundant)
+			std::snprintf(line, sizeof(line), "  %-32s %10.1f  (%.1f redundant)\n", Name(i), entry.calls / n, entry.redundant / n);
+		else
+			std::snprintf(line, sizeof(line), "  %-32s %10.1f\n", Name(i), entry.calls / n);
+		out << line;
+	}
+}
+
+inline GLInterceptor::UniformLayout GLInterceptor::uniformLayout(const char* name)
+{
+	//glUniform{1234}{f,i,ui,d}[v], glUniformMatrix{2,3,4,2x3,..}{f,d}v and the glProgramUniform forms, which take the
+	//program first and so have their count one argument later
+	UniformLayout layout;
+	int countArg;
+	if (std::strncmp(name, "glUniform", 9) == 0)
+	{
+		name += 9;
+		countArg = 1;
+	}
+	else if (std::strncmp(name, "glProgramUniform", 16) == 0)
+	{
+		name += 16;
+		countArg = 2;
+	}
+	else
+	{
+		return layout;
+	}
+
+	if (std::strcmp(name, "Subroutinesuiv") == 0)
+	{
+		layout.bytes = 4;
+		layout.countArg = 1;
+		return layout;
+	}
+
+	int elements;
+	if (std::strncmp(name, "Matrix", 6) == 0)
+	{
+		name += 6;
+		if (!(name[0] >= '2' && name[0] <= '4'))
+			return layout;
+		elements = (name[0] - '0') * (name[0] - '0');
+		++name;
+		if (name[0] == 'x' && name[1] >= '2' && name[1] <= '4')
+		{
+			elements = (name[-1] - '0') * (name[1] - '0');
+			name += 2;
+		}
+	}
+	else if (name[0] >= '1' && name[0] <= '4')
+	{
+		elements = name[0] - '0';
+		++name;
+	}
+	else
+	{
+		//glUniformBlockBinding and friends
+		return layout;
+	}
+
+	int bytes;
+	if (name[0] == 'f' || name[0] == 'i')
+	{
+		bytes = 4;
+		++name;
+	}
+	else if (name[0] == 'u' && name[1] == 'i')
+	{
+		bytes = 4;
+		name += 2;
+	}
+	else if (name[0] == 'd')
+	{
+		bytes = 8;
+		++name;
+	}
+	else
+	{
+		return layout;
+	}
+
+	layout.bytes = elements * bytes;
+	layout.countArg = name[0] == 'v' ? countArg : -1;
+	return layout;
+}
+
+inline bool GLInterceptor::setBinding(uint64_t slot, GLuint object)
+{
+	auto it = bindings().find(slot);
+	if (it != bindings().end() && it->second == object)
+		return false;
+	bindings()[slot] = object;
+	return true;
+}
+
+inline void GLInterceptor::countBind(int entryPoint, bool changed)
+{
+	Stats& stats = current();
+	if (changed)
+	{
+		++stats.bindChanges;
+	}
+	else
+	{
+		++stats.redundantBinds;
+		++stats.entries[entryPoint].redundant;
+	}
+}
+
+inline void GLInterceptor::forget(uint64_t kindMask, GLsizei n, const GLuint* objects)
+{
+	//deleting a bound object unbinds it, a later name reuse must not look redundant
+	for (auto it = bindings().begin(); it != bindings().end();)
+	{
+		if ((kindMask >> (it->first >> 56) & 1) && std::find(objects, objects + n, it->second) != objects + n)
+			it = bindings().erase(it);
+		else
+			++it;
+	}
+}
+
+inline void GLInterceptor::draw(GLenum mode, uint64_t count, uint64_t instances)
+{
+	uint64_t primitives;
+	switch (mode)
+	{
+	case GL_POINTS: primitives = count; break;
+	case GL_LINES: primitives = count / 2; break;
+	case GL_LINE_LOOP: primitives = count; break;
+	case GL_LINE_STRIP: primitives = count > 1 ? count - 1 : 0; break;
+	case GL_TRIANGLES: primitives = count / 3; break;
+	case GL_TRIANGLE_STRIP: case GL_TRIANGLE_FAN: primitives = count > 2 ? count - 2 : 0; break;
+	case GL_LINES_ADJACENCY: primitives = count / 4; break;
+	case GL_LINE_STRIP_ADJACENCY: primitives = count > 3 ? count - 3 : 0; break;
+	case GL_TRIANGLES_ADJACENCY: primitives = count / 6; break;
+	case GL_TRIANGLE_STRIP_ADJACENCY: primitives = count > 4 ? (count - 4) / 2 : 0; break;
+	default: primitives = count; break;		// patches count their vertices
+	}
+
+	Stats& stats = current();
+	++stats.draws;
+	stats.vertices += count * instances;
+	stats.primitives += primitives * instances;
+}
+
+inline void GLInterceptor::upload(uint64_t bytes)
+{
+	++current().uploads;
+	current().uploadBytes += bytes;
+}
+
+inline uint64_t GLInterceptor::pixelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type)
+{
+	int components;
+	switch (format)
+	{
+	case GL_RED: case GL_GREEN: case GL_BLUE: case GL_RED_INTEGER: case GL_GREEN_INTEGER: case GL_BLUE_INTEGER:
+	case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: components = 1; break;
+	case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: components = 2; break;
+	case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER: components = 3; break;
+	default: components = 4; break;
+	}
+
+	//packed types hold the whole pixel
+	int bytes;
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE: case GL_BYTE: bytes = components; break;
+	case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: bytes = components * 2; break;
+	case GL_UNSIGNED_BYTE_3_3_2: case GL_UNSIGNED_BYTE_2_3_3_REV: bytes = 1; break;
+	case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_5_6_5_REV: case GL_UNSIGNED_SHORT_4_4_4_4: case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+	case GL_UNSIGNED_SHORT_5_5_5_1: case GL_UNSIGNED_SHORT_1_5_5_5_REV: bytes = 2; break;
+	case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_10F_11F_11F_REV: case GL_UNSIGNED_INT_2_10_10_10_REV: case GL_UNSIGNED_INT_10_10_10_2:
+	case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_5_9_9_9_REV: bytes = 4; break;
+	case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: bytes = 8; break;
+	default: bytes = components * 4; break;
+	}
+	return (uint64_t)width * height * depth * bytes;
+}
+
+inline void APIENTRY GLInterceptor::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	draw(mode, count, 1);
+	GL_INTERCEPTED(glDrawArrays)(mode, first, count);
+}
+
+inline void APIENTRY GLInterceptor::drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	draw(mode, count, 1);
+	GL_INTERCEPTED(glDrawElements)(mode, count, type, indices);
+}
+
+inline void APIENTRY GLInterceptor::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+	draw(mode, count, instances);
+	GL_INTERCEPTED(glDrawArraysInstanced)(mode, first, count, instances);
+}
+
+inline void APIENTRY GLInterceptor::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances)
+{
+	draw(mode, count, instances);
+	GL_INTERCEPTED(glDrawElementsInstanced)(mode, count, type, indices, instances);
+}
+
+inline void APIENTRY GLInterceptor::drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex)
+{
+	draw(mode, count, 1);
+	GL_INTERCEPTED(glDrawElementsBaseVertex)(mode, count, type, indices, baseVertex);
+}
+
+inline void APIENTRY GLInterceptor::drawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices,
+	GLsizei instances, GLint baseVertex)
+{
+	draw(mode, count, instances);
+	GL_INTERCEPTED(glDrawElementsInstancedBaseVertex)(mode, count, type, indices, instances, baseVertex);
+}
+
+inline void APIENTRY GLInterceptor::drawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void* indices)
+{
+	draw(mode, count, 1);
+	GL_INTERCEPTED(glDrawRangeElements)(mode, start, end, count, type, indices);
+}
+
+inline void APIENTRY GLInterceptor::drawArraysIndirect(GLenum mode, const void* indirect)
+{
+	++current().draws;
+	GL_INTERCEPTED(glDrawArraysIndirect)(mode, indirect);
+}
+
+inline void APIENTRY GLInterceptor::drawElementsIndirect(GLenum mode, GLenum type, const void* indirect)
+{
+	++current().draws;
+	GL_INTERCEPTED(glDrawElementsIndirect)(mode, type, indirect);
+}
+
+inline void APIENTRY GLInterceptor::multiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawCount, GLsizei stride)
+{
+	current().draws += drawCount;
+	GL_INTERCEPTED(glMultiDrawArraysIndirect)(mode, indirect, drawCount, stride);
+}
+
+inline void APIENTRY GLInterceptor::multiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride)
+{
+	current().draws += drawCount;
+	GL_INTERCEPTED(glMultiDrawElementsIndirect)(mode, type, indirect, drawCount, stride);
+}
+
+inline void APIENTRY GLInterceptor::dispatchCompute(GLuint x, GLuint y, GLuint z)
+{
+	++current().dispatches;
+	GL_INTERCEPTED(glDispatchCompute)(x, y, z);
+}
+
+inline void APIENTRY GLInterceptor::dispatchComputeIndirect(GLintptr indirect)
+{
+	++current().dispatches;
+	GL_INTERCEPTED(glDispatchComputeIndirect)(indirect);
+}
+
+inline void APIENTRY GLInterceptor::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	if (data)
+		upload(size);
+	GL_INTERCEPTED(glBufferData)(target, size, data, usage);
+}
+
+inline void APIENTRY GLInterceptor::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	upload(size);
+	GL_INTERCEPTED(glBufferSubData)(target, offset, size, data);
+}
+
+inline void APIENTRY GLInterceptor::namedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+{
+	if (data)
+		upload(size);
+	GL_INTERCEPTED(glNamedBufferData)(buffer, size, data, usage);
+}
+
+inline void APIENTRY GLInterceptor::namedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	upload(size);
+	GL_INTERCEPTED(glNamedBufferSubData)(buffer, offset, size, data);
+}
+
+inline void APIENTRY GLInterceptor::texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+	GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	if (pixels)
+		upload(pixelBytes(width, height, 1, format, type));
+	GL_INTERCEPTED(glTexImage2D)(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+inline void APIENTRY GLInterceptor::texSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, const void* pixels)
+{
+	upload(pixelBytes(width, height, 1, format, type));
+	GL_INTERCEPTED(glTexSubImage2D)(target, level, x, y, width, height, format, type, pixels);
+}
+
+inline void APIENTRY GLInterceptor::texImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+	GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	if (pixels)
+		upload(pixelBytes(width, height, depth, format, type));
+	GL_INTERCEPTED(glTexImage3D)(target, level, internalFormat, width, height, depth, border, format, type, pixels);
+}
+
+inline void APIENTRY GLInterceptor::texSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height,
+	GLsizei depth, GLenum format, GLenum type, const void* pixels)
+{
+	upload(pixelBytes(width, height, depth, format, type));
+	GL_INTERCEPTED(glTexSubImage3D)(target, level, x, y, z, width, height, depth, format, type, pixels);
+}
+
+inline void APIENTRY GLInterceptor::bindBuffer(GLenum target, GLuint buffer)
+{
+	bind(EP_glBindBuffer, BIND_BUFFER, target, 0, buffer);
+	GL_INTERCEPTED(glBindBuffer)(target, buffer);
+}
+
+inline void APIENTRY GLInterceptor::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	bind(EP_glBindBufferBase, BIND_BUFFER_BASE, target, index, buffer);
+	//also binds the generic target
+	setBinding(slot(BIND_BUFFER, target, 0), buffer);
+	GL_INTERCEPTED(glBindBufferBase)(target, index, buffer);
+}
+
+inline void APIENTRY GLInterceptor::bindVertexArray(GLuint vao)
+{
+	bool changed = setBinding(slot(BIND_VERTEX_ARRAY, 0, 0), vao);
+	countBind(EP_glBindVertexArray, changed);
+	//the element array binding is vao state, the new vao brings its own
+	if (changed)
+		bindings().erase(slot(BIND_BUFFER, GL_ELEMENT_ARRAY_BUFFER, 0));
+	GL_INTERCEPTED(glBindVertexArray)(vao);
+}
+
+inline void APIENTRY GLInterceptor::useProgram(GLuint program)
+{
+	bind(EP_glUseProgram, BIND_PROGRAM, 0, 0, program);
+	GL_INTERCEPTED(glUseProgram)(program);
+}
+
+inline void APIENTRY GLInterceptor::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	if (target == GL_FRAMEBUFFER)
+	{
+		//sets both, redundant only if both were already there
+		bool drawChanged = setBinding(slot(BIND_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER, 0), framebuffer);
+		bool readChanged = setBinding(slot(BIND_FRAMEBUFFER, GL_READ_FRAMEBUFFER, 0), framebuffer);
+		countBind(EP_glBindFramebuffer, drawChanged || readChanged);
+	}
+	else
+	{
+		bind(EP_glBindFramebuffer, BIND_FRAMEBUFFER, target, 0, framebuffer);
+	}
+	GL_INTERCEPTED(glBindFramebuffer)(target, framebuffer);
+}
+
+inline void APIENTRY GLInterceptor::bindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+	bind(EP_glBindRenderbuffer, BIND_RENDERBUFFER, target, 0, renderbuffer);
+	GL_INTERCEPTED(glBindRenderbuffer)(target, renderbuffer);
+}
+
+inline void APIENTRY GLInterceptor::activeTexture(GLenum unit)
+{
+	activeUnit() = unit - GL_TEXTURE0;
+	GL_INTERCEPTED(glActiveTexture)(unit);
+}
+
+inline void APIENTRY GLInterceptor::bindTexture(GLenum target, GLuint texture)
+{
+	bind(EP_glBindTexture, BIND_TEXTURE, target, activeUnit(), texture);
+	GL_INTERCEPTED(glBindTexture)(target, texture);
+}
+
+inline void APIENTRY GLInterceptor::bindSampler(GLuint unit, GLuint sampler)
+{
+	bind(EP_glBindSampler, BIND_SAMPLER, 0, unit, sampler);
+	GL_INTERCEPTED(glBindSampler)(unit, sampler);
+}
+
+inline void APIENTRY GLInterceptor::deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	forget(1ull << BIND_BUFFER | 1ull << BIND_BUFFER_BASE, n, buffers);
+	GL_INTERCEPTED(glDeleteBuffers)(n, buffers);
+}
+
+inline void APIENTRY GLInterceptor::deleteVertexArrays(GLsizei n, const GLuint* vaos)
+{
+	forget(1ull << BIND_VERTEX_ARRAY, n, vaos);
+	//one of them may have been bound, vao 0 has an element array binding of its own
+	bindings().erase(slot(BIND_BUFFER, GL_ELEMENT_ARRAY_BUFFER, 0));
+	GL_INTERCEPTED(glDeleteVertexArrays)(n, vaos);
+}
+
+inline void APIENTRY GLInterceptor::deleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	forget(1ull << BIND_FRAMEBUFFER, n, framebuffers);
+	GL_INTERCEPTED(glDeleteFramebuffers)(n, framebuffers);
+}
+
+inline void APIENTRY GLInterceptor::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+	forget(1ull << BIND_RENDERBUFFER, n, renderbuffers);
+	GL_INTERCEPTED(glDeleteRenderbuffers)(n, renderbuffers);
+}
+
+inline void APIENTRY GLInterceptor::deleteTextures(GLsizei n, const GLuint* textures)
+{
+	forget(1ull << BIND_TEXTURE, n, textures);
+	GL_INTERCEPTED(glDeleteTextures)(n, textures);
+}
+
+inline void APIENTRY GLInterceptor::deleteSamplers(GLsizei n, const GLuint* samplers)
+{
+	forget(1ull << BIND_SAMPLER, n, samplers);
+	GL_INTERCEPTED(glDeleteSamplers)(n, samplers);
+}
+
+#undef GL_INTERCEPTED
@@ -0,0 +1,499 @@
+#pragma once
+
+#include "glad/glad.h"
+
+//Thin shadow of the GL binding and fixed function state.
+//Engine code binds through this instead of calling gl* directly, calls that would not change
+//anything are skipped and counted. Everything starts as "unknown" so the first call always reaches GL.
+//If code outside the cache touches GL state (third party, raw gl calls), call Invalidate() afterwards.
+class GLStateCache
+{
+public:
+	struct Stats
+	{
+		unsigned int issued = 0;	// calls forwarded to GL
+		unsigned int skipped = 0;	// redundant calls filtered out
+	};
+
+	static const unsigned int MAX_TEXTURE_UNITS = 32;
+	static const unsigned int MAX_BUFFER_BINDINGS = 16;
+
+public:
+	static GLStateCache& Get()
+	{
+		static GLStateCache instance;
+		return instance;
+	}
+
+	void Invalidate();
+
+	const Stats& GetStats() const { return stats; }
+	void ResetStats() { stats = Stats(); }
+
+	//objects
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vao);
+	void BindBuffer(GLenum target, GLuint buffer);
+	//uniform and shader storage binding points, a bind that reaches GL sets the generic target too, like glBindBufferBase
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	void ActiveTexture(GLenum unit);
+	void BindTexture(GLenum target, GLuint texture);	// on the active unit, like glBindTexture
+	void BindTextureUnit(GLuint unit, GLenum target, GLuint texture);
+	void BindFramebuffer(GLenum target, GLuint framebuffer);
+	void BindRenderbuffer(GLuint renderbuffer);
+	//where binding framebuffer 0 goes, an offscreen target when there is no window (see GLContext)
+	void SetDefaultFramebuffer(GLuint framebuffer) { defaultFramebuffer = framebuffer; }
+	GLuint DefaultFramebuffer() const { return defaultFramebuffer; }
+
+	//deleting through the cache forgets the name, GL may hand the same name out again
+	void DeleteProgram(GLuint program);
+	void DeleteVertexArray(GLuint vao);
+	void DeleteBuffer(GLuint buffer);
+	void DeleteTexture(GLuint texture);
+	void DeleteFramebuffer(GLuint framebuffer);
+	void DeleteRenderbuffer(GLuint renderbuffer);
+
+	//fixed function
+	void Enable(GLenum cap) { SetEnabled(cap, true); }
+	void Disable(GLenum cap) { SetEnabled(cap, false); }
+	void SetEnabled(GLenum cap, bool enabled);
+	void BlendFunc(GLenum src, GLenum dst) { BlendFuncSeparate(src, dst, src, dst); }
+	void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+	void DepthFunc(GLenum func);
+	void DepthMask(GLboolean flag);
+	void ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a);
+	void StencilFunc(GLenum func, GLint ref, GLuint mask);
+	void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+	void StencilMask(GLuint mask);
+	void CullFace(GLenum mode);
+	void FrontFace(GLenum mode);
+	void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+	void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+private:
+	static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+	enum TextureTarget { TEX_2D, TEX_2D_ARRAY, TEX_CUBE_MAP, TEX_BUFFER, TEX_2D_MULTISAMPLE, TEX_TARGET_NUM };
+	enum BufferTarget { BUF_ARRAY, BUF_ELEMENT_ARRAY, BUF_UNIFORM, BUF_TEXTURE, BUF_SHADER_STORAGE, BUF_PIXEL_UNPACK, BUF_DRAW_INDIRECT, BUF_TARGET_NUM };
+	enum IndexedTarget { BASE_UNIFORM, BASE_SHADER_STORAGE, BASE_TARGET_NUM };
+	enum Capability { CAP_BLEND, CAP_DEPTH_TEST, CAP_STENCIL_TEST, CAP_CULL_FACE, CAP_SCISSOR_TEST, CAP_MULTISAMPLE, CAP_FRAMEBUFFER_SRGB, CAP_POLYGON_OFFSET_FILL, CAP_TEXTURE_CUBE_MAP_SEAMLESS, CAP_NUM };
+
+	GLStateCache() { Invalidate(); }
+	GLStateCache(const GLStateCache&) = delete;
+	GLStateCache& operator=(const GLStateCache&) = delete;
+
+	static int textureTargetIndex(GLenum target);
+	static int bufferTargetIndex(GLenum target);
+	static int indexedTargetIndex(GLenum target);
+	static int capabilityIndex(GLenum cap);
+
+	//true when the call has to reach GL, false when it was filtered
+	bool changed(GLuint& cached, GLuint value)
+	{
+		if (cached == value)
+		{
+			++stats.skipped;
+			return false;
+		}
+		cached = value;
+		++stats.issued;
+		return true;
+	}
+
+private:
+	Stats stats;
+
+	GLuint program;
+	GLuint vao;
+	GLuint buffers[BUF_TARGET_NUM];
+	GLuint bufferBases[BASE_TARGET_NUM][MAX_BUFFER_BINDINGS];
+	GLuint activeUnit;
+	GLuint textures[MAX_TEXTURE_UNITS][TEX_TARGET_NUM];
+	GLuint drawFramebuffer;
+	GLuint readFramebuffer;
+	GLuint renderbuffer;
+	GLuint defaultFramebuffer = 0;
+
+	GLuint caps[CAP_NUM];
+	GLuint blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha;
+	GLuint depthFunc;
+	GLuint depthMask;
+	GLuint colorMask;
+	GLuint stencilFunc, stencilRef, stencilFuncMask;
+	GLuint stencilSFail, stencilDPFail, stencilDPPass;
+	GLuint stencilMask;
+	GLuint cullFace;
+	GLuint frontFace;
+	GLint viewport[4];
+	GLfloat clearColor[4];
+	bool viewportKnown;
+	bool clearColorKnown;
+};
+
+inline void GLStateCache::Invalidate()
+{
+	program = vao = UNKNOWN;
+	for (GLuint& b : buffers)
+		b = UNKNOWN;
+	for (auto& target : bufferBases)
+		for (GLuint& b : target)
+			b = UNKNOWN;
+	activeUnit = UNKNOWN;
+	for (auto& unit : textures)
+		for (GLuint& t : unit)
+			t = UNKNOWN;
+	drawFramebuffer = readFramebuffer = renderbuffer = UNKNOWN;
+
+	for (GLuint& c : caps)
+		c = UNKNOWN;
+	blendSrcRGB = blendDstRGB = blendSrcAlpha = blendDstAlpha = UNKNOWN;
+	depthFunc = depthMask = colorMask = UNKNOWN;
+	stencilFunc = stencilRef = stencilFuncMask = UNKNOWN;
+	stencilSFail = stencilDPFail = stencilDPPass = UNKNOWN;
+	stencilMask = UNKNOWN;
+	cullFace = frontFace = UNKNOWN;
+	viewportKnown = false;
+	clearColorKnown = false;
+}
+
+inline void GLStateCache::UseProgram(GLuint p)
+{
+	if (changed(program, p))
+		glUseProgram(p);
+}
+
+inline void GLStateCache::BindVertexArray(GLuint v)
+{
+	if (changed(vao, v))
+	{
+		glBindVertexArray(v);
+		//the element array binding is vao state
+		buffers[BUF_ELEMENT_ARRAY] = UNKNOWN;
+	}
+}
+
+inline void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	int index = bufferTargetIndex(target);
+	if (index < 0)
+	{
+		++stats.issued;
+		glBindBuffer(target, buffer);
+		return;
+	}
+	if (changed(buffers[index], buffer))
+		glBindBuffer(target, buffer);
+}
+
+inline void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	int indexed = indexedTargetIndex(target);
+	if (indexed >= 0 && index < MAX_BUFFER_BINDINGS && !changed(bufferBases[indexed][index], buffer))
+		return;
+	if (indexed < 0 || index >= MAX_BUFFER_BINDINGS)
+		++stats.issued;
+	glBindBufferBase(target, index, buffer);
+	int generic = bufferTargetIndex(target);
+	if (generic >= 0)
+		buffers[generic] = buffer;
+}
+
+inline void GLStateCache::ActiveTexture(GLenum unit)
+{
+	if (changed(activeUnit, unit - GL_TEXTURE0))
+		glActiveTexture(unit);
+}
+
+inline void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+	int index = textureTargetIndex(target);
+	if (index < 0 || activeUnit >= MAX_TEXTURE_UNITS)
+	{
+		++stats.issued;
+		glBindTexture(target, texture);
+		return;
+	}
+	if (changed(textures[activeUnit][index], texture))
+		glBindTexture(target, texture);
+}
+
+inline void GLStateCache::BindTextureUnit(GLuint unit, GLenum target, GLuint texture)
+{
+	int index = textureTargetIndex(target);
+	if (index >= 0 && unit < MAX_TEXTURE_UNITS && textures[unit][index] == texture)
+	{
+		++stats.skipped;
+		return;
+	}
+	ActiveTexture(GL_TEXTURE0 + unit);
+	BindTexture(target, texture);
+}
+
+inline void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	if (framebuffer == 0)
+		framebuffer = defaultFramebuffer;
+
+	switch (target)
+	{
+	case GL_DRAW_FRAMEBUFFER:
+		if (changed(drawFramebuffer, framebuffer))
+			glBindFramebuffer(target, framebuffer);
+		break;
+	case GL_READ_FRAMEBUFFER:
+		if (changed(readFramebuffer, framebuffer))
+			glBindFramebuffer(target, framebuffer);
+		break;
+	default:
+		if (drawFramebuffer == framebuffer && readFramebuffer == framebuffer)
+		{
+			++stats.skipped;
+			return;
+		}
+		drawFramebuffer = readFramebuffer = framebuffer;
+		++stats.issued;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		break;
+	}
+}
+
+inline void GLStateCache::BindRenderbuffer(GLuint rb)
+{
+	if (changed(renderbuffer, rb))
+		glBindRenderbuffer(GL_RENDERBUFFER, rb);
+}
+
+inline void GLStateCache::DeleteProgram(GLuint p)
+{
+	if (program == p)
+		program = UNKNOWN;
+	glDeleteProgram(p);
+}
+
+inline void GLStateCache::DeleteVertexArray(GLuint v)
+{
+	if (vao == v)
+	{
+		vao = UNKNOWN;
+		buffers[BUF_ELEMENT_ARRAY] = UNKNOWN;
+	}
+	glDeleteVertexArrays(1, &v);
+}
+
+inline void GLStateCache::DeleteBuffer(GLuint buffer)
+{
+	for (GLuint& b : buffers)
+		if (b == buffer)
+			b = UNKNOWN;
+	for (auto& target : bufferBases)
+		for (GLuint& b : target)
+			if (b == buffer)
+				b = UNKNOWN;
+	glDeleteBuffers(1, &buffer);
+}
+
+inline void GLStateCache::DeleteTexture(GLuint texture)
+{
+	for (auto& unit : textures)
+		for (GLuint& t : unit)
+			if (t == texture)
+				t = UNKNOWN;
+	glDeleteTextures(1, &texture);
+}
+
+inline void GLStateCache::DeleteFramebuffer(GLuint framebuffer)
+{
+	if (drawFramebuffer == framebuffer)
+		drawFramebuffer = UNKNOWN;
+	if (readFramebuffer == framebuffer)
+		readFramebuffer = UNKNOWN;
+	glDeleteFramebuffers(1, &framebuffer);
+}
+
+inline void GLStateCache::DeleteRenderbuffer(GLuint rb)
+{
+	if (renderbuffer == rb)
+		renderbuffer = UNKNOWN;
+	glDeleteRenderbuffers(1, &rb);
+}
+
+inline void GLStateCache::SetEnabled(GLenum cap, bool enabled)
+{
+	int index = capabilityIndex(cap);
+	if (index >= 0 && !changed(caps[index], enabled ? 1u : 0u))
+		return;
+	if (index < 0)
+		++stats.issued;
+
+	if (enabled)
+		glEnable(cap);
+	else
+		glDisable(cap);
+}
+
+inline void GLStateCache::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+	if (blendSrcRGB == srcRGB && blendDstRGB == dstRGB && blendSrcAlpha == srcAlpha && blendDstAlpha == dstAlpha)
+	{
+		++stats.skipped;
+		return;
+	}
+	blendSrcRGB = srcRGB;
+	blendDstRGB = dstRGB;
+	blendSrcAlpha = srcAlpha;
+	blendDstAlpha = dstAlpha;
+	++stats.issued;
+	glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+inline void GLStateCache::DepthFunc(GLenum func)
+{
+	if (changed(depthFunc, func))
+		glDepthFunc(func);
+}
+
+inline void GLStateCache::DepthMask(GLboolean flag)
+{
+	if (changed(depthMask, flag))
+		glDepthMask(flag);
+}
+
+inline void GLStateCache::ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+{
+	GLuint packed = (r ? 1u : 0u) | (g ? 2u : 0u) | (b ? 4u : 0u) | (a ? 8u : 0u);
+	if (changed(colorMask, packed))
+		glColorMask(r, g, b, a);
+}
+
+inline void GLStateCache::StencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+	if (stencilFunc == func && stencilRef == (GLuint)ref && stencilFuncMask == mask)
+	{
+		++stats.skipped;
+		return;
+	}
+	stencilFunc = func;
+	stencilRef = (GLuint)ref;
+	stencilFuncMask = mask;
+	++stats.issued;
+	glStencilFunc(func, ref, mask);
+}
+
+inline void GLStateCache::StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	if (stencilSFail == sfail && stencilDPFail == dpfail && stencilDPPass == dppass)
+	{
+		++stats.skipped;
+		return;
+	}
+	stencilSFail = sfail;
+	stencilDPFail = dpfail;
+	stencilDPPass = dppass;
+	++stats.issued;
+	glStencilOp(sfail, dpfail, dppass);
+}
+
+inline void GLStateCache::StencilMask(GLuint mask)
+{
+	if (changed(stencilMask, mask))
+		glStencilMask(mask);
+}
+
+inline void GLStateCache::CullFace(GLenum mode)
+{
+	if (changed(cullFace, mode))
+		glCullFace(mode);
+}
+
+inline void GLStateCache::FrontFace(GLenum mode)
+{
+	if (changed(frontFace, mode))
+		glFrontFace(mode);
+}
+
+inline void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (viewportKnown && viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+	{
+		++stats.skipped;
+		return;
+	}
+	viewport[0] = x;
+	viewport[1] = y;
+	viewport[2] = width;
+	viewport[3] = height;
+	viewportKnown = true;
+	++stats.issued;
+	glViewport(x, y, width, height);
+}
+
+inline void GLStateCache::ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+	if (clearColorKnown && clearColor[0] == r && clearColor[1] == g && clearColor[2] == b && clearColor[3] == a)
+	{
+		++stats.skipped;
+		return;
+	}
+	clearColor[0] = r;
+	clearColor[1] = g;
+	clearColor[2] = b;
+	clearColor[3] = a;
+	clearColorKnown = true;
+	++stats.issued;
+	glClearColor(r, g, b, a);
+}
+
+inline int GLStateCache::textureTargetIndex(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D: return TEX_2D;
+	case GL_TEXTURE_2D_ARRAY: return TEX_2D_ARRAY;
+	case GL_TEXTURE_CUBE_MAP: return TEX_CUBE_MAP;
+	case GL_TEXTURE_BUFFER: return TEX_BUFFER;
+	case GL_TEXTURE_2D_MULTISAMPLE: return TEX_2D_MULTISAMPLE;
+	default: return -1;
+	}
+}
+
+inline int GLStateCache::bufferTargetIndex(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return BUF_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER: return BUF_ELEMENT_ARRAY;
+	case GL_UNIFORM_BUFFER: return BUF_UNIFORM;
+	case GL_TEXTURE_BUFFER: return BUF_TEXTURE;
+	case GL_SHADER_STORAGE_BUFFER: return BUF_SHADER_STORAGE;
+	case GL_PIXEL_UNPACK_BUFFER: return BUF_PIXEL_UNPACK;
+	case GL_DRAW_INDIRECT_BUFFER: return BUF_DRAW_INDIRECT;
+	default: return -1;
+	}
+}
+
+inline int GLStateCache::indexedTargetIndex(GLenum target)
+{
+	switch (target)
+	{
+	case GL_UNIFORM_BUFFER: return BASE_UNIFORM;
+	case GL_SHADER_STORAGE_BUFFER: return BASE_SHADER_STORAGE;
+	default: return -1;
+	}
+}
+
+inline int GLStateCache::capabilityIndex(GLenum cap)
+{
+	switch (cap)
+	{
+	case GL_BLEND: return CAP_BLEND;
+	case GL_DEPTH_TEST: return CAP_DEPTH_TEST;
+	case GL_STENCIL_TEST: return CAP_STENCIL_TEST;
+	case GL_CULL_FACE: return CAP_CULL_FACE;
+	case GL_SCISSOR_TEST: return CAP_SCISSOR_TEST;
+	case GL_MULTISAMPLE: return CAP_MULTISAMPLE;
+	case GL_FRAMEBUFFER_SRGB: return CAP_FRAMEBUFFER_SRGB;
+	case GL_POLYGON_OFFSET_FILL: return CAP_POLYGON_OFFSET_FILL;
+	case GL_TEXTURE_CUBE_MAP_SEAMLESS: return CAP_TEXTURE_CUBE_MAP_SEAMLESS;
+	default: return -1;
+	}
+}
@@ -0,0 +1,814 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "GLInterceptor.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+//GL command trace: --gl-trace=file.gltrace [--gl-trace-start=frame] [--gl-trace-frames=N] records every GL call the
+//demo makes, with the data behind its pointers, to a binary file that TraceReplay runs again without the demo or
+//its assets. Capture() hooks every entry point glad loaded, the way GLInterceptor does, and has to run right after
+//glad is loaded so the trace sees every object the frames use. Calls before the start frame are recorded minus
+//draws, clears, dispatches, blits, queries and reads, so the replay builds the same resources and state without
+//drawing the frames in between; then N frames are recorded whole, EndFrame() (Benchmark calls it) closes each.
+//What a call's pointers carry comes from GLTraceArgs.h and buildRules(): buffer and texture data from client memory
+//(an offset into a bound unpack buffer stays an offset), uniform values, shader sources, strings and name arrays.
+//Names the driver hands out (glGen*, glCreate*), uniform locations and block indices are kept so the replay can
+//map them to its own. Writes through mapped buffers are recorded at unmap, at an explicit flush, and for persistent
+//mappings as the bytes that changed, before every draw and at the end of the frame.
+//Calls the trace cannot size the pointers of (glGetTexImage, glTransformFeedbackVaryings, debug callbacks...) still
+//reach the driver but only their name is recorded, the replay reports them. Functions loaded outside glad (see
+//BindlessTextures) are not seen.
+class GLTrace
+{
+public:
+	struct Settings
+	{
+		std::string file;		// no trace when empty
+		int startFrame = 0;
+		int frames = 1;
+	};
+
+	static Settings ParseArgs(int argc, char** argv);
+
+	static void Capture(const Settings& traceSettings);
+	static bool Capturing() { return state().out.is_open(); }
+	static void EndFrame();
+
+private:
+	friend class GLTraceReplay;
+	template<int Id, typename F> friend struct GLTraceHook;
+	template<int Id, typename F> friend struct GLTraceReplayHook;
+	template<typename R> friend struct GLTraceResult;
+
+	//file: u32 magic, u32 version, then u64 width, height, default framebuffer, start frame, frames and the renderer
+	//as a blob, then records. Everything is 8 byte aligned.
+	//record: u16 entry point or Record, u16 0, u32 payload bytes, payload
+	//call payload: a u64 per argument (integers sign extended, floats by their bits, pointers as addresses), the blobs
+	//of the arguments that carry data in argument order, the return value as a u64, then the blobs of generated names
+	//blob: u32 bytes or NO_BLOB for a null pointer or a buffer offset, u32 0, the bytes padded to 8
+	//MAPPED_DATA: u64 buffer, u64 offset into it, u64 bytes, the bytes. SKIPPED: u64 entry point
+	static const uint32_t FILE_MAGIC = 0x52544C47;		// "GLTR"
+	static const uint32_t FILE_VERSION = 2;		// 2: name arrays are recorded
+	static const uint32_t NO_BLOB = 0xFFFFFFFF;
+	static const int MAX_ARGS = 16;
+
+	enum Record : uint16_t
+	{
+		SETUP_END = 0xFFFC,
+		SKIPPED = 0xFFFD,
+		MAPPED_DATA = 0xFFFE,
+		FRAME_END = 0xFFFF
+	};
+
+	enum NameKind : uint8_t
+	{
+		BUFFER,
+		TEXTURE,
+		FRAMEBUFFER,
+		RENDERBUFFER,
+		VERTEX_ARRAY,
+		PROGRAM,		// shaders too, they share the namespace
+		PIPELINE,
+		SAMPLER,
+		QUERY,
+		TRANSFORM_FEEDBACK,
+		NAME_KIND_COUNT
+	};
+
+	enum ArgKind : uint8_t
+	{
+		ARG_VALUE,			// passed as is, a pointer without a rule cannot be recorded
+		ARG_NAME,			// detail is the NameKind
+		ARG_NAMES,			// count is the element count argument, detail the NameKind
+		ARG_GEN,
+		ARG_LOCATION,		// count is the program argument, -1 for the program in use
+		ARG_BLOCK,
+		ARG_DRAW_BUFFER,	// GL_BACK and friends, the replay may draw to a framebuffer object instead
+		ARG_UNIFORM,		// count is the element count argument or -1, detail the bytes per element
+		ARG_STRING,			// count is the length argument or -1
+		ARG_ARRAY,			// count is the element count argument, detail the bytes per element
+		ARG_BYTES,			// count is the size argument, detail UNPACK when it can be an unpack buffer offset
+		ARG_PIXELS,			// sized by the entry's pixel arguments and the unpack state, detail as for bytes
+		ARG_SHADER_SOURCE,
+		ARG_CLEAR_VALUE,	// count is the buffer argument, GL_COLOR takes four values
+		ARG_OFFSET,			// an offset into a bound buffer
+		ARG_OUT,
+		ARG_OUT_BYTES,		// count is the size argument
+		ARG_OUT_PIXELS,		// sized like pixels, by the pack state
+		ARG_IGNORED,		// glShaderSource's lengths, the source is recorded joined
+		ARG_UNSUPPORTED
+	};
+
+	enum : uint8_t
+	{
+		UNPACK = 1
+	};
+
+	enum EntryFlag : uint8_t
+	{
+		ELIDED = 1,		// not recorded before the start frame
+		WORK = 2		// draws and dispatches, persistent mappings are recorded before them
+	};
+
+	struct ArgRule
+	{
+		uint8_t kind = ARG_VALUE;
+		uint8_t detail = 0;
+		int8_t count = -1;
+	};
+
+	struct EntryRule
+	{
+		ArgRule args[MAX_ARGS];
+		int8_t pixels[5] = { -1, -1, -1, -1, -1 };		// width, height, depth, format and type arguments
+		uint8_t returnName = NAME_KIND_COUNT;
+		uint8_t flags = 0;
+	};
+
+	struct Mapping
+	{
+		GLintptr offset = 0;
+		GLsizeiptr length = 0;
+		GLbitfield access = 0;
+		char* pointer = nullptr;
+		std::vector<char> shadow;		// persistent mappings, the contents the trace holds so far
+	};
+
+	struct PixelStore
+	{
+		GLint alignment = 4;
+		GLint rowLength = 0;
+		GLint imageHeight = 0;
+	};
+
+	struct CaptureState
+	{
+		Settings settings;
+		std::ofstream out;
+		std::vector<char> record;
+		std::vector<char> scratch;
+		int frame = 0;
+		uint64_t bytes = 0;
+		uint64_t calls = 0;
+		uint64_t skipped = 0;
+		std::unordered_map<GLenum, GLuint> buffers;		// bound per target
+		std::unordered_map<GLuint, Mapping> mappings;	// written through, per buffer
+		PixelStore unpack;
+		PixelStore pack;
+	};
+
+	static CaptureState& state() { static CaptureState s; return s; }
+	static EntryRule* rules() { static EntryRule r[GLInterceptor::ENTRY_POINT_COUNT]; return r; }
+	static void buildRules();
+	static bool inputBlob(uint8_t kind) { return kind == ARG_NAMES || (kind >= ARG_UNIFORM && kind <= ARG_CLEAR_VALUE); }
+	static uint64_t imageBytes(const EntryRule& rule, const int64_t* values, const PixelStore& store);
+
+	static void putU64(std::vector<char>& to, uint64_t value) { to.insert(to.end(), (const char*)&value, (const char*)&value + 8); }
+	static void putBlob(std::vector<char>& to, const void* data, uint64_t size);
+	static void beginRecord(std::vector<char>& to, uint16_t id);
+	static void writeRecord(std::vector<char>& record);
+
+	static bool recording(int id);
+	static bool beginCall(int id, int argc, const int64_t* values, const void* const* pointers, const bool* isPointer);
+	static void endCall(int id, int argc, const int64_t* values, const void* const* pointers, int64_t result);
+	static void observe(int id, const int64_t* values);
+	static void mapped(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access, void* pointer);
+	static void writeMapped(GLuint buffer, uint64_t offset, const char* data, uint64_t size);
+	//records what changed in a persistent mapping since the last time
+	static void writeChanges(GLuint buffer, Mapping& mapping);
+	static void writePersistent();
+	static void finish();
+
+	template<typename T> static int64_t asValue(T value, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr) { return (int64_t)value; }
+	static int64_t asValue(float value) { uint32_t bits; std::memcpy(&bits, &value, 4); return bits; }
+	static int64_t asValue(double value) { int64_t bits; std::memcpy(&bits, &value, 8); return bits; }
+	template<typename T> static int64_t asValue(T* value) { return (int64_t)(intptr_t)value; }
+	template<typename T> static const void* asPointer(T* value) { return (const void*)value; }
+	template<typename T> static const void* asPointer(T) { return nullptr; }
+};
+
+//the call and its result, void has none
+template<typename R> struct GLTraceResult
+{
+	R value;
+
+	template<typename F, typename... A> void Call(F function, A... args) { value = function(args...); }
+	R Get() const { return value; }
+	int64_t Bits() const { return GLTrace::asValue(value); }
+};
+
+template<> struct GLTraceResult<void>
+{
+	template<typename F, typename... A> void Call(F function, A... args) { function(args...); }
+	void Get() const {}
+	int64_t Bits() const { return 0; }
+};
+
+//one instance per entry point: Capture records the call and forwards to the driver's pointer kept in next
+template<int Id, typename F> struct GLTraceHook;
+
+template<int Id, typename R, typename... A>
+struct GLTraceHook<Id, R (APIENTRYP)(A...)>
+{
+	static R (APIENTRYP next)(A...);
+
+	static R APIENTRY Capture(A... args)
+	{
+		if (!GLTrace::recording(Id))
+			return next(args...);
+
+		//sync objects are handles, not data
+		static const bool isPointer[] = { (std::is_pointer<A>::value && !std::is_same<A, GLsync>::value)..., false };
+		const int64_t values[] = { GLTrace::asValue(args)..., 0 };
+		const void* pointers[] = { GLTrace::asPointer(args)..., nullptr };
+		if (!GLTrace::beginCall(Id, sizeof...(A), values, pointers, isPointer))
+			return next(args...);
+
+		GLTraceResult<R> result;
+		result.Call(next, args...);
+		GLTrace::endCall(Id, sizeof...(A), values, pointers, result.Bits());
+		return result.Get();
+	}
+};
+
+template<int Id, typename R, typename... A>
+R (APIENTRYP GLTraceHook<Id, R (APIENTRYP)(A...)>::next)(A...) = nullptr;
+
+//the driver's entry point, for the calls the trace makes itself
+#define GL_TRACE_NEXT(name) GLTraceHook<GLInterceptor::EP_##name, decltype(glad_##name)>::next
+
+inline GLTrace::Settings GLTrace::ParseArgs(int argc, char** argv)
+{
+	Settings result;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 11, "--gl-trace=") == 0)
+			result.file = arg.substr(11);
+		else if (arg.compare(0, 17, "--gl-trace-start=") == 0)
+			result.startFrame = std::max(std::atoi(arg.c_str() + 17), 0);
+		else if (arg.compare(0, 18, "--gl-trace-frames=") == 0)
+			result.frames = std::max(std::atoi(arg.c_str() + 18), 1);
+	}
+	return result;
+}
+
+inline void GLTrace::Capture(const Settings& traceSettings)
+{
+	CaptureState& s = state();
+	if (traceSettings.file.empty() || s.out.is_open())
+		return;
+
+	s.settings = traceSettings;
+	s.out.open(s.settings.file, std::ios::binary | std::ios::trunc);
+	if (!s.out)
+	{
+		std::cout << "Error: could not write GL trace " << s.settings.file << std::endl;
+		return;
+	}
+	buildRules();
+
+	//the header is read before the hooks go in, these calls are not part of the trace
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	const char* renderer = (const char*)glGetString(GL_RENDERER);
+	std::vector<char> header;
+	uint32_t magic = FILE_MAGIC, version = FILE_VERSION;
+	header.insert(header.end(), (const char*)&magic, (const char*)&magic + 4);
+	header.insert(header.end(), (const char*)&version, (const char*)&version + 4);
+	putU64(header, viewport[2]);
+	putU64(header, viewport[3]);
+	putU64(header, GLStateCache::Get().DefaultFramebuffer());
+	putU64(header, s.settings.startFrame);
+	putU64(header, s.settings.frames);
+	putBlob(header, renderer ? renderer : "", renderer ? std::strlen(renderer) : 0);
+	s.out.write(header.data(), header.size());
+	s.bytes = header.size();
+
+#define GL_ENTRY_POINT(name) \
+	if (glad_##name) \
+	{ \
+		GLTraceHook<GLInterceptor::EP_##name, decltype(glad_##name)>::next = glad_##name; \
+		glad_##name = GLTraceHook<GLInterceptor::EP_##name, decltype(glad_##name)>::Capture; \
+	}
+#include "GLEntryPoints.h"
+#undef GL_ENTRY_POINT
+
+	if (s.settings.startFrame == 0)
+	{
+		beginRecord(s.record, SETUP_END);
+		writeRecord(s.record);
+	}
+	std::cout << "GL trace: recording " << s.settings.frames << " frames from frame " << s.settings.startFrame
+		<< " to " << s.settings.file << std::endl;
+}
+
+inline void GLTrace::EndFrame()
+{
+	CaptureState& s = state();
+	if (!s.out.is_open())
+		return;
+
+	writePersistent();
+	if (s.frame >= s.settings.startFrame)
+	{
+		beginRecord(s.record, FRAME_END);
+		writeRecord(s.record);
+	}
+	++s.frame;
+	if (s.frame == s.settings.startFrame)
+	{
+		beginRecord(s.record, SETUP_END);
+		writeRecord(s.record);
+	}
+	if (s.frame >= s.settings.startFrame + s.settings.frames)
+		finish();
+}
+
+inline void GLTrace::finish()
+{
+	CaptureState& s = state();
+	s.out.close();
+	s.mappings.clear();
+	std::cout << "GL trace: wrote " << s.settings.frames << " frames, " << s.calls << " calls, "
+		<< s.bytes / (1024.0 * 1024.0) << " MB to " << s.settings.file << std::endl;
+	if (s.skipped)
+		std::cout << "GL trace: " << s.skipped << " calls could not be recorded, the replay lists them" << std::endl;
+}
+
+inline void GLTrace::buildRules()
+{
+	static bool built = false;
+	if (built)
+		return;
+	built = true;
+
+	EntryRule* r = rules();
+	auto arg = [r](int id, int index, uint8_t kind, int count = -1, uint8_t detail = 0)
+	{
+		ArgRule& rule = r[id].args[index];
+		rule.kind = kind;
+		rule.count = (int8_t)count;
+		rule.detail = detail;
+	};
+
+#define GL_TRACE_NAME(entry, index, kind) arg(GLInterceptor::EP_##entry, index, ARG_NAME, -1, kind);
+#define GL_TRACE_NAMES(entry, index, countArg, kind) arg(GLInterceptor::EP_##entry, index, ARG_NAMES, countArg, kind);
+#define GL_TRACE_GEN(entry, index, countArg, kind) arg(GLInterceptor::EP_##entry, index, ARG_GEN, countArg, kind);
+#define GL_TRACE_RETURN_NAME(entry, kind) r[GLInterceptor::EP_##entry].returnName = kind;
+#define GL_TRACE_LOCATION(entry, index, programArg) arg(GLInterceptor::EP_##entry, index, ARG_LOCATION, programArg);
+#define GL_TRACE_BLOCK(entry, index, programArg) arg(GLInterceptor::EP_##entry, index, ARG_BLOCK, programArg);
+#define GL_TRACE_UNIFORM(entry, index) \
+	{ \
+		GLInterceptor::UniformLayout layout = GLInterceptor::uniformLayout(#entry); \
+		arg(GLInterceptor::EP_##entry, index, ARG_UNIFORM, layout.countArg, (uint8_t)layout.bytes); \
+	}
+#define GL_TRACE_STRING(entry, index, lengthArg) arg(GLInterceptor::EP_##entry, index, ARG_STRING, lengthArg);
+#define GL_TRACE_ARRAY(entry, index, countArg, bytes) arg(GLInterceptor::EP_##entry, index, ARG_ARRAY, countArg, bytes);
+#define GL_TRACE_OUT(entry, index) arg(GLInterceptor::EP_##entry, index, ARG_OUT);
+#include "GLTraceArgs.h"
+#undef GL_TRACE_NAME
+#undef GL_TRACE_NAMES
+#undef GL_TRACE_GEN
+#undef GL_TRACE_RETURN_NAME
+#undef GL_TRACE_LOCATION
+#undef GL_TRACE_BLOCK
+#undef GL_TRACE_UNIFORM
+#undef GL_TRACE_STRING
+#undef GL_TRACE_ARRAY
+#undef GL_TRACE_OUT
+
+	//what the parameter names do not tell
+#define GL_TRACE_RULE(entry, index, kind, count, detail) arg(GLInterceptor::EP_##entry, index, kind, count, detail);
+#define GL_TRACE_PIXELS(entry, index, kind, detail, width, height, depth, format, type) \
+	{ \
+		arg(GLInterceptor::EP_##entry, index, kind, -1, detail); \
+		int8_t pixels[5] = { width, height, depth, format, type }; \
+		std::copy(pixels, pixels + 5, r[GLInterceptor::EP_##entry].pixels); \
+	}
+	GL_TRACE_RULE(glBufferData, 2, ARG_BYTES, 1, 0)
+	GL_TRACE_RULE(glBufferSubData, 3, ARG_BYTES, 2, 0)
+	GL_TRACE_RULE(glBufferStorage, 2, ARG_BYTES, 1, 0)
+	GL_TRACE_RULE(glNamedBufferData, 2, ARG_BYTES, 1, 0)
+	GL_TRACE_RULE(glNamedBufferSubData, 3, ARG_BYTES, 2, 0)
+	GL_TRACE_RULE(glNamedBufferStorage, 2, ARG_BYTES, 1, 0)
+	GL_TRACE_RULE(glGetBufferSubData, 3, ARG_OUT_BYTES, 2, 0)
+	GL_TRACE_RULE(glGetNamedBufferSubData, 3, ARG_OUT_BYTES, 2, 0)
+	GL_TRACE_RULE(glShaderBinary, 3, ARG_BYTES, 4, 0)
+	GL_TRACE_RULE(glProgramBinary, 2, ARG_BYTES, 3, 0)
+
+	GL_TRACE_PIXELS(glTexImage1D, 7, ARG_PIXELS, UNPACK, 3, -1, -1, 5, 6)
+	GL_TRACE_PIXELS(glTexImage2D, 8, ARG_PIXELS, UNPACK, 3, 4, -1, 6, 7)
+	GL_TRACE_PIXELS(glTexImage3D, 9, ARG_PIXELS, UNPACK, 3, 4, 5, 7, 8)
+	GL_TRACE_PIXELS(glTexSubImage1D, 6, ARG_PIXELS, UNPACK, 3, -1, -1, 4, 5)
+	GL_TRACE_PIXELS(glTexSubImage2D, 8, ARG_PIXELS, UNPACK, 4, 5, -1, 6, 7)
+	GL_TRACE_PIXELS(glTexSubImage3D, 10, ARG_PIXELS, UNPACK, 5, 6, 7, 8, 9)
+	GL_TRACE_PIXELS(glTextureSubImage1D, 6, ARG_PIXELS, UNPACK, 3, -1, -1, 4, 5)
+	GL_TRACE_PIXELS(glTextureSubImage2D, 8, ARG_PIXELS, UNPACK, 4, 5, -1, 6, 7)
+	GL_TRACE_PIXELS(glTextureSubImage3D, 10, ARG_PIXELS, UNPACK, 5, 6, 7, 8, 9)
+	GL_TRACE_RULE(glCompressedTexImage1D, 6, ARG_BYTES, 5, UNPACK)
+	GL_TRACE_RULE(glCompressedTexImage2D, 7, ARG_BYTES, 6, UNPACK)
+	GL_TRACE_RULE(glCompressedTexImage3D, 8, ARG_BYTES, 7, UNPACK)
+	GL_TRACE_RULE(glCompressedTexSubImage1D, 6, ARG_BYTES, 5, UNPACK)
+	GL_TRACE_RULE(glCompressedTexSubImage2D, 8, ARG_BYTES, 7, UNPACK)
+	GL_TRACE_RULE(glCompressedTexSubImage3D, 10, ARG_BYTES, 9, UNPACK)
+	GL_TRACE_RULE(glCompressedTextureSubImage1D, 6, ARG_BYTES, 5, UNPACK)
+	GL_TRACE_RULE(glCompressedTextureSubImage2D, 8, ARG_BYTES, 7, UNPACK)
+	GL_TRACE_RULE(glCompressedTextureSubImage3D, 10, ARG_BYTES, 9, UNPACK)
+	//clear values are one pixel of client memory
+	GL_TRACE_PIXELS(glClearBufferData, 4, ARG_PIXELS, 0, -1, -1, -1, 2, 3)
+	GL_TRACE_PIXELS(glClearBufferSubData, 6, ARG_PIXELS, 0, -1, -1, -1, 4, 5)
+	GL_TRACE_PIXELS(glClearNamedBufferData, 4, ARG_PIXELS, 0, -1, -1, -1, 2, 3)
+	GL_TRACE_PIXELS(glClearNamedBufferSubData, 6, ARG_PIXELS, 0, -1, -1, -1, 4, 5)
+	GL_TRACE_PIXELS(glClearTexImage, 4, ARG_PIXELS, 0, -1, -1, -1, 2, 3)
+	GL_TRACE_PIXELS(glClearTexSubImage, 10, ARG_PIXELS, 0, -1, -1, -1, 8, 9)
+
+	GL_TRACE_PIXELS(glReadPixels, 6, ARG_OUT_PIXELS, 0, 2, 3, -1, 4, 5)
+	GL_TRACE_RULE(glReadnPixels, 7, ARG_OUT_BYTES, 6, 0)
+	GL_TRACE_RULE(glGetnTexImage, 5, ARG_OUT_BYTES, 4, 0)
+	GL_TRACE_RULE(glGetTextureImage, 5, ARG_OUT_BYTES, 4, 0)
+	GL_TRACE_RULE(glGetTextureSubImage, 11, ARG_OUT_BYTES, 10, 0)
+	GL_TRACE_RULE(glGetnCompressedTexImage, 3, ARG_OUT_BYTES, 2, 0)
+	GL_TRACE_RULE(glGetCompressedTextureImage, 3, ARG_OUT_BYTES, 2, 0)
+	GL_TRACE_RULE(glGetCompressedTextureSubImage, 9, ARG_OUT_BYTES, 8, 0)
+	//sized by the texture level, which the trace does not follow
+	GL_TRACE_RULE(glGetTexImage, 4, ARG_UNSUPPORTED, -1, 0)
+	GL_TRACE_RULE(glGetCompressedTexImage, 2, ARG_UNSUPPORTED, -1, 0)
+
+	GL_TRACE_RULE(glVertexAttribPointer, 5, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glVertexAttribIPointer, 4, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glVertexAttribLPointer, 4, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElements, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsInstanced, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsBaseVertex, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsInstancedBaseVertex, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsInstancedBaseInstance, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsInstancedBaseVertexBaseInstance, 3, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawRangeElements, 5, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawRangeElementsBaseVertex, 5, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawArraysIndirect, 1, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glDrawElementsIndirect, 2, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glMultiDrawArraysIndirect, 1, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glMultiDrawElementsIndirect, 2, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glMultiDrawArraysIndirectCount, 1, ARG_OFFSET, -1, 0)
+	GL_TRACE_RULE(glMultiDrawElementsIndirectCount, 2, ARG_OFFSET, -1, 0)
+
+	GL_TRACE_RULE(glClearBufferiv, 2, ARG_CLEAR_VALUE, 0, 0)
+	GL_TRACE_RULE(glClearBufferuiv, 2, ARG_CLEAR_VALUE, 0, 0)
+	GL_TRACE_RULE(glClearBufferfv, 2, ARG_CLEAR_VALUE, 0, 0)
+	GL_TRACE_RULE(glClearNamedFramebufferiv, 3, ARG_CLEAR_VALUE, 1, 0)
+	GL_TRACE_RULE(glClearNamedFramebufferuiv, 3, ARG_CLEAR_VALUE, 1, 0)
+	GL_TRACE_RULE(glClearNamedFramebufferfv, 3, ARG_CLEAR_VALUE, 1, 0)
+
+	GL_TRACE_RULE(glShaderSource, 2, ARG_SHADER_SOURCE, 1, 0)
+	GL_TRACE_RULE(glShaderSource, 3, ARG_IGNORED, -1, 0)
+
+	GL_TRACE_RULE(glDrawBuffer, 0, ARG_DRAW_BUFFER, -1, 0)
+	GL_TRACE_RULE(glReadBuffer, 0, ARG_DRAW_BUFFER, -1, 0)
+	GL_TRACE_RULE(glNamedFramebufferDrawBuffer, 1, ARG_DRAW_BUFFER, 0, 0)
+	GL_TRACE_RULE(glNamedFramebufferReadBuffer, 1, ARG_DRAW_BUFFER, 0, 0)
+#undef GL_TRACE_RULE
+#undef GL_TRACE_PIXELS
+
+	for (int id = 0; id < GLInterceptor::ENTRY_POINT_COUNT; ++id)
+	{
+		const char* name = GLInterceptor::Name(id);
+		if (std::strncmp(name, "glDraw", 6) == 0 || std::strncmp(name, "glMultiDraw", 11) == 0 || std::strncmp(name, "glDispatch", 10) == 0)
+			r[id].flags |= ELIDED | WORK;
+
+		//the frame's work and reads of its results, not state the later frames build on
+		static const char* elided[] = { "glClear", "glClearBufferiv", "glClearBufferuiv", "glClearBufferfv", "glClearBufferfi",
+			"glClearNamedFramebufferiv", "glClearNamedFramebufferuiv", "glClearNamedFramebufferfv", "glClearNamedFramebufferfi",
+			"glBlitFramebuffer", "glBlitNamedFramebuffer", "glReadPixels", "glReadnPixels", "glFinish", "glFlush",
+			"glBeginQuery", "glEndQuery", "glBeginQueryIndexed", "glEndQueryIndexed", "glQueryCounter",
+			"glBeginConditionalRender", "glEndConditionalRender" };
+		for (const char* e : elided)
+		{
+			if (std::strcmp(name, e) == 0)
+				r[id].flags |= ELIDED;
+		}
+		//getters only read back, apart from the locations and indices the replay maps
+		static const char* mapped[] = { "glGetUniformLocation", "glGetUniformBlockIndex", "glGetProgramResourceIndex",
+			"glGetProgramResourceLocation" };
+		if (std::strncmp(name, "glGet", 5) == 0
+			&& std::find_if(std::begin(mapped), std::end(mapped), [name](const char* e) { return std::strcmp(name, e) == 0; }) == std::end(mapped))
+			r[id].flags |= ELIDED;
+	}
+}
+
+inline uint64_t GLTrace::imageBytes(const EntryRule& rule, const int64_t* values, const PixelStore& store)
+{
+	int64_t width = rule.pixels[0] >= 0 ? values[rule.pixels[0]] : 1;
+	int64_t height = rule.pixels[1] >= 0 ? values[rule.pixels[1]] : 1;
+	int64_t depth = rule.pixels[2] >= 0 ? values[rule.pixels[2]] : 1;
+	if (width <= 0 || height <= 0 || depth <= 0)
+		return 0;
+
+	//rows start on the store's alignment, a row length or image height set by glPixelStorei widens them
+	uint64_t pixel = GLInterceptor::pixelBytes(1, 1, 1, (GLenum)values[rule.pixels[3]], (GLenum)values[rule.pixels[4]]);
+	uint64_t alignment = std::max(store.alignment, 1);
+	uint64_t row = (pixel * (store.rowLength > 0 ? store.rowLength : width) + alignment - 1) / alignment * alignment;
+	uint64_t image = row * (store.imageHeight > 0 ? store.imageHeight : height);
+	return image * (depth - 1) + row * (height - 1) + pixel * width;
+}
+
+inline void GLTrace::putBlob(std::vector<char>& to, const void* data, uint64_t size)
+{
+	if (!data)
+	{
+		putU64(to, NO_BLOB);
+		return;
+	}
+	putU64(to, (uint32_t)size);
+	to.insert(to.end(), (const char*)data, (const char*)data + size);
+	to.resize((to.size() + 7) & ~(size_t)7, 0);
+}
+
+inline void GLTrace::beginRecord(std::vector<char>& to, uint16_t id)
+{
+	to.clear();
+	uint16_t header[4] = { id, 0, 0, 0 };
+	to.insert(to.end(), (const char*)header, (const char*)header + 8);
+}
+
+inline void GLTrace::writeRecord(std::vector<char>& record)
+{
+	CaptureState& s = state();
+	uint32_t size = (uint32_t)(record.size() - 8);
+	std::memcpy(&record[4], &size, 4);
+	s.out.write(record.data(), record.size());
+	s.bytes += record.size();
+}
+
+inline bool GLTrace::recording(int id)
+{
+	CaptureState& s = state();
+	return s.out.is_open() && (s.frame >= s.settings.startFrame || !(rules()[id].flags & ELIDED));
+}
+
+inline bool GLTrace::beginCall(int id, int argc, const int64_t* values, const void* const* pointers, const bool* isPointer)
+{
+	CaptureState& s = state();
+	const EntryRule& rule = rules()[id];
+	for (int i = 0; i < argc; ++i)
+	{
+		uint8_t kind = i < MAX_ARGS ? rule.args[i].kind : (uint8_t)ARG_UNSUPPORTED;
+		if (isPointer[i] && pointers[i] && (kind == ARG_VALUE || kind == ARG_UNSUPPORTED))
+		{
+			beginRecord(s.record, SKIPPED);
+			putU64(s.record, id);
+			writeRecord(s.record);
+			++s.skipped;
+			return false;
+		}
+	}
+
+	observe(id, values);
+	++s.calls;
+
+	std::vector<char>& record = s.record;
+	beginRecord(record, (uint16_t)id);
+	for (int i = 0; i < argc; ++i)
+		putU64(record, values[i]);
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const ArgRule& a = rule.args[i];
+		if (!inputBlob(a.kind))
+			continue;
+		const void* data = pointers[i];
+		bool offset = (a.detail & UNPACK) && s.buffers[GL_PIXEL_UNPACK_BUFFER];
+		if (!data || offset)
+		{
+			putU64(record, NO_BLOB);
+			continue;
+		}
+
+		uint64_t size = 0;
+		switch (a.kind)
+		{
+		case ARG_UNIFORM:
+			size = (uint64_t)a.detail * (a.count < 0 ? 1 : values[a.count]);
+			break;
+		case ARG_STRING:
+			size = a.count >= 0 && values[a.count] >= 0 ? values[a.count] : std::strlen((const char*)data) + 1;
+			break;
+		case ARG_ARRAY:
+			size = (uint64_t)a.detail * values[a.count];
+			break;
+		case ARG_NAMES:
+			size = sizeof(GLuint) * values[a.count];
+			break;
+		case ARG_BYTES:
+			size = values[a.count];
+			break;
+		case ARG_PIXELS:
+			size = imageBytes(rule, values, s.unpack);
+			break;
+		case ARG_SHADER_SOURCE:
+		{
+			//joined into one string, the replay hands it over as a single source
+			const GLchar* const* strings = (const GLchar* const*)data;
+			const GLint* lengths = (const GLint*)pointers[3];
+			s.scratch.clear();
+			for (int64_t j = 0; j < values[1]; ++j)
+			{
+				size_t length = lengths && lengths[j] >= 0 ? lengths[j] : std::strlen(strings[j]);
+				s.scratch.insert(s.scratch.end(), strings[j], strings[j] + length);
+			}
+			s.scratch.push_back(0);
+			data = s.scratch.data();
+			size = s.scratch.size();
+			break;
+		}
+		case ARG_CLEAR_VALUE:
+			size = values[a.count] == GL_COLOR ? 16 : 4;
+			break;
+		}
+		putBlob(record, data, size);
+	}
+	return true;
+}
+
+inline void GLTrace::endCall(int id, int argc, const int64_t* values, const void* const* pointers, int64_t result)
+{
+	CaptureState& s = state();
+	const EntryRule& rule = rules()[id];
+	std::vector<char>& record = s.record;
+	putU64(record, result);
+	for (int i = 0; i < argc; ++i)
+	{
+		const ArgRule& a = rule.args[i];
+		if (a.kind == ARG_GEN)
+			putBlob(record, pointers[i], sizeof(GLuint) * values[a.count]);
+	}
+	writeRecord(record);
+
+	switch (id)
+	{
+	case GLInterceptor::EP_glMapBuffer:
+	case GLInterceptor::EP_glMapNamedBuffer:
+	{
+		GLint64 size = 0;
+		GLuint buffer = (GLuint)values[0];
+		if (id == GLInterceptor::EP_glMapBuffer)
+		{
+			buffer = s.buffers[(GLenum)values[0]];
+			GL_TRACE_NEXT(glGetBufferParameteri64v)((GLenum)values[0], GL_BUFFER_SIZE, &size);
+		}
+		else
+		{
+			GL_TRACE_NEXT(glGetNamedBufferParameteri64v)(buffer, GL_BUFFER_SIZE, &size);
+		}
+		mapped(buffer, 0, (GLsizeiptr)size, values[1] == GL_READ_ONLY ? GL_MAP_READ_BIT : GL_MAP_WRITE_BIT, (void*)(intptr_t)result);
+		break;
+	}
+	case GLInterceptor::EP_glMapBufferRange:
+		mapped(s.buffers[(GLenum)values[0]], (GLintptr)values[1], (GLsizeiptr)values[2], (GLbitfield)values[3], (void*)(intptr_t)result);
+		break;
+	case GLInterceptor::EP_glMapNamedBufferRange:
+		mapped((GLuint)values[0], (GLintptr)values[1], (GLsizeiptr)values[2], (GLbitfield)values[3], (void*)(intptr_t)result);
+		break;
+	}
+}
+
+inline void GLTrace::observe(int id, const int64_t* values)
+{
+	CaptureState& s = state();
+	if (rules()[id].flags & WORK)
+		writePersistent();
+
+	switch (id)
+	{
+	case GLInterceptor::EP_glBindBuffer:
+	case GLInterceptor::EP_glBindBufferBase:
+	case GLInterceptor::EP_glBindBufferRange:
+		s.buffers[(GLenum)values[0]] = (GLuint)values[id == GLInterceptor::EP_glBindBuffer ? 1 : 2];
+		break;
+	case GLInterceptor::EP_glPixelStorei:
+		switch ((GLenum)values[0])
+		{
+		case GL_UNPACK_ALIGNMENT: s.unpack.alignment = (GLint)values[1]; break;
+		case GL_UNPACK_ROW_LENGTH: s.unpack.rowLength = (GLint)values[1]; break;
+		case GL_UNPACK_IMAGE_HEIGHT: s.unpack.imageHeight = (GLint)values[1]; break;
+		case GL_PACK_ALIGNMENT: s.pack.alignment = (GLint)values[1]; break;
+		case GL_PACK_ROW_LENGTH: s.pack.rowLength = (GLint)values[1]; break;
+		case GL_PACK_IMAGE_HEIGHT: s.pack.imageHeight = (GLint)values[1]; break;
+		}
+		break;
+	case GLInterceptor::EP_glUnmapBuffer:
+	case GLInterceptor::EP_glUnmapNamedBuffer:
+	{
+		//explicitly flushed mappings are recorded at their flushes
+		GLuint buffer = id == GLInterceptor::EP_glUnmapBuffer ? s.buffers[(GLenum)values[0]] : (GLuint)values[0];
+		auto it = s.mappings.find(buffer);
+		if (it == s.mappings.end())
+			break;
+		Mapping& mapping = it->second;
+		if (mapping.access & GL_MAP_PERSISTENT_BIT)
+			writeChanges(buffer, mapping);
+		else if (!(mapping.access & GL_MAP_FLUSH_EXPLICIT_BIT))
+			writeMapped(buffer, mapping.offset, mapping.pointer, mapping.length);
+		s.mappings.erase(it);
+		break;
+	}
+	case GLInterceptor::EP_glFlushMappedBufferRange:
+	case GLInterceptor::EP_glFlushMappedNamedBufferRange:
+	{
+		GLuint buffer = id == GLInterceptor::EP_glFlushMappedBufferRange ? s.buffers[(GLenum)values[0]] : (GLuint)values[0];
+		auto it = s.mappings.find(buffer);
+		if (it != s.mappings.end())
+			writeMapped(buffer, it->second.offset + values[1], it->second.pointer + values[1], values[2]);
+		break;
+	}
+	case GLInterceptor::EP_glDeleteBuffers:
+	{
+		//deleting a mapped buffer unmaps it
+		const GLuint* names = (const GLuint*)(intptr_t)values[1];
+		for (int64_t i = 0; names && i < values[0]; ++i)
+			s.mappings.erase(names[i]);
+		break;
+	}
+	}
+}
+
+inline void GLTrace::mapped(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access, void* pointer)
+{
+	if (!pointer || !(access & GL_MAP_WRITE_BIT))
+		return;
+	Mapping& mapping = state().mappings[buffer];
+	mapping.offset = offset;
+	mapping.length = length;
+	mapping.access = access;
+	mapping.pointer = (char*)pointer;
+	mapping.shadow.clear();
+}
+
+inline void GLTrace::writeMapped(GLuint buffer, uint64_t offset, const char* data, uint64_t size)
+{
+	CaptureState& s = state();
+	std::vector<char>& record = s.scratch;
+	beginRecord(record, MAPPED_DATA);
+	putU64(record, buffer);
+	putU64(record, offset);
+	putU64(record, size);
+	record.insert(record.end(), data, data + size);
+	record.resize((record.size() + 7) & ~(size_t)7, 0);
+	writeRecord(record);
+}
+
+inline void GLTrace::writeChanges(GLuint buffer, Mapping& mapping)
+{
+	if (mapping.shadow.empty())
+	{
+		mapping.shadow.assign(mapping.pointer, mapping.pointer + mapping.length);
+		writeMapped(buffer, mapping.offset, mapping.pointer, mapping.length);
+		return;
+	}
+
+	//runs of changed 64 byte blocks
+	const size_t BLOCK = 64;
+	size_t length = (size_t)mapping.length;
+	size_t i = 0;
+	while (i < length)
+	{
+		size_t n = std::min(BLOCK, length - i);
+		if (std::memcmp(mapping.pointer + i, &mapping.shadow[i], n) == 0)
+		{
+			i += n;
+			continue;
+		}
+		size_t start = i;
+		while (i < length)
+		{
+			n = std::min(BLOCK, length - i);
+			if (std::memcmp(mapping.pointer + i, &mapping.shadow[i], n) == 0)
+				break;
+			i += n;
+		}
+		std::memcpy(&mapping.shadow[start], mapping.pointer + start, i - start);
+		writeMapped(buffer, mapping.offset + start, mapping.pointer + start, i - start);
+	}
+}
+
+inline void GLTrace::writePersistent()
+{
+	for (auto& it : state().mappings)
+	{
+		if ((it.second.access & GL_MAP_PERSISTENT_BIT) && !(it.second.access & GL_MAP_FLUSH_EXPLICIT_BIT))
+			writeChanges(it.first, it.second);
+	}
+}
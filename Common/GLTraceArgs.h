@@ -0,0 +1,709 @@
+//What GLTrace needs to know about the arguments of the entry points in GLEntryPoints.h, for X-macro use like that file:
+//define the macros, include this file, undefine them. No include guard on purpose.
+//Derived from the parameter names in glad/glad.h, keep in step with it when glad is regenerated:
+//	GL_TRACE_NAME(entry, arg, kind)				a GLuint object name: buffer(s), readBuffer, writeBuffer, texture(s),
+//												origtexture, framebuffer(s), read/drawFramebuffer, renderbuffer(s),
+//												array(s), vaobj, program(s), shader(s), pipeline(s), sampler(s), xfb,
+//												and id(s) in query and transform feedback functions
+//	GL_TRACE_NAMES(entry, arg, countArg, kind)	const GLuint* of those names, countArg the GLsizei n/count/drawcount
+//	GL_TRACE_GEN(entry, arg, countArg, kind)	GLuint* the call writes those names to (glGen*, glCreate*)
+//	GL_TRACE_RETURN_NAME(entry, kind)			glCreateShader, glCreateProgram, glCreateShaderProgramv
+//	GL_TRACE_LOCATION(entry, arg, programArg)	a uniform location, programArg -1 for the program in use
+//	GL_TRACE_BLOCK(entry, arg, programArg)		a uniform block index
+//	GL_TRACE_UNIFORM(entry, arg)				the value pointer of glUniform* / glProgramUniform*
+//	GL_TRACE_STRING(entry, arg, lengthArg)		const GLchar*, NUL terminated when lengthArg is -1
+//	GL_TRACE_ARRAY(entry, arg, countArg, bytes)	any other const scalar pointer with a count
+//	GL_TRACE_OUT(entry, arg)					a non-const pointer the call writes results to
+
+GL_TRACE_OUT(glGetBooleanv, 1)
+GL_TRACE_OUT(glGetDoublev, 1)
+GL_TRACE_OUT(glGetFloatv, 1)
+GL_TRACE_OUT(glGetIntegerv, 1)
+GL_TRACE_OUT(glGetTexImage, 4)
+GL_TRACE_OUT(glGetTexParameterfv, 2)
+GL_TRACE_OUT(glGetTexParameteriv, 2)
+GL_TRACE_OUT(glGetTexLevelParameterfv, 3)
+GL_TRACE_OUT(glGetTexLevelParameteriv, 3)
+GL_TRACE_NAME(glBindTexture, 1, TEXTURE)
+GL_TRACE_NAMES(glDeleteTextures, 1, 0, TEXTURE)
+GL_TRACE_GEN(glGenTextures, 1, 0, TEXTURE)
+GL_TRACE_NAME(glIsTexture, 0, TEXTURE)
+GL_TRACE_OUT(glGetCompressedTexImage, 2)
+GL_TRACE_ARRAY(glMultiDrawArrays, 1, 3, 4)
+GL_TRACE_ARRAY(glMultiDrawArrays, 2, 3, 4)
+GL_TRACE_ARRAY(glMultiDrawElements, 1, 4, 4)
+GL_TRACE_GEN(glGenQueries, 1, 0, QUERY)
+GL_TRACE_NAMES(glDeleteQueries, 1, 0, QUERY)
+GL_TRACE_NAME(glIsQuery, 0, QUERY)
+GL_TRACE_NAME(glBeginQuery, 1, QUERY)
+GL_TRACE_OUT(glGetQueryiv, 2)
+GL_TRACE_NAME(glGetQueryObjectiv, 0, QUERY)
+GL_TRACE_OUT(glGetQueryObjectiv, 2)
+GL_TRACE_NAME(glGetQueryObjectuiv, 0, QUERY)
+GL_TRACE_OUT(glGetQueryObjectuiv, 2)
+GL_TRACE_NAME(glBindBuffer, 1, BUFFER)
+GL_TRACE_NAMES(glDeleteBuffers, 1, 0, BUFFER)
+GL_TRACE_GEN(glGenBuffers, 1, 0, BUFFER)
+GL_TRACE_NAME(glIsBuffer, 0, BUFFER)
+GL_TRACE_OUT(glGetBufferSubData, 3)
+GL_TRACE_OUT(glGetBufferParameteriv, 2)
+GL_TRACE_ARRAY(glDrawBuffers, 1, 0, 4)
+GL_TRACE_NAME(glAttachShader, 0, PROGRAM)
+GL_TRACE_NAME(glAttachShader, 1, PROGRAM)
+GL_TRACE_NAME(glBindAttribLocation, 0, PROGRAM)
+GL_TRACE_STRING(glBindAttribLocation, 2, -1)
+GL_TRACE_NAME(glCompileShader, 0, PROGRAM)
+GL_TRACE_RETURN_NAME(glCreateProgram, PROGRAM)
+GL_TRACE_RETURN_NAME(glCreateShader, PROGRAM)
+GL_TRACE_NAME(glDeleteProgram, 0, PROGRAM)
+GL_TRACE_NAME(glDeleteShader, 0, PROGRAM)
+GL_TRACE_NAME(glDetachShader, 0, PROGRAM)
+GL_TRACE_NAME(glDetachShader, 1, PROGRAM)
+GL_TRACE_NAME(glGetActiveAttrib, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveAttrib, 3)
+GL_TRACE_OUT(glGetActiveAttrib, 4)
+GL_TRACE_OUT(glGetActiveAttrib, 5)
+GL_TRACE_OUT(glGetActiveAttrib, 6)
+GL_TRACE_NAME(glGetActiveUniform, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveUniform, 3)
+GL_TRACE_OUT(glGetActiveUniform, 4)
+GL_TRACE_OUT(glGetActiveUniform, 5)
+GL_TRACE_OUT(glGetActiveUniform, 6)
+GL_TRACE_NAME(glGetAttachedShaders, 0, PROGRAM)
+GL_TRACE_OUT(glGetAttachedShaders, 2)
+GL_TRACE_NAME(glGetAttribLocation, 0, PROGRAM)
+GL_TRACE_STRING(glGetAttribLocation, 1, -1)
+GL_TRACE_NAME(glGetProgramiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramiv, 2)
+GL_TRACE_NAME(glGetProgramInfoLog, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramInfoLog, 2)
+GL_TRACE_OUT(glGetProgramInfoLog, 3)
+GL_TRACE_NAME(glGetShaderiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetShaderiv, 2)
+GL_TRACE_NAME(glGetShaderInfoLog, 0, PROGRAM)
+GL_TRACE_OUT(glGetShaderInfoLog, 2)
+GL_TRACE_OUT(glGetShaderInfoLog, 3)
+GL_TRACE_NAME(glGetShaderSource, 0, PROGRAM)
+GL_TRACE_OUT(glGetShaderSource, 2)
+GL_TRACE_OUT(glGetShaderSource, 3)
+GL_TRACE_NAME(glGetUniformLocation, 0, PROGRAM)
+GL_TRACE_STRING(glGetUniformLocation, 1, -1)
+GL_TRACE_NAME(glGetUniformfv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetUniformfv, 1, 0)
+GL_TRACE_OUT(glGetUniformfv, 2)
+GL_TRACE_NAME(glGetUniformiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetUniformiv, 1, 0)
+GL_TRACE_OUT(glGetUniformiv, 2)
+GL_TRACE_OUT(glGetVertexAttribdv, 2)
+GL_TRACE_OUT(glGetVertexAttribfv, 2)
+GL_TRACE_OUT(glGetVertexAttribiv, 2)
+GL_TRACE_NAME(glIsProgram, 0, PROGRAM)
+GL_TRACE_NAME(glIsShader, 0, PROGRAM)
+GL_TRACE_NAME(glLinkProgram, 0, PROGRAM)
+GL_TRACE_NAME(glShaderSource, 0, PROGRAM)
+GL_TRACE_ARRAY(glShaderSource, 3, 1, 4)
+GL_TRACE_NAME(glUseProgram, 0, PROGRAM)
+GL_TRACE_LOCATION(glUniform1f, 0, -1)
+GL_TRACE_LOCATION(glUniform2f, 0, -1)
+GL_TRACE_LOCATION(glUniform3f, 0, -1)
+GL_TRACE_LOCATION(glUniform4f, 0, -1)
+GL_TRACE_LOCATION(glUniform1i, 0, -1)
+GL_TRACE_LOCATION(glUniform2i, 0, -1)
+GL_TRACE_LOCATION(glUniform3i, 0, -1)
+GL_TRACE_LOCATION(glUniform4i, 0, -1)
+GL_TRACE_LOCATION(glUniform1fv, 0, -1)
+GL_TRACE_UNIFORM(glUniform1fv, 2)
+GL_TRACE_LOCATION(glUniform2fv, 0, -1)
+GL_TRACE_UNIFORM(glUniform2fv, 2)
+GL_TRACE_LOCATION(glUniform3fv, 0, -1)
+GL_TRACE_UNIFORM(glUniform3fv, 2)
+GL_TRACE_LOCATION(glUniform4fv, 0, -1)
+GL_TRACE_UNIFORM(glUniform4fv, 2)
+GL_TRACE_LOCATION(glUniform1iv, 0, -1)
+GL_TRACE_UNIFORM(glUniform1iv, 2)
+GL_TRACE_LOCATION(glUniform2iv, 0, -1)
+GL_TRACE_UNIFORM(glUniform2iv, 2)
+GL_TRACE_LOCATION(glUniform3iv, 0, -1)
+GL_TRACE_UNIFORM(glUniform3iv, 2)
+GL_TRACE_LOCATION(glUniform4iv, 0, -1)
+GL_TRACE_UNIFORM(glUniform4iv, 2)
+GL_TRACE_LOCATION(glUniformMatrix2fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4fv, 3)
+GL_TRACE_NAME(glValidateProgram, 0, PROGRAM)
+GL_TRACE_LOCATION(glUniformMatrix2x3fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2x3fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3x2fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3x2fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix2x4fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2x4fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4x2fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4x2fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3x4fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3x4fv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4x3fv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4x3fv, 3)
+GL_TRACE_OUT(glGetBooleani_v, 2)
+GL_TRACE_OUT(glGetIntegeri_v, 2)
+GL_TRACE_NAME(glBindBufferRange, 2, BUFFER)
+GL_TRACE_NAME(glBindBufferBase, 2, BUFFER)
+GL_TRACE_NAME(glTransformFeedbackVaryings, 0, PROGRAM)
+GL_TRACE_NAME(glGetTransformFeedbackVarying, 0, PROGRAM)
+GL_TRACE_OUT(glGetTransformFeedbackVarying, 3)
+GL_TRACE_OUT(glGetTransformFeedbackVarying, 4)
+GL_TRACE_OUT(glGetTransformFeedbackVarying, 5)
+GL_TRACE_OUT(glGetTransformFeedbackVarying, 6)
+GL_TRACE_OUT(glGetVertexAttribIiv, 2)
+GL_TRACE_OUT(glGetVertexAttribIuiv, 2)
+GL_TRACE_NAME(glGetUniformuiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetUniformuiv, 1, 0)
+GL_TRACE_OUT(glGetUniformuiv, 2)
+GL_TRACE_NAME(glBindFragDataLocation, 0, PROGRAM)
+GL_TRACE_STRING(glBindFragDataLocation, 2, -1)
+GL_TRACE_NAME(glGetFragDataLocation, 0, PROGRAM)
+GL_TRACE_STRING(glGetFragDataLocation, 1, -1)
+GL_TRACE_LOCATION(glUniform1ui, 0, -1)
+GL_TRACE_LOCATION(glUniform2ui, 0, -1)
+GL_TRACE_LOCATION(glUniform3ui, 0, -1)
+GL_TRACE_LOCATION(glUniform4ui, 0, -1)
+GL_TRACE_LOCATION(glUniform1uiv, 0, -1)
+GL_TRACE_UNIFORM(glUniform1uiv, 2)
+GL_TRACE_LOCATION(glUniform2uiv, 0, -1)
+GL_TRACE_UNIFORM(glUniform2uiv, 2)
+GL_TRACE_LOCATION(glUniform3uiv, 0, -1)
+GL_TRACE_UNIFORM(glUniform3uiv, 2)
+GL_TRACE_LOCATION(glUniform4uiv, 0, -1)
+GL_TRACE_UNIFORM(glUniform4uiv, 2)
+GL_TRACE_OUT(glGetTexParameterIiv, 2)
+GL_TRACE_OUT(glGetTexParameterIuiv, 2)
+GL_TRACE_NAME(glIsRenderbuffer, 0, RENDERBUFFER)
+GL_TRACE_NAME(glBindRenderbuffer, 1, RENDERBUFFER)
+GL_TRACE_NAMES(glDeleteRenderbuffers, 1, 0, RENDERBUFFER)
+GL_TRACE_GEN(glGenRenderbuffers, 1, 0, RENDERBUFFER)
+GL_TRACE_OUT(glGetRenderbufferParameteriv, 2)
+GL_TRACE_NAME(glIsFramebuffer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glBindFramebuffer, 1, FRAMEBUFFER)
+GL_TRACE_NAMES(glDeleteFramebuffers, 1, 0, FRAMEBUFFER)
+GL_TRACE_GEN(glGenFramebuffers, 1, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glFramebufferTexture1D, 3, TEXTURE)
+GL_TRACE_NAME(glFramebufferTexture2D, 3, TEXTURE)
+GL_TRACE_NAME(glFramebufferTexture3D, 3, TEXTURE)
+GL_TRACE_NAME(glFramebufferRenderbuffer, 3, RENDERBUFFER)
+GL_TRACE_OUT(glGetFramebufferAttachmentParameteriv, 3)
+GL_TRACE_NAME(glFramebufferTextureLayer, 2, TEXTURE)
+GL_TRACE_NAME(glBindVertexArray, 0, VERTEX_ARRAY)
+GL_TRACE_NAMES(glDeleteVertexArrays, 1, 0, VERTEX_ARRAY)
+GL_TRACE_GEN(glGenVertexArrays, 1, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glIsVertexArray, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glTexBuffer, 2, BUFFER)
+GL_TRACE_NAME(glGetUniformIndices, 0, PROGRAM)
+GL_TRACE_OUT(glGetUniformIndices, 3)
+GL_TRACE_NAME(glGetActiveUniformsiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveUniformsiv, 4)
+GL_TRACE_NAME(glGetActiveUniformName, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveUniformName, 3)
+GL_TRACE_OUT(glGetActiveUniformName, 4)
+GL_TRACE_NAME(glGetUniformBlockIndex, 0, PROGRAM)
+GL_TRACE_STRING(glGetUniformBlockIndex, 1, -1)
+GL_TRACE_NAME(glGetActiveUniformBlockiv, 0, PROGRAM)
+GL_TRACE_BLOCK(glGetActiveUniformBlockiv, 1, 0)
+GL_TRACE_OUT(glGetActiveUniformBlockiv, 3)
+GL_TRACE_NAME(glGetActiveUniformBlockName, 0, PROGRAM)
+GL_TRACE_BLOCK(glGetActiveUniformBlockName, 1, 0)
+GL_TRACE_OUT(glGetActiveUniformBlockName, 3)
+GL_TRACE_OUT(glGetActiveUniformBlockName, 4)
+GL_TRACE_NAME(glUniformBlockBinding, 0, PROGRAM)
+GL_TRACE_BLOCK(glUniformBlockBinding, 1, 0)
+GL_TRACE_ARRAY(glMultiDrawElementsBaseVertex, 1, 4, 4)
+GL_TRACE_ARRAY(glMultiDrawElementsBaseVertex, 5, 4, 4)
+GL_TRACE_OUT(glGetInteger64v, 1)
+GL_TRACE_OUT(glGetSynciv, 3)
+GL_TRACE_OUT(glGetSynciv, 4)
+GL_TRACE_OUT(glGetInteger64i_v, 2)
+GL_TRACE_OUT(glGetBufferParameteri64v, 2)
+GL_TRACE_NAME(glFramebufferTexture, 2, TEXTURE)
+GL_TRACE_OUT(glGetMultisamplefv, 2)
+GL_TRACE_NAME(glBindFragDataLocationIndexed, 0, PROGRAM)
+GL_TRACE_STRING(glBindFragDataLocationIndexed, 3, -1)
+GL_TRACE_NAME(glGetFragDataIndex, 0, PROGRAM)
+GL_TRACE_STRING(glGetFragDataIndex, 1, -1)
+GL_TRACE_GEN(glGenSamplers, 1, 0, SAMPLER)
+GL_TRACE_NAMES(glDeleteSamplers, 1, 0, SAMPLER)
+GL_TRACE_NAME(glIsSampler, 0, SAMPLER)
+GL_TRACE_NAME(glBindSampler, 1, SAMPLER)
+GL_TRACE_NAME(glSamplerParameteri, 0, SAMPLER)
+GL_TRACE_NAME(glSamplerParameteriv, 0, SAMPLER)
+GL_TRACE_NAME(glSamplerParameterf, 0, SAMPLER)
+GL_TRACE_NAME(glSamplerParameterfv, 0, SAMPLER)
+GL_TRACE_NAME(glSamplerParameterIiv, 0, SAMPLER)
+GL_TRACE_NAME(glSamplerParameterIuiv, 0, SAMPLER)
+GL_TRACE_NAME(glGetSamplerParameteriv, 0, SAMPLER)
+GL_TRACE_OUT(glGetSamplerParameteriv, 2)
+GL_TRACE_NAME(glGetSamplerParameterIiv, 0, SAMPLER)
+GL_TRACE_OUT(glGetSamplerParameterIiv, 2)
+GL_TRACE_NAME(glGetSamplerParameterfv, 0, SAMPLER)
+GL_TRACE_OUT(glGetSamplerParameterfv, 2)
+GL_TRACE_NAME(glGetSamplerParameterIuiv, 0, SAMPLER)
+GL_TRACE_OUT(glGetSamplerParameterIuiv, 2)
+GL_TRACE_NAME(glQueryCounter, 0, QUERY)
+GL_TRACE_NAME(glGetQueryObjecti64v, 0, QUERY)
+GL_TRACE_OUT(glGetQueryObjecti64v, 2)
+GL_TRACE_NAME(glGetQueryObjectui64v, 0, QUERY)
+GL_TRACE_OUT(glGetQueryObjectui64v, 2)
+GL_TRACE_LOCATION(glUniform1d, 0, -1)
+GL_TRACE_LOCATION(glUniform2d, 0, -1)
+GL_TRACE_LOCATION(glUniform3d, 0, -1)
+GL_TRACE_LOCATION(glUniform4d, 0, -1)
+GL_TRACE_LOCATION(glUniform1dv, 0, -1)
+GL_TRACE_UNIFORM(glUniform1dv, 2)
+GL_TRACE_LOCATION(glUniform2dv, 0, -1)
+GL_TRACE_UNIFORM(glUniform2dv, 2)
+GL_TRACE_LOCATION(glUniform3dv, 0, -1)
+GL_TRACE_UNIFORM(glUniform3dv, 2)
+GL_TRACE_LOCATION(glUniform4dv, 0, -1)
+GL_TRACE_UNIFORM(glUniform4dv, 2)
+GL_TRACE_LOCATION(glUniformMatrix2dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix2x3dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2x3dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix2x4dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix2x4dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3x2dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3x2dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix3x4dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix3x4dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4x2dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4x2dv, 3)
+GL_TRACE_LOCATION(glUniformMatrix4x3dv, 0, -1)
+GL_TRACE_UNIFORM(glUniformMatrix4x3dv, 3)
+GL_TRACE_NAME(glGetUniformdv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetUniformdv, 1, 0)
+GL_TRACE_OUT(glGetUniformdv, 2)
+GL_TRACE_NAME(glGetSubroutineUniformLocation, 0, PROGRAM)
+GL_TRACE_STRING(glGetSubroutineUniformLocation, 2, -1)
+GL_TRACE_NAME(glGetSubroutineIndex, 0, PROGRAM)
+GL_TRACE_STRING(glGetSubroutineIndex, 2, -1)
+GL_TRACE_NAME(glGetActiveSubroutineUniformiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveSubroutineUniformiv, 4)
+GL_TRACE_NAME(glGetActiveSubroutineUniformName, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveSubroutineUniformName, 4)
+GL_TRACE_OUT(glGetActiveSubroutineUniformName, 5)
+GL_TRACE_NAME(glGetActiveSubroutineName, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveSubroutineName, 4)
+GL_TRACE_OUT(glGetActiveSubroutineName, 5)
+GL_TRACE_ARRAY(glUniformSubroutinesuiv, 2, 1, 4)
+GL_TRACE_LOCATION(glGetUniformSubroutineuiv, 1, -1)
+GL_TRACE_OUT(glGetUniformSubroutineuiv, 2)
+GL_TRACE_NAME(glGetProgramStageiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramStageiv, 3)
+GL_TRACE_NAME(glBindTransformFeedback, 1, TRANSFORM_FEEDBACK)
+GL_TRACE_NAMES(glDeleteTransformFeedbacks, 1, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_GEN(glGenTransformFeedbacks, 1, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glIsTransformFeedback, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glDrawTransformFeedback, 1, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glDrawTransformFeedbackStream, 1, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glBeginQueryIndexed, 2, QUERY)
+GL_TRACE_OUT(glGetQueryIndexediv, 3)
+GL_TRACE_NAMES(glShaderBinary, 1, 0, PROGRAM)
+GL_TRACE_OUT(glGetShaderPrecisionFormat, 2)
+GL_TRACE_OUT(glGetShaderPrecisionFormat, 3)
+GL_TRACE_NAME(glGetProgramBinary, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramBinary, 2)
+GL_TRACE_OUT(glGetProgramBinary, 3)
+GL_TRACE_OUT(glGetProgramBinary, 4)
+GL_TRACE_NAME(glProgramBinary, 0, PROGRAM)
+GL_TRACE_NAME(glProgramParameteri, 0, PROGRAM)
+GL_TRACE_NAME(glUseProgramStages, 0, PIPELINE)
+GL_TRACE_NAME(glUseProgramStages, 2, PROGRAM)
+GL_TRACE_NAME(glActiveShaderProgram, 0, PIPELINE)
+GL_TRACE_NAME(glActiveShaderProgram, 1, PROGRAM)
+GL_TRACE_RETURN_NAME(glCreateShaderProgramv, PROGRAM)
+GL_TRACE_NAME(glBindProgramPipeline, 0, PIPELINE)
+GL_TRACE_NAMES(glDeleteProgramPipelines, 1, 0, PIPELINE)
+GL_TRACE_GEN(glGenProgramPipelines, 1, 0, PIPELINE)
+GL_TRACE_NAME(glIsProgramPipeline, 0, PIPELINE)
+GL_TRACE_NAME(glGetProgramPipelineiv, 0, PIPELINE)
+GL_TRACE_OUT(glGetProgramPipelineiv, 2)
+GL_TRACE_NAME(glProgramUniform1i, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1i, 1, 0)
+GL_TRACE_NAME(glProgramUniform1iv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1iv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform1iv, 3)
+GL_TRACE_NAME(glProgramUniform1f, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1f, 1, 0)
+GL_TRACE_NAME(glProgramUniform1fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform1fv, 3)
+GL_TRACE_NAME(glProgramUniform1d, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1d, 1, 0)
+GL_TRACE_NAME(glProgramUniform1dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform1dv, 3)
+GL_TRACE_NAME(glProgramUniform1ui, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1ui, 1, 0)
+GL_TRACE_NAME(glProgramUniform1uiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform1uiv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform1uiv, 3)
+GL_TRACE_NAME(glProgramUniform2i, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2i, 1, 0)
+GL_TRACE_NAME(glProgramUniform2iv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2iv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform2iv, 3)
+GL_TRACE_NAME(glProgramUniform2f, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2f, 1, 0)
+GL_TRACE_NAME(glProgramUniform2fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform2fv, 3)
+GL_TRACE_NAME(glProgramUniform2d, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2d, 1, 0)
+GL_TRACE_NAME(glProgramUniform2dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform2dv, 3)
+GL_TRACE_NAME(glProgramUniform2ui, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2ui, 1, 0)
+GL_TRACE_NAME(glProgramUniform2uiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform2uiv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform2uiv, 3)
+GL_TRACE_NAME(glProgramUniform3i, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3i, 1, 0)
+GL_TRACE_NAME(glProgramUniform3iv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3iv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform3iv, 3)
+GL_TRACE_NAME(glProgramUniform3f, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3f, 1, 0)
+GL_TRACE_NAME(glProgramUniform3fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform3fv, 3)
+GL_TRACE_NAME(glProgramUniform3d, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3d, 1, 0)
+GL_TRACE_NAME(glProgramUniform3dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform3dv, 3)
+GL_TRACE_NAME(glProgramUniform3ui, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3ui, 1, 0)
+GL_TRACE_NAME(glProgramUniform3uiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform3uiv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform3uiv, 3)
+GL_TRACE_NAME(glProgramUniform4i, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4i, 1, 0)
+GL_TRACE_NAME(glProgramUniform4iv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4iv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform4iv, 3)
+GL_TRACE_NAME(glProgramUniform4f, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4f, 1, 0)
+GL_TRACE_NAME(glProgramUniform4fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform4fv, 3)
+GL_TRACE_NAME(glProgramUniform4d, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4d, 1, 0)
+GL_TRACE_NAME(glProgramUniform4dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform4dv, 3)
+GL_TRACE_NAME(glProgramUniform4ui, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4ui, 1, 0)
+GL_TRACE_NAME(glProgramUniform4uiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniform4uiv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniform4uiv, 3)
+GL_TRACE_NAME(glProgramUniformMatrix2fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix2dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix2x3fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2x3fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2x3fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3x2fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3x2fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3x2fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix2x4fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2x4fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2x4fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4x2fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4x2fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4x2fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3x4fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3x4fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3x4fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4x3fv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4x3fv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4x3fv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix2x3dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2x3dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2x3dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3x2dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3x2dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3x2dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix2x4dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix2x4dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix2x4dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4x2dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4x2dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4x2dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix3x4dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix3x4dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix3x4dv, 4)
+GL_TRACE_NAME(glProgramUniformMatrix4x3dv, 0, PROGRAM)
+GL_TRACE_LOCATION(glProgramUniformMatrix4x3dv, 1, 0)
+GL_TRACE_UNIFORM(glProgramUniformMatrix4x3dv, 4)
+GL_TRACE_NAME(glValidateProgramPipeline, 0, PIPELINE)
+GL_TRACE_NAME(glGetProgramPipelineInfoLog, 0, PIPELINE)
+GL_TRACE_OUT(glGetProgramPipelineInfoLog, 2)
+GL_TRACE_OUT(glGetProgramPipelineInfoLog, 3)
+GL_TRACE_OUT(glGetVertexAttribLdv, 2)
+GL_TRACE_ARRAY(glViewportArrayv, 2, 1, 4)
+GL_TRACE_ARRAY(glScissorArrayv, 2, 1, 4)
+GL_TRACE_ARRAY(glDepthRangeArrayv, 2, 1, 8)
+GL_TRACE_OUT(glGetFloati_v, 2)
+GL_TRACE_OUT(glGetDoublei_v, 2)
+GL_TRACE_OUT(glGetInternalformativ, 4)
+GL_TRACE_NAME(glGetActiveAtomicCounterBufferiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetActiveAtomicCounterBufferiv, 3)
+GL_TRACE_NAME(glBindImageTexture, 1, TEXTURE)
+GL_TRACE_NAME(glDrawTransformFeedbackInstanced, 1, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glDrawTransformFeedbackStreamInstanced, 1, TRANSFORM_FEEDBACK)
+GL_TRACE_OUT(glGetFramebufferParameteriv, 2)
+GL_TRACE_OUT(glGetInternalformati64v, 4)
+GL_TRACE_NAME(glInvalidateTexSubImage, 0, TEXTURE)
+GL_TRACE_NAME(glInvalidateTexImage, 0, TEXTURE)
+GL_TRACE_NAME(glInvalidateBufferSubData, 0, BUFFER)
+GL_TRACE_NAME(glInvalidateBufferData, 0, BUFFER)
+GL_TRACE_ARRAY(glInvalidateFramebuffer, 2, 1, 4)
+GL_TRACE_ARRAY(glInvalidateSubFramebuffer, 2, 1, 4)
+GL_TRACE_NAME(glGetProgramInterfaceiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramInterfaceiv, 3)
+GL_TRACE_NAME(glGetProgramResourceIndex, 0, PROGRAM)
+GL_TRACE_STRING(glGetProgramResourceIndex, 2, -1)
+GL_TRACE_NAME(glGetProgramResourceName, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramResourceName, 4)
+GL_TRACE_OUT(glGetProgramResourceName, 5)
+GL_TRACE_NAME(glGetProgramResourceiv, 0, PROGRAM)
+GL_TRACE_OUT(glGetProgramResourceiv, 6)
+GL_TRACE_OUT(glGetProgramResourceiv, 7)
+GL_TRACE_NAME(glGetProgramResourceLocation, 0, PROGRAM)
+GL_TRACE_STRING(glGetProgramResourceLocation, 2, -1)
+GL_TRACE_NAME(glGetProgramResourceLocationIndex, 0, PROGRAM)
+GL_TRACE_STRING(glGetProgramResourceLocationIndex, 2, -1)
+GL_TRACE_NAME(glShaderStorageBlockBinding, 0, PROGRAM)
+GL_TRACE_NAME(glTexBufferRange, 2, BUFFER)
+GL_TRACE_NAME(glTextureView, 0, TEXTURE)
+GL_TRACE_NAME(glTextureView, 2, TEXTURE)
+GL_TRACE_NAME(glBindVertexBuffer, 1, BUFFER)
+GL_TRACE_ARRAY(glDebugMessageControl, 4, 3, 4)
+GL_TRACE_STRING(glDebugMessageInsert, 5, 4)
+GL_TRACE_OUT(glGetDebugMessageLog, 2)
+GL_TRACE_OUT(glGetDebugMessageLog, 3)
+GL_TRACE_OUT(glGetDebugMessageLog, 4)
+GL_TRACE_OUT(glGetDebugMessageLog, 5)
+GL_TRACE_OUT(glGetDebugMessageLog, 6)
+GL_TRACE_OUT(glGetDebugMessageLog, 7)
+GL_TRACE_STRING(glPushDebugGroup, 3, 2)
+GL_TRACE_STRING(glObjectLabel, 3, 2)
+GL_TRACE_OUT(glGetObjectLabel, 3)
+GL_TRACE_OUT(glGetObjectLabel, 4)
+GL_TRACE_STRING(glObjectPtrLabel, 2, 1)
+GL_TRACE_OUT(glGetObjectPtrLabel, 2)
+GL_TRACE_OUT(glGetObjectPtrLabel, 3)
+GL_TRACE_NAME(glClearTexImage, 0, TEXTURE)
+GL_TRACE_NAME(glClearTexSubImage, 0, TEXTURE)
+GL_TRACE_NAMES(glBindBuffersBase, 3, 2, BUFFER)
+GL_TRACE_NAMES(glBindBuffersRange, 3, 2, BUFFER)
+GL_TRACE_ARRAY(glBindBuffersRange, 4, 2, 8)
+GL_TRACE_ARRAY(glBindBuffersRange, 5, 2, 8)
+GL_TRACE_NAMES(glBindTextures, 2, 1, TEXTURE)
+GL_TRACE_NAMES(glBindSamplers, 2, 1, SAMPLER)
+GL_TRACE_NAMES(glBindImageTextures, 2, 1, TEXTURE)
+GL_TRACE_NAMES(glBindVertexBuffers, 2, 1, BUFFER)
+GL_TRACE_ARRAY(glBindVertexBuffers, 3, 1, 8)
+GL_TRACE_ARRAY(glBindVertexBuffers, 4, 1, 4)
+GL_TRACE_GEN(glCreateTransformFeedbacks, 1, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glTransformFeedbackBufferBase, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glTransformFeedbackBufferBase, 2, BUFFER)
+GL_TRACE_NAME(glTransformFeedbackBufferRange, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_NAME(glTransformFeedbackBufferRange, 2, BUFFER)
+GL_TRACE_NAME(glGetTransformFeedbackiv, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_OUT(glGetTransformFeedbackiv, 2)
+GL_TRACE_NAME(glGetTransformFeedbacki_v, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_OUT(glGetTransformFeedbacki_v, 3)
+GL_TRACE_NAME(glGetTransformFeedbacki64_v, 0, TRANSFORM_FEEDBACK)
+GL_TRACE_OUT(glGetTransformFeedbacki64_v, 3)
+GL_TRACE_GEN(glCreateBuffers, 1, 0, BUFFER)
+GL_TRACE_NAME(glNamedBufferStorage, 0, BUFFER)
+GL_TRACE_NAME(glNamedBufferData, 0, BUFFER)
+GL_TRACE_NAME(glNamedBufferSubData, 0, BUFFER)
+GL_TRACE_NAME(glCopyNamedBufferSubData, 0, BUFFER)
+GL_TRACE_NAME(glCopyNamedBufferSubData, 1, BUFFER)
+GL_TRACE_NAME(glClearNamedBufferData, 0, BUFFER)
+GL_TRACE_NAME(glClearNamedBufferSubData, 0, BUFFER)
+GL_TRACE_NAME(glMapNamedBuffer, 0, BUFFER)
+GL_TRACE_NAME(glMapNamedBufferRange, 0, BUFFER)
+GL_TRACE_NAME(glUnmapNamedBuffer, 0, BUFFER)
+GL_TRACE_NAME(glFlushMappedNamedBufferRange, 0, BUFFER)
+GL_TRACE_NAME(glGetNamedBufferParameteriv, 0, BUFFER)
+GL_TRACE_OUT(glGetNamedBufferParameteriv, 2)
+GL_TRACE_NAME(glGetNamedBufferParameteri64v, 0, BUFFER)
+GL_TRACE_OUT(glGetNamedBufferParameteri64v, 2)
+GL_TRACE_NAME(glGetNamedBufferPointerv, 0, BUFFER)
+GL_TRACE_NAME(glGetNamedBufferSubData, 0, BUFFER)
+GL_TRACE_OUT(glGetNamedBufferSubData, 3)
+GL_TRACE_GEN(glCreateFramebuffers, 1, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferRenderbuffer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferRenderbuffer, 3, RENDERBUFFER)
+GL_TRACE_NAME(glNamedFramebufferParameteri, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferTexture, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferTexture, 2, TEXTURE)
+GL_TRACE_NAME(glNamedFramebufferTextureLayer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferTextureLayer, 2, TEXTURE)
+GL_TRACE_NAME(glNamedFramebufferDrawBuffer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glNamedFramebufferDrawBuffers, 0, FRAMEBUFFER)
+GL_TRACE_ARRAY(glNamedFramebufferDrawBuffers, 2, 1, 4)
+GL_TRACE_NAME(glNamedFramebufferReadBuffer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glInvalidateNamedFramebufferData, 0, FRAMEBUFFER)
+GL_TRACE_ARRAY(glInvalidateNamedFramebufferData, 2, 1, 4)
+GL_TRACE_NAME(glInvalidateNamedFramebufferSubData, 0, FRAMEBUFFER)
+GL_TRACE_ARRAY(glInvalidateNamedFramebufferSubData, 2, 1, 4)
+GL_TRACE_NAME(glClearNamedFramebufferiv, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glClearNamedFramebufferuiv, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glClearNamedFramebufferfv, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glClearNamedFramebufferfi, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glBlitNamedFramebuffer, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glBlitNamedFramebuffer, 1, FRAMEBUFFER)
+GL_TRACE_NAME(glCheckNamedFramebufferStatus, 0, FRAMEBUFFER)
+GL_TRACE_NAME(glGetNamedFramebufferParameteriv, 0, FRAMEBUFFER)
+GL_TRACE_OUT(glGetNamedFramebufferParameteriv, 2)
+GL_TRACE_NAME(glGetNamedFramebufferAttachmentParameteriv, 0, FRAMEBUFFER)
+GL_TRACE_OUT(glGetNamedFramebufferAttachmentParameteriv, 3)
+GL_TRACE_GEN(glCreateRenderbuffers, 1, 0, RENDERBUFFER)
+GL_TRACE_NAME(glNamedRenderbufferStorage, 0, RENDERBUFFER)
+GL_TRACE_NAME(glNamedRenderbufferStorageMultisample, 0, RENDERBUFFER)
+GL_TRACE_NAME(glGetNamedRenderbufferParameteriv, 0, RENDERBUFFER)
+GL_TRACE_OUT(glGetNamedRenderbufferParameteriv, 2)
+GL_TRACE_GEN(glCreateTextures, 2, 1, TEXTURE)
+GL_TRACE_NAME(glTextureBuffer, 0, TEXTURE)
+GL_TRACE_NAME(glTextureBuffer, 2, BUFFER)
+GL_TRACE_NAME(glTextureBufferRange, 0, TEXTURE)
+GL_TRACE_NAME(glTextureBufferRange, 2, BUFFER)
+GL_TRACE_NAME(glTextureStorage1D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureStorage2D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureStorage3D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureStorage2DMultisample, 0, TEXTURE)
+GL_TRACE_NAME(glTextureStorage3DMultisample, 0, TEXTURE)
+GL_TRACE_NAME(glTextureSubImage1D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureSubImage2D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureSubImage3D, 0, TEXTURE)
+GL_TRACE_NAME(glCompressedTextureSubImage1D, 0, TEXTURE)
+GL_TRACE_NAME(glCompressedTextureSubImage2D, 0, TEXTURE)
+GL_TRACE_NAME(glCompressedTextureSubImage3D, 0, TEXTURE)
+GL_TRACE_NAME(glCopyTextureSubImage1D, 0, TEXTURE)
+GL_TRACE_NAME(glCopyTextureSubImage2D, 0, TEXTURE)
+GL_TRACE_NAME(glCopyTextureSubImage3D, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameterf, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameterfv, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameteri, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameterIiv, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameterIuiv, 0, TEXTURE)
+GL_TRACE_NAME(glTextureParameteriv, 0, TEXTURE)
+GL_TRACE_NAME(glGenerateTextureMipmap, 0, TEXTURE)
+GL_TRACE_NAME(glBindTextureUnit, 1, TEXTURE)
+GL_TRACE_NAME(glGetTextureImage, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureImage, 5)
+GL_TRACE_NAME(glGetCompressedTextureImage, 0, TEXTURE)
+GL_TRACE_OUT(glGetCompressedTextureImage, 3)
+GL_TRACE_NAME(glGetTextureLevelParameterfv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureLevelParameterfv, 3)
+GL_TRACE_NAME(glGetTextureLevelParameteriv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureLevelParameteriv, 3)
+GL_TRACE_NAME(glGetTextureParameterfv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureParameterfv, 2)
+GL_TRACE_NAME(glGetTextureParameterIiv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureParameterIiv, 2)
+GL_TRACE_NAME(glGetTextureParameterIuiv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureParameterIuiv, 2)
+GL_TRACE_NAME(glGetTextureParameteriv, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureParameteriv, 2)
+GL_TRACE_GEN(glCreateVertexArrays, 1, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glDisableVertexArrayAttrib, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glEnableVertexArrayAttrib, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayElementBuffer, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayElementBuffer, 1, BUFFER)
+GL_TRACE_NAME(glVertexArrayVertexBuffer, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayVertexBuffer, 2, BUFFER)
+GL_TRACE_NAME(glVertexArrayVertexBuffers, 0, VERTEX_ARRAY)
+GL_TRACE_NAMES(glVertexArrayVertexBuffers, 3, 2, BUFFER)
+GL_TRACE_ARRAY(glVertexArrayVertexBuffers, 4, 2, 8)
+GL_TRACE_ARRAY(glVertexArrayVertexBuffers, 5, 2, 4)
+GL_TRACE_NAME(glVertexArrayAttribBinding, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayAttribFormat, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayAttribIFormat, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayAttribLFormat, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glVertexArrayBindingDivisor, 0, VERTEX_ARRAY)
+GL_TRACE_NAME(glGetVertexArrayiv, 0, VERTEX_ARRAY)
+GL_TRACE_OUT(glGetVertexArrayiv, 2)
+GL_TRACE_NAME(glGetVertexArrayIndexediv, 0, VERTEX_ARRAY)
+GL_TRACE_OUT(glGetVertexArrayIndexediv, 3)
+GL_TRACE_NAME(glGetVertexArrayIndexed64iv, 0, VERTEX_ARRAY)
+GL_TRACE_OUT(glGetVertexArrayIndexed64iv, 3)
+GL_TRACE_GEN(glCreateSamplers, 1, 0, SAMPLER)
+GL_TRACE_GEN(glCreateProgramPipelines, 1, 0, PIPELINE)
+GL_TRACE_GEN(glCreateQueries, 2, 1, QUERY)
+GL_TRACE_NAME(glGetQueryBufferObjecti64v, 0, QUERY)
+GL_TRACE_NAME(glGetQueryBufferObjecti64v, 1, BUFFER)
+GL_TRACE_NAME(glGetQueryBufferObjectiv, 0, QUERY)
+GL_TRACE_NAME(glGetQueryBufferObjectiv, 1, BUFFER)
+GL_TRACE_NAME(glGetQueryBufferObjectui64v, 0, QUERY)
+GL_TRACE_NAME(glGetQueryBufferObjectui64v, 1, BUFFER)
+GL_TRACE_NAME(glGetQueryBufferObjectuiv, 0, QUERY)
+GL_TRACE_NAME(glGetQueryBufferObjectuiv, 1, BUFFER)
+GL_TRACE_NAME(glGetTextureSubImage, 0, TEXTURE)
+GL_TRACE_OUT(glGetTextureSubImage, 11)
+GL_TRACE_NAME(glGetCompressedTextureSubImage, 0, TEXTURE)
+GL_TRACE_OUT(glGetCompressedTextureSubImage, 9)
+GL_TRACE_OUT(glGetnCompressedTexImage, 3)
+GL_TRACE_OUT(glGetnTexImage, 5)
+GL_TRACE_NAME(glGetnUniformdv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetnUniformdv, 1, 0)
+GL_TRACE_OUT(glGetnUniformdv, 3)
+GL_TRACE_NAME(glGetnUniformfv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetnUniformfv, 1, 0)
+GL_TRACE_OUT(glGetnUniformfv, 3)
+GL_TRACE_NAME(glGetnUniformiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetnUniformiv, 1, 0)
+GL_TRACE_OUT(glGetnUniformiv, 3)
+GL_TRACE_NAME(glGetnUniformuiv, 0, PROGRAM)
+GL_TRACE_LOCATION(glGetnUniformuiv, 1, 0)
+GL_TRACE_OUT(glGetnUniformuiv, 3)
+GL_TRACE_OUT(glGetnMapdv, 3)
+GL_TRACE_OUT(glGetnMapfv, 3)
+GL_TRACE_OUT(glGetnMapiv, 3)
+GL_TRACE_OUT(glGetnPixelMapfv, 2)
+GL_TRACE_OUT(glGetnPixelMapuiv, 2)
+GL_TRACE_OUT(glGetnPixelMapusv, 2)
+GL_TRACE_OUT(glGetnPolygonStipple, 1)
+GL_TRACE_OUT(glGetnColorTable, 4)
+GL_TRACE_OUT(glGetnConvolutionFilter, 4)
+GL_TRACE_OUT(glGetnSeparableFilter, 4)
+GL_TRACE_OUT(glGetnSeparableFilter, 6)
+GL_TRACE_OUT(glGetnSeparableFilter, 7)
+GL_TRACE_OUT(glGetnHistogram, 5)
+GL_TRACE_OUT(glGetnMinmax, 5)
+GL_TRACE_NAME(glSpecializeShader, 0, PROGRAM)
+GL_TRACE_STRING(glSpecializeShader, 1, -1)
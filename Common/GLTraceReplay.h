@@ -0,0 +1,631 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "GLInterceptor.h"
+#include "GLTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//Runs a GLTrace file again on the current context (TraceReplay uses the headless one): Setup() replays the part
+//recorded before the start frame once, then every Frame() one recorded frame, as fast as the driver takes them.
+//Object names, uniform locations and block indices the driver hands out are mapped from the recorded ones, and the
+//recorded default framebuffer becomes the one given to Setup(), with GL_BACK drawing going to its first color
+//attachment when that is a framebuffer object. Every call is timed on the cpu per entry point, and every frame end
+//to end; Frame(true) closes the frame with a glFinish so its time covers the gpu as well.
+//Calls the trace could not record are listed by Print(), the frames run without them.
+class GLTraceReplay
+{
+public:
+	struct Header
+	{
+		int width = 0;
+		int height = 0;
+		GLuint defaultFramebuffer = 0;
+		int startFrame = 0;
+		int frames = 0;
+		std::string renderer;
+	};
+
+	struct EntryTiming
+	{
+		uint64_t calls = 0;
+		uint64_t totalNs = 0;
+		uint64_t maxNs = 0;
+	};
+
+	bool Load(const std::string& path);
+	const Header& GetHeader() const { return header; }
+
+	//with the context current, before the first Frame()
+	void Setup(GLuint defaultFramebuffer);
+	//false once the trace has no whole frame left
+	bool Frame(bool finish = false);
+	//back to the first recorded frame, for another loop
+	void Rewind() { position = framesStart; }
+
+	const std::vector<float>& FrameMs() const { return frameMs; }
+	void Print(std::ostream& out, int top = 20) const;
+	bool WriteReport(const std::string& path) const;
+
+private:
+	template<int Id, typename F> friend struct GLTraceReplayHook;
+	template<typename T, int Type> friend struct GLTraceArg;
+
+	typedef void (*Replayer)(GLTraceReplay& replay);
+
+	struct Mapping
+	{
+		GLintptr offset = 0;
+		char* pointer = nullptr;
+	};
+
+	std::string file;
+	Header header;
+	std::vector<char> data;
+	size_t position = 0;
+	size_t framesStart = 0;
+	//the record being replayed
+	size_t cursor = 0;
+	size_t recordEnd = 0;
+
+	Replayer replayers[GLInterceptor::ENTRY_POINT_COUNT] = {};
+	EntryTiming timings[GLInterceptor::ENTRY_POINT_COUNT];
+	uint64_t skipped[GLInterceptor::ENTRY_POINT_COUNT] = {};
+	uint64_t missing[GLInterceptor::ENTRY_POINT_COUNT] = {};
+	std::vector<float> frameMs;
+	float setupMs = 0.0f;
+	uint64_t mappedBytes = 0;
+
+	//the arguments of the call being replayed, as recorded and as pointers to hand over
+	int64_t raw[GLTrace::MAX_ARGS] = {};
+	void* pointers[GLTrace::MAX_ARGS] = {};
+	std::vector<char> scratch[GLTrace::MAX_ARGS];
+	const GLchar* source = nullptr;
+
+	GLuint defaultFramebuffer = 0;
+	GLuint drawFramebuffer = 0;
+	GLuint readFramebuffer = 0;
+	int64_t program = 0;
+	std::unordered_map<GLuint, GLuint> names[GLTrace::NAME_KIND_COUNT];
+	std::unordered_map<uint64_t, GLint> locations;		// per recorded program and location
+	std::unordered_map<uint64_t, GLuint> blocks;
+	std::unordered_map<int64_t, GLsync> syncs;
+	std::unordered_map<GLenum, GLuint> buffers;			// recorded names, bound per target
+	std::unordered_map<GLuint, Mapping> mappings;		// per recorded buffer
+	GLTrace::PixelStore pack;
+
+private:
+	int64_t readU64();
+	//the blob's bytes, nullptr for NO_BLOB
+	char* readBlob(uint64_t& size);
+	//runs records until one of the given kind, false at the end of the trace
+	bool runUntil(uint16_t marker);
+	void mapped();
+
+	//per call, around the driver's function
+	void decode(int id, int argc);
+	int64_t value(int id, int index) const;
+	GLuint name(int kind, int64_t recorded) const;
+	GLenum drawBuffer(GLuint framebuffer, GLenum buffer) const;
+	void* scratchFor(int index, uint64_t size);
+	void returned(int id, int argc, int64_t result);
+	static uint64_t key(int64_t program, int64_t value) { return (uint64_t)program << 32 | (uint32_t)value; }
+};
+
+//decodes one argument of type T: 0 integers, 1 floating point, 2 pointers, 3 sync objects
+template<typename T, int Type = std::is_same<T, GLsync>::value ? 3 : std::is_pointer<T>::value ? 2 : std::is_floating_point<T>::value ? 1 : 0>
+struct GLTraceArg;
+
+template<typename T> struct GLTraceArg<T, 0>
+{
+	static T Decode(const GLTraceReplay& replay, int id, int index) { return (T)replay.value(id, index); }
+};
+
+template<typename T> struct GLTraceArg<T, 1>
+{
+	static T Decode(const GLTraceReplay& replay, int, int index)
+	{
+		T value;
+		std::memcpy(&value, &replay.raw[index], sizeof(T));
+		return value;
+	}
+};
+
+template<typename T> struct GLTraceArg<T, 2>
+{
+	static T Decode(const GLTraceReplay& replay, int, int index) { return (T)replay.pointers[index]; }
+};
+
+template<typename T> struct GLTraceArg<T, 3>
+{
+	static T Decode(const GLTraceReplay& replay, int, int index)
+	{
+		auto it = replay.syncs.find(replay.raw[index]);
+		return it != replay.syncs.end() ? it->second : nullptr;
+	}
+};
+
+//one instance per entry point: Replay decodes a recorded call, times the driver's function on it and maps what it returned
+template<int Id, typename F> struct GLTraceReplayHook;
+
+template<int Id, typename R, typename... A>
+struct GLTraceReplayHook<Id, R (APIENTRYP)(A...)>
+{
+	static R (APIENTRYP function)(A...);
+
+	static void Replay(GLTraceReplay& replay)
+	{
+		if (!function || sizeof...(A) > GLTrace::MAX_ARGS)
+		{
+			++replay.missing[Id];
+			return;
+		}
+		replay.decode(Id, sizeof...(A));
+		call(replay, std::index_sequence_for<A...>());
+	}
+
+	template<size_t... I>
+	static void call(GLTraceReplay& replay, std::index_sequence<I...>)
+	{
+		std::tuple<A...> args{ GLTraceArg<A>::Decode(replay, Id, (int)I)... };
+
+		GLTraceResult<R> result;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		result.Call(function, std::get<I>(args)...);
+		uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		GLTraceReplay::EntryTiming& timing = replay.timings[Id];
+		++timing.calls;
+		timing.totalNs += ns;
+		timing.maxNs = std::max(timing.maxNs, ns);
+		replay.returned(Id, sizeof...(A), result.Bits());
+	}
+};
+
+template<int Id, typename R, typename... A>
+R (APIENTRYP GLTraceReplayHook<Id, R (APIENTRYP)(A...)>::function)(A...) = nullptr;
+
+inline bool GLTraceReplay::Load(const std::string& path)
+{
+	file = path;
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in)
+	{
+		std::cout << "Error: could not read GL trace " << path << std::endl;
+		return false;
+	}
+	data.resize((size_t)in.tellg());
+	in.seekg(0);
+	in.read(data.data(), data.size());
+
+	uint32_t magic = 0, version = 0;
+	if (data.size() >= 8)
+	{
+		std::memcpy(&magic, &data[0], 4);
+		std::memcpy(&version, &data[4], 4);
+	}
+	if (!in || magic != GLTrace::FILE_MAGIC || version != GLTrace::FILE_VERSION)
+	{
+		std::cout << "Error: " << path << " is not a GL trace" << std::endl;
+		return false;
+	}
+
+	position = 8;
+	recordEnd = data.size();
+	cursor = position;
+	header.width = (int)readU64();
+	header.height = (int)readU64();
+	header.defaultFramebuffer = (GLuint)readU64();
+	header.startFrame = (int)readU64();
+	header.frames = (int)readU64();
+	uint64_t size = 0;
+	const char* renderer = readBlob(size);
+	header.renderer.assign(renderer ? renderer : "", renderer ? (size_t)size : 0);
+	position = cursor;
+	return true;
+}
+
+inline void GLTraceReplay::Setup(GLuint framebuffer)
+{
+#define GL_ENTRY_POINT(name) \
+	GLTraceReplayHook<GLInterceptor::EP_##name, decltype(glad_##name)>::function = glad_##name; \
+	replayers[GLInterceptor::EP_##name] = GLTraceReplayHook<GLInterceptor::EP_##name, decltype(glad_##name)>::Replay;
+#include "GLEntryPoints.h"
+#undef GL_ENTRY_POINT
+	GLTrace::buildRules();
+
+	defaultFramebuffer = framebuffer;
+	drawFramebuffer = readFramebuffer = framebuffer;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!runUntil(GLTrace::SETUP_END))
+		std::cout << "Error: " << file << " ends before its first frame" << std::endl;
+	glFinish();
+	setupMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	framesStart = position;
+}
+
+inline bool GLTraceReplay::Frame(bool finish)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!runUntil(GLTrace::FRAME_END))
+		return false;
+	if (finish)
+		glFinish();
+	frameMs.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+	return true;
+}
+
+inline bool GLTraceReplay::runUntil(uint16_t marker)
+{
+	while (position + 8 <= data.size())
+	{
+		uint16_t id;
+		uint32_t size;
+		std::memcpy(&id, &data[position], 2);
+		std::memcpy(&size, &data[position + 4], 4);
+		cursor = position + 8;
+		recordEnd = cursor + size;
+		if (recordEnd > data.size())
+			break;
+		position = recordEnd;
+
+		if (id == marker)
+			return true;
+		if (id == GLTrace::MAPPED_DATA)
+		{
+			mapped();
+		}
+		else if (id == GLTrace::SKIPPED)
+		{
+			int64_t entry = readU64();
+			if (entry >= 0 && entry < GLInterceptor::ENTRY_POINT_COUNT)
+				++skipped[entry];
+		}
+		else if (id < GLInterceptor::ENTRY_POINT_COUNT && replayers[id])
+		{
+			replayers[id](*this);
+		}
+	}
+	position = data.size();
+	return false;
+}
+
+inline int64_t GLTraceReplay::readU64()
+{
+	int64_t value = 0;
+	if (cursor + 8 <= recordEnd)
+		std::memcpy(&value, &data[cursor], 8);
+	cursor += 8;
+	return value;
+}
+
+inline char* GLTraceReplay::readBlob(uint64_t& size)
+{
+	size = (uint32_t)readU64();
+	if (size == GLTrace::NO_BLOB || cursor + size > recordEnd)
+		return nullptr;
+	char* blob = &data[cursor];
+	cursor += (size + 7) & ~(uint64_t)7;
+	return blob;
+}
+
+inline void GLTraceReplay::mapped()
+{
+	GLuint buffer = (GLuint)readU64();
+	int64_t offset = readU64();
+	uint64_t size = readU64();
+	auto it = mappings.find(buffer);
+	if (it == mappings.end() || cursor + size > recordEnd)
+		return;
+	std::memcpy(it->second.pointer + (offset - it->second.offset), &data[cursor], (size_t)size);
+	mappedBytes += size;
+}
+
+inline void GLTraceReplay::decode(int id, int argc)
+{
+	const GLTrace::EntryRule& rule = GLTrace::rules()[id];
+	for (int i = 0; i < argc; ++i)
+	{
+		raw[i] = readU64();
+		pointers[i] = (void*)(intptr_t)raw[i];
+	}
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const GLTrace::ArgRule& a = rule.args[i];
+		if (GLTrace::inputBlob(a.kind))
+		{
+			uint64_t size;
+			char* blob = readBlob(size);
+			if (!blob)
+				continue;
+			pointers[i] = blob;
+			if (a.kind == GLTrace::ARG_NAMES)
+			{
+				//a copy, the trace may loop
+				GLuint* translated = (GLuint*)scratchFor(i, size);
+				std::memcpy(translated, blob, (size_t)size);
+				for (uint64_t j = 0; j < size / sizeof(GLuint); ++j)
+					translated[j] = name(a.detail, translated[j]);
+				pointers[i] = translated;
+			}
+			else if (a.kind == GLTrace::ARG_SHADER_SOURCE)
+			{
+				source = blob;
+				pointers[i] = &source;
+			}
+			else if (id == GLInterceptor::EP_glDrawBuffers || id == GLInterceptor::EP_glNamedFramebufferDrawBuffers)
+			{
+				GLuint framebuffer = id == GLInterceptor::EP_glDrawBuffers ? drawFramebuffer : name(GLTrace::FRAMEBUFFER, raw[0]);
+				GLenum* translated = (GLenum*)scratchFor(i, size);
+				std::memcpy(translated, blob, (size_t)size);
+				for (uint64_t j = 0; j < size / sizeof(GLenum); ++j)
+					translated[j] = drawBuffer(framebuffer, translated[j]);
+				pointers[i] = translated;
+			}
+			continue;
+		}
+
+		switch (a.kind)
+		{
+		case GLTrace::ARG_GEN:
+			pointers[i] = scratchFor(i, sizeof(GLuint) * std::max<int64_t>(raw[a.count], 0));
+			break;
+		case GLTrace::ARG_OUT:
+			pointers[i] = scratchFor(i, 1 << 20);
+			break;
+		case GLTrace::ARG_OUT_BYTES:
+		case GLTrace::ARG_OUT_PIXELS:
+			//into a bound pack buffer the pointer is an offset
+			if (!buffers[GL_PIXEL_PACK_BUFFER])
+				pointers[i] = scratchFor(i, a.kind == GLTrace::ARG_OUT_BYTES ? raw[a.count] : GLTrace::imageBytes(rule, raw, pack));
+			break;
+		case GLTrace::ARG_IGNORED:
+			pointers[i] = nullptr;
+			break;
+		}
+	}
+}
+
+inline int64_t GLTraceReplay::value(int id, int index) const
+{
+	const GLTrace::ArgRule& a = GLTrace::rules()[id].args[index];
+	int64_t recorded = raw[index];
+	switch (a.kind)
+	{
+	case GLTrace::ARG_NAME:
+		return name(a.detail, recorded);
+	case GLTrace::ARG_LOCATION:
+	{
+		auto it = locations.find(key(a.count < 0 ? program : raw[a.count], recorded));
+		return it != locations.end() ? it->second : recorded;
+	}
+	case GLTrace::ARG_BLOCK:
+	{
+		auto it = blocks.find(key(raw[a.count], recorded));
+		return it != blocks.end() ? it->second : recorded;
+	}
+	case GLTrace::ARG_DRAW_BUFFER:
+	{
+		GLuint framebuffer = a.count >= 0 ? name(GLTrace::FRAMEBUFFER, raw[a.count])
+			: id == GLInterceptor::EP_glReadBuffer ? readFramebuffer : drawFramebuffer;
+		return drawBuffer(framebuffer, (GLenum)recorded);
+	}
+	}
+	//the joined source is the only string
+	if (id == GLInterceptor::EP_glShaderSource && index == 1)
+		return 1;
+	return recorded;
+}
+
+inline GLuint GLTraceReplay::name(int kind, int64_t recorded) const
+{
+	if (kind == GLTrace::FRAMEBUFFER && (recorded == 0 || recorded == header.defaultFramebuffer))
+		return defaultFramebuffer;
+	auto it = names[kind].find((GLuint)recorded);
+	return it != names[kind].end() ? it->second : (GLuint)recorded;
+}
+
+inline GLenum GLTraceReplay::drawBuffer(GLuint framebuffer, GLenum buffer) const
+{
+	if (framebuffer != defaultFramebuffer)
+		return buffer;
+	//a window's buffers on a framebuffer object and the other way around
+	bool windowBuffer = buffer == GL_BACK || buffer == GL_FRONT || buffer == GL_BACK_LEFT || buffer == GL_FRONT_LEFT
+		|| buffer == GL_LEFT || buffer == GL_FRONT_AND_BACK;
+	if (defaultFramebuffer && windowBuffer)
+		return GL_COLOR_ATTACHMENT0;
+	if (!defaultFramebuffer && buffer == GL_COLOR_ATTACHMENT0)
+		return GL_BACK;
+	return buffer;
+}
+
+inline void* GLTraceReplay::scratchFor(int index, uint64_t size)
+{
+	std::vector<char>& s = scratch[index];
+	if (s.size() < size)
+		s.resize((size_t)size);
+	return s.data();
+}
+
+inline void GLTraceReplay::returned(int id, int argc, int64_t result)
+{
+	const GLTrace::EntryRule& rule = GLTrace::rules()[id];
+	int64_t recorded = readU64();
+	if (rule.returnName != GLTrace::NAME_KIND_COUNT)
+		names[rule.returnName][(GLuint)recorded] = (GLuint)result;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		if (rule.args[i].kind != GLTrace::ARG_GEN)
+			continue;
+		uint64_t size;
+		const char* blob = readBlob(size);
+		if (!blob)
+			continue;
+		const GLuint* generated = (const GLuint*)pointers[i];
+		for (uint64_t j = 0; j < size / sizeof(GLuint); ++j)
+		{
+			GLuint from;
+			std::memcpy(&from, blob + j * sizeof(GLuint), sizeof(GLuint));
+			names[rule.args[i].detail][from] = generated[j];
+		}
+	}
+
+	switch (id)
+	{
+	case GLInterceptor::EP_glGetUniformLocation:
+		locations[key(raw[0], recorded)] = (GLint)result;
+		break;
+	case GLInterceptor::EP_glGetProgramResourceLocation:
+		if (raw[1] == GL_UNIFORM)
+			locations[key(raw[0], recorded)] = (GLint)result;
+		break;
+	case GLInterceptor::EP_glGetUniformBlockIndex:
+		blocks[key(raw[0], recorded)] = (GLuint)result;
+		break;
+	case GLInterceptor::EP_glGetProgramResourceIndex:
+		if (raw[1] == GL_UNIFORM_BLOCK)
+			blocks[key(raw[0], recorded)] = (GLuint)result;
+		break;
+	case GLInterceptor::EP_glUseProgram:
+		program = raw[0];
+		break;
+	case GLInterceptor::EP_glBindFramebuffer:
+	{
+		GLuint framebuffer = name(GLTrace::FRAMEBUFFER, raw[1]);
+		if (raw[0] == GL_FRAMEBUFFER || raw[0] == GL_DRAW_FRAMEBUFFER)
+			drawFramebuffer = framebuffer;
+		if (raw[0] == GL_FRAMEBUFFER || raw[0] == GL_READ_FRAMEBUFFER)
+			readFramebuffer = framebuffer;
+		break;
+	}
+	case GLInterceptor::EP_glBindBuffer:
+	case GLInterceptor::EP_glBindBufferBase:
+	case GLInterceptor::EP_glBindBufferRange:
+		buffers[(GLenum)raw[0]] = (GLuint)raw[id == GLInterceptor::EP_glBindBuffer ? 1 : 2];
+		break;
+	case GLInterceptor::EP_glPixelStorei:
+		if (raw[0] == GL_PACK_ALIGNMENT)
+			pack.alignment = (GLint)raw[1];
+		else if (raw[0] == GL_PACK_ROW_LENGTH)
+			pack.rowLength = (GLint)raw[1];
+		else if (raw[0] == GL_PACK_IMAGE_HEIGHT)
+			pack.imageHeight = (GLint)raw[1];
+		break;
+	case GLInterceptor::EP_glFenceSync:
+		syncs[recorded] = (GLsync)(intptr_t)result;
+		break;
+	case GLInterceptor::EP_glDeleteSync:
+		syncs.erase(raw[0]);
+		break;
+	case GLInterceptor::EP_glMapBuffer:
+	case GLInterceptor::EP_glMapBufferRange:
+	case GLInterceptor::EP_glMapNamedBuffer:
+	case GLInterceptor::EP_glMapNamedBufferRange:
+	{
+		bool named = id == GLInterceptor::EP_glMapNamedBuffer || id == GLInterceptor::EP_glMapNamedBufferRange;
+		bool range = id == GLInterceptor::EP_glMapBufferRange || id == GLInterceptor::EP_glMapNamedBufferRange;
+		GLuint buffer = named ? (GLuint)raw[0] : buffers[(GLenum)raw[0]];
+		if (!result)
+			break;
+		Mapping& mapping = mappings[buffer];
+		mapping.offset = range ? (GLintptr)raw[1] : 0;
+		mapping.pointer = (char*)(intptr_t)result;
+		break;
+	}
+	case GLInterceptor::EP_glUnmapBuffer:
+		mappings.erase(buffers[(GLenum)raw[0]]);
+		break;
+	case GLInterceptor::EP_glUnmapNamedBuffer:
+		mappings.erase((GLuint)raw[0]);
+		break;
+	}
+}
+
+inline void GLTraceReplay::Print(std::ostream& out, int top) const
+{
+	std::vector<float> sorted = frameMs;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (float ms : sorted)
+		total += ms;
+	int frames = std::max((int)sorted.size(), 1);
+	auto percentile = [&sorted](double p) { return sorted.empty() ? 0.0f : sorted[std::min((size_t)(p * sorted.size()), sorted.size() - 1)]; };
+
+	char line[256];
+	out << "Replayed " << sorted.size() << " frames of " << file << ", recorded on " << header.renderer << std::endl;
+	std::snprintf(line, sizeof(line), "setup %.1f ms, frame mean %.3f ms, p50 %.3f, p95 %.3f, max %.3f, mapped data %.1f KB per frame\n",
+		setupMs, total / frames, percentile(0.5), percentile(0.95), sorted.empty() ? 0.0f : sorted.back(), mappedBytes / 1024.0 / frames);
+	out << line;
+
+	std::vector<int> order;
+	for (int i = 0; i < GLInterceptor::ENTRY_POINT_COUNT; ++i)
+	{
+		if (timings[i].calls)
+			order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [this](int a, int b) { return timings[a].totalNs > timings[b].totalNs; });
+	if ((int)order.size() > top)
+		order.resize(top);
+	std::snprintf(line, sizeof(line), "  %-32s %10s %12s %10s %10s\n", "cpu time per call", "calls", "total ms", "mean us", "max us");
+	out << line;
+	for (int i : order)
+	{
+		const EntryTiming& t = timings[i];
+		std::snprintf(line, sizeof(line), "  %-32s %10llu %12.3f %10.3f %10.3f\n", GLInterceptor::Name(i), (unsigned long long)t.calls,
+			t.totalNs / 1e6, t.totalNs / 1e3 / t.calls, t.maxNs / 1e3);
+		out << line;
+	}
+
+	for (int i = 0; i < GLInterceptor::ENTRY_POINT_COUNT; ++i)
+	{
+		if (skipped[i])
+			out << "  not recorded: " << GLInterceptor::Name(i) << " x" << skipped[i] << std::endl;
+		if (missing[i])
+			out << "  not available here: " << GLInterceptor::Name(i) << " x" << missing[i] << std::endl;
+	}
+}
+
+inline bool GLTraceReplay::WriteReport(const std::string& path) const
+{
+	std::ofstream out(path);
+	if (!out)
+	{
+		std::cout << "Error: could not write " << path << std::endl;
+		return false;
+	}
+
+	out << "{\n  \"trace\": \"" << file << "\",\n  \"setupMs\": " << setupMs << ",\n  \"frameMs\": [";
+	for (size_t i = 0; i < frameMs.size(); ++i)
+		out << (i ? ", " : "") << frameMs[i];
+	out << "],\n  \"entryPoints\": [";
+	bool first = true;
+	char line[256];
+	for (int i = 0; i < GLInterceptor::ENTRY_POINT_COUNT; ++i)
+	{
+		const EntryTiming& t = timings[i];
+		if (!t.calls)
+			continue;
+		std::snprintf(line, sizeof(line), "%s\n    { \"name\": \"%s\", \"calls\": %llu, \"totalMs\": %.4f, \"maxUs\": %.3f }",
+			first ? "" : ",", GLInterceptor::Name(i), (unsigned long long)t.calls, t.totalNs / 1e6, t.maxNs / 1e3);
+		out << line;
+		first = false;
+	}
+	out << "\n  ]\n}\n";
+	return true;
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+//Scoped gpu timer built on GL_TIMESTAMP queries.
+//Every scope writes a timestamp at its begin and end, which nests where GL_TIME_ELAPSED can not (only one
+//elapsed query may be active at a time). Queries live in a ring of FRAME_LATENCY frames: BeginFrame() reads
+//back the frame that used the slot before, by then the gpu has long finished it. A frame whose results are
+//still not there is dropped rather than waited for, so the profiler never stalls the pipeline.
+//Each scope also records the cpu time around it. A GL_TIMESTAMP read at the start of every frame maps gpu
+//time onto the CPUProfiler clock, so gpu scopes, their submission and the CPUProfiler zones of every thread
+//show up on one timeline in the Chrome trace (chrome://tracing, Perfetto).
+//Per scope averages roll over the last frames, scopes are keyed by their path ("frame/scene/shadows").
+class GPUProfiler
+{
+public:
+	static const int FRAME_LATENCY = 4;
+	static const int TRACE_FRAMES = 240;
+
+	struct Timing
+	{
+		std::string path;
+		std::string name;
+		int depth;
+		float gpuMs;		// rolling average
+		float cpuMs;
+		int lastFrame;		// frame it was last seen in
+		double gpuTotalMs = 0.0;	// summed over the frames in the totals range
+		double cpuTotalMs = 0.0;
+		int totalFrames = 0;
+	};
+
+	GPUProfiler();
+	~GPUProfiler();
+
+	//opens the "frame" scope, EndFrame() closes it
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginScope(const std::string& name);
+	void EndScope();
+
+	//in the order the scopes first ran
+	const std::vector<Timing>& Timings() const { return timings; }
+	int DroppedFrames() const { return droppedFrames; }
+	//frames [firstFrame, endFrame), counted by BeginFrame() calls from 0, also sum into the Timing totals
+	//and leave their whole gpu frame time in TotalsFrameGpuMs()
+	void SetTotalsRange(int firstFrame, int endFrame) { totalsFirst = firstFrame; totalsEnd = endFrame; }
+	const std::vector<float>& TotalsFrameGpuMs() const { return totalsFrameGpuMs; }
+	void PrintTable(std::ostream& out) const;
+	//the last TRACE_FRAMES resolved frames as process "gpu" (submission and gpu tracks) next to the cpu zones
+	bool WriteTrace(const std::string& path) const;
+
+private:
+	struct Scope
+	{
+		std::string path;
+		std::string name;
+		int depth;
+		GLuint beginQuery;
+		GLuint endQuery;
+		double cpuBegin;	// CPUProfiler::Now()
+		double cpuEnd;
+	};
+
+	struct Frame
+	{
+		std::vector<Scope> scopes;
+		std::vector<GLuint> queries;	// pool, reused every time the slot comes round
+		int usedQueries = 0;
+		int index = -1;
+		double gpuToCpu = 0.0;			// add to a gpu time in microseconds to get cpu time
+	};
+
+	struct TraceEvent
+	{
+		std::string name;
+		int depth;
+		double cpuBegin;
+		double cpuEnd;
+		double gpuBegin;
+		double gpuEnd;
+	};
+
+	Frame frames[FRAME_LATENCY];
+	int frameIndex = 0;
+	std::vector<int> openScopes;
+	std::vector<Timing> timings;
+	std::map<std::string, int> timingIndex;
+	std::deque<std::vector<TraceEvent>> trace;
+	int droppedFrames = 0;
+	int totalsFirst = 0;
+	int totalsEnd = 0;
+	std::vector<float> totalsFrameGpuMs;
+
+private:
+	GLuint nextQuery(Frame& frame);
+	void resolve(Frame& frame);
+};
+
+//Times the enclosing block, the gpu side of a pass or any other range of commands.
+class GPUProfileScope
+{
+public:
+	GPUProfileScope(GPUProfiler& profiler, const std::string& name) :profiler(profiler) { profiler.BeginScope(name); }
+	~GPUProfileScope() { profiler.EndScope(); }
+
+private:
+	GPUProfiler& profiler;
+};
+
+inline GPUProfiler::GPUProfiler()
+{
+}
+
+inline GPUProfiler::~GPUProfiler()
+{
+	for (Frame& frame : frames)
+	{
+		if (!frame.queries.empty())
+			glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+	}
+}
+
+inline void GPUProfiler::BeginFrame()
+{
+	Frame& frame = frames[frameIndex % FRAME_LATENCY];
+	if (frame.index >= 0)
+		resolve(frame);
+
+	frame.scopes.clear();
+	frame.usedQueries = 0;
+	frame.index = frameIndex;
+
+	//current gpu time without waiting for anything queued
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	frame.gpuToCpu = CPUProfiler::Now() - gpuNow / 1000.0;
+
+	BeginScope("frame");
+}
+
+inline void GPUProfiler::EndFrame()
+{
+	while (!openScopes.empty())
+		EndScope();
+	++frameIndex;
+}
+
+inline void GPUProfiler::BeginScope(const std::string& name)
+{
+	Frame& frame = frames[frameIndex % FRAME_LATENCY];
+	Scope scope;
+	scope.name = name;
+	scope.path = openScopes.empty() ? name : frame.scopes[openScopes.back()].path + '/' + name;
+	scope.depth = (int)openScopes.size();
+	scope.beginQuery = nextQuery(frame);
+	scope.endQuery = nextQuery(frame);
+	scope.cpuBegin = CPUProfiler::Now();
+	scope.cpuEnd = scope.cpuBegin;
+	glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+
+	openScopes.push_back((int)frame.scopes.size());
+	frame.scopes.push_back(scope);
+}
+
+inline void GPUProfiler::EndScope()
+{
+	if (openScopes.empty())
+	{
+		std::cout << "Error: GPUProfiler::EndScope without a matching BeginScope" << std::endl;
+		return;
+	}
+
+	Frame& frame = frames[frameIndex % FRAME_LATENCY];
+	Scope& scope = frame.scopes[openScopes.back()];
+	openScopes.pop_back();
+	glQueryCounter(scope.endQuery, GL_TIMESTAMP);
+	scope.cpuEnd = CPUProfiler::Now();
+}
+
+inline void GPUProfiler::PrintTable(std::ostream& out) const
+{
+	char line[160];
+	std::snprintf(line, sizeof(line), "%-40s %9s %9s", "scope", "gpu ms", "cpu ms");
+	out << line << '\n';
+	int latest = frameIndex - FRAME_LATENCY;
+	for (const Timing& timing : timings)
+	{
+		//scopes that stopped running (a culled pass) fall out of the table
+		if (latest - timing.lastFrame > 60)
+			continue;
+		std::string label = std::string(timing.depth * 2, ' ') + timing.name;
+		std::snprintf(line, sizeof(line), "%-40s %9.3f %9.3f", label.c_str(), timing.gpuMs, timing.cpuMs);
+		out << line << '\n';
+	}
+	if (droppedFrames > 0)
+		out << droppedFrames << " frames dropped, results were not ready in time\n";
+	out.flush();
+}
+
+inline bool GPUProfiler::WriteTrace(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "Error: failed to write gpu trace " << path << std::endl;
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"cpu\"}},\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"gpu\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":1,\"args\":{\"name\":\"submit\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":2,\"args\":{\"name\":\"gpu\"}}";
+	char event[256];
+	for (const std::vector<TraceEvent>& events : trace)
+	{
+		for (const TraceEvent& e : events)
+		{
+			std::snprintf(event, sizeof(event), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":2,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				CPUProfiler::EscapeJson(e.name).c_str(), e.cpuBegin, e.cpuEnd - e.cpuBegin);
+			file << event;
+			std::snprintf(event, sizeof(event), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":2,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f}",
+				CPUProfiler::EscapeJson(e.name).c_str(), e.gpuBegin, e.gpuEnd - e.gpuBegin);
+			file << event;
+		}
+	}
+	CPUProfiler::Get().WriteTraceEvents(file);
+	file << "\n]}\n";
+	std::cout << "GPUProfiler: wrote " << trace.size() << " frames to " << path << std::endl;
+	return true;
+}
+
+inline GLuint GPUProfiler::nextQuery(Frame& frame)
+{
+	if (frame.usedQueries == (int)frame.queries.size())
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		frame.queries.push_back(query);
+	}
+	return frame.queries[frame.usedQueries++];
+}
+
+inline void GPUProfiler::resolve(Frame& frame)
+{
+	if (frame.scopes.empty())
+		return;
+
+	//the frame scope closes last, once its end has landed every other query has too
+	GLint available = 0;
+	glGetQueryObjectiv(frame.scopes.front().endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+	{
+		++droppedFrames;
+		return;
+	}
+
+	std::vector<TraceEvent> events;
+	events.reserve(frame.scopes.size());
+	for (const Scope& scope : frame.scopes)
+	{
+		GLuint64 gpuBegin = 0, gpuEnd = 0;
+		glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &gpuBegin);
+		glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &gpuEnd);
+
+		TraceEvent e;
+		e.name = scope.name;
+		e.depth = scope.depth;
+		e.cpuBegin = scope.cpuBegin;
+		e.cpuEnd = scope.cpuEnd;
+		e.gpuBegin = gpuBegin / 1000.0 + frame.gpuToCpu;
+		e.gpuEnd = std::max(gpuEnd, gpuBegin) / 1000.0 + frame.gpuToCpu;
+		events.push_back(e);
+
+		auto it = timingIndex.find(scope.path);
+		if (it == timingIndex.end())
+		{
+			Timing timing;
+			timing.path = scope.path;
+			timing.name = scope.name;
+			timing.depth = scope.depth;
+			timing.gpuMs = (float)((e.gpuEnd - e.gpuBegin) / 1000.0);
+			timing.cpuMs = (float)((e.cpuEnd - e.cpuBegin) / 1000.0);
+			timingIndex[scope.path] = (int)timings.size();
+			timings.push_back(timing);
+			it = timingIndex.find(scope.path);
+		}
+
+		//exponential average, roughly the last 30 frames
+		Timing& timing = timings[it->second];
+		timing.gpuMs += ((float)((e.gpuEnd - e.gpuBegin) / 1000.0) - timing.gpuMs) * (1.0f / 30.0f);
+		timing.cpuMs += ((float)((e.cpuEnd - e.cpuBegin) / 1000.0) - timing.cpuMs) * (1.0f / 30.0f);
+		timing.lastFrame = frame.index;
+
+		if (frame.index >= totalsFirst && frame.index < totalsEnd)
+		{
+			timing.gpuTotalMs += (e.gpuEnd - e.gpuBegin) / 1000.0;
+			timing.cpuTotalMs += (e.cpuEnd - e.cpuBegin) / 1000.0;
+			++timing.totalFrames;
+			if (scope.depth == 0)
+				totalsFrameGpuMs.push_back((float)((e.gpuEnd - e.gpuBegin) / 1000.0));
+		}
+	}
+
+	trace.push_back(std::move(events));
+	if ((int)trace.size() > TRACE_FRAMES)
+		trace.pop_front();
+}
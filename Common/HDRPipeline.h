@@ -0,0 +1,282 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "ComputeShader.h"
+#include "RenderGraph.h"
+#include "GLStateCache.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+//HDR back end on top of a RenderGraph: scene color in COLOR_FORMAT, bloom, auto exposure and tonemapping.
+//Bloom is a dual filter mip chain (Bjorge 2015): the scene is prefiltered and halved bloomLevels times with
+//5 bilinear taps per pixel, then each level is upsampled with 8 taps and added onto the level above.
+//Every pass after the first runs at a quarter of the pixels of the one before, so the whole chain costs
+//about a third of one full resolution pass regardless of the apparent radius.
+//Auto exposure builds a 256 bin log luminance histogram in a compute shader from a quarter of the scene
+//pixels and eases a 1x1 average towards its mean. Without 4.3 the exposure stays fixed at 1.
+//Bloom add, exposure, the tonemap curve and the sRGB encode all happen in the single pass that writes the
+//8 bit output.
+class HDRPipeline
+{
+public:
+	struct Settings
+	{
+		float bloomThreshold = 1.0f;
+		float bloomKnee = 0.5f;
+		float bloomIntensity = 0.05f;
+		float exposureKey = 0.5f;		// the average luminance maps to this before the curve
+		float adaptSpeed = 1.5f;		// per second
+		float minLogLuminance = -8.0f;	// histogram range, log2
+		float maxLogLuminance = 4.0f;
+	};
+
+	//11/11/10 float, half the bandwidth of RGBA16F and enough range for lighting
+	static const GLenum COLOR_FORMAT = GL_R11F_G11F_B10F;
+	static const int MAX_BLOOM_LEVELS = 8;
+
+	//shaderDir holds quad_vert, sky_vert/frag, bloom_down/up_frag, tonemap_frag, histogram_comp and exposure_comp
+	HDRPipeline(const std::string& shaderDir, int bloomLevels = 5);
+	~HDRPipeline();
+
+	Settings& GetSettings() { return settings; }
+	bool AutoExposure() const { return histogramCompute != nullptr; }
+
+	//equirectangular environment behind whatever the bound target already holds
+	void DrawEnvironment(GLuint equirectMap, float intensity, const glm::mat4& view, const glm::mat4& projection);
+	//bloom, exposure and tonemap passes reading hdrColor and writing output (an 8 bit transient or BACKBUFFER)
+	void AddPasses(RenderGraph& graph, RenderGraph::Resource hdrColor, RenderGraph::Resource output);
+	//frame time for the exposure adaptation
+	void Update(float deltaTime) { frameTime = deltaTime; }
+
+private:
+	Shader downShader;
+	Shader upShader;
+	Shader tonemapShader;
+	Shader skyShader;
+	ComputeShader* histogramCompute = nullptr;
+	ComputeShader* exposureCompute = nullptr;
+
+	Settings settings;
+	int bloomLevels;
+	float frameTime = 0.0f;
+
+	GLuint histogramBuffer = 0;
+	GLuint luminanceTex = 0;
+
+	GLuint quadVAO = 0;
+	GLuint quadVBO = 0;
+
+private:
+	void runExposure(int width, int height, GLuint scene);
+	void drawQuad() const;
+	void setupQuad();
+};
+
+inline HDRPipeline::HDRPipeline(const std::string& shaderDir, int levels)
+	:downShader((shaderDir + "/quad_vert.glsl").c_str(), (shaderDir + "/bloom_down_frag.glsl").c_str()),
+	upShader((shaderDir + "/quad_vert.glsl").c_str(), (shaderDir + "/bloom_up_frag.glsl").c_str()),
+	tonemapShader((shaderDir + "/quad_vert.glsl").c_str(), (shaderDir + "/tonemap_frag.glsl").c_str()),
+	skyShader((shaderDir + "/sky_vert.glsl").c_str(), (shaderDir + "/sky_frag.glsl").c_str()),
+	bloomLevels(levels < 1 ? 1 : (levels > MAX_BLOOM_LEVELS ? MAX_BLOOM_LEVELS : levels))
+{
+	GLStateCache& state = GLStateCache::Get();
+	downShader.Use();
+	downShader.SetInt("sourceTex", 0);
+	upShader.Use();
+	upShader.SetInt("sourceTex", 0);
+	tonemapShader.Use();
+	tonemapShader.SetInt("sceneTex", 0);
+	tonemapShader.SetInt("bloomTex", 1);
+	tonemapShader.SetInt("luminanceTex", 2);
+	skyShader.Use();
+	skyShader.SetInt("environmentMap", 0);
+
+	//starts at the key so the exposure is 1 until the first histogram lands
+	glGenTextures(1, &luminanceTex);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, luminanceTex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, &settings.exposureKey);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	if (GLAD_GL_VERSION_4_3)
+	{
+		histogramCompute = new ComputeShader((shaderDir + "/histogram_comp.glsl").c_str());
+		histogramCompute->Use();
+		histogramCompute->SetInt("sceneTex", 0);
+		exposureCompute = new ComputeShader((shaderDir + "/exposure_comp.glsl").c_str());
+
+		GLuint zeros[256] = {};
+		glGenBuffers(1, &histogramBuffer);
+		state.BindBuffer(GL_SHADER_STORAGE_BUFFER, histogramBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_COPY);
+	}
+	setupQuad();
+}
+
+inline HDRPipeline::~HDRPipeline()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.DeleteVertexArray(quadVAO);
+	state.DeleteBuffer(quadVBO);
+	state.DeleteTexture(luminanceTex);
+	if (histogramBuffer)
+		state.DeleteBuffer(histogramBuffer);
+	delete histogramCompute;
+	delete exposureCompute;
+}
+
+inline void HDRPipeline::DrawEnvironment(GLuint equirectMap, float intensity, const glm::mat4& view, const glm::mat4& projection)
+{
+	GLStateCache& state = GLStateCache::Get();
+	//the quad sits on the far plane, LEQUAL lets it through wherever nothing was drawn
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthFunc(GL_LEQUAL);
+	state.DepthMask(GL_FALSE);
+
+	skyShader.Use();
+	skyShader.SetMat4("inverseViewProjection", glm::inverse(projection * glm::mat4(glm::mat3(view))));
+	skyShader.SetFloat("environmentIntensity", intensity);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, equirectMap);
+	drawQuad();
+
+	state.DepthFunc(GL_LESS);
+	state.DepthMask(GL_TRUE);
+}
+
+inline void HDRPipeline::AddPasses(RenderGraph& graph, RenderGraph::Resource hdrColor, RenderGraph::Resource output)
+{
+	std::vector<RenderGraph::Resource> levels;
+	for (int i = 0; i < bloomLevels; ++i)
+		levels.push_back(graph.CreateTexture("bloom" + std::to_string(i), COLOR_FORMAT, 1.0f / (float)(2 << i)));
+	RenderGraph::Resource luminance = graph.ImportTexture("luminance", luminanceTex);
+
+	//down: scene -> 1/2 -> 1/4 ..., the first step also drops everything below the threshold
+	for (int i = 0; i < bloomLevels; ++i)
+	{
+		RenderGraph::Resource source = i == 0 ? hdrColor : levels[i - 1];
+		graph.AddPass("bloomDown" + std::to_string(i), { source }, { levels[i] },
+			[this, source, i](const RenderGraph& g)
+		{
+			GLStateCache& state = GLStateCache::Get();
+			state.Disable(GL_DEPTH_TEST);
+			downShader.Use();
+			downShader.SetBool("prefilter", i == 0);
+			downShader.SetFloat("threshold", settings.bloomThreshold);
+			downShader.SetFloat("knee", settings.bloomKnee);
+			state.BindTextureUnit(0, GL_TEXTURE_2D, g.Texture(source));
+			drawQuad();
+		});
+	}
+
+	//up: each level is added onto the next larger one in place, bloom0 ends up with the sum
+	for (int i = bloomLevels - 2; i >= 0; --i)
+	{
+		RenderGraph::Resource source = levels[i + 1];
+		graph.AddPass("bloomUp" + std::to_string(i), { source }, { levels[i] },
+			[this, source](const RenderGraph& g)
+		{
+			GLStateCache& state = GLStateCache::Get();
+			state.Disable(GL_DEPTH_TEST);
+			state.Enable(GL_BLEND);
+			state.BlendFunc(GL_ONE, GL_ONE);
+			upShader.Use();
+			state.BindTextureUnit(0, GL_TEXTURE_2D, g.Texture(source));
+			drawQuad();
+			state.Disable(GL_BLEND);
+		});
+	}
+
+	graph.AddComputePass("exposure", { hdrColor }, { luminance },
+		[this, hdrColor](const RenderGraph& g)
+	{
+		runExposure(g.Width(), g.Height(), g.Texture(hdrColor));
+	});
+
+	RenderGraph::Resource bloom = levels[0];
+	graph.AddPass("tonemap", { hdrColor, bloom, luminance }, { output },
+		[this, hdrColor, bloom, luminance](const RenderGraph& g)
+	{
+		GLStateCache& state = GLStateCache::Get();
+		state.Disable(GL_DEPTH_TEST);
+		tonemapShader.Use();
+		tonemapShader.SetFloat("bloomIntensity", settings.bloomIntensity);
+		tonemapShader.SetFloat("exposureKey", settings.exposureKey);
+		state.BindTextureUnit(0, GL_TEXTURE_2D, g.Texture(hdrColor));
+		state.BindTextureUnit(1, GL_TEXTURE_2D, g.Texture(bloom));
+		state.BindTextureUnit(2, GL_TEXTURE_2D, g.Texture(luminance));
+		drawQuad();
+		state.Enable(GL_DEPTH_TEST);
+	});
+}
+
+inline void HDRPipeline::runExposure(int width, int height, GLuint scene)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (!histogramCompute)
+		return;
+
+	const int groupSize = 16;	// local size in histogram_comp.glsl
+	int samplesX = (width + 1) / 2;
+	int samplesY = (height + 1) / 2;
+	float logRange = settings.maxLogLuminance - settings.minLogLuminance;
+
+	state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, histogramBuffer);
+
+	histogramCompute->Use();
+	histogramCompute->SetFloat("minLogLuminance", settings.minLogLuminance);
+	histogramCompute->SetFloat("inverseLogLuminanceRange", 1.0f / logRange);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, scene);
+	histogramCompute->Dispatch((samplesX + groupSize - 1) / groupSize, (samplesY + groupSize - 1) / groupSize);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	exposureCompute->Use();
+	exposureCompute->SetUInt("sampleCount", (GLuint)(samplesX * samplesY));
+	exposureCompute->SetFloat("minLogLuminance", settings.minLogLuminance);
+	exposureCompute->SetFloat("logLuminanceRange", logRange);
+	exposureCompute->SetFloat("adaptation", 1.0f - std::exp(-frameTime * settings.adaptSpeed));
+	glBindImageTexture(0, luminanceTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F);
+	exposureCompute->Dispatch(1, 1);
+
+	//the tonemap pass fetches the average, next frame's reduction reads and clears the bins
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+inline void HDRPipeline::drawQuad() const
+{
+	GLStateCache::Get().BindVertexArray(quadVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+inline void HDRPipeline::setupQuad()
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLfloat quadVertices[] = { // coord in ndc
+		// positions   // texCoords
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		-1.0f, -1.0f,  0.0f, 0.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+		 1.0f,  1.0f,  1.0f, 1.0f
+	};
+
+	glGenVertexArrays(1, &quadVAO);
+	state.BindVertexArray(quadVAO);
+
+	glGenBuffers(1, &quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	state.BindVertexArray(0);
+}
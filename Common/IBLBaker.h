@@ -0,0 +1,543 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "JobPool.h"
+#include "stb_image.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define IBL_USE_SSE 1
+#endif
+
+//Image based lighting terms for a metallic/roughness shader, see Shaders/PBR/pbr_frag.glsl.
+struct IBLMaps
+{
+	glm::vec3 irradianceSH[9];		// cosine convolved and divided by pi, diffuse = albedo * sum(c * Y(n))
+	GLuint specularCube = 0;		// GGX prefiltered, mip = roughness * (specularMips - 1)
+	int specularMips = 0;
+	GLuint brdfLUT = 0;				// split sum (scale, bias) on F0, x = NdotV, y = roughness
+	bool fromCache = false;
+
+	//irradianceSH, specularMips, specularMap on firstUnit and brdfLUT on firstUnit + 1
+	void Bind(const Shader& shader, int firstUnit) const;
+	void Release();
+};
+
+//Turns an equirectangular .hdr into IBLMaps on the cpu: 9 coefficient irradiance SH, a GGX prefiltered
+//specular cube mip chain (filtered importance sampling over a box filtered pyramid of the source) and the
+//split sum BRDF LUT. Work is spread over a JobPool by rows, the SH projection runs four texels per SSE op.
+//The result is written next to the source as <name>.hdr.ibl together with a hash of the .hdr bytes and the
+//settings. Load() only decodes and bakes when that hash does not match, otherwise startup costs one file read.
+class IBLBaker
+{
+public:
+	struct Settings
+	{
+		int specularSize = 128;		// mip 0 face size
+		int specularMips = 6;
+		int specularSamples = 128;
+		int lutSize = 128;
+		int lutSamples = 256;
+	};
+
+	IBLBaker() {}
+	IBLBaker(const Settings& bakeSettings) :settings(bakeSettings) {}
+
+	IBLMaps Load(const std::string& hdrPath);
+
+private:
+	static const uint32_t CACHE_MAGIC = 0x314C4249;	// "IBL1"
+	static const uint32_t CACHE_VERSION = 1;
+
+	struct BakedData
+	{
+		float sh[27];
+		std::vector<std::vector<float>> specular;	// per mip, [face][y][x][rgb]
+		std::vector<float> lut;						// [y][x][rg]
+	};
+
+	struct Image
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<float> rgb;
+
+		glm::vec3 Texel(int x, int y) const;
+		glm::vec3 Sample(const glm::vec3& dir) const;
+		Image Half() const;
+	};
+
+	Settings settings;
+	JobPool jobs;
+
+private:
+	uint64_t hash(const std::vector<char>& bytes) const;
+	bool readCache(const std::string& path, uint64_t key, BakedData& data) const;
+	void writeCache(const std::string& path, uint64_t key, const BakedData& data) const;
+
+	void bakeSH(const Image& source, float* sh);
+	void bakeSpecular(const Image& source, BakedData& data);
+	void bakeLUT(BakedData& data);
+	IBLMaps upload(const BakedData& data) const;
+
+	static glm::vec3 cubeDirection(int face, float s, float t);
+	static glm::vec2 hammersley(unsigned int i, unsigned int count);
+	static glm::vec3 importanceSampleGGX(const glm::vec2& xi, const glm::vec3& n, float roughness);
+};
+
+inline void IBLMaps::Bind(const Shader& shader, int firstUnit) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	glUniform3fv(glGetUniformLocation(shader.shaderProgram, "irradianceSH"), 9, &irradianceSH[0][0]);
+	shader.SetFloat("specularMips", (float)specularMips);
+	shader.SetInt("specularMap", firstUnit);
+	shader.SetInt("brdfLUT", firstUnit + 1);
+	state.BindTextureUnit(firstUnit, GL_TEXTURE_CUBE_MAP, specularCube);
+	state.BindTextureUnit(firstUnit + 1, GL_TEXTURE_2D, brdfLUT);
+}
+
+inline void IBLMaps::Release()
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (specularCube)
+		state.DeleteTexture(specularCube);
+	if (brdfLUT)
+		state.DeleteTexture(brdfLUT);
+	specularCube = brdfLUT = 0;
+}
+
+inline IBLMaps IBLBaker::Load(const std::string& hdrPath)
+{
+	std::ifstream file(hdrPath, std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (bytes.empty())
+	{
+		std::cout << "Error: failed to read environment " << hdrPath << std::endl;
+		return IBLMaps();
+	}
+
+	uint64_t key = hash(bytes);
+	std::string cachePath = hdrPath + ".ibl";
+	BakedData data;
+	if (readCache(cachePath, key, data))
+	{
+		IBLMaps maps = upload(data);
+		maps.fromCache = true;
+		return maps;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Image source;
+	int channels;
+	float* pixels = stbi_loadf_from_memory((const stbi_uc*)bytes.data(), (int)bytes.size(), &source.width, &source.height, &channels, 3);
+	if (!pixels)
+	{
+		std::cout << "Error: failed to decode environment " << hdrPath << std::endl;
+		return IBLMaps();
+	}
+	source.rgb.assign(pixels, pixels + source.width * source.height * 3);
+	stbi_image_free(pixels);
+
+	bakeSH(source, data.sh);
+	bakeSpecular(source, data);
+	bakeLUT(data);
+	writeCache(cachePath, key, data);
+
+	float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	std::cout << "IBL: baked " << hdrPath << " in " << ms << " ms on " << jobs.ThreadNum() << " threads" << std::endl;
+	return upload(data);
+}
+
+inline uint64_t IBLBaker::hash(const std::vector<char>& bytes) const
+{
+	//FNV-1a over the file, then the settings so changing them rebakes too
+	uint64_t h = 14695981039346656037ull;
+	for (char c : bytes)
+		h = (h ^ (unsigned char)c) * 1099511628211ull;
+	const int params[5] = { settings.specularSize, settings.specularMips, settings.specularSamples, settings.lutSize, settings.lutSamples };
+	for (int param : params)
+		h = (h ^ (uint64_t)param) * 1099511628211ull;
+	return h;
+}
+
+inline bool IBLBaker::readCache(const std::string& path, uint64_t key, BakedData& data) const
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	uint32_t magic = 0, version = 0;
+	uint64_t storedKey = 0;
+	file.read((char*)&magic, sizeof(magic));
+	file.read((char*)&version, sizeof(version));
+	file.read((char*)&storedKey, sizeof(storedKey));
+	if (!file || magic != CACHE_MAGIC || version != CACHE_VERSION || storedKey != key)
+		return false;
+
+	file.read((char*)data.sh, sizeof(data.sh));
+	data.specular.resize(settings.specularMips);
+	for (int mip = 0; mip < settings.specularMips; ++mip)
+	{
+		int size = std::max(settings.specularSize >> mip, 1);
+		data.specular[mip].resize(6 * size * size * 3);
+		file.read((char*)data.specular[mip].data(), data.specular[mip].size() * sizeof(float));
+	}
+	data.lut.resize(settings.lutSize * settings.lutSize * 2);
+	file.read((char*)data.lut.data(), data.lut.size() * sizeof(float));
+	return (bool)file;
+}
+
+inline void IBLBaker::writeCache(const std::string& path, uint64_t key, const BakedData& data) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "Error: failed to write IBL cache " << path << std::endl;
+		return;
+	}
+
+	uint32_t magic = CACHE_MAGIC, version = CACHE_VERSION;
+	file.write((const char*)&magic, sizeof(magic));
+	file.write((const char*)&version, sizeof(version));
+	file.write((const char*)&key, sizeof(key));
+	file.write((const char*)data.sh, sizeof(data.sh));
+	for (const std::vector<float>& mip : data.specular)
+		file.write((const char*)mip.data(), mip.size() * sizeof(float));
+	file.write((const char*)data.lut.data(), data.lut.size() * sizeof(float));
+}
+
+inline void IBLBaker::bakeSH(const Image& source, float* sh)
+{
+	const float pi = 3.14159265f;
+	int width = source.width;
+	int height = source.height;
+
+	std::vector<float> cosPhi(width + 4, 0.0f), sinPhi(width + 4, 0.0f);
+	for (int x = 0; x < width; ++x)
+	{
+		float phi = ((x + 0.5f) / width - 0.5f) * 2.0f * pi;
+		cosPhi[x] = std::cos(phi);
+		sinPhi[x] = std::sin(phi);
+	}
+
+	//one row per job into its own partial sum, 9 coefficients x rgb
+	std::vector<float> partial(height * 27, 0.0f);
+	jobs.ParallelFor(height, [&](int row)
+	{
+		//row 0 is the top of the image
+		float latitude = (0.5f - (row + 0.5f) / height) * pi;
+		float y = std::sin(latitude);
+		float ring = std::cos(latitude);
+		float solidAngle = (2.0f * pi / width) * (pi / height) * ring;
+		const float* pixels = &source.rgb[row * width * 3];
+		float* out = &partial[row * 27];
+
+		int x = 0;
+#ifdef IBL_USE_SSE
+		__m128 acc[27];
+		for (int i = 0; i < 27; ++i)
+			acc[i] = _mm_setzero_ps();
+		const __m128 ringV = _mm_set1_ps(ring), yV = _mm_set1_ps(y), weightV = _mm_set1_ps(solidAngle);
+		for (; x + 4 <= width; x += 4)
+		{
+			__m128 dx = _mm_mul_ps(ringV, _mm_loadu_ps(&cosPhi[x]));
+			__m128 dz = _mm_mul_ps(ringV, _mm_loadu_ps(&sinPhi[x]));
+			const float* p = &pixels[x * 3];
+			__m128 r = _mm_mul_ps(_mm_set_ps(p[9], p[6], p[3], p[0]), weightV);
+			__m128 g = _mm_mul_ps(_mm_set_ps(p[10], p[7], p[4], p[1]), weightV);
+			__m128 b = _mm_mul_ps(_mm_set_ps(p[11], p[8], p[5], p[2]), weightV);
+
+			__m128 basis[9];
+			basis[0] = _mm_set1_ps(0.282095f);
+			basis[1] = _mm_mul_ps(_mm_set1_ps(0.488603f), yV);
+			basis[2] = _mm_mul_ps(_mm_set1_ps(0.488603f), dz);
+			basis[3] = _mm_mul_ps(_mm_set1_ps(0.488603f), dx);
+			basis[4] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dx, yV));
+			basis[5] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(yV, dz));
+			basis[6] = _mm_mul_ps(_mm_set1_ps(0.315392f), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(dz, dz)), _mm_set1_ps(1.0f)));
+			basis[7] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dx, dz));
+			basis[8] = _mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(yV, yV)));
+			for (int i = 0; i < 9; ++i)
+			{
+				acc[i * 3 + 0] = _mm_add_ps(acc[i * 3 + 0], _mm_mul_ps(basis[i], r));
+				acc[i * 3 + 1] = _mm_add_ps(acc[i * 3 + 1], _mm_mul_ps(basis[i], g));
+				acc[i * 3 + 2] = _mm_add_ps(acc[i * 3 + 2], _mm_mul_ps(basis[i], b));
+			}
+		}
+		for (int i = 0; i < 27; ++i)
+		{
+			float lanes[4];
+			_mm_storeu_ps(lanes, acc[i]);
+			out[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+#endif
+		for (; x < width; ++x)
+		{
+			float dx = ring * cosPhi[x], dz = ring * sinPhi[x];
+			const float basis[9] = {
+				0.282095f,
+				0.488603f * y, 0.488603f * dz, 0.488603f * dx,
+				1.092548f * dx * y, 1.092548f * y * dz, 0.315392f * (3.0f * dz * dz - 1.0f),
+				1.092548f * dx * dz, 0.546274f * (dx * dx - y * y)
+			};
+			for (int i = 0; i < 9; ++i)
+			{
+				for (int c = 0; c < 3; ++c)
+					out[i * 3 + c] += basis[i] * pixels[x * 3 + c] * solidAngle;
+			}
+		}
+	});
+
+	//cosine lobe per band (pi, 2pi/3, pi/4), divided by pi so the shader multiplies by albedo only
+	const float band[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+	for (int i = 0; i < 27; ++i)
+	{
+		sh[i] = 0.0f;
+		for (int row = 0; row < height; ++row)
+			sh[i] += partial[row * 27 + i];
+		sh[i] *= band[i / 3];
+	}
+}
+
+inline void IBLBaker::bakeSpecular(const Image& source, BakedData& data)
+{
+	const float pi = 3.14159265f;
+
+	//box filtered pyramid, the samples of rough lobes read coarser levels instead of aliasing
+	std::vector<Image> pyramid(1, source);
+	while (pyramid.back().width > 8 && pyramid.back().height > 4)
+		pyramid.push_back(pyramid.back().Half());
+	int topLevel = (int)pyramid.size() - 1;
+	float texelSolidAngle = 4.0f * pi / (source.width * source.height);
+
+	data.specular.resize(settings.specularMips);
+	for (int mip = 0; mip < settings.specularMips; ++mip)
+	{
+		int size = std::max(settings.specularSize >> mip, 1);
+		float roughness = settings.specularMips > 1 ? (float)mip / (settings.specularMips - 1) : 0.0f;
+		std::vector<float>& out = data.specular[mip];
+		out.resize(6 * size * size * 3);
+
+		jobs.ParallelFor(6 * size, [&](int job)
+		{
+			int face = job / size;
+			int y = job % size;
+			for (int x = 0; x < size; ++x)
+			{
+				glm::vec3 n = cubeDirection(face, 2.0f * (x + 0.5f) / size - 1.0f, 2.0f * (y + 0.5f) / size - 1.0f);
+				glm::vec3 color(0.0f);
+				if (mip == 0)
+				{
+					color = source.Sample(n);
+				}
+				else
+				{
+					//N = V = R, the usual split sum approximation
+					float weight = 0.0f;
+					float a = roughness * roughness;
+					for (int i = 0; i < settings.specularSamples; ++i)
+					{
+						glm::vec3 h = importanceSampleGGX(hammersley(i, settings.specularSamples), n, roughness);
+						glm::vec3 l = 2.0f * glm::dot(n, h) * h - n;
+						float nDotL = glm::dot(n, l);
+						if (nDotL <= 0.0f)
+							continue;
+
+						float nDotH = std::max(glm::dot(n, h), 0.0f);
+						float denom = nDotH * nDotH * (a * a - 1.0f) + 1.0f;
+						float d = a * a / (pi * denom * denom);
+						float pdf = d * 0.25f + 0.0001f;
+						float sampleSolidAngle = 1.0f / (settings.specularSamples * pdf);
+						float level = glm::clamp(0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f, (float)topLevel);
+
+						int lower = (int)level;
+						int upper = std::min(lower + 1, topLevel);
+						float blend = level - lower;
+						color += (pyramid[lower].Sample(l) * (1.0f - blend) + pyramid[upper].Sample(l) * blend) * nDotL;
+						weight += nDotL;
+					}
+					color /= std::max(weight, 0.0001f);
+				}
+				float* texel = &out[((face * size + y) * size + x) * 3];
+				texel[0] = color.r;
+				texel[1] = color.g;
+				texel[2] = color.b;
+			}
+		});
+	}
+}
+
+inline void IBLBaker::bakeLUT(BakedData& data)
+{
+	int size = settings.lutSize;
+	data.lut.resize(size * size * 2);
+	jobs.ParallelFor(size, [&](int y)
+	{
+		float roughness = (y + 0.5f) / size;
+		float k = roughness * roughness / 2.0f;
+		for (int x = 0; x < size; ++x)
+		{
+			float nDotV = (x + 0.5f) / size;
+			glm::vec3 v(std::sqrt(1.0f - nDotV * nDotV), 0.0f, nDotV);
+			glm::vec3 n(0.0f, 0.0f, 1.0f);
+
+			float scale = 0.0f, bias = 0.0f;
+			for (int i = 0; i < settings.lutSamples; ++i)
+			{
+				glm::vec3 h = importanceSampleGGX(hammersley(i, settings.lutSamples), n, roughness);
+				glm::vec3 l = 2.0f * glm::dot(v, h) * h - v;
+				float nDotL = std::max(l.z, 0.0f);
+				float nDotH = std::max(h.z, 0.0f);
+				float vDotH = std::max(glm::dot(v, h), 0.0f);
+				if (nDotL <= 0.0f)
+					continue;
+
+				float g = (nDotV / (nDotV * (1.0f - k) + k)) * (nDotL / (nDotL * (1.0f - k) + k));
+				float gVis = g * vDotH / (nDotH * nDotV);
+				float fc = std::pow(1.0f - vDotH, 5.0f);
+				scale += (1.0f - fc) * gVis;
+				bias += fc * gVis;
+			}
+			data.lut[(y * size + x) * 2 + 0] = scale / settings.lutSamples;
+			data.lut[(y * size + x) * 2 + 1] = bias / settings.lutSamples;
+		}
+	});
+}
+
+inline IBLMaps IBLBaker::upload(const BakedData& data) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	IBLMaps maps;
+	for (int i = 0; i < 9; ++i)
+		maps.irradianceSH[i] = glm::vec3(data.sh[i * 3], data.sh[i * 3 + 1], data.sh[i * 3 + 2]);
+
+	maps.specularMips = settings.specularMips;
+	glGenTextures(1, &maps.specularCube);
+	state.BindTextureUnit(0, GL_TEXTURE_CUBE_MAP, maps.specularCube);
+	for (int mip = 0; mip < settings.specularMips; ++mip)
+	{
+		int size = std::max(settings.specularSize >> mip, 1);
+		for (int face = 0; face < 6; ++face)
+		{
+			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, GL_R11F_G11F_B10F, size, size, 0, GL_RGB, GL_FLOAT,
+				&data.specular[mip][face * size * size * 3]);
+		}
+	}
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, settings.specularMips - 1);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	//rough mips are tiny, filtering across faces hides the seams
+	state.Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	glGenTextures(1, &maps.brdfLUT);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, maps.brdfLUT);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, settings.lutSize, settings.lutSize, 0, GL_RG, GL_FLOAT, data.lut.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return maps;
+}
+
+inline glm::vec3 IBLBaker::cubeDirection(int face, float s, float t)
+{
+	//GL cube map face orientation, t grows downwards on every face
+	glm::vec3 dir;
+	switch (face)
+	{
+	case 0: dir = glm::vec3(1.0f, -t, -s); break;
+	case 1: dir = glm::vec3(-1.0f, -t, s); break;
+	case 2: dir = glm::vec3(s, 1.0f, t); break;
+	case 3: dir = glm::vec3(s, -1.0f, -t); break;
+	case 4: dir = glm::vec3(s, -t, 1.0f); break;
+	default: dir = glm::vec3(-s, -t, -1.0f); break;
+	}
+	return glm::normalize(dir);
+}
+
+inline glm::vec2 IBLBaker::hammersley(unsigned int i, unsigned int count)
+{
+	unsigned int bits = i;
+	bits = (bits << 16u) | (bits >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+	return glm::vec2((float)i / count, bits * 2.3283064365386963e-10f);
+}
+
+inline glm::vec3 IBLBaker::importanceSampleGGX(const glm::vec2& xi, const glm::vec3& n, float roughness)
+{
+	const float pi = 3.14159265f;
+	float a = roughness * roughness;
+	float phi = 2.0f * pi * xi.x;
+	float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+	float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+	glm::vec3 h(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+
+	glm::vec3 up = std::abs(n.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+	glm::vec3 tangent = glm::normalize(glm::cross(up, n));
+	glm::vec3 bitangent = glm::cross(n, tangent);
+	return glm::normalize(tangent * h.x + bitangent * h.y + n * h.z);
+}
+
+inline glm::vec3 IBLBaker::Image::Texel(int x, int y) const
+{
+	x = ((x % width) + width) % width;
+	y = glm::clamp(y, 0, height - 1);
+	const float* p = &rgb[(y * width + x) * 3];
+	return glm::vec3(p[0], p[1], p[2]);
+}
+
+inline glm::vec3 IBLBaker::Image::Sample(const glm::vec3& dir) const
+{
+	//same mapping as Shaders/HDR/sky_frag.glsl, row 0 is the top
+	const float pi = 3.14159265f;
+	float u = std::atan2(dir.z, dir.x) / (2.0f * pi) + 0.5f;
+	float v = std::asin(glm::clamp(dir.y, -1.0f, 1.0f)) / pi + 0.5f;
+	float px = u * width - 0.5f;
+	float py = (1.0f - v) * height - 0.5f;
+	int x0 = (int)std::floor(px), y0 = (int)std::floor(py);
+	float fx = px - x0, fy = py - y0;
+	glm::vec3 top = Texel(x0, y0) * (1.0f - fx) + Texel(x0 + 1, y0) * fx;
+	glm::vec3 bottom = Texel(x0, y0 + 1) * (1.0f - fx) + Texel(x0 + 1, y0 + 1) * fx;
+	return top * (1.0f - fy) + bottom * fy;
+}
+
+inline IBLBaker::Image IBLBaker::Image::Half() const
+{
+	Image half;
+	half.width = std::max(width / 2, 1);
+	half.height = std::max(height / 2, 1);
+	half.rgb.resize(half.width * half.height * 3);
+	for (int y = 0; y < half.height; ++y)
+	{
+		for (int x = 0; x < half.width; ++x)
+		{
+			glm::vec3 sum = Texel(2 * x, 2 * y) + Texel(2 * x + 1, 2 * y) + Texel(2 * x, 2 * y + 1) + Texel(2 * x + 1, 2 * y + 1);
+			float* p = &half.rgb[(y * half.width + x) * 3];
+			p[0] = sum.r * 0.25f;
+			p[1] = sum.g * 0.25f;
+			p[2] = sum.b * 0.25f;
+		}
+	}
+	return half;
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include "glfw3.h"
+#include "glm/glm.hpp"
+
+#include "Camera.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//Records a session's input to a compact binary file and plays it back: --record=file.input, --replay=file.input.
+//Attach() puts the recorder between glfw and the demo's cursor, scroll and key callbacks. Recording logs
+//every event with its time, and BeginFrame() logs a frame record with the frame's clock and the camera
+//state. Replay feeds each frame's events back through the same callbacks and hands the demo the recorded
+//clock, so processInput, mouse_callback and scroll_callback move the camera exactly as they did live,
+//one recorded step per frame however long the frame actually takes. processInput must read keys through
+//GetKey() for the held keys to replay. The camera is checked against the recorded state every frame and
+//put back if it drifted (a different compiler or math library can round differently), the largest drift
+//is printed when the replay ends.
+//While replaying, live cursor and scroll events are dropped; live keys still reach the demo's key
+//callback (profiler toggles and the like) but do not count as held.
+class InputRecorder
+{
+public:
+	enum class Mode
+	{
+		OFF,
+		RECORD,
+		REPLAY
+	};
+
+	struct Settings
+	{
+		Mode mode = Mode::OFF;
+		std::string file;
+	};
+
+	static Settings ParseArgs(int argc, char** argv);
+
+	InputRecorder(const Settings& recorderSettings);
+	~InputRecorder();
+
+	bool Recording() const { return settings.mode == Mode::RECORD; }
+	bool Replaying() const { return settings.mode == Mode::REPLAY; }
+	bool Finished() const { return Replaying() && frame >= (int)frames.size(); }
+
+	//installs the callbacks on window (may be nullptr when headless, replay still works), in place of
+	//glfwSetCursorPosCallback / glfwSetScrollCallback / glfwSetKeyCallback, any of them may be nullptr
+	void Attach(GLFWwindow* window, GLFWcursorposfun cursor, GLFWscrollfun scroll, GLFWkeyfun key);
+
+	//call once per frame before processInput, with the frame's clock: recording logs it, replay
+	//dispatches the frame's events and overwrites time and deltaTime with the recorded ones
+	void BeginFrame(Camera& camera, double& time, float& deltaTime);
+
+	//glfwGetKey that answers from the recording while replaying
+	static int GetKey(GLFWwindow* window, int key);
+
+private:
+	enum Record : uint8_t
+	{
+		FRAME = 0,
+		CURSOR = 1,
+		SCROLL = 2,
+		KEY = 3
+	};
+
+	struct Event
+	{
+		Record type;
+		float time;
+		double x, y;		// cursor position or scroll offset
+		int key, scancode, action, mods;
+	};
+
+	struct Frame
+	{
+		double time;
+		float deltaTime;
+		glm::vec3 position;
+		float yaw, pitch, fov;
+		std::vector<Event> events;		// arrived before this frame began
+	};
+
+	static const uint32_t FILE_MAGIC = 0x52494947;		// "GIIR"
+	static const uint32_t FILE_VERSION = 2;		// 2: frame time is a double
+
+	Settings settings;
+	GLFWwindow* window = nullptr;
+	GLFWcursorposfun cursorCallback = nullptr;
+	GLFWscrollfun scrollCallback = nullptr;
+	GLFWkeyfun keyCallback = nullptr;
+
+	std::ofstream out;
+	double startTime = 0.0;
+
+	std::vector<Frame> frames;
+	int frame = 0;
+	std::array<uint8_t, GLFW_KEY_LAST + 1> held;
+	float maxDrift = 0.0f;
+
+private:
+	static InputRecorder*& active() { static InputRecorder* recorder = nullptr; return recorder; }
+	bool load();
+	float eventTime() const;
+	template<typename T> void write(const T& value) { out.write((const char*)&value, sizeof(T)); }
+
+	static void cursorEvent(GLFWwindow* window, double x, double y);
+	static void scrollEvent(GLFWwindow* window, double x, double y);
+	static void keyEvent(GLFWwindow* window, int key, int scancode, int action, int mods);
+};
+
+inline InputRecorder::Settings InputRecorder::ParseArgs(int argc, char** argv)
+{
+	Settings result;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 9, "--record=") == 0)
+		{
+			result.mode = Mode::RECORD;
+			result.file = arg.substr(9);
+		}
+		else if (arg.compare(0, 9, "--replay=") == 0)
+		{
+			result.mode = Mode::REPLAY;
+			result.file = arg.substr(9);
+		}
+	}
+	return result;
+}
+
+inline InputRecorder::InputRecorder(const Settings& recorderSettings)
+	:settings(recorderSettings)
+{
+	held.fill(0);
+	if (settings.mode == Mode::OFF)
+		return;
+
+	if (active())
+	{
+		std::cout << "Error: only one input recorder can be active" << std::endl;
+		settings.mode = Mode::OFF;
+		return;
+	}
+
+	if (Recording())
+	{
+		out.open(settings.file, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			std::cout << "Error: could not write input recording " << settings.file << std::endl;
+			settings.mode = Mode::OFF;
+			return;
+		}
+		uint32_t magic = FILE_MAGIC, version = FILE_VERSION;
+		write(magic);
+		write(version);
+	}
+	else if (!load())
+	{
+		settings.mode = Mode::OFF;
+		return;
+	}
+	active() = this;
+}
+
+inline InputRecorder::~InputRecorder()
+{
+	if (active() != this)
+		return;
+	active() = nullptr;
+
+	if (Recording())
+	{
+		std::cout << "Recorded " << frame << " frames of input to " << settings.file << std::endl;
+	}
+	else
+	{
+		std::cout << "Replayed " << frame << " of " << frames.size() << " frames from " << settings.file
+			<< ", largest camera drift " << maxDrift << std::endl;
+	}
+}
+
+inline bool InputRecorder::load()
+{
+	std::ifstream file(settings.file, std::ios::binary);
+	uint32_t magic = 0, version = 0;
+	file.read((char*)&magic, sizeof(magic));
+	file.read((char*)&version, sizeof(version));
+	if (!file || magic != FILE_MAGIC || version != FILE_VERSION)
+	{
+		std::cout << "Error: " << settings.file << " is not an input recording" << std::endl;
+		return false;
+	}
+
+	//events ahead of a frame record happened before that frame, events after the last one are dropped
+	std::vector<Event> pending;
+	uint8_t type;
+	while (file.read((char*)&type, 1))
+	{
+		if (type == FRAME)
+		{
+			Frame f;
+			file.read((char*)&f.time, sizeof(double));
+			file.read((char*)&f.deltaTime, sizeof(float));
+			file.read((char*)&f.position, sizeof(glm::vec3));
+			file.read((char*)&f.yaw, sizeof(float));
+			file.read((char*)&f.pitch, sizeof(float));
+			file.read((char*)&f.fov, sizeof(float));
+			f.events.swap(pending);
+			if (file)
+				frames.push_back(std::move(f));
+			continue;
+		}
+
+		Event e = {};
+		e.type = (Record)type;
+		file.read((char*)&e.time, sizeof(float));
+		if (type == CURSOR || type == SCROLL)
+		{
+			file.read((char*)&e.x, sizeof(double));
+			file.read((char*)&e.y, sizeof(double));
+		}
+		else if (type == KEY)
+		{
+			int16_t key, scancode;
+			uint8_t action, mods;
+			file.read((char*)&key, sizeof(key));
+			file.read((char*)&scancode, sizeof(scancode));
+			file.read((char*)&action, sizeof(action));
+			file.read((char*)&mods, sizeof(mods));
+			e.key = key;
+			e.scancode = scancode;
+			e.action = action;
+			e.mods = mods;
+		}
+		else
+		{
+			std::cout << "Error: unknown record in " << settings.file << ", replaying what came before it" << std::endl;
+			break;
+		}
+		if (file)
+			pending.push_back(e);
+	}
+
+	if (frames.empty())
+	{
+		std::cout << "Error: " << settings.file << " holds no frames" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+inline void InputRecorder::Attach(GLFWwindow* targetWindow, GLFWcursorposfun cursor, GLFWscrollfun scroll, GLFWkeyfun key)
+{
+	window = targetWindow;
+	cursorCallback = cursor;
+	scrollCallback = scroll;
+	keyCallback = key;
+
+	if (Recording() && !window)
+	{
+		std::cout << "Error: recording input needs a window" << std::endl;
+		settings.mode = Mode::OFF;
+		active() = nullptr;
+	}
+	if (!window)
+		return;
+
+	if (settings.mode == Mode::OFF)
+	{
+		glfwSetCursorPosCallback(window, cursor);
+		glfwSetScrollCallback(window, scroll);
+		glfwSetKeyCallback(window, key);
+		return;
+	}
+
+	//the key hook is needed even without a demo callback, held keys come from it
+	glfwSetCursorPosCallback(window, cursorEvent);
+	glfwSetScrollCallback(window, scrollEvent);
+	glfwSetKeyCallback(window, keyEvent);
+	startTime = glfwGetTime();
+}
+
+inline void InputRecorder::BeginFrame(Camera& camera, double& time, float& deltaTime)
+{
+	if (Recording())
+	{
+		write((uint8_t)FRAME);
+		write(time);
+		write(deltaTime);
+		write(camera.Position);
+		write(camera.Yaw);
+		write(camera.Pitch);
+		write(camera.Fov);
+		++frame;
+		return;
+	}
+	if (!Replaying() || Finished())
+		return;
+
+	const Frame& f = frames[frame++];
+	for (const Event& e : f.events)
+	{
+		if (e.type == CURSOR)
+		{
+			if (cursorCallback)
+				cursorCallback(window, e.x, e.y);
+		}
+		else if (e.type == SCROLL)
+		{
+			if (scrollCallback)
+				scrollCallback(window, e.x, e.y);
+		}
+		else
+		{
+			if (e.key >= 0 && e.key <= GLFW_KEY_LAST)
+				held[e.key] = e.action != GLFW_RELEASE;
+			if (keyCallback)
+				keyCallback(window, e.key, e.scancode, e.action, e.mods);
+		}
+	}
+	time = f.time;
+	deltaTime = f.deltaTime;
+
+	float drift = glm::length(camera.Position - f.position);
+	drift = std::max(drift, std::abs(camera.Yaw - f.yaw));
+	drift = std::max(drift, std::abs(camera.Pitch - f.pitch));
+	drift = std::max(drift, std::abs(camera.Fov - f.fov));
+	maxDrift = std::max(maxDrift, drift);
+	if (drift > 0.0f)
+	{
+		camera.Position = f.position;
+		camera.Fov = f.fov;
+		camera.SetOrientation(f.yaw, f.pitch);
+	}
+}
+
+inline int InputRecorder::GetKey(GLFWwindow* window, int key)
+{
+	InputRecorder* recorder = active();
+	if (recorder && recorder->Replaying())
+		return key >= 0 && key <= GLFW_KEY_LAST && recorder->held[key] ? GLFW_PRESS : GLFW_RELEASE;
+	return window ? glfwGetKey(window, key) : GLFW_RELEASE;
+}
+
+inline float InputRecorder::eventTime() const
+{
+	return (float)(glfwGetTime() - startTime);
+}
+
+inline void InputRecorder::cursorEvent(GLFWwindow* window, double x, double y)
+{
+	InputRecorder* recorder = active();
+	if (!recorder || recorder->Replaying())
+		return;
+	recorder->write((uint8_t)CURSOR);
+	recorder->write(recorder->eventTime());
+	recorder->write(x);
+	recorder->write(y);
+	if (recorder->cursorCallback)
+		recorder->cursorCallback(window, x, y);
+}
+
+inline void InputRecorder::scrollEvent(GLFWwindow* window, double x, double y)
+{
+	InputRecorder* recorder = active();
+	if (!recorder || recorder->Replaying())
+		return;
+	recorder->write((uint8_t)SCROLL);
+	recorder->write(recorder->eventTime());
+	recorder->write(x);
+	recorder->write(y);
+	if (recorder->scrollCallback)
+		recorder->scrollCallback(window, x, y);
+}
+
+inline void InputRecorder::keyEvent(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	InputRecorder* recorder = active();
+	if (!recorder)
+		return;
+	if (recorder->Recording())
+	{
+		recorder->write((uint8_t)KEY);
+		recorder->write(recorder->eventTime());
+		recorder->write((int16_t)key);
+		recorder->write((int16_t)scancode);
+		recorder->write((uint8_t)action);
+		recorder->write((uint8_t)mods);
+	}
+	if (recorder->keyCallback)
+		recorder->keyCallback(window, key, scancode, action, mods);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Persistent worker threads for data parallel loops.
+//ParallelFor hands out indices through an atomic counter, the calling thread works too and
+//returns once every index is done, so the threads are created once and never per frame.
+//It also waits for every worker to have left runJobs, before re-arming the counters and before
+//returning: a worker still on its way out of the previous call would otherwise read the new,
+//larger jobCount against its stale index and run an index twice.
+class JobPool
+{
+public:
+	//0 picks hardware_concurrency - 1 workers (the caller is the last thread)
+	JobPool(unsigned int workerNum = 0);
+	~JobPool();
+
+	void ParallelFor(int count, const std::function<void(int)>& job);
+
+	unsigned int ThreadNum() const { return (unsigned int)workers.size() + 1; }
+
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wakeCond;
+	std::condition_variable doneCond;
+
+	std::atomic<const std::function<void(int)>*> currentJob;
+	std::atomic<int> jobCount;
+	std::atomic<int> nextIndex;
+	std::atomic<int> doneCount;
+	unsigned long long generation = 0;
+	int activeWorkers = 0;		// inside runJobs, guarded by mutex
+	bool quit = false;
+
+private:
+	void workerLoop();
+	void runJobs();
+};
+
+inline JobPool::JobPool(unsigned int workerNum)
+	:currentJob(nullptr), jobCount(0), nextIndex(0), doneCount(0)
+{
+	if (workerNum == 0)
+	{
+		unsigned int hw = std::thread::hardware_concurrency();
+		workerNum = hw > 1 ? hw - 1 : 1;
+	}
+	for (unsigned int i = 0; i < workerNum; ++i)
+	{
+		workers.emplace_back(&JobPool::workerLoop, this);
+	}
+}
+
+inline JobPool::~JobPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wakeCond.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+inline void JobPool::ParallelFor(int count, const std::function<void(int)>& job)
+{
+	PROFILE_ZONE("JobPool::ParallelFor");
+	if (count <= 0)
+		return;
+	if (count == 1)
+	{
+		job(0);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		//a worker that woke after the previous call finished may still be in runJobs
+		doneCond.wait(lock, [this]() { return activeWorkers == 0; });
+		currentJob = &job;
+		jobCount = count;
+		doneCount = 0;
+		nextIndex = 0;
+		++generation;
+	}
+	wakeCond.notify_all();
+
+	runJobs();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCond.wait(lock, [this]() { return doneCount.load() >= jobCount && activeWorkers == 0; });
+	currentJob = nullptr;
+}
+
+inline void JobPool::workerLoop()
+{
+	PROFILE_THREAD("JobPool worker");
+	unsigned long long seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCond.wait(lock, [this, seen]() { return quit || generation != seen; });
+			if (quit)
+				return;
+			seen = generation;
+			++activeWorkers;
+		}
+		runJobs();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			--activeWorkers;
+		}
+		doneCond.notify_all();
+	}
+}
+
+inline void JobPool::runJobs()
+{
+	PROFILE_ZONE("JobPool::runJobs");
+	int index;
+	while ((index = nextIndex.fetch_add(1)) < jobCount)
+	{
+		(*currentJob.load())(index);
+		if (doneCount.fetch_add(1) + 1 == jobCount)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			doneCond.notify_all();
+		}
+	}
+}
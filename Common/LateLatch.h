@@ -0,0 +1,165 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "GLStateCache.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+//Camera matrices for the vertex shaders in a uniform block at BINDING, one of SLOTS slots per frame:
+//	layout(std140) uniform LateLatch { mat4 latchedView; mat4 latchedProjection; };
+//BeginFrame() writes the frame start camera. With --late-latch (4.4) the slot is mapped persistent and
+//Latch(matrices), after the last draw and before the swap, overwrites it with the camera polled last;
+//draws the driver flushed before that keep the frame start camera. Latch() only fences the slot.
+class LateLatch
+{
+public:
+	static const GLuint BINDING = 0;
+	static const int SLOTS = 3;
+
+	struct Matrices
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+	};
+
+	//--late-latch
+	static bool ParseArgs(int argc, char** argv);
+
+	LateLatch(bool lateLatch);
+	~LateLatch();
+
+	//late latching asked for and available
+	bool Enabled() const { return mapped != nullptr; }
+	//points the program's LateLatch block at BINDING
+	void BindProgram(GLuint program) const;
+
+	//before the first draw that reads the block
+	void BeginFrame(const Matrices& matrices);
+	//after the last draw, before the swap
+	void Latch(const Matrices& matrices);
+	//same, keeping the frame start camera
+	void Latch();
+
+private:
+	GLuint buffer = 0;
+	GLintptr slotSize = 0;
+	unsigned char* mapped = nullptr;
+	GLsync fences[SLOTS] = {};
+	int slot = 0;
+	int frames = 0;
+	int movedFrames = 0;		// latched a different camera than the frame started with
+	Matrices early;
+
+private:
+	void wait(int index);
+};
+
+inline bool LateLatch::ParseArgs(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--late-latch")
+			return true;
+	}
+	return false;
+}
+
+inline LateLatch::LateLatch(bool lateLatch)
+{
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	slotSize = ((GLintptr)sizeof(Matrices) + alignment - 1) / alignment * alignment;
+
+	GLStateCache& state = GLStateCache::Get();
+	glGenBuffers(1, &buffer);
+	state.BindBuffer(GL_UNIFORM_BUFFER, buffer);
+	if (lateLatch && GLAD_GL_VERSION_4_4)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_UNIFORM_BUFFER, slotSize * SLOTS, nullptr, flags);
+		mapped = (unsigned char*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, slotSize * SLOTS, flags);
+		if (!mapped)
+			std::cout << "Error: could not map the late latch buffer, latching at frame start" << std::endl;
+	}
+	else
+	{
+		if (lateLatch)
+			std::cout << "Error: late latching needs GL 4.4, latching at frame start" << std::endl;
+		glBufferData(GL_UNIFORM_BUFFER, slotSize * SLOTS, nullptr, GL_DYNAMIC_DRAW);
+	}
+}
+
+inline LateLatch::~LateLatch()
+{
+	for (GLsync fence : fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+	}
+	if (mapped)
+	{
+		GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		std::cout << "LateLatch: the camera moved after recording in " << movedFrames << " of " << frames << " frames" << std::endl;
+	}
+	GLStateCache::Get().DeleteBuffer(buffer);
+}
+
+inline void LateLatch::BindProgram(GLuint program) const
+{
+	GLuint block = glGetUniformBlockIndex(program, "LateLatch");
+	if (block == GL_INVALID_INDEX)
+	{
+		std::cout << "Error: program " << program << " has no LateLatch block" << std::endl;
+		return;
+	}
+	glUniformBlockBinding(program, block, BINDING);
+}
+
+inline void LateLatch::BeginFrame(const Matrices& matrices)
+{
+	slot = (slot + 1) % SLOTS;
+	wait(slot);
+	early = matrices;
+
+	//the generic binding goes through the cache, glBindBufferRange sets it too
+	GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, buffer);
+	if (mapped)
+		std::memcpy(mapped + slot * slotSize, &matrices, sizeof(Matrices));
+	else
+		glBufferSubData(GL_UNIFORM_BUFFER, slot * slotSize, sizeof(Matrices), &matrices);
+	glBindBufferRange(GL_UNIFORM_BUFFER, BINDING, buffer, slot * slotSize, sizeof(Matrices));
+}
+
+inline void LateLatch::Latch(const Matrices& matrices)
+{
+	if (mapped)
+	{
+		//coherent, the gpu sees the write without a flush
+		std::memcpy(mapped + slot * slotSize, &matrices, sizeof(Matrices));
+		++frames;
+		if (std::memcmp(&matrices, &early, sizeof(Matrices)) != 0)
+			++movedFrames;
+	}
+	Latch();
+}
+
+inline void LateLatch::Latch()
+{
+	fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+inline void LateLatch::wait(int index)
+{
+	if (!fences[index])
+		return;
+	while (glClientWaitSync(fences[index], GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED)
+	{
+	}
+	glDeleteSync(fences[index]);
+	fences[index] = nullptr;
+}
@@ -2,11 +2,13 @@
 
 #include "glad/glad.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 
 #include "Shader.h"
+#include "GLStateCache.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -18,6 +20,15 @@ enum class TextureType
 
 };
 
+//How the vertex buffers are laid out on the gpu.
+//SPLIT_POSITION keeps positions in their own tightly packed 12 byte stream next to a normal/uv stream,
+//so depth, shadow and picking passes fetch a third of the data. Vertices stays interleaved on the cpu side.
+enum class VertexLayout
+{
+	INTERLEAVED,
+	SPLIT_POSITION,
+};
+
 struct Vertex
 {
 	glm::vec3 Position;
@@ -30,35 +41,61 @@ struct Texture
 	GLuint id;
 	TextureType type;
 	std::string path;
+	//packed textures live in a GL_TEXTURE_2D_ARRAY, see TexturePacker
+	GLenum target = GL_TEXTURE_2D;
+	GLint layer = 0;
+	glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	//resident handle on the bindless path, see BindlessTextureManager
+	GLuint64 handle = 0;
 };
 
 class Mesh
 {
 public:
-	Mesh(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, const std::vector<Texture>& textures)
-		:Vertices(vertices), Indices(indices), Textures(textures)
+	Mesh(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, const std::vector<Texture>& textures,
+		VertexLayout layout = VertexLayout::SPLIT_POSITION)
+		:Vertices(vertices), Indices(indices), Textures(textures), Layout(layout)
 	{
 		setupMesh();
 	}
 
-	void Draw(Shader shader) const;
+	void Draw(const Shader& shader) const;
+	//position only, for passes that need nothing but depth, the caller sets the program and matrices
+	void DrawDepth() const;
 	
 public:
 	std::vector<Vertex> Vertices;
 	std::vector<GLuint> Indices;
 	std::vector<Texture> Textures;
+	//index into the bindless material ssbo, -1 binds textures to units instead
+	GLint MaterialIndex = -1;
+	VertexLayout Layout;
 
 private:
 	GLuint VAO;
-	GLuint VBO;
+	GLuint VBO;			// everything when interleaved, normal + uv when split
+	GLuint positionVBO = 0;
 	GLuint EBO;
+	GLuint depthVAO;		// attribute 0 only
 
 private:
 	void setupMesh();
 };
 
-void Mesh::Draw(Shader shader) const
+void Mesh::Draw(const Shader& shader) const
 {
+	PROFILE_ZONE("Mesh::Draw");
+	GLStateCache& state = GLStateCache::Get();
+
+	if (MaterialIndex >= 0)
+	{
+		//bindless: the shader fetches handles from the material ssbo, nothing to bind per material
+		shader.SetInt("materialIndex", MaterialIndex);
+		state.BindVertexArray(VAO);
+		glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
+		return;
+	}
+
 	unsigned int diffuseNum = 1;
 	unsigned int specularNum = 1;
 	for (unsigned int i = 0; i < Textures.size(); ++i)
@@ -76,38 +113,88 @@ void Mesh::Draw(Shader shader) const
 			break;
 		}
 		shader.SetInt(texName, i);
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, Textures[i].id);
+		if (Textures[i].target == GL_TEXTURE_2D_ARRAY)
+		{
+			//meshes sharing an array keep the same binding, only the layer uniform changes
+			shader.SetInt(texName + "_layer", Textures[i].layer);
+			shader.SetVec4(texName + "_rect", Textures[i].uvRect);
+		}
+		state.BindTextureUnit(i, Textures[i].target, Textures[i].id);
 	}
 
-	glBindVertexArray(VAO);
+	//no unbind afterwards, the next draw binds what it needs through the cache
+	state.BindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
+}
 
-	glBindVertexArray(0);
-	glActiveTexture(GL_TEXTURE0);
+void Mesh::DrawDepth() const
+{
+	GLStateCache::Get().BindVertexArray(depthVAO);
+	glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
 }
 
 void Mesh::setupMesh()
 {
+	GLStateCache& state = GLStateCache::Get();
 	//VAO
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	//VBO
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, Vertices.size()*sizeof(Vertex), &Vertices[0], GL_STATIC_DRAW);
-	//vertex layout
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, Normal)));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, TexCoords)));
-	glEnableVertexAttribArray(2);
+	state.BindVertexArray(VAO);
 	//EBO
 	glGenBuffers(1, &EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size()*sizeof(GLuint), &Indices[0], GL_STATIC_DRAW);
 
-	glBindVertexArray(0);
+	GLsizei positionStride = sizeof(Vertex);
+	if (Layout == VertexLayout::SPLIT_POSITION)
+	{
+		//position stream
+		std::vector<glm::vec3> positions(Vertices.size());
+		std::vector<GLfloat> attributes(Vertices.size() * 5);
+		for (unsigned int i = 0; i < Vertices.size(); ++i)
+		{
+			positions[i] = Vertices[i].Position;
+			memcpy(&attributes[i * 5], &Vertices[i].Normal, sizeof(glm::vec3));
+			memcpy(&attributes[i * 5 + 3], &Vertices[i].TexCoords, sizeof(glm::vec2));
+		}
+		glGenBuffers(1, &positionVBO);
+		state.BindBuffer(GL_ARRAY_BUFFER, positionVBO);
+		glBufferData(GL_ARRAY_BUFFER, positions.size()*sizeof(glm::vec3), &positions[0], GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+		glEnableVertexAttribArray(0);
+		positionStride = sizeof(glm::vec3);
+
+		//shading stream
+		glGenBuffers(1, &VBO);
+		state.BindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, attributes.size()*sizeof(GLfloat), &attributes[0], GL_STATIC_DRAW);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(2);
+	}
+	else
+	{
+		//VBO
+		glGenBuffers(1, &VBO);
+		state.BindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, Vertices.size()*sizeof(Vertex), &Vertices[0], GL_STATIC_DRAW);
+		//vertex layout
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, Normal)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, TexCoords)));
+		glEnableVertexAttribArray(2);
+	}
+
+	//depth VAO, same indices, position only
+	glGenVertexArrays(1, &depthVAO);
+	state.BindVertexArray(depthVAO);
+	state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, Layout == VertexLayout::SPLIT_POSITION ? positionVBO : VBO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, positionStride, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	state.BindVertexArray(0);
 }
 
@@ -13,42 +13,150 @@
 
 #include "Mesh.h"
 #include "Shader.h"
+#include "TexturePacker.h"
+#include "BindlessTextures.h"
 
-GLuint LoadTextureFromFile(const char* path, const std::string& directory);
+//srgb stores colour maps as SRGB8(_ALPHA8) so sampling returns linear values, single channel maps stay linear
+GLuint LoadTextureFromFile(const char* path, const std::string& directory, bool srgb = false);
+//radiance .hdr as linear float, stored R11F_G11F_B10F
+GLuint LoadHDRTextureFromFile(const char* path, const std::string& directory);
 
 TextureType AiTexTypeToTexType(aiTextureType aiType);
 
 class Model
 {
 public:
-	Model(const std::string& path)
+	//packTextures: put material textures into shared texture arrays/atlases (shader samples sampler2DArray)
+	Model(const std::string& path, bool packTextures = false)
+		:packTextures(packTextures)
 	{
 		loadModel(path);
 	}
-	void Draw(Shader shader) const;
+	void Draw(const Shader& shader) const;
+	//position stream only, for depth/shadow/picking programs that just need model space positions
+	void DrawDepth() const;
+
+	//switch to bindless materials, no-op (bound units stay in use) when the manager is unsupported
+	void MakeBindless(BindlessTextureManager& manager);
 
 private:
 	void loadModel(const std::string& path);
 	void processNode(const aiNode* node, const aiScene* scene);
 	Mesh processMesh(const aiMesh* mesh, const aiScene* scene);
 	std::vector<Texture> loadMaterialTextures(const aiMaterial* mat, aiTextureType type);
+	void packSceneTextures(const aiScene* scene);
 private:
+	bool packTextures;
+
+	BindlessTextureManager* bindless = nullptr;
+	GLuint materialSSBO = 0;
+	GLuint whiteTexture = 0;	// stands in for maps a bindless material lacks
+	std::vector<std::vector<unsigned int>> materialSlots;
+
 	std::vector<Mesh> meshes;
 	std::string directory;
 
 	std::map<std::string, Texture> texture_loaded;
 };
 
-void Model::Draw(Shader shader) const
+void Model::Draw(const Shader& shader) const
 {
+	if (bindless)
+	{
+		GLStateCache::Get().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, materialSSBO);
+	}
+
 	for (unsigned int i = 0; i < meshes.size(); ++i)
 	{
+		if (bindless)
+		{
+			for (unsigned int slot : materialSlots[meshes[i].MaterialIndex])
+			{
+				bindless->Touch(slot);
+			}
+		}
 		meshes[i].Draw(shader);
 	}
 }
 
+void Model::DrawDepth() const
+{
+	for (unsigned int i = 0; i < meshes.size(); ++i)
+	{
+		meshes[i].DrawDepth();
+	}
+}
+
+void Model::MakeBindless(BindlessTextureManager& manager)
+{
+	if (!manager.Supported())
+		return;
+	if (packTextures)
+	{
+		std::cout << "Bindless: packed models sample texture arrays, keeping bound units" << std::endl;
+		return;
+	}
+	if (meshes.empty())
+		return;
+
+	//one material per distinct (diffuse, specular) pair, laid out as uvec2 handles[2*i], handles[2*i+1]
+	std::map<std::pair<GLuint, GLuint>, GLint> materialIds;
+	std::vector<GLuint64> handles;
+	for (Mesh& mesh : meshes)
+	{
+		GLuint diffuse = 0;
+		GLuint specular = 0;
+		for (const Texture& texture : mesh.Textures)
+		{
+			if (texture.type == TextureType::DIFFUSE && !diffuse)
+				diffuse = texture.id;
+			else if (texture.type == TextureType::SPECULAR && !specular)
+				specular = texture.id;
+		}
+
+		auto key = std::make_pair(diffuse, specular);
+		auto it = materialIds.find(key);
+		if (it == materialIds.end())
+		{
+			//the shader samples both handles unconditionally and a 0 handle is no valid sampler,
+			//a missing map gets a resident 1x1 white texture instead
+			if ((!diffuse || !specular) && !whiteTexture)
+			{
+				const unsigned char white[4] = { 255, 255, 255, 255 };
+				glGenTextures(1, &whiteTexture);
+				GLStateCache::Get().BindTexture(GL_TEXTURE_2D, whiteTexture);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+			std::vector<unsigned int> slots;
+			GLuint ids[2] = { diffuse ? diffuse : whiteTexture, specular ? specular : whiteTexture };
+			for (GLuint id : ids)
+			{
+				slots.push_back(manager.Acquire(id));
+				handles.push_back(manager.Handle(slots.back()));
+			}
+			materialSlots.push_back(slots);
+			it = materialIds.insert(std::make_pair(key, (GLint)materialSlots.size() - 1)).first;
+		}
+
+		mesh.MaterialIndex = it->second;
+		for (Texture& texture : mesh.Textures)
+		{
+			texture.handle = manager.Handle(manager.Acquire(texture.id));
+		}
+	}
+
+	glGenBuffers(1, &materialSSBO);
+	GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, materialSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, handles.size()*sizeof(GLuint64), handles.data(), GL_STATIC_DRAW);
+
+	bindless = &manager;
+}
+
 void Model::loadModel(const std::string& path)
 {
+	PROFILE_ZONE("Model::loadModel");
 	Assimp::Importer importer;
 	const aiScene* pScene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
 	if (!pScene || pScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !pScene->mRootNode)
@@ -57,6 +165,11 @@ void Model::loadModel(const std::string& path)
 	}
 	directory = path.substr(0, path.find_last_of('/'));
 
+	if (packTextures)
+	{
+		packSceneTextures(pScene);
+	}
+
 	processNode(pScene->mRootNode, pScene);
 }
 
@@ -109,7 +222,31 @@ Mesh Model::processMesh(const aiMesh* mesh, const aiScene* scene)
 	std::vector<Texture> diffuseTextures = loadMaterialTextures(pMat, aiTextureType_DIFFUSE);
 	textures.insert(textures.end(), diffuseTextures.begin(), diffuseTextures.end());
 	std::vector<Texture> specularTextures = loadMaterialTextures(pMat, aiTextureType_SPECULAR);
-	textures.insert(textures.end(), diffuseTextures.begin(), diffuseTextures.end());
+	textures.insert(textures.end(), specularTextures.begin(), specularTextures.end());
+
+	//atlas remap at import: if every texture of the mesh sits in the same atlas rect, bake the rect
+	//into the uvs so the draw needs no per-texture rect. Otherwise the rect stays a uniform.
+	if (!textures.empty() && textures[0].uvRect != glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))
+	{
+		bool sharedRect = true;
+		for (const Texture& texture : textures)
+		{
+			sharedRect = sharedRect && texture.uvRect == textures[0].uvRect;
+		}
+
+		if (sharedRect)
+		{
+			glm::vec4 rect = textures[0].uvRect;
+			for (Vertex& vertex : vertices)
+			{
+				vertex.TexCoords = glm::vec2(rect.x, rect.y) + vertex.TexCoords * glm::vec2(rect.z, rect.w);
+			}
+			for (Texture& texture : textures)
+			{
+				texture.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+			}
+		}
+	}
 
 	return Mesh(vertices, indices, textures);
 }
@@ -140,8 +277,75 @@ std::vector<Texture> Model::loadMaterialTextures(const aiMaterial* mat, aiTextur
 	return textures;
 }
 
-GLuint LoadTextureFromFile(const char* path, const std::string& directory)
+void Model::packSceneTextures(const aiScene* scene)
+{
+	//textures sampled outside [0,1] rely on GL_REPEAT and must keep a whole layer
+	std::map<std::string, bool> tiling;
+	const aiTextureType types[2] = { aiTextureType_DIFFUSE, aiTextureType_SPECULAR };
+	for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+	{
+		const aiMesh* mesh = scene->mMeshes[i];
+		bool outside = false;
+		if (mesh->mTextureCoords[0])
+		{
+			for (unsigned int v = 0; v < mesh->mNumVertices && !outside; ++v)
+			{
+				const aiVector3D& uv = mesh->mTextureCoords[0][v];
+				outside = uv.x < 0.0f || uv.x > 1.0f || uv.y < 0.0f || uv.y > 1.0f;
+			}
+		}
+
+		const aiMaterial* mat = scene->mMaterials[mesh->mMaterialIndex];
+		for (aiTextureType type : types)
+		{
+			for (unsigned int t = 0; t < mat->GetTextureCount(type); ++t)
+			{
+				aiString path;
+				mat->GetTexture(type, t, &path);
+				tiling[path.C_Str()] = tiling[path.C_Str()] || outside;
+			}
+		}
+	}
+
+	TexturePacker packer;
+	std::map<std::string, TextureType> texTypes;
+	for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+	{
+		const aiMaterial* mat = scene->mMaterials[i];
+		for (aiTextureType type : types)
+		{
+			for (unsigned int t = 0; t < mat->GetTextureCount(type); ++t)
+			{
+				aiString path;
+				mat->GetTexture(type, t, &path);
+				std::string key(path.C_Str());
+				if (texTypes.find(key) != texTypes.end())
+					continue;
+
+				texTypes[key] = AiTexTypeToTexType(type);
+				packer.AddFile(key, directory + '/' + key, tiling[key]);
+			}
+		}
+	}
+
+	//loadMaterialTextures finds these in texture_loaded and never loads the files again
+	std::map<std::string, PackedTextureRef> packed = packer.Build();
+	for (const auto& it : packed)
+	{
+		Texture texture;
+		texture.id = it.second.arrayId;
+		texture.type = texTypes[it.first];
+		texture.path = it.first;
+		texture.target = GL_TEXTURE_2D_ARRAY;
+		texture.layer = it.second.layer;
+		texture.uvRect = it.second.uvRect;
+		texture_loaded[texture.path] = texture;
+	}
+}
+
+GLuint LoadTextureFromFile(const char* path, const std::string& directory, bool srgb)
 {
+	PROFILE_ZONE("LoadTextureFromFile");
 	GLuint texID;
 	glGenTextures(1, &texID);
 
@@ -168,8 +372,13 @@ GLuint LoadTextureFromFile(const char* path, const std::string& directory)
 			format = GL_RED;
 			break;
 		}
-		glBindTexture(GL_TEXTURE_2D, texID);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		GLint internalFormat = format;
+		if (srgb && format == GL_RGB)
+			internalFormat = GL_SRGB8;
+		else if (srgb && format == GL_RGBA)
+			internalFormat = GL_SRGB8_ALPHA8;
+		GLStateCache::Get().BindTexture(GL_TEXTURE_2D, texID);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		//Note that when sampling textures at their borders, 
@@ -191,6 +400,39 @@ GLuint LoadTextureFromFile(const char* path, const std::string& directory)
 	return texID;
 }
 
+GLuint LoadHDRTextureFromFile(const char* path, const std::string& directory)
+{
+	PROFILE_ZONE("LoadHDRTextureFromFile");
+	GLuint texID;
+	glGenTextures(1, &texID);
+
+	std::string imagePath = directory + '/' + path;
+
+	//equirectangular maps have the sky in the first row, flip it to the top of the texture
+	stbi_set_flip_vertically_on_load(true);
+	int width, height, nrChannels;
+	float* data = stbi_loadf(imagePath.c_str(), &width, &height, &nrChannels, 3);
+	stbi_set_flip_vertically_on_load(false);
+	if (data)
+	{
+		GLStateCache::Get().BindTexture(GL_TEXTURE_2D, texID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height, 0, GL_RGB, GL_FLOAT, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else
+	{
+		std::cout << "Failed to load image " << imagePath << std::endl;
+	}
+	stbi_image_free(data);
+
+	return texID;
+}
+
 TextureType AiTexTypeToTexType(aiTextureType aiType)
 {
 	TextureType texType;
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "Model.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Metallic/roughness texture set read from one directory (albedo.png, normal.png, metallic.png, roughness.png,
+//ao.png), as found under Resources/Textures/pbr. The three scalar maps are packed at import into one RGB8
+//texture (r = ao, g = roughness, b = metallic), so a material costs three samplers and three fetches instead
+//of five. Albedo is authored in sRGB and loaded as SRGB8 so the shader reads linear colour, the other maps
+//are data and stay linear. A file that is missing is replaced by a neutral value, a shared 1x1 texture when
+//the whole map is.
+struct PBRMaterial
+{
+	GLuint albedo = 0;
+	GLuint normal = 0;
+	GLuint aoRoughnessMetallic = 0;
+
+	//albedoMap, normalMap, ormMap on firstUnit..firstUnit + 2
+	void Bind(const Shader& shader, int firstUnit) const;
+};
+
+PBRMaterial LoadPBRMaterial(const std::string& directory);
+
+inline GLuint PBRFallbackTexture(const glm::vec4& value)
+{
+	//one texture per neutral value, shared by all materials
+	static std::vector<std::pair<glm::vec4, GLuint>> fallbacks;
+	for (const auto& entry : fallbacks)
+	{
+		if (entry.first == value)
+			return entry.second;
+	}
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	GLStateCache::Get().BindTextureUnit(0, GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_FLOAT, &value[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	fallbacks.push_back(std::make_pair(value, texture));
+	return texture;
+}
+
+//fallback is a linear value, the file is decoded from sRGB when srgb is set
+inline GLuint LoadPBRMap(const std::string& directory, const char* file, const glm::vec4& fallback, bool srgb)
+{
+	if (std::ifstream(directory + '/' + file).good())
+		return LoadTextureFromFile(file, directory, srgb);
+	return PBRFallbackTexture(fallback);
+}
+
+inline GLuint PackPBRChannels(const std::string& directory, const char* const (&files)[3], const float (&fallbacks)[3])
+{
+	struct Channel
+	{
+		unsigned char* data = nullptr;
+		int width = 0;
+		int height = 0;
+	} channels[3];
+
+	int width = 0, height = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		std::string path = directory + '/' + files[i];
+		if (!std::ifstream(path).good())
+			continue;
+
+		//grey maps, any colour ones collapse to luminance
+		int comp;
+		channels[i].data = stbi_load(path.c_str(), &channels[i].width, &channels[i].height, &comp, 1);
+		if (!channels[i].data)
+		{
+			std::cout << "Failed to load image " << path << std::endl;
+			continue;
+		}
+		width = std::max(width, channels[i].width);
+		height = std::max(height, channels[i].height);
+	}
+
+	if (width == 0)
+		return PBRFallbackTexture(glm::vec4(fallbacks[0], fallbacks[1], fallbacks[2], 1.0f));
+
+	//maps of different sizes are point sampled up to the largest one
+	std::vector<unsigned char> packed(width * height * 3);
+	for (int i = 0; i < 3; ++i)
+	{
+		const Channel& channel = channels[i];
+		unsigned char constant = (unsigned char)(fallbacks[i] * 255.0f + 0.5f);
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				unsigned char value = constant;
+				if (channel.data)
+					value = channel.data[(y * channel.height / height) * channel.width + x * channel.width / width];
+				packed[(y * width + x) * 3 + i] = value;
+			}
+		}
+		stbi_image_free(channel.data);
+	}
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	GLStateCache::Get().BindTextureUnit(0, GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, packed.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return texture;
+}
+
+inline PBRMaterial LoadPBRMaterial(const std::string& directory)
+{
+	const char* const ormFiles[3] = { "ao.png", "roughness.png", "metallic.png" };
+	const float ormFallbacks[3] = { 1.0f, 0.5f, 0.0f };
+
+	PBRMaterial material;
+	material.albedo = LoadPBRMap(directory, "albedo.png", glm::vec4(0.5f, 0.5f, 0.5f, 1.0f), true);
+	material.normal = LoadPBRMap(directory, "normal.png", glm::vec4(0.5f, 0.5f, 1.0f, 1.0f), false);
+	material.aoRoughnessMetallic = PackPBRChannels(directory, ormFiles, ormFallbacks);
+	return material;
+}
+
+inline void PBRMaterial::Bind(const Shader& shader, int firstUnit) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	const char* names[3] = { "albedoMap", "normalMap", "ormMap" };
+	const GLuint textures[3] = { albedo, normal, aoRoughnessMetallic };
+	for (int i = 0; i < 3; ++i)
+	{
+		shader.SetInt(names[i], firstUnit + i);
+		state.BindTextureUnit(firstUnit + i, GL_TEXTURE_2D, textures[i]);
+	}
+}
@@ -0,0 +1,507 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "ComputeShader.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+enum class PostEffectType
+{
+	GRAYSCALE,		// per-pixel
+	INVERSION,		// per-pixel
+	TONEMAP,		// per-pixel, 1 - exp(-color * exposure)
+	KERNEL,			// 3x3 convolution
+	BLUR,			// separable gaussian
+};
+
+//One node of a PostProcessChain, build it with the factories. Fields the type does not use are ignored.
+struct PostEffect
+{
+	PostEffectType type = PostEffectType::GRAYSCALE;
+	bool enabled = true;
+	float exposure = 1.0f;		// TONEMAP
+	int radius = 0;				// BLUR, in texels, sigma is radius / 3
+	float kernel[9] = {};		// KERNEL, row major with the top row first
+
+	bool PerPixel() const
+	{
+		return type == PostEffectType::GRAYSCALE || type == PostEffectType::INVERSION || type == PostEffectType::TONEMAP;
+	}
+
+	static PostEffect Grayscale() { PostEffect effect; effect.type = PostEffectType::GRAYSCALE; return effect; }
+	static PostEffect Inversion() { PostEffect effect; effect.type = PostEffectType::INVERSION; return effect; }
+	static PostEffect Tonemap(float exposure) { PostEffect effect; effect.type = PostEffectType::TONEMAP; effect.exposure = exposure; return effect; }
+	static PostEffect Blur(int radius) { PostEffect effect; effect.type = PostEffectType::BLUR; effect.radius = radius; return effect; }
+	static PostEffect Kernel(const float (&weights)[9])
+	{
+		PostEffect effect;
+		effect.type = PostEffectType::KERNEL;
+		std::copy(weights, weights + 9, effect.kernel);
+		return effect;
+	}
+};
+
+//Post processing as an ordered list of effect nodes between the scene target and the default framebuffer.
+//The list is turned into passes whenever it changes:
+//	- a run of per-pixel effects becomes one generated ApplyColor() evaluated at the end of the pass in front
+//	  of it (a kernel or a vertical blur pass), or in a plain copy pass when nothing can take it
+//	- blurs are separable. Up to MAX_FRAGMENT_RADIUS they run as two fragment passes with linear sampling
+//	  (one bilinear fetch covers two texels), wider ones on a 4.3 context as two compute passes that read
+//	  each row/column once into shared memory
+//	- the last pass renders straight into the default framebuffer, compute results get a copy pass
+//Generated programs are cached by their source, toggling effects back and forth compiles nothing new.
+//The scene and intermediate targets are RGBA16F so tonemapping sees unclamped color.
+class PostProcessChain
+{
+public:
+	static const int MAX_FRAGMENT_RADIUS = 30;		// 16 linear taps, the array size in post_frag.glsl
+	static const int MAX_COMPUTE_RADIUS = 64;		// MAX_RADIUS in blur_comp.glsl
+	static const int COMPUTE_ABOVE_RADIUS = 12;		// narrower blurs are cheaper as fragment passes
+	static const int MAX_COLOR_OPS = 8;				// colorParams size in color_ops.glsl
+
+	//shaderDir holds post_vert, post_frag, color_ops and blur_comp
+	PostProcessChain(const std::string& shaderDir);
+	~PostProcessChain();
+
+	//returns the node index used by Effect() and SetEnabled()
+	int Add(const PostEffect& effect);
+	//editing a node rebuilds the passes on the next Present()
+	PostEffect& Effect(int index) { dirty = true; return effects[index]; }
+	void SetEnabled(int index, bool enabled) { dirty = true; effects[index].enabled = enabled; }
+	int EffectCount() const { return (int)effects.size(); }
+
+	//(re)creates the targets when the framebuffer size changes, cheap to call every frame
+	void Resize(int width, int height);
+	//bind the scene target, caller clears and draws as usual
+	void BeginScene() const;
+	//run the passes, the result lands in the default framebuffer
+	void Present() { Present(sceneTex); }
+	//same from a texture rendered elsewhere (a render graph transient)
+	void Present(GLuint source);
+	//skip the built in scene target when every frame comes through Present(source)
+	void UseExternalScene() { ownScene = false; }
+
+	int PassCount() const { return (int)passes.size(); }
+	bool ComputeAvailable() const { return blurCompute != nullptr; }
+
+private:
+	enum class PassKind { COPY, KERNEL, BLUR_H, BLUR_V, COMPUTE_BLUR_H, COMPUTE_BLUR_V };
+
+	struct Pass
+	{
+		PassKind kind = PassKind::COPY;
+		int effect = -1;				// kernel or blur node
+		std::vector<int> colorOps;		// per-pixel nodes applied to the output
+		Shader* shader = nullptr;		// fragment passes, owned by shaderCache
+	};
+
+	std::string vertexCode;
+	std::string fragmentCode;
+	std::string colorOpsCode;
+	std::map<std::string, Shader> shaderCache;
+	ComputeShader* blurCompute = nullptr;
+
+	std::vector<PostEffect> effects;
+	std::vector<Pass> passes;
+	bool dirty = true;
+	bool ownScene = true;
+
+	int width = 0;
+	int height = 0;
+
+	GLuint sceneFBO = 0;
+	GLuint sceneTex = 0;
+	GLuint depthRBO = 0;
+	GLuint pingFBO[2] = {};
+	GLuint pingTex[2] = {};
+
+	GLuint quadVAO = 0;
+	GLuint quadVBO = 0;
+
+private:
+	void compile();
+	Shader* fragmentProgram(const Pass& pass);
+	void runFragment(const Pass& pass, GLuint source);
+	void runCompute(const Pass& pass, GLuint source, GLuint target);
+
+	static bool isCompute(PassKind kind) { return kind == PassKind::COMPUTE_BLUR_H || kind == PassKind::COMPUTE_BLUR_V; }
+	static void gaussianWeights(int radius, GLfloat* weights);
+	static int linearTaps(int radius, GLfloat* offsets, GLfloat* weights);
+
+	void setupQuad();
+	void releaseTargets();
+	GLuint createTarget() const;
+};
+
+inline PostProcessChain::PostProcessChain(const std::string& shaderDir)
+{
+	vertexCode = Shader::ReadFile((shaderDir + "/post_vert.glsl").c_str());
+	fragmentCode = Shader::ReadFile((shaderDir + "/post_frag.glsl").c_str());
+	colorOpsCode = Shader::ReadFile((shaderDir + "/color_ops.glsl").c_str());
+
+	if (GLAD_GL_VERSION_4_3)
+	{
+		blurCompute = new ComputeShader((shaderDir + "/blur_comp.glsl").c_str());
+		blurCompute->Use();
+		blurCompute->SetInt("sourceTex", 0);
+	}
+	setupQuad();
+}
+
+inline PostProcessChain::~PostProcessChain()
+{
+	GLStateCache& state = GLStateCache::Get();
+	releaseTargets();
+	state.DeleteVertexArray(quadVAO);
+	state.DeleteBuffer(quadVBO);
+
+	for (auto& cached : shaderCache)
+		state.DeleteProgram(cached.second.shaderProgram);
+	if (blurCompute)
+		state.DeleteProgram(blurCompute->shaderProgram);
+	delete blurCompute;
+}
+
+inline int PostProcessChain::Add(const PostEffect& effect)
+{
+	effects.push_back(effect);
+	dirty = true;
+	return (int)effects.size() - 1;
+}
+
+inline void PostProcessChain::Resize(int w, int h)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (w == width && h == height)
+		return;
+
+	releaseTargets();
+	width = w;
+	height = h;
+	if (width <= 0 || height <= 0) // minimized
+		return;
+
+	if (ownScene)
+	{
+		sceneTex = createTarget();
+		glGenRenderbuffers(1, &depthRBO);
+		state.BindRenderbuffer(depthRBO);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+		state.BindRenderbuffer(0);
+
+		glGenFramebuffers(1, &sceneFBO);
+		state.BindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneTex, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "Error: post process scene framebuffer is not complete" << std::endl;
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		pingTex[i] = createTarget();
+		glGenFramebuffers(1, &pingFBO[i]);
+		state.BindFramebuffer(GL_FRAMEBUFFER, pingFBO[i]);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pingTex[i], 0);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "Error: post process pass framebuffer is not complete" << std::endl;
+	}
+
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void PostProcessChain::BeginScene() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+	state.DepthMask(GL_TRUE);
+	state.Enable(GL_DEPTH_TEST);
+}
+
+inline void PostProcessChain::Present(GLuint source)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (dirty)
+		compile();
+
+	state.Disable(GL_DEPTH_TEST);
+	state.Disable(GL_BLEND);
+	state.BindVertexArray(quadVAO);
+
+	//scene -> ping 0 -> ping 1 -> ping 0 ..., the last pass goes to the default framebuffer
+	int target = 0;
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		const Pass& pass = passes[i];
+		if (isCompute(pass.kind))
+		{
+			runCompute(pass, source, pingTex[target]);
+		}
+		else
+		{
+			state.BindFramebuffer(GL_FRAMEBUFFER, i + 1 == passes.size() ? 0 : pingFBO[target]);
+			runFragment(pass, source);
+		}
+		source = pingTex[target];
+		target ^= 1;
+	}
+
+	state.Enable(GL_DEPTH_TEST);
+}
+
+inline void PostProcessChain::compile()
+{
+	passes.clear();
+
+	//index of the pass whose output still takes per-pixel effects, -1 if none does
+	int open = -1;
+	for (int i = 0; i < (int)effects.size(); ++i)
+	{
+		const PostEffect& effect = effects[i];
+		if (!effect.enabled)
+			continue;
+
+		Pass pass;
+		pass.effect = i;
+		if (effect.PerPixel())
+		{
+			if (open < 0 || passes[open].colorOps.size() == MAX_COLOR_OPS)
+			{
+				pass.effect = -1;
+				passes.push_back(pass);
+				open = (int)passes.size() - 1;
+			}
+			passes[open].colorOps.push_back(i);
+		}
+		else if (effect.type == PostEffectType::KERNEL)
+		{
+			pass.kind = PassKind::KERNEL;
+			passes.push_back(pass);
+			open = (int)passes.size() - 1;
+		}
+		else if (effect.radius > 0)
+		{
+			//per-pixel effects do not commute with the blur, the horizontal half never takes them
+			bool compute = blurCompute && effect.radius > COMPUTE_ABOVE_RADIUS;
+			pass.kind = compute ? PassKind::COMPUTE_BLUR_H : PassKind::BLUR_H;
+			passes.push_back(pass);
+			pass.kind = compute ? PassKind::COMPUTE_BLUR_V : PassKind::BLUR_V;
+			passes.push_back(pass);
+			open = compute ? -1 : (int)passes.size() - 1;
+		}
+	}
+
+	//compute writes an image, presenting needs a fragment pass
+	if (passes.empty() || isCompute(passes.back().kind))
+		passes.push_back(Pass());
+
+	for (Pass& pass : passes)
+	{
+		if (!isCompute(pass.kind))
+			pass.shader = fragmentProgram(pass);
+	}
+	dirty = false;
+}
+
+inline Shader* PostProcessChain::fragmentProgram(const Pass& pass)
+{
+	std::string block;
+	if (pass.kind == PassKind::KERNEL)
+		block = "#define PASS_KERNEL\n";
+	else if (pass.kind == PassKind::BLUR_H || pass.kind == PassKind::BLUR_V)
+		block = "#define PASS_BLUR\n";
+	else
+		block = "#define PASS_COPY\n";
+	block += colorOpsCode + "\n\nvec3 ApplyColor(vec3 color)\n{\n";
+	for (size_t i = 0; i < pass.colorOps.size(); ++i)
+	{
+		switch (effects[pass.colorOps[i]].type)
+		{
+		case PostEffectType::GRAYSCALE:
+			block += "    color = Grayscale(color);\n";
+			break;
+		case PostEffectType::INVERSION:
+			block += "    color = Inversion(color);\n";
+			break;
+		case PostEffectType::TONEMAP:
+			block += "    color = Tonemap(color, colorParams[" + std::to_string(i) + "]);\n";
+			break;
+		default:
+			break;
+		}
+	}
+	block += "    return color;\n}\n";
+
+	//spliced in right after the #version line
+	size_t versionEnd = fragmentCode.find('\n') + 1;
+	std::string source = fragmentCode.substr(0, versionEnd) + block + fragmentCode.substr(versionEnd);
+
+	auto cached = shaderCache.find(source);
+	if (cached != shaderCache.end())
+		return &cached->second;
+
+	Shader& shader = shaderCache.emplace(source, Shader::FromSource(vertexCode, source)).first->second;
+	shader.Use();
+	shader.SetInt("sourceTex", 0);
+	return &shader;
+}
+
+inline void PostProcessChain::runFragment(const Pass& pass, GLuint source)
+{
+	GLStateCache& state = GLStateCache::Get();
+	Shader& shader = *pass.shader;
+	shader.Use();
+	state.BindTextureUnit(0, GL_TEXTURE_2D, source);
+
+	GLfloat colorParams[MAX_COLOR_OPS] = {};
+	for (size_t i = 0; i < pass.colorOps.size(); ++i)
+		colorParams[i] = effects[pass.colorOps[i]].exposure;
+	if (!pass.colorOps.empty())
+		glUniform1fv(glGetUniformLocation(shader.shaderProgram, "colorParams"), MAX_COLOR_OPS, colorParams);
+
+	if (pass.kind == PassKind::KERNEL)
+	{
+		glUniform1fv(glGetUniformLocation(shader.shaderProgram, "kernel"), 9, effects[pass.effect].kernel);
+	}
+	else if (pass.kind == PassKind::BLUR_H || pass.kind == PassKind::BLUR_V)
+	{
+		GLfloat offsets[16], weights[16];
+		int taps = linearTaps(std::min(effects[pass.effect].radius, (int)MAX_FRAGMENT_RADIUS), offsets, weights);
+		shader.SetVec2("blurStep", pass.kind == PassKind::BLUR_H ? glm::vec2(1.0f / width, 0.0f) : glm::vec2(0.0f, 1.0f / height));
+		shader.SetInt("blurTaps", taps);
+		glUniform1fv(glGetUniformLocation(shader.shaderProgram, "blurOffsets"), taps, offsets);
+		glUniform1fv(glGetUniformLocation(shader.shaderProgram, "blurWeights"), taps, weights);
+	}
+
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+inline void PostProcessChain::runCompute(const Pass& pass, GLuint source, GLuint target)
+{
+	GLStateCache& state = GLStateCache::Get();
+	const int groupSize = 128;	// GROUP_SIZE in blur_comp.glsl
+	bool horizontal = pass.kind == PassKind::COMPUTE_BLUR_H;
+	int radius = std::min(effects[pass.effect].radius, (int)MAX_COMPUTE_RADIUS);
+
+	GLfloat weights[MAX_COMPUTE_RADIUS + 1];
+	gaussianWeights(radius, weights);
+
+	blurCompute->Use();
+	state.BindTextureUnit(0, GL_TEXTURE_2D, source);
+	glBindImageTexture(0, target, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+	blurCompute->SetIVec2("blurAxis", horizontal ? glm::ivec2(1, 0) : glm::ivec2(0, 1));
+	blurCompute->SetInt("blurRadius", radius);
+	blurCompute->SetFloatArray("blurWeights", weights, radius + 1);
+
+	//x walks along the axis in groups, y picks the row or column
+	int extent = horizontal ? width : height;
+	int lines = horizontal ? height : width;
+	blurCompute->Dispatch((extent + groupSize - 1) / groupSize, lines);
+
+	//the next pass samples the result or renders into the same texture
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+inline void PostProcessChain::gaussianWeights(int radius, GLfloat* weights)
+{
+	float sigma = std::max(radius / 3.0f, 0.5f);
+	float sum = 0.0f;
+	for (int i = 0; i <= radius; ++i)
+	{
+		weights[i] = std::exp(-(float)(i * i) / (2.0f * sigma * sigma));
+		sum += i == 0 ? weights[i] : 2.0f * weights[i];
+	}
+	for (int i = 0; i <= radius; ++i)
+		weights[i] /= sum;
+}
+
+inline int PostProcessChain::linearTaps(int radius, GLfloat* offsets, GLfloat* weights)
+{
+	GLfloat discrete[MAX_FRAGMENT_RADIUS + 2] = {};
+	gaussianWeights(radius, discrete);
+
+	//center alone, then texel pairs (1,2), (3,4) ... merged into one fetch placed at their weighted center
+	offsets[0] = 0.0f;
+	weights[0] = discrete[0];
+	int taps = 1;
+	for (int i = 1; i <= radius; i += 2, ++taps)
+	{
+		float weight = discrete[i] + discrete[i + 1];
+		weights[taps] = weight;
+		offsets[taps] = (i * discrete[i] + (i + 1) * discrete[i + 1]) / weight;
+	}
+	return taps;
+}
+
+inline void PostProcessChain::releaseTargets()
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (sceneFBO)
+		state.DeleteFramebuffer(sceneFBO);
+	if (sceneTex)
+		state.DeleteTexture(sceneTex);
+	if (depthRBO)
+		state.DeleteRenderbuffer(depthRBO);
+	for (int i = 0; i < 2; ++i)
+	{
+		if (pingFBO[i])
+			state.DeleteFramebuffer(pingFBO[i]);
+		if (pingTex[i])
+			state.DeleteTexture(pingTex[i]);
+		pingFBO[i] = pingTex[i] = 0;
+	}
+	sceneFBO = sceneTex = depthRBO = 0;
+}
+
+inline GLuint PostProcessChain::createTarget() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLuint tex;
+	glGenTextures(1, &tex);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, tex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+	//linear filtering is what the blur taps rely on
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return tex;
+}
+
+inline void PostProcessChain::setupQuad()
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLfloat quadVertices[] = { // coord in ndc
+		// positions   // texCoords
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		-1.0f, -1.0f,  0.0f, 0.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+		 1.0f,  1.0f,  1.0f, 1.0f
+	};
+
+	glGenVertexArrays(1, &quadVAO);
+	state.BindVertexArray(quadVAO);
+
+	glGenBuffers(1, &quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	state.BindVertexArray(0);
+}
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "GLStateCache.h"
+#include "GPUProfiler.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//Frame graph for render-to-texture pipelines.
+//Passes are added in execution order and declare the textures they read and write. Writing BACKBUFFER
+//makes a pass an output. Resize() compiles the graph for the new size:
+//	- passes whose writes nobody downstream reads are culled, with their transient textures
+//	- every transient gets a lifetime (first to last pass using it), textures come from a pool keyed by
+//	  size and format, and a texture is handed to the next transient once the last pass of the previous
+//	  one has run. Resources with disjoint lifetimes share one GL texture, which is the closest GL gets to
+//	  memory aliasing
+//	- framebuffers are built once per pass here, Execute() only binds them
+//Pool textures survive a recompile when their size and format are still wanted, only stale ones are freed.
+//An aliased texture holds whatever the previous owner left, the first pass writing a transient must clear it.
+//Textures that outlive a frame (history, adaptation state) are imported instead, they take part in culling and
+//ordering but are never pooled. Compute passes get no framebuffer, they bind what they touch themselves.
+//With a profiler set every pass runs inside a scope of its own name.
+class RenderGraph
+{
+public:
+	typedef int Resource;
+	static const Resource BACKBUFFER = -1;
+
+	struct Stats
+	{
+		int passes = 0;				// after culling
+		int culled = 0;
+		int textures = 0;			// GL textures behind the transients
+		size_t bytes = 0;			// their memory
+		size_t unaliasedBytes = 0;	// what one texture per transient would take
+	};
+
+	~RenderGraph();
+
+	//scale is relative to the graph size, 0.5 for a half resolution target
+	Resource CreateTexture(const std::string& name, GLenum internalFormat, float scale = 1.0f);
+	//a texture owned by the caller, Texture() returns it as is
+	Resource ImportTexture(const std::string& name, GLuint texture);
+	//execute runs with the pass framebuffer bound and the viewport set to its size
+	void AddPass(const std::string& name, const std::vector<Resource>& reads, const std::vector<Resource>& writes,
+		std::function<void(const RenderGraph&)> execute);
+	void AddComputePass(const std::string& name, const std::vector<Resource>& reads, const std::vector<Resource>& writes,
+		std::function<void(const RenderGraph&)> execute);
+
+	//recompiles when the size changes, cheap to call every frame
+	void Resize(int width, int height);
+	void Execute() const;
+	void SetProfiler(GPUProfiler* gpuProfiler) { profiler = gpuProfiler; }
+
+	//the GL texture behind a transient, valid while its pass executes
+	GLuint Texture(Resource resource) const;
+	int Width() const { return width; }
+	int Height() const { return height; }
+	const Stats& GetStats() const { return stats; }
+
+private:
+	struct TextureNode
+	{
+		std::string name;
+		GLenum internalFormat;
+		float scale;
+		int physical = -1;		// pool slot, -1 when culled
+		GLuint imported = 0;
+	};
+
+	struct PassNode
+	{
+		std::string name;
+		std::vector<Resource> reads;
+		std::vector<Resource> writes;
+		std::function<void(const RenderGraph&)> execute;
+		bool compute = false;
+		bool alive = false;
+		GLuint fbo = 0;
+		int viewportWidth = 0;
+		int viewportHeight = 0;
+	};
+
+	struct PoolTexture
+	{
+		int width;
+		int height;
+		GLenum internalFormat;
+		GLuint texture;
+		bool used;
+	};
+
+	std::vector<TextureNode> textures;
+	std::vector<PassNode> passes;
+	std::vector<PoolTexture> pool;
+	Stats stats;
+
+	int width = 0;
+	int height = 0;
+	GPUProfiler* profiler = nullptr;
+
+private:
+	void compile();
+	void cull();
+	void allocate();
+	void createFramebuffers();
+
+	int acquire(int w, int h, GLenum internalFormat);
+	int scaledWidth(const TextureNode& node) const { return (int)(width * node.scale) > 1 ? (int)(width * node.scale) : 1; }
+	int scaledHeight(const TextureNode& node) const { return (int)(height * node.scale) > 1 ? (int)(height * node.scale) : 1; }
+
+	static bool isDepthFormat(GLenum internalFormat);
+	static void pixelFormat(GLenum internalFormat, GLenum& format, GLenum& type, int& bytesPerPixel);
+};
+
+inline RenderGraph::~RenderGraph()
+{
+	GLStateCache& state = GLStateCache::Get();
+	for (PassNode& pass : passes)
+	{
+		if (pass.fbo)
+			state.DeleteFramebuffer(pass.fbo);
+	}
+	for (PoolTexture& entry : pool)
+		state.DeleteTexture(entry.texture);
+}
+
+inline RenderGraph::Resource RenderGraph::CreateTexture(const std::string& name, GLenum internalFormat, float scale)
+{
+	TextureNode node;
+	node.name = name;
+	node.internalFormat = internalFormat;
+	node.scale = scale;
+	textures.push_back(node);
+	width = height = 0; // recompile on the next Resize
+	return (Resource)textures.size() - 1;
+}
+
+inline RenderGraph::Resource RenderGraph::ImportTexture(const std::string& name, GLuint texture)
+{
+	TextureNode node;
+	node.name = name;
+	node.internalFormat = GL_NONE;
+	node.scale = 1.0f;
+	node.imported = texture;
+	textures.push_back(node);
+	width = height = 0;
+	return (Resource)textures.size() - 1;
+}
+
+inline void RenderGraph::AddPass(const std::string& name, const std::vector<Resource>& reads, const std::vector<Resource>& writes,
+	std::function<void(const RenderGraph&)> execute)
+{
+	PassNode pass;
+	pass.name = name;
+	pass.reads = reads;
+	pass.writes = writes;
+	pass.execute = execute;
+	passes.push_back(pass);
+	width = height = 0;
+}
+
+inline void RenderGraph::AddComputePass(const std::string& name, const std::vector<Resource>& reads, const std::vector<Resource>& writes,
+	std::function<void(const RenderGraph&)> execute)
+{
+	AddPass(name, reads, writes, execute);
+	passes.back().compute = true;
+}
+
+inline GLuint RenderGraph::Texture(Resource resource) const
+{
+	const TextureNode& node = textures[resource];
+	if (node.imported)
+		return node.imported;
+	return node.physical < 0 ? 0 : pool[node.physical].texture;
+}
+
+inline void RenderGraph::Resize(int w, int h)
+{
+	if (w == width && h == height)
+		return;
+
+	width = w;
+	height = h;
+	if (width <= 0 || height <= 0) // minimized
+		return;
+
+	compile();
+}
+
+inline void RenderGraph::Execute() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (width <= 0 || height <= 0)
+		return;
+
+	for (const PassNode& pass : passes)
+	{
+		if (!pass.alive)
+			continue;
+		if (!pass.compute)
+		{
+			state.BindFramebuffer(GL_FRAMEBUFFER, pass.fbo);
+			state.Viewport(0, 0, pass.viewportWidth, pass.viewportHeight);
+		}
+		if (profiler)
+			profiler->BeginScope(pass.name);
+		pass.execute(*this);
+		if (profiler)
+			profiler->EndScope();
+	}
+
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	state.Viewport(0, 0, width, height);
+}
+
+inline void RenderGraph::compile()
+{
+	cull();
+	allocate();
+	createFramebuffers();
+
+	std::cout << "RenderGraph: " << stats.passes << " passes (" << stats.culled << " culled), "
+		<< stats.textures << " textures, " << stats.bytes / 1024 << " KB (" << stats.unaliasedBytes / 1024 << " KB unaliased)" << std::endl;
+}
+
+inline void RenderGraph::cull()
+{
+	//walk back from the outputs, a pass lives if a live pass (or the screen) reads something it writes
+	std::vector<bool> needed(textures.size(), false);
+	stats.passes = stats.culled = 0;
+	for (int i = (int)passes.size() - 1; i >= 0; --i)
+	{
+		PassNode& pass = passes[i];
+		pass.alive = false;
+		for (Resource resource : pass.writes)
+			pass.alive = pass.alive || resource == BACKBUFFER || needed[resource];
+		if (!pass.alive)
+		{
+			++stats.culled;
+			continue;
+		}
+		++stats.passes;
+		for (Resource resource : pass.reads)
+		{
+			if (resource != BACKBUFFER)
+				needed[resource] = true;
+		}
+	}
+}
+
+inline void RenderGraph::allocate()
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	//lifetimes over the live passes
+	std::vector<int> first(textures.size(), -1), last(textures.size(), -1);
+	for (int i = 0; i < (int)passes.size(); ++i)
+	{
+		if (!passes[i].alive)
+			continue;
+		for (const std::vector<Resource>* list : { &passes[i].reads, &passes[i].writes })
+		{
+			for (Resource resource : *list)
+			{
+				if (resource == BACKBUFFER)
+					continue;
+				if (first[resource] < 0)
+					first[resource] = i;
+				last[resource] = i;
+			}
+		}
+	}
+
+	for (PoolTexture& entry : pool)
+		entry.used = false;
+	for (TextureNode& node : textures)
+		node.physical = -1;
+
+	//every pool texture is free again, hand them out in pass order and take them back after the last use
+	stats.unaliasedBytes = 0;
+	for (int i = 0; i < (int)passes.size(); ++i)
+	{
+		for (int r = 0; r < (int)textures.size(); ++r)
+		{
+			if (first[r] != i || textures[r].imported)
+				continue;
+			TextureNode& node = textures[r];
+			node.physical = acquire(scaledWidth(node), scaledHeight(node), node.internalFormat);
+
+			GLenum format, type;
+			int bytesPerPixel;
+			pixelFormat(node.internalFormat, format, type, bytesPerPixel);
+			stats.unaliasedBytes += (size_t)scaledWidth(node) * scaledHeight(node) * bytesPerPixel;
+		}
+		for (int r = 0; r < (int)textures.size(); ++r)
+		{
+			if (last[r] == i && !textures[r].imported)
+				pool[textures[r].physical].used = false;
+		}
+	}
+
+	//whatever no transient asked for this time is stale (old size or format)
+	stats.textures = 0;
+	stats.bytes = 0;
+	std::vector<int> remap(pool.size(), -1);
+	std::vector<PoolTexture> kept;
+	for (int i = 0; i < (int)pool.size(); ++i)
+	{
+		bool referenced = false;
+		for (const TextureNode& node : textures)
+			referenced = referenced || node.physical == i;
+		if (!referenced)
+		{
+			state.DeleteTexture(pool[i].texture);
+			continue;
+		}
+		remap[i] = (int)kept.size();
+		kept.push_back(pool[i]);
+
+		GLenum format, type;
+		int bytesPerPixel;
+		pixelFormat(pool[i].internalFormat, format, type, bytesPerPixel);
+		++stats.textures;
+		stats.bytes += (size_t)pool[i].width * pool[i].height * bytesPerPixel;
+	}
+	pool = kept;
+	for (TextureNode& node : textures)
+	{
+		if (node.physical >= 0)
+			node.physical = remap[node.physical];
+	}
+}
+
+inline int RenderGraph::acquire(int w, int h, GLenum internalFormat)
+{
+	GLStateCache& state = GLStateCache::Get();
+	for (int i = 0; i < (int)pool.size(); ++i)
+	{
+		PoolTexture& entry = pool[i];
+		if (!entry.used && entry.width == w && entry.height == h && entry.internalFormat == internalFormat)
+		{
+			entry.used = true;
+			return i;
+		}
+	}
+
+	GLenum format, type;
+	int bytesPerPixel;
+	pixelFormat(internalFormat, format, type, bytesPerPixel);
+
+	PoolTexture entry;
+	entry.width = w;
+	entry.height = h;
+	entry.internalFormat = internalFormat;
+	entry.used = true;
+	glGenTextures(1, &entry.texture);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, entry.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, format, type, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	pool.push_back(entry);
+	return (int)pool.size() - 1;
+}
+
+inline void RenderGraph::createFramebuffers()
+{
+	GLStateCache& state = GLStateCache::Get();
+	for (PassNode& pass : passes)
+	{
+		if (pass.fbo)
+			state.DeleteFramebuffer(pass.fbo);
+		pass.fbo = 0;
+		pass.viewportWidth = width;
+		pass.viewportHeight = height;
+		if (!pass.alive || pass.compute)
+			continue;
+
+		bool toScreen = false;
+		for (Resource resource : pass.writes)
+			toScreen = toScreen || resource == BACKBUFFER;
+		if (toScreen)
+			continue;
+
+		glGenFramebuffers(1, &pass.fbo);
+		state.BindFramebuffer(GL_FRAMEBUFFER, pass.fbo);
+		std::vector<GLenum> drawBuffers;
+		for (Resource resource : pass.writes)
+		{
+			const TextureNode& node = textures[resource];
+			if (isDepthFormat(node.internalFormat))
+			{
+				GLenum attachment = node.internalFormat == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+				glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, Texture(resource), 0);
+			}
+			else
+			{
+				GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+				glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, Texture(resource), 0);
+				drawBuffers.push_back(attachment);
+			}
+			pass.viewportWidth = scaledWidth(node);
+			pass.viewportHeight = scaledHeight(node);
+		}
+		if (drawBuffers.empty())
+			glDrawBuffer(GL_NONE);
+		else
+			glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "Error: render graph framebuffer of pass " << pass.name << " is not complete" << std::endl;
+	}
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline bool RenderGraph::isDepthFormat(GLenum internalFormat)
+{
+	return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F;
+}
+
+inline void RenderGraph::pixelFormat(GLenum internalFormat, GLenum& format, GLenum& type, int& bytesPerPixel)
+{
+	switch (internalFormat)
+	{
+	case GL_DEPTH24_STENCIL8:
+		format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; bytesPerPixel = 4;
+		break;
+	case GL_DEPTH_COMPONENT24:
+		format = GL_DEPTH_COMPONENT; type = GL_UNSIGNED_INT; bytesPerPixel = 4;
+		break;
+	case GL_DEPTH_COMPONENT32F:
+		format = GL_DEPTH_COMPONENT; type = GL_FLOAT; bytesPerPixel = 4;
+		break;
+	case GL_RGBA16F:
+		format = GL_RGBA; type = GL_HALF_FLOAT; bytesPerPixel = 8;
+		break;
+	case GL_RG16F:
+		format = GL_RG; type = GL_HALF_FLOAT; bytesPerPixel = 4;
+		break;
+	case GL_R16F:
+		format = GL_RED; type = GL_HALF_FLOAT; bytesPerPixel = 2;
+		break;
+	case GL_R32F:
+		format = GL_RED; type = GL_FLOAT; bytesPerPixel = 4;
+		break;
+	case GL_R11F_G11F_B10F:
+		format = GL_RGB; type = GL_HALF_FLOAT; bytesPerPixel = 4;
+		break;
+	default:	// GL_RGBA8 and friends
+		format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4;
+		break;
+	}
+}
@@ -3,6 +3,9 @@
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 
+#include "GLStateCache.h"
+#include "CPUProfiler.h"
+
 #include <iostream>
 #include <string>
 #include <fstream>
@@ -11,7 +14,11 @@
 class Shader
 {
 public:
-	Shader(const GLchar* vertShaderPath, const GLchar* fragShaderPath);
+	//the geometry stage is optional
+	Shader(const GLchar* vertShaderPath, const GLchar* fragShaderPath, const GLchar* geomShaderPath = nullptr);
+	//for programs assembled at runtime, an empty geometryCode skips the stage
+	static Shader FromSource(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode = "");
+	static std::string ReadFile(const GLchar* path);
 
 	void Use();
 	void SetBool(const std::string& name, bool value) const;
@@ -20,42 +27,56 @@ public:
 
 	void SetVec2(const std::string& name, const glm::vec2& value) const;
 	void SetVec3(const std::string& name, const glm::vec3& value) const;
+	void SetVec4(const std::string& name, const glm::vec4& value) const;
 	void SetMat4(const std::string& name, const glm::mat4& value) const;
 	GLuint shaderProgram;
+
+private:
+	Shader() = default;
+	void build(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode);
 };
 
-Shader::Shader(const GLchar * vertShaderPath, const GLchar * fragShaderPath)
+Shader::Shader(const GLchar * vertShaderPath, const GLchar * fragShaderPath, const GLchar * geomShaderPath)
 {
-	std::string vertexCode;
-	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
+	PROFILE_ZONE("Shader::Shader");
+	std::string vertexCode = ReadFile(vertShaderPath);
+	std::string fragmentCode = ReadFile(fragShaderPath);
+	std::string geometryCode = geomShaderPath ? ReadFile(geomShaderPath) : std::string();
 
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	std::cout << vertexCode << std::endl << std::endl << fragmentCode << std::endl;
 
-	try
-	{
-		vShaderFile.open(vertShaderPath);
-		fShaderFile.open(fragShaderPath);
+	build(vertexCode, fragmentCode, geometryCode);
+}
 
-		std::stringstream vShaderStream, fShaderStream;
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		
-		vShaderFile.close();
-		fShaderFile.close();
+inline Shader Shader::FromSource(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode)
+{
+	Shader shader;
+	shader.build(vertexCode, fragmentCode, geometryCode);
+	return shader;
+}
 
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+inline std::string Shader::ReadFile(const GLchar* path)
+{
+	std::ifstream shaderFile;
+	shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
-		std::cout << vertexCode << std::endl << std::endl << fragmentCode << std::endl;
+	try
+	{
+		shaderFile.open(path);
+		std::stringstream shaderStream;
+		shaderStream << shaderFile.rdbuf();
+		shaderFile.close();
+		return shaderStream.str();
 	}
 	catch (std::ifstream::failure e)
 	{
 		std::cout << "Error: failed to read shader file" << std::endl;
 	}
+	return std::string();
+}
 
+inline void Shader::build(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode)
+{
 	const char* vShaderCode = vertexCode.c_str();
 	const char* fShaderCode = fragmentCode.c_str();
 
@@ -83,9 +104,27 @@ Shader::Shader(const GLchar * vertShaderPath, const GLchar * fragShaderPath)
 		std::cout << "Error: fragment shader compile failed!\n " << infoLog << std::endl;
 	}
 
+	GLuint geometryShader = 0;
+	if (!geometryCode.empty())
+	{
+		const char* gShaderCode = geometryCode.c_str();
+		geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
+		glShaderSource(geometryShader, 1, &gShaderCode, nullptr);
+		glCompileShader(geometryShader);
+
+		glGetShaderiv(geometryShader, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(geometryShader, 512, nullptr, infoLog);
+			std::cout << "Error: geometry shader compile failed!\n " << infoLog << std::endl;
+		}
+	}
+
 	shaderProgram = glCreateProgram();
 	glAttachShader(shaderProgram, vertexShader);
 	glAttachShader(shaderProgram, fragmentShader);
+	if (geometryShader)
+		glAttachShader(shaderProgram, geometryShader);
 	glLinkProgram(shaderProgram);
 
 	glGetShaderiv(shaderProgram, GL_LINK_STATUS, &success);
@@ -97,11 +136,13 @@ Shader::Shader(const GLchar * vertShaderPath, const GLchar * fragShaderPath)
 
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
+	if (geometryShader)
+		glDeleteShader(geometryShader);
 }
 
 inline void Shader::Use()
 {
-	glUseProgram(shaderProgram);
+	GLStateCache::Get().UseProgram(shaderProgram);
 }
 
 inline void Shader::SetBool(const std::string & name, bool value) const
@@ -129,6 +170,11 @@ inline void Shader::SetVec3(const std::string& name, const glm::vec3& value) con
 	glUniform3fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
 }
 
+inline void Shader::SetVec4(const std::string& name, const glm::vec4& value) const
+{
+	glUniform4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+}
+
 inline void Shader::SetMat4(const std::string& name, const glm::mat4& value) const
 {
 	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &value[0][0]);
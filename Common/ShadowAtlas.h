@@ -0,0 +1,447 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "CascadedShadowMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+enum class ShadowLightType
+{
+	SPOT,		// one perspective tile
+	POINT,		// six cube face tiles
+};
+
+//What the atlas needs to know about a local light, outerCutOff is the cosine like in SpotLight.
+struct ShadowLightDesc
+{
+	ShadowLightType type;
+	glm::vec3 position;
+	glm::vec3 direction;
+	float outerCutOff;
+	float radius;
+};
+
+//One depth texture shared by the shadows of all spot and point lights.
+//The atlas is cut into horizontal bands, one per tile size (atlasSize/4 down to atlasSize/32), each band a
+//grid of equal tiles. Every frame a light picks a size from its rough on-screen size and keeps its tiles
+//until that changes, so unchanged lights keep their rendered maps.
+//Rendering is budgeted: only faceBudget faces are drawn per frame, lights are refreshed in order of
+//importance times how long they have waited, and lights whose description and casters (set + versions)
+//are unchanged since their last render are skipped. Point lights draw all six faces in one pass with a
+//geometry shader picking gl_ViewportIndex when the context has 4.1, otherwise one pass per face.
+class ShadowAtlas
+{
+public:
+	static const int SIZE_CLASS_NUM = 4;
+
+	struct Stats
+	{
+		int lightsRendered = 0;
+		int facesRendered = 0;
+		int lightsSkipped = 0;		// up to date, nothing to do
+		int lightsDeferred = 0;		// out of date but over budget this frame
+	};
+
+	//shaderDir holds depth_vert/depth_frag and, for the single pass cube, cube_depth_vert/cube_depth_geom
+	ShadowAtlas(const std::string& shaderDir, int atlasSize = 4096, int faceBudget = 12);
+	~ShadowAtlas();
+
+	int AddLight(const ShadowLightDesc& desc);
+	void SetLight(int id, const ShadowLightDesc& desc);
+
+	//size the tiles, schedule and render, draw(shader, casterIndex) sets "model" and draws one caster
+	void Update(const glm::vec3& viewPos, float fovY, int screenHeight, const std::vector<ShadowCaster>& casters,
+		const std::function<void(Shader&, unsigned int)>& draw);
+
+	bool Ready(int id) const { return lights[id].rendered; }
+	const Stats& GetStats() const { return stats; }
+
+	//sampler "shadowAtlas"
+	void Bind(const Shader& shader, GLuint unit) const;
+	//name.shadowValid, name.shadowMatrix, name.shadowRect
+	void SetSpotUniforms(const Shader& shader, const std::string& name, int id) const;
+	//name.shadowValid, name.shadowRects[6], name.shadowNear, name.shadowFar
+	void SetPointUniforms(const Shader& shader, const std::string& name, int id) const;
+
+private:
+	struct Light
+	{
+		ShadowLightDesc desc;
+		ShadowLightDesc renderedDesc;
+		int sizeClass = -1;
+		int slots[6];
+		bool rendered = false;
+		unsigned long long renderedSignature = 0;
+		unsigned int framesWaiting = 0;
+		float importance = 0.0f;
+		float screenSize = 0.0f;
+		glm::mat4 matrices[6];
+	};
+
+	Shader depthShader;
+	Shader* cubeShader = nullptr;
+	int atlasSize;
+	int faceBudget;
+	float nearPlane = 0.05f;
+
+	std::vector<Light> lights;
+	std::vector<int> freeSlots[SIZE_CLASS_NUM];
+	Stats stats;
+
+	GLuint atlas = 0;
+	GLuint fbo = 0;
+
+private:
+	int tileSize(int sizeClass) const { return atlasSize / 4 >> sizeClass; }
+	int faceNum(const Light& light) const { return light.desc.type == ShadowLightType::POINT ? 6 : 1; }
+	glm::ivec4 tileRect(int sizeClass, int slot) const;
+	bool allocate(Light& light, int sizeClass);
+	void release(Light& light);
+	void buildMatrices(Light& light) const;
+	unsigned long long casterSignature(const Light& light, const std::vector<ShadowCaster>& casters, std::vector<unsigned int>& visible) const;
+	void render(Light& light, const std::vector<unsigned int>& visible, const std::function<void(Shader&, unsigned int)>& draw);
+	static bool sameDesc(const ShadowLightDesc& a, const ShadowLightDesc& b);
+};
+
+//cube face forward/up, the usual GL_TEXTURE_CUBE_MAP_POSITIVE_X.. order, mirrored in the shaders
+static const glm::vec3 shadowCubeForward[6] = {
+	glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+	glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+};
+static const glm::vec3 shadowCubeUp[6] = {
+	glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+	glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+	glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)
+};
+
+inline ShadowAtlas::ShadowAtlas(const std::string& shaderDir, int atlasSize, int faceBudget)
+	:depthShader((shaderDir + "/depth_vert.glsl").c_str(), (shaderDir + "/depth_frag.glsl").c_str()),
+	atlasSize(atlasSize), faceBudget(faceBudget)
+{
+	GLStateCache& state = GLStateCache::Get();
+
+	if (GLAD_GL_VERSION_4_1)
+	{
+		cubeShader = new Shader((shaderDir + "/cube_depth_vert.glsl").c_str(), (shaderDir + "/cube_depth_frag.glsl").c_str(),
+			(shaderDir + "/cube_depth_geom.glsl").c_str());
+	}
+
+	int bandHeight = atlasSize / SIZE_CLASS_NUM;
+	for (int c = 0; c < SIZE_CLASS_NUM; ++c)
+	{
+		int slotNum = (atlasSize / tileSize(c)) * (bandHeight / tileSize(c));
+		for (int slot = slotNum - 1; slot >= 0; --slot)
+			freeSlots[c].push_back(slot);
+	}
+
+	glGenTextures(1, &atlas);
+	state.BindTexture(GL_TEXTURE_2D, atlas);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, atlasSize, atlasSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	glGenFramebuffers(1, &fbo);
+	state.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlas, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: shadow atlas framebuffer is not complete" << std::endl;
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline ShadowAtlas::~ShadowAtlas()
+{
+	GLStateCache& state = GLStateCache::Get();
+	delete cubeShader;
+	state.DeleteFramebuffer(fbo);
+	state.DeleteTexture(atlas);
+}
+
+inline int ShadowAtlas::AddLight(const ShadowLightDesc& desc)
+{
+	Light light;
+	light.desc = desc;
+	lights.push_back(light);
+	return (int)lights.size() - 1;
+}
+
+inline void ShadowAtlas::SetLight(int id, const ShadowLightDesc& desc)
+{
+	lights[id].desc = desc;
+}
+
+inline glm::ivec4 ShadowAtlas::tileRect(int sizeClass, int slot) const
+{
+	int size = tileSize(sizeClass);
+	int columns = atlasSize / size;
+	int bandHeight = atlasSize / SIZE_CLASS_NUM;
+	return glm::ivec4((slot % columns) * size, sizeClass * bandHeight + (slot / columns) * size, size, size);
+}
+
+inline bool ShadowAtlas::allocate(Light& light, int sizeClass)
+{
+	int need = faceNum(light);
+	if ((int)freeSlots[sizeClass].size() < need)
+		return false;
+	for (int i = 0; i < need; ++i)
+	{
+		light.slots[i] = freeSlots[sizeClass].back();
+		freeSlots[sizeClass].pop_back();
+	}
+	light.sizeClass = sizeClass;
+	light.rendered = false;
+	return true;
+}
+
+inline void ShadowAtlas::release(Light& light)
+{
+	if (light.sizeClass < 0)
+		return;
+	for (int i = 0; i < faceNum(light); ++i)
+		freeSlots[light.sizeClass].push_back(light.slots[i]);
+	light.sizeClass = -1;
+	light.rendered = false;
+}
+
+inline bool ShadowAtlas::sameDesc(const ShadowLightDesc& a, const ShadowLightDesc& b)
+{
+	return a.type == b.type && a.position == b.position && a.radius == b.radius
+		&& (a.type == ShadowLightType::POINT || (a.direction == b.direction && a.outerCutOff == b.outerCutOff));
+}
+
+inline void ShadowAtlas::buildMatrices(Light& light) const
+{
+	const ShadowLightDesc& desc = light.desc;
+	if (desc.type == ShadowLightType::SPOT)
+	{
+		//a little wider than the cone so pcf at the edge stays inside the tile
+		float fov = 2.0f * acos(glm::clamp(desc.outerCutOff, 0.0f, 1.0f)) + glm::radians(4.0f);
+		glm::vec3 up = fabs(desc.direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		light.matrices[0] = glm::perspective(std::min(fov, glm::radians(170.0f)), 1.0f, nearPlane, desc.radius)
+			* glm::lookAt(desc.position, desc.position + desc.direction, up);
+		return;
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, desc.radius);
+	for (int face = 0; face < 6; ++face)
+	{
+		light.matrices[face] = projection * glm::lookAt(desc.position, desc.position + shadowCubeForward[face], shadowCubeUp[face]);
+	}
+}
+
+inline unsigned long long ShadowAtlas::casterSignature(const Light& light, const std::vector<ShadowCaster>& casters, std::vector<unsigned int>& visible) const
+{
+	//casters touching the light's range, a spot light uses the same sphere as a point light
+	visible.clear();
+	unsigned long long signature = 1469598103934665603ull;
+	for (unsigned int c = 0; c < casters.size(); ++c)
+	{
+		float reach = light.desc.radius + casters[c].radius;
+		glm::vec3 d = casters[c].center - light.desc.position;
+		if (glm::dot(d, d) > reach * reach)
+			continue;
+		visible.push_back(c);
+		signature = (signature ^ c) * 1099511628211ull;
+		signature = (signature ^ casters[c].version) * 1099511628211ull;
+	}
+	return signature;
+}
+
+inline void ShadowAtlas::Update(const glm::vec3& viewPos, float fovY, int screenHeight, const std::vector<ShadowCaster>& casters,
+	const std::function<void(Shader&, unsigned int)>& draw)
+{
+	stats = Stats();
+	float pixelsPerUnit = screenHeight * 0.5f / tan(fovY * 0.5f);
+
+	//rough projected size of the light's range decides its tile size
+	std::vector<int> order;
+	for (unsigned int i = 0; i < lights.size(); ++i)
+	{
+		Light& light = lights[i];
+		float distance = std::max(glm::length(light.desc.position - viewPos) - light.desc.radius, 1.0f);
+		light.screenSize = light.desc.radius / distance * pixelsPerUnit;
+		light.importance = light.screenSize;
+		order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [this](int a, int b) { return lights[a].importance > lights[b].importance; });
+
+	for (int id : order)
+	{
+		Light& light = lights[id];
+		int wanted = SIZE_CLASS_NUM - 1;
+		while (wanted > 0 && tileSize(wanted) < light.screenSize)
+			--wanted;
+
+		//hysteresis, only move when the size is clearly off
+		if (light.sizeClass >= 0)
+		{
+			int size = tileSize(light.sizeClass);
+			bool tooBig = light.sizeClass < SIZE_CLASS_NUM - 1 && light.screenSize < size * 0.35f;
+			bool tooSmall = light.sizeClass > 0 && light.screenSize > size * 1.5f;
+			if (!tooBig && !tooSmall)
+				continue;
+			release(light);
+		}
+		//fall back to smaller tiles when a band is full
+		for (int c = wanted; c < SIZE_CLASS_NUM; ++c)
+		{
+			if (allocate(light, c))
+				break;
+		}
+	}
+
+	//schedule, stale lights by importance times waiting time, never rendered ones first
+	std::vector<std::vector<unsigned int>> visible(lights.size());
+	std::vector<unsigned long long> signatures(lights.size());
+	std::vector<std::pair<float, int>> stale;
+	for (unsigned int i = 0; i < lights.size(); ++i)
+	{
+		Light& light = lights[i];
+		if (light.sizeClass < 0)
+			continue;
+		signatures[i] = casterSignature(light, casters, visible[i]);
+		if (light.rendered && light.renderedSignature == signatures[i] && sameDesc(light.renderedDesc, light.desc))
+		{
+			light.framesWaiting = 0;
+			++stats.lightsSkipped;
+			continue;
+		}
+		float priority = light.importance * (1.0f + light.framesWaiting) * (light.rendered ? 1.0f : 4.0f);
+		stale.push_back(std::make_pair(priority, (int)i));
+	}
+	std::sort(stale.begin(), stale.end(), [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; });
+
+	GLStateCache& state = GLStateCache::Get();
+	bool bound = false;
+	int facesLeft = faceBudget;
+	for (const std::pair<float, int>& entry : stale)
+	{
+		Light& light = lights[entry.second];
+		int faces = faceNum(light);
+		//the first light always goes through so a budget smaller than a cube does not starve it
+		if (faces > facesLeft && stats.lightsRendered > 0)
+		{
+			++light.framesWaiting;
+			++stats.lightsDeferred;
+			continue;
+		}
+
+		if (!bound)
+		{
+			state.BindFramebuffer(GL_FRAMEBUFFER, fbo);
+			state.Enable(GL_DEPTH_TEST);
+			state.DepthMask(GL_TRUE);
+			state.DepthFunc(GL_LESS);
+			state.Disable(GL_BLEND);
+			state.Enable(GL_POLYGON_OFFSET_FILL);
+			glPolygonOffset(2.0f, 4.0f);
+			bound = true;
+		}
+
+		render(light, visible[entry.second], draw);
+		light.renderedDesc = light.desc;
+		light.renderedSignature = signatures[entry.second];
+		light.rendered = true;
+		light.framesWaiting = 0;
+		facesLeft -= faces;
+		++stats.lightsRendered;
+		stats.facesRendered += faces;
+	}
+
+	if (bound)
+	{
+		state.Disable(GL_POLYGON_OFFSET_FILL);
+		state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+inline void ShadowAtlas::render(Light& light, const std::vector<unsigned int>& visible, const std::function<void(Shader&, unsigned int)>& draw)
+{
+	GLStateCache& state = GLStateCache::Get();
+	buildMatrices(light);
+	int faces = faceNum(light);
+
+	//clear only this light's tiles
+	state.Enable(GL_SCISSOR_TEST);
+	for (int face = 0; face < faces; ++face)
+	{
+		glm::ivec4 rect = tileRect(light.sizeClass, light.slots[face]);
+		glScissor(rect.x, rect.y, rect.z, rect.w);
+		glClear(GL_DEPTH_BUFFER_BIT);
+	}
+	state.Disable(GL_SCISSOR_TEST);
+
+	if (faces == 6 && cubeShader)
+	{
+		//viewports 1..6 so the cached viewport 0 stays valid
+		for (int face = 0; face < 6; ++face)
+		{
+			glm::ivec4 rect = tileRect(light.sizeClass, light.slots[face]);
+			glViewportIndexedf(face + 1, (float)rect.x, (float)rect.y, (float)rect.z, (float)rect.w);
+		}
+		cubeShader->Use();
+		for (int face = 0; face < 6; ++face)
+			cubeShader->SetMat4("faceMatrices[" + std::to_string(face) + "]", light.matrices[face]);
+		for (unsigned int c : visible)
+			draw(*cubeShader, c);
+		return;
+	}
+
+	depthShader.Use();
+	for (int face = 0; face < faces; ++face)
+	{
+		glm::ivec4 rect = tileRect(light.sizeClass, light.slots[face]);
+		state.Viewport(rect.x, rect.y, rect.z, rect.w);
+		depthShader.SetMat4("lightSpaceMatrix", light.matrices[face]);
+		for (unsigned int c : visible)
+			draw(depthShader, c);
+	}
+}
+
+inline void ShadowAtlas::Bind(const Shader& shader, GLuint unit) const
+{
+	GLStateCache::Get().BindTextureUnit(unit, GL_TEXTURE_2D, atlas);
+	shader.SetInt("shadowAtlas", unit);
+}
+
+inline void ShadowAtlas::SetSpotUniforms(const Shader& shader, const std::string& name, int id) const
+{
+	const Light& light = lights[id];
+	shader.SetBool(name + ".shadowValid", light.rendered);
+	if (!light.rendered)
+		return;
+	glm::vec4 rect = glm::vec4(tileRect(light.sizeClass, light.slots[0])) / (float)atlasSize;
+	shader.SetMat4(name + ".shadowMatrix", light.matrices[0]);
+	shader.SetVec4(name + ".shadowRect", rect);
+}
+
+inline void ShadowAtlas::SetPointUniforms(const Shader& shader, const std::string& name, int id) const
+{
+	const Light& light = lights[id];
+	shader.SetBool(name + ".shadowValid", light.rendered);
+	if (!light.rendered)
+		return;
+	for (int face = 0; face < 6; ++face)
+	{
+		glm::vec4 rect = glm::vec4(tileRect(light.sizeClass, light.slots[face])) / (float)atlasSize;
+		shader.SetVec4(name + ".shadowRects[" + std::to_string(face) + "]", rect);
+	}
+	shader.SetFloat(name + ".shadowNear", nearPlane);
+	shader.SetFloat(name + ".shadowFar", light.renderedDesc.radius);
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "stb_image.h"
+
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+//Where a packed image ended up: an array texture, the layer inside it, and the sub-rectangle
+//(offset.xy, scale.zw in uv space) for images that share an atlas page. Whole layers have rect (0,0,1,1).
+struct PackedTextureRef
+{
+	GLuint arrayId = 0;
+	GLint layer = 0;
+	glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
+
+//Groups images into GL_TEXTURE_2D_ARRAY objects so many materials can share one binding.
+//Images of identical size and format become layers of the same array. Small images that are never
+//sampled outside [0,1] are shelf packed into atlas pages (which are themselves array layers) and
+//the caller remaps uvs with the returned rect. Pages are only as large as what got packed into them,
+//rounded up to a power of two, atlasPageSize is the most a page holds.
+class TexturePacker
+{
+public:
+	TexturePacker(int atlasThreshold = 256, int atlasPageSize = 2048, int atlasPadding = 4)
+		:atlasThreshold(atlasThreshold), atlasPageSize(atlasPageSize), atlasPadding(atlasPadding)
+	{
+	}
+
+	//load an image from disk and queue it, tiling images (uvs outside [0,1]) are never atlased
+	bool AddFile(const std::string& key, const std::string& imagePath, bool tiling);
+	//upload every queued image, returns key -> location
+	std::map<std::string, PackedTextureRef> Build();
+
+private:
+	struct Image
+	{
+		std::string key;
+		int width;
+		int height;
+		int channels;
+		bool tiling;
+		std::vector<unsigned char> pixels;
+	};
+
+	struct AtlasPlacement
+	{
+		const Image* image;
+		int page;
+		int x;
+		int y;
+	};
+
+	int atlasThreshold;
+	int atlasPageSize;
+	int atlasPadding;
+	std::vector<Image> images;
+
+private:
+	static GLenum channelsToFormat(int channels);
+	static int nextPowerOfTwo(int value);
+	GLuint createArray(int width, int height, int layers, int channels, bool atlas) const;
+	void packAtlas(const std::vector<const Image*>& group, std::map<std::string, PackedTextureRef>& result) const;
+	void blitWithGutter(std::vector<unsigned char>& page, int pageWidth, const Image& image, int x, int y) const;
+};
+
+inline bool TexturePacker::AddFile(const std::string& key, const std::string& imagePath, bool tiling)
+{
+	int width, height, nrChannels;
+	unsigned char* data = stbi_load(imagePath.c_str(), &width, &height, &nrChannels, 0);
+	if (!data)
+	{
+		std::cout << "Failed to load image " << imagePath << std::endl;
+		return false;
+	}
+
+	Image image;
+	image.key = key;
+	image.width = width;
+	image.height = height;
+	image.channels = nrChannels;
+	image.tiling = tiling;
+	image.pixels.assign(data, data + width*height*nrChannels);
+	stbi_image_free(data);
+
+	images.push_back(std::move(image));
+	return true;
+}
+
+inline std::map<std::string, PackedTextureRef> TexturePacker::Build()
+{
+	std::map<std::string, PackedTextureRef> result;
+
+	//(width, height, channels) -> whole-layer images, channels -> atlas candidates
+	std::map<std::tuple<int, int, int>, std::vector<const Image*>> arrayGroups;
+	std::map<int, std::vector<const Image*>> atlasGroups;
+	for (const Image& image : images)
+	{
+		bool small = image.width <= atlasThreshold && image.height <= atlasThreshold;
+		if (small && !image.tiling)
+			atlasGroups[image.channels].push_back(&image);
+		else
+			arrayGroups[std::make_tuple(image.width, image.height, image.channels)].push_back(&image);
+	}
+
+	GLint oldAlignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (auto& group : arrayGroups)
+	{
+		int width = std::get<0>(group.first);
+		int height = std::get<1>(group.first);
+		int channels = std::get<2>(group.first);
+		GLenum format = channelsToFormat(channels);
+
+		GLuint arrayId = createArray(width, height, (int)group.second.size(), channels, false);
+		for (unsigned int layer = 0; layer < group.second.size(); ++layer)
+		{
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, format, GL_UNSIGNED_BYTE, &group.second[layer]->pixels[0]);
+
+			PackedTextureRef ref;
+			ref.arrayId = arrayId;
+			ref.layer = layer;
+			result[group.second[layer]->key] = ref;
+		}
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+
+	for (auto& group : atlasGroups)
+	{
+		packAtlas(group.second, result);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
+
+	std::cout << "TexturePacker: " << images.size() << " textures -> " << arrayGroups.size() << " arrays + "
+		<< atlasGroups.size() << " atlases" << std::endl;
+
+	images.clear();
+	return result;
+}
+
+inline GLenum TexturePacker::channelsToFormat(int channels)
+{
+	switch (channels)
+	{
+	case 1:
+		return GL_RED;
+	case 3:
+		return GL_RGB;
+	case 4:
+		return GL_RGBA;
+	default:
+		return GL_RED;
+	}
+}
+
+inline int TexturePacker::nextPowerOfTwo(int value)
+{
+	int result = 1;
+	while (result < value)
+		result <<= 1;
+	return result;
+}
+
+inline GLuint TexturePacker::createArray(int width, int height, int layers, int channels, bool atlas) const
+{
+	GLenum format = channelsToFormat(channels);
+
+	GLuint arrayId;
+	glGenTextures(1, &arrayId);
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, arrayId);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, width, height, layers, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+	//same wrap rule as LoadTextureFromFile, atlases always clamp so neighbours never wrap in
+	GLint wrap = (atlas || format == GL_RGBA) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	if (atlas)
+	{
+		//past this level a texel covers more than the gutter and neighbours bleed in
+		int maxLevel = 0;
+		while ((2 << maxLevel) <= atlasPadding)
+			++maxLevel;
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, maxLevel);
+	}
+
+	return arrayId;
+}
+
+inline void TexturePacker::packAtlas(const std::vector<const Image*>& group, std::map<std::string, PackedTextureRef>& result) const
+{
+	//shelf packing, tallest first
+	std::vector<const Image*> sorted = group;
+	std::sort(sorted.begin(), sorted.end(), [](const Image* a, const Image* b) { return a->height > b->height; });
+
+	std::vector<AtlasPlacement> placements;
+	int page = 0;
+	int cursorX = 0;
+	int cursorY = 0;
+	int shelfHeight = 0;
+	int extentX = 0;
+	int extentY = 0;
+	for (const Image* image : sorted)
+	{
+		int w = image->width + 2 * atlasPadding;
+		int h = image->height + 2 * atlasPadding;
+		if (cursorX + w > atlasPageSize)
+		{
+			cursorX = 0;
+			cursorY += shelfHeight;
+			shelfHeight = 0;
+		}
+		if (cursorY + h > atlasPageSize)
+		{
+			++page;
+			cursorX = cursorY = shelfHeight = 0;
+		}
+
+		placements.push_back({ image, page, cursorX + atlasPadding, cursorY + atlasPadding });
+		cursorX += w;
+		shelfHeight = std::max(shelfHeight, h);
+		extentX = std::max(extentX, cursorX);
+		extentY = std::max(extentY, cursorY + h);
+	}
+
+	int channels = group[0]->channels;
+	GLenum format = channelsToFormat(channels);
+	int pageNum = page + 1;
+	//every layer of the array has the size of the fullest page
+	int pageWidth = nextPowerOfTwo(extentX);
+	int pageHeight = nextPowerOfTwo(extentY);
+	GLuint arrayId = createArray(pageWidth, pageHeight, pageNum, channels, true);
+
+	std::vector<unsigned char> pixels;
+	for (int p = 0; p < pageNum; ++p)
+	{
+		pixels.assign(pageWidth*pageHeight*channels, 0);
+		for (const AtlasPlacement& placement : placements)
+		{
+			if (placement.page != p)
+				continue;
+			blitWithGutter(pixels, pageWidth, *placement.image, placement.x, placement.y);
+
+			PackedTextureRef ref;
+			ref.arrayId = arrayId;
+			ref.layer = p;
+			ref.uvRect = glm::vec4((float)placement.x / pageWidth, (float)placement.y / pageHeight,
+				(float)placement.image->width / pageWidth, (float)placement.image->height / pageHeight);
+			result[placement.image->key] = ref;
+		}
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, p, pageWidth, pageHeight, 1, format, GL_UNSIGNED_BYTE, &pixels[0]);
+	}
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+inline void TexturePacker::blitWithGutter(std::vector<unsigned char>& page, int pageWidth, const Image& image, int x, int y) const
+{
+	//copy the image and extrude its edge texels into the padding so filtering at the border stays inside
+	int channels = image.channels;
+	for (int row = -atlasPadding; row < image.height + atlasPadding; ++row)
+	{
+		int srcRow = std::min(std::max(row, 0), image.height - 1);
+		for (int col = -atlasPadding; col < image.width + atlasPadding; ++col)
+		{
+			int srcCol = std::min(std::max(col, 0), image.width - 1);
+			const unsigned char* src = &image.pixels[(srcRow*image.width + srcCol)*channels];
+			unsigned char* dst = &page[((y + row)*pageWidth + (x + col))*channels];
+			memcpy(dst, src, channels);
+		}
+	}
+}
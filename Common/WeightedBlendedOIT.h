@@ -0,0 +1,232 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Shader.h"
+#include "GLStateCache.h"
+
+#include <iostream>
+
+enum class TransparencyMode
+{
+	SORTED,				// cpu sort by distance, draw back to front
+	WEIGHTED_BLENDED,	// one unsorted pass into accum/revealage, then resolve
+};
+
+//Weighted blended order-independent transparency (McGuire & Bavoil 2013).
+//The scene is rendered into an offscreen opaque target. Transparent geometry is then drawn in any order
+//into an accumulation target (premultiplied color * weight, revealage in alpha) and a weight target
+//that share the opaque depth buffer, and a resolve pass composites the average color over the opaque image.
+//
+//The blend state below is the single-function variant, so it works on a 3.3 context without glBlendFunci:
+//	accum.rgb += color * alpha * w		accum.a *= (1 - alpha)		weight.r += alpha * w
+class WeightedBlendedOIT
+{
+public:
+	WeightedBlendedOIT(const GLchar* compositeVertPath, const GLchar* compositeFragPath)
+		:compositeShader(compositeVertPath, compositeFragPath)
+	{
+		compositeShader.Use();
+		compositeShader.SetInt("accumTex", 0);
+		compositeShader.SetInt("weightTex", 1);
+		setupQuad();
+	}
+
+	~WeightedBlendedOIT();
+
+	//(re)creates the targets when the framebuffer size changes, cheap to call every frame
+	void Resize(int width, int height);
+
+	//bind the opaque target, caller clears and draws opaque geometry as usual
+	void BeginOpaque() const;
+	//bind the accumulation target with depth writes off and the oit blend state
+	void BeginTransparent() const;
+	//resolve accumulation over the opaque image and blit the result to the default framebuffer
+	void Composite();
+
+	int Width() const { return width; }
+	int Height() const { return height; }
+
+private:
+	Shader compositeShader;
+
+	int width = 0;
+	int height = 0;
+
+	GLuint opaqueFBO = 0;
+	GLuint opaqueTex = 0;
+	GLuint depthRBO = 0;
+
+	GLuint accumFBO = 0;
+	GLuint accumTex = 0;
+	GLuint weightTex = 0;
+
+	GLuint quadVAO = 0;
+	GLuint quadVBO = 0;
+
+private:
+	void setupQuad();
+	void releaseTargets();
+	GLuint createTarget(GLint internalFormat, GLenum format, GLenum type) const;
+};
+
+inline WeightedBlendedOIT::~WeightedBlendedOIT()
+{
+	GLStateCache& state = GLStateCache::Get();
+	releaseTargets();
+	state.DeleteVertexArray(quadVAO);
+	state.DeleteBuffer(quadVBO);
+}
+
+inline void WeightedBlendedOIT::Resize(int w, int h)
+{
+	GLStateCache& state = GLStateCache::Get();
+	if (w == width && h == height)
+		return;
+
+	releaseTargets();
+	width = w;
+	height = h;
+	if (width <= 0 || height <= 0) // minimized
+		return;
+
+	opaqueTex = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+	accumTex = createTarget(GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+	weightTex = createTarget(GL_R16F, GL_RED, GL_HALF_FLOAT);
+
+	glGenRenderbuffers(1, &depthRBO);
+	state.BindRenderbuffer(depthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	state.BindRenderbuffer(0);
+
+	//opaque
+	glGenFramebuffers(1, &opaqueFBO);
+	state.BindFramebuffer(GL_FRAMEBUFFER, opaqueFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, opaqueTex, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: OIT opaque framebuffer is not complete" << std::endl;
+
+	//accumulation, shares the opaque depth so transparent fragments are still occluded
+	glGenFramebuffers(1, &accumFBO);
+	state.BindFramebuffer(GL_FRAMEBUFFER, accumFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, weightTex, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+	const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, drawBuffers);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: OIT accumulation framebuffer is not complete" << std::endl;
+
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void WeightedBlendedOIT::BeginOpaque() const
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, opaqueFBO);
+	state.DepthMask(GL_TRUE);
+	state.Enable(GL_DEPTH_TEST);
+}
+
+inline void WeightedBlendedOIT::BeginTransparent() const
+{
+	//minimized, there are no targets and the clears below would hit the default framebuffer
+	if (width <= 0 || height <= 0)
+		return;
+
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, accumFBO);
+
+	//revealage starts at 1 (fully revealed), sums start at 0
+	const GLfloat accumClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	const GLfloat weightClear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	glClearBufferfv(GL_COLOR, 0, accumClear);
+	glClearBufferfv(GL_COLOR, 1, weightClear);
+
+	state.Enable(GL_DEPTH_TEST);
+	state.DepthMask(GL_FALSE);
+	state.Enable(GL_BLEND);
+	state.BlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+inline void WeightedBlendedOIT::Composite()
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	GLStateCache& state = GLStateCache::Get();
+	state.BindFramebuffer(GL_FRAMEBUFFER, opaqueFBO);
+	state.DepthMask(GL_TRUE);
+	state.Disable(GL_DEPTH_TEST);
+	state.Enable(GL_BLEND);
+	state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	compositeShader.Use();
+	state.BindTextureUnit(0, GL_TEXTURE_2D, accumTex);
+	state.BindTextureUnit(1, GL_TEXTURE_2D, weightTex);
+	state.BindVertexArray(quadVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+
+	state.BindFramebuffer(GL_READ_FRAMEBUFFER, opaqueFBO);
+	state.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	state.BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	state.Enable(GL_DEPTH_TEST);
+}
+
+inline void WeightedBlendedOIT::setupQuad()
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLfloat quadVertices[] = { // coord in ndc
+		// positions   // texCoords
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		-1.0f, -1.0f,  0.0f, 0.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+
+		-1.0f,  1.0f,  0.0f, 1.0f,
+		 1.0f, -1.0f,  1.0f, 0.0f,
+		 1.0f,  1.0f,  1.0f, 1.0f
+	};
+
+	glGenVertexArrays(1, &quadVAO);
+	state.BindVertexArray(quadVAO);
+
+	glGenBuffers(1, &quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	state.BindVertexArray(0);
+}
+
+inline void WeightedBlendedOIT::releaseTargets()
+{
+	GLStateCache& state = GLStateCache::Get();
+	state.DeleteFramebuffer(opaqueFBO);
+	state.DeleteFramebuffer(accumFBO);
+	state.DeleteTexture(opaqueTex);
+	state.DeleteTexture(accumTex);
+	state.DeleteTexture(weightTex);
+	state.DeleteRenderbuffer(depthRBO);
+	opaqueFBO = accumFBO = opaqueTex = accumTex = weightTex = depthRBO = 0;
+}
+
+inline GLuint WeightedBlendedOIT::createTarget(GLint internalFormat, GLenum format, GLenum type) const
+{
+	GLStateCache& state = GLStateCache::Get();
+	GLuint tex;
+	glGenTextures(1, &tex);
+	state.BindTextureUnit(0, GL_TEXTURE_2D, tex);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return tex;
+}
@@ -1,18 +1,19 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
+#include "WeightedBlendedOIT.h"
+#include "DemoLoop.h"
 
 #include <iostream>
-#include <direct.h>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
@@ -20,54 +21,46 @@ const int screenHeight = 600;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
 
 bool firstMouse = true;
 
-void processInput(GLFWwindow* window);
+//per scene choice between the cpu sorted path and weighted blended oit, toggled with T
+TransparencyMode transparencyMode = TransparencyMode::WEIGHTED_BLENDED;
 
-void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
+void processInput(GLFWwindow* window);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
-int main()
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
 {
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "Blend", nullptr, nullptr);
-	if (!window)
+	if (key == GLFW_KEY_T && action == GLFW_PRESS)
 	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
-		return -1;
+		transparencyMode = transparencyMode == TransparencyMode::SORTED ? TransparencyMode::WEIGHTED_BLENDED : TransparencyMode::SORTED;
+		std::cout << "Transparency: " << (transparencyMode == TransparencyMode::SORTED ? "sorted" : "weighted blended oit") << std::endl;
 	}
+}
 
-	glfwMakeContextCurrent(window);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
+int main(int argc, char** argv)
+{
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "Blend";
+	loopSettings.scene = "Blend";
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-	{
-		glViewport(0, 0, width, height);
-	});
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	loop.AttachInput(mouse_callback, scroll_callback, key_callback);
 
 	GLfloat cubeVertices[] = {
 		// positions          // texture Coords
@@ -146,10 +139,10 @@ int main()
 
 	GLuint cubeVAO, cubeVBO;
 	glGenVertexArrays(1, &cubeVAO);
-	glBindVertexArray(cubeVAO);
+	state.BindVertexArray(cubeVAO);
 
 	glGenBuffers(1, &cubeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, cubeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -159,10 +152,10 @@ int main()
 
 	GLuint planeVAO, planeVBO;
 	glGenVertexArrays(1, &planeVAO);
-	glBindVertexArray(planeVAO);
+	state.BindVertexArray(planeVAO);
 
 	glGenBuffers(1, &planeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, planeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -172,10 +165,10 @@ int main()
 
 	GLuint quadVAO, quadVBO;
 	glGenVertexArrays(1, &quadVAO);
-	glBindVertexArray(quadVAO);
+	state.BindVertexArray(quadVAO);
 
 	glGenBuffers(1, &quadVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -183,16 +176,19 @@ int main()
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
 
-	glBindVertexArray(0);
+	state.BindVertexArray(0);
 
 	//lode shader file and compile
 	Shader shader("../../Shaders/Blend/vert.glsl", "../../Shaders/Blend/frag.glsl");
 	Shader grassShader("../../Shaders/Blend/vert.glsl", "../../Shaders/Blend/alpha_discard_frag.glsl");
 	Shader windowShader("../../Shaders/Blend/vert.glsl", "../../Shaders/Blend/alpha_blend_frag.glsl");
+	Shader windowOITShader("../../Shaders/Blend/vert.glsl", "../../Shaders/Blend/oit_accum_frag.glsl");
+
+	WeightedBlendedOIT oit("../../Shaders/Blend/oit_composite_vert.glsl", "../../Shaders/Blend/oit_composite_frag.glsl");
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	state.Enable(GL_DEPTH_TEST);
+	state.Enable(GL_BLEND);
+	state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	GLuint cubeTex = LoadTextureFromFile("marble.jpg", "../../Resources/Textures");
 	GLuint planeTex = LoadTextureFromFile("metal.png", "../../Resources/Textures");
@@ -202,17 +198,22 @@ int main()
 	shader.SetInt("texture_diffuse1", 0);
 	grassShader.SetInt("texture1", 0);
 	windowShader.SetInt("texture1", 0);
+	windowOITShader.Use();
+	windowOITShader.SetInt("texture1", 0);
 
 	//render loop
-	while (!glfwWindowShouldClose(window))
+	while (loop.BeginFrame(camera, deltaTime, processInput))
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
 
-		processInput(window);
+		if (transparencyMode == TransparencyMode::WEIGHTED_BLENDED)
+		{
+			int fbWidth, fbHeight;
+			loop.Context().GetFramebufferSize(fbWidth, fbHeight);
+			oit.Resize(fbWidth, fbHeight);
+			oit.BeginOpaque();
+		}
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		shader.Use();
@@ -225,15 +226,14 @@ int main()
 
 		//plane
 		shader.Use();
-		glBindVertexArray(planeVAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, planeTex);
+		state.BindVertexArray(planeVAO);
+		state.BindTextureUnit(0, GL_TEXTURE_2D, planeTex);
 		shader.SetMat4("model", glm::mat4());
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
 		//cube
-		glBindVertexArray(cubeVAO);
-		glBindTexture(GL_TEXTURE_2D, cubeTex);
+		state.BindVertexArray(cubeVAO);
+		state.BindTexture(GL_TEXTURE_2D, cubeTex);
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(-1.0f, 0.01f, -1.0f));
 		shader.SetMat4("model", model);
@@ -244,60 +244,80 @@ int main()
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
 		//quad
-		glBindVertexArray(quadVAO);
-		windowShader.Use();
-		windowShader.SetMat4("view", view);
-		windowShader.SetMat4("projection", proj);
-		glBindTexture(GL_TEXTURE_2D, windowTex);
-
-		//When drawing a scene with non - transparent and transparent objects the general outline is usually as follows :
-		//1.Draw all opaque objects first.
-		//2.Sort all the transparent objects.
-		//3.Draw all the transparent objects in sorted order.
-		std::map<float, glm::vec3> sortedByDist;
-		for (unsigned int i = 0; i < quadPoses.size(); ++i)
+		state.BindVertexArray(quadVAO);
+		state.BindTexture(GL_TEXTURE_2D, windowTex);
+
+		if (transparencyMode == TransparencyMode::SORTED)
 		{
-			float dist = glm::length(camera.Position - quadPoses[i]);
-			sortedByDist[dist] = quadPoses[i];
+			windowShader.Use();
+			windowShader.SetMat4("view", view);
+			windowShader.SetMat4("projection", proj);
+
+			//When drawing a scene with non - transparent and transparent objects the general outline is usually as follows :
+			//1.Draw all opaque objects first.
+			//2.Sort all the transparent objects.
+			//3.Draw all the transparent objects in sorted order.
+			std::map<float, glm::vec3> sortedByDist;
+			for (unsigned int i = 0; i < quadPoses.size(); ++i)
+			{
+				float dist = glm::length(camera.Position - quadPoses[i]);
+				sortedByDist[dist] = quadPoses[i];
+			}
+
+			for (auto it = sortedByDist.crbegin(); it != sortedByDist.crend(); ++it)
+			{
+				model = glm::mat4();
+				model = glm::translate(model, it->second);
+				windowShader.SetMat4("model", model);
+				glDrawArrays(GL_TRIANGLES, 0, 6);
+			}
 		}
-
-		for (auto it = sortedByDist.crbegin(); it != sortedByDist.crend(); ++it)
+		else
 		{
-			model = glm::mat4();
-			model = glm::translate(model,it->second);
-			windowShader.SetMat4("model", model);
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			//no sort: every transparent quad goes into the accumulation targets in submission order
+			oit.BeginTransparent();
+			windowOITShader.Use();
+			windowOITShader.SetMat4("view", view);
+			windowOITShader.SetMat4("projection", proj);
+			for (unsigned int i = 0; i < quadPoses.size(); ++i)
+			{
+				model = glm::mat4();
+				model = glm::translate(model, quadPoses[i]);
+				windowOITShader.SetMat4("model", model);
+				glDrawArrays(GL_TRIANGLES, 0, 6);
+			}
+
+			oit.Composite();
+			state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		}
 
-		glBindVertexArray(0);
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		loop.EndFrame();
 	}
 
-	glfwTerminate();
 	return 0;
 }
 
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
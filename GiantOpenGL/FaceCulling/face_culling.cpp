@@ -1,18 +1,18 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
+#include "DemoLoop.h"
 
 #include <iostream>
-#include <direct.h>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
@@ -20,7 +20,6 @@ const int screenHeight = 600;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
@@ -32,42 +31,22 @@ void processInput(GLFWwindow* window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
 
-int main()
+int main(int argc, char** argv)
 {
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "FaceCulling", nullptr, nullptr);
-	if (!window)
-	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "FaceCulling";
+	loopSettings.scene = "FaceCulling";
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwMakeContextCurrent(window);
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
-		return -1;
-	}
-
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-	{
-		glViewport(0, 0, width, height);
-	});
-
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	loop.AttachInput(mouse_callback, scroll_callback, nullptr);
 
 	GLfloat cubeVertices[] = {
 		// Back face
@@ -146,10 +125,10 @@ int main()
 
 	GLuint cubeVAO, cubeVBO;
 	glGenVertexArrays(1, &cubeVAO);
-	glBindVertexArray(cubeVAO);
+	state.BindVertexArray(cubeVAO);
 
 	glGenBuffers(1, &cubeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, cubeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -159,10 +138,10 @@ int main()
 
 	GLuint planeVAO, planeVBO;
 	glGenVertexArrays(1, &planeVAO);
-	glBindVertexArray(planeVAO);
+	state.BindVertexArray(planeVAO);
 
 	glGenBuffers(1, &planeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, planeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -172,10 +151,10 @@ int main()
 
 	GLuint quadVAO, quadVBO;
 	glGenVertexArrays(1, &quadVAO);
-	glBindVertexArray(quadVAO);
+	state.BindVertexArray(quadVAO);
 
 	glGenBuffers(1, &quadVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, quadVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -183,16 +162,16 @@ int main()
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
 
-	glBindVertexArray(0);
+	state.BindVertexArray(0);
 
 	//lode shader file and compile
 	Shader shader("../../Shaders/FaceCulling/vert.glsl", "../../Shaders/FaceCulling/frag.glsl");
 	Shader grassShader("../../Shaders/FaceCulling/vert.glsl", "../../Shaders/FaceCulling/alpha_discard_frag.glsl");
 	Shader windowShader("../../Shaders/FaceCulling/vert.glsl", "../../Shaders/FaceCulling/alpha_blend_frag.glsl");
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	state.Enable(GL_DEPTH_TEST);
+	state.Enable(GL_BLEND);
+	state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	GLuint cubeTex = LoadTextureFromFile("marble.jpg", "../../Resources/Textures");
 	GLuint planeTex = LoadTextureFromFile("metal.png", "../../Resources/Textures");
@@ -204,15 +183,10 @@ int main()
 	windowShader.SetInt("texture1", 0);
 
 	//render loop
-	while (!glfwWindowShouldClose(window))
+	while (loop.BeginFrame(camera, deltaTime, processInput))
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-
-		processInput(window);
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		shader.Use();
@@ -224,20 +198,19 @@ int main()
 		shader.SetMat4("projection", proj);
 		
 		//plane
-		glDisable(GL_CULL_FACE);
+		state.Disable(GL_CULL_FACE);
 		shader.Use();
-		glBindVertexArray(planeVAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, planeTex);
+		state.BindVertexArray(planeVAO);
+		state.BindTextureUnit(0, GL_TEXTURE_2D, planeTex);
 		shader.SetMat4("model", glm::mat4());
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
 		//cube
-		glEnable(GL_CULL_FACE);
-		/*glCullFace(GL_FRONT);*/
-		glFrontFace(GL_CW);
-		glBindVertexArray(cubeVAO);
-		glBindTexture(GL_TEXTURE_2D, cubeTex);
+		state.Enable(GL_CULL_FACE);
+		/*state.CullFace(GL_FRONT);*/
+		state.FrontFace(GL_CW);
+		state.BindVertexArray(cubeVAO);
+		state.BindTexture(GL_TEXTURE_2D, cubeTex);
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(-1.0f, 0.01f, -1.0f));
 		shader.SetMat4("model", model);
@@ -248,12 +221,12 @@ int main()
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
 		//quad
-		/*glDisable(GL_CULL_FACE);
-		glBindVertexArray(quadVAO);
+		/*state.Disable(GL_CULL_FACE);
+		state.BindVertexArray(quadVAO);
 		windowShader.Use();
 		windowShader.SetMat4("view", view);
 		windowShader.SetMat4("projection", proj);
-		glBindTexture(GL_TEXTURE_2D, windowTex);*/
+		state.BindTexture(GL_TEXTURE_2D, windowTex);*/
 
 		//When drawing a scene with non - transparent and transparent objects the general outline is usually as follows :
 		//1.Draw all opaque objects first.
@@ -274,35 +247,33 @@ int main()
 			glDrawArrays(GL_TRIANGLES, 0, 6);
 		}*/
 
-		glBindVertexArray(0);
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		loop.EndFrame();
 	}
 
-	glfwTerminate();
 	return 0;
 }
 
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
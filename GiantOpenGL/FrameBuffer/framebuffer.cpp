@@ -1,18 +1,24 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
+#include "PostProcessChain.h"
+#include "RenderGraph.h"
+#include "HDRPipeline.h"
+#include "IBLBaker.h"
+#include "PBRMaterial.h"
+#include "GPUProfiler.h"
+#include "DemoLoop.h"
 
 #include <iostream>
-#include <direct.h>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
@@ -20,56 +26,51 @@ const int screenHeight = 600;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
 
 bool firstMouse = true;
 
+//number key pressed since the last frame, toggles that post effect
+int toggledEffect = -1;
+
+//P prints the per pass gpu table once a second, T writes the last frames of gpu scopes and cpu zones
+//as a Chrome trace
+bool printProfile = false;
+bool writeTrace = false;
+
 void processInput(GLFWwindow* window);
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
-int main()
-{
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "FrameBuffer", nullptr, nullptr);
-	if (!window)
-	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
-		return -1;
-	}
-
-	glfwMakeContextCurrent(window);
+Mesh CreateSphere(int segments);
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
+int main(int argc, char** argv)
+{
+	PROFILE_THREAD("main");
+
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "FrameBuffer";
+	loopSettings.scene = "FrameBuffer";
+	loopSettings.benchmarkPath = Benchmark::OrbitPath(glm::vec3(0.0f, 0.0f, -1.0f), 5.0f, 1.0f);
+	//auto exposure keeps easing for a while after the view stopped
+	loopSettings.settleSeconds = 3.0;
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-	{
-		glViewport(0, 0, width, height);
-	});
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	loop.AttachInput(mouse_callback, scroll_callback, key_callback);
 
-	glEnable(GL_DEPTH_TEST);
+	state.Enable(GL_DEPTH_TEST);
 	//glDepthFunc(GL_ALWAYS);
 
 	GLfloat cubeVertices[] = {
@@ -128,23 +129,12 @@ int main()
 		5.0f, -0.5f, -5.0f,  2.0f, 2.0f
 	};
 
-	GLfloat screenQuadVertices[] = { // coord in ndc
-		// positions   // texCoords
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		-1.0f, -1.0f,  0.0f, 0.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-		 1.0f,  1.0f,  1.0f, 1.0f
-	};
-
 	GLuint cubeVAO, cubeVBO;
 	glGenVertexArrays(1, &cubeVAO);
-	glBindVertexArray(cubeVAO);
+	state.BindVertexArray(cubeVAO);
 
 	glGenBuffers(1, &cubeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, cubeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -154,10 +144,10 @@ int main()
 
 	GLuint planeVAO, planeVBO;
 	glGenVertexArrays(1, &planeVAO);
-	glBindVertexArray(planeVAO);
+	state.BindVertexArray(planeVAO);
 
 	glGenBuffers(1, &planeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, planeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -165,52 +155,38 @@ int main()
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
 
-	GLuint screenQuadVAO, screenQuadVBO;
-	glGenVertexArrays(1, &screenQuadVAO);
-	glBindVertexArray(screenQuadVAO);
-
-	glGenBuffers(1, &screenQuadVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, screenQuadVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(screenQuadVertices), screenQuadVertices, GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)(2*sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	glBindVertexArray(0);
-
-	//framebuffer
-	GLuint frameBuffer;
-	glGenFramebuffers(1, &frameBuffer);
-	glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
-
-	GLuint frameBufferTex;
-	glGenTextures(1, &frameBufferTex);
-	glBindTexture(GL_TEXTURE_2D, frameBufferTex);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 800, 600, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frameBufferTex, 0);
-
-	GLuint renderBuffer;
-	glGenRenderbuffers(1, &renderBuffer);
-	glBindRenderbuffer(GL_RENDERBUFFER, renderBuffer);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 800, 600);
-	glBindRenderbuffer(GL_RENDERBUFFER, 0);
-
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderBuffer);
+	state.BindVertexArray(0);
 
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-		std::cout << "Error: Framebuffer is not complete" << std::endl;
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	//post process chain on the tonemapped image, number keys toggle the nodes in this order
+	PostProcessChain postChain("../../Shaders/PostProcess");
+	const float edgeKernel[9] = {
+		1, 1, 1,
+		1,-8, 1,
+		1, 1, 1
+	};
+	postChain.Add(PostEffect::Blur(24));
+	postChain.Add(PostEffect::Kernel(edgeKernel));
+	postChain.Add(PostEffect::Grayscale());
+	postChain.Add(PostEffect::Inversion());
+	for (int i = 0; i < postChain.EffectCount(); ++i)
+		postChain.SetEnabled(i, false);
+
+	//hdr scene with the loft environment behind it, bloom/exposure/tonemap in the graph
+	HDRPipeline hdr("../../Shaders/HDR");
+	GLuint environmentTex = LoadHDRTextureFromFile("newport_loft.hdr", "../../Resources/Textures/hdr");
+
+	//lighting for the pbr spheres, baked once and read back from newport_loft.hdr.ibl after that
+	IBLBaker iblBaker;
+	IBLMaps ibl = iblBaker.Load("../../Resources/Textures/hdr/newport_loft.hdr");
+	Shader pbrShader("../../Shaders/PBR/pbr_vert.glsl", "../../Shaders/PBR/pbr_frag.glsl");
+	Mesh sphere = CreateSphere(64);
+	const char* pbrSets[] = { "gold", "grass", "plastic", "rusted_iron", "wall" };
+	std::vector<PBRMaterial> pbrMaterials;
+	for (const char* set : pbrSets)
+		pbrMaterials.push_back(LoadPBRMaterial(std::string("../../Resources/Textures/pbr/") + set));
 
 	//lode shader file and compile
 	Shader shader("../../Shaders/FrameBuffer/vert.glsl", "../../Shaders/FrameBuffer/frag.glsl");
-	Shader screenShader("../../Shaders/FrameBuffer/screen_vert.glsl", "../../Shaders/FrameBuffer/screen_frag.glsl");
 
 	GLuint cubeTex = LoadTextureFromFile("container.jpg", "../../Resources/Textures");
 	GLuint planeTex = LoadTextureFromFile("metal.png", "../../Resources/Textures");
@@ -220,36 +196,36 @@ int main()
 	shader.SetFloat("near", 0.1f);
 	shader.SetFloat("far", 100.0f);
 
-	screenShader.SetInt("texture1", 0);
-
-	//render loop
-	while (!glfwWindowShouldClose(window))
+	//frame graph: hdr scene into transient targets, then bloom, exposure and tonemap into an 8 bit target
+	//and the post chain from there to the screen
+	RenderGraph graph;
+	GPUProfiler& profiler = loop.Profiler();
+	graph.SetProfiler(&profiler);
+	double lastProfilePrint = 0.0;
+	RenderGraph::Resource sceneColor = graph.CreateTexture("sceneColor", HDRPipeline::COLOR_FORMAT);
+	RenderGraph::Resource sceneDepth = graph.CreateTexture("sceneDepth", GL_DEPTH24_STENCIL8);
+	RenderGraph::Resource ldrColor = graph.CreateTexture("ldrColor", GL_RGBA8);
+	postChain.UseExternalScene();
+
+	graph.AddPass("scene", {}, { sceneColor, sceneDepth },
+		[&](const RenderGraph& g)
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-
-		processInput(window);
-
-		//draw scene to custom framebuffer
-		glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
-		glEnable(GL_DEPTH_TEST);
-
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		state.DepthMask(GL_TRUE);
+		state.Enable(GL_DEPTH_TEST);
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		
+
 		shader.Use();
 
 		glm::mat4 view = camera.GetViewMatrix();
 		shader.SetMat4("view", view);
 		glm::mat4 proj;
-		proj = glm::perspective(glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
+		proj = glm::perspective(glm::radians(camera.Fov), (float)g.Width() / (float)g.Height(), 0.1f, 100.0f);
 		shader.SetMat4("projection", proj);
 
 		//cube
-		glBindVertexArray(cubeVAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, cubeTex);
+		state.BindVertexArray(cubeVAO);
+		state.BindTextureUnit(0, GL_TEXTURE_2D, cubeTex);
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(-1.0f, 0.01f, -1.0f));
 		shader.SetMat4("model", model);
@@ -260,66 +236,140 @@ int main()
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
 		//plane
-		glBindVertexArray(planeVAO);
-		glBindTexture(GL_TEXTURE_2D, planeTex);
+		state.BindVertexArray(planeVAO);
+		state.BindTexture(GL_TEXTURE_2D, planeTex);
 		shader.SetMat4("model", glm::mat4());
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
-		//draw screen quad to default frame buffer
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-		glDisable(GL_DEPTH_TEST); //룬testһƬ
-		
-		glBindVertexArray(screenQuadVAO);
-		glBindTexture(GL_TEXTURE_2D, frameBufferTex);
-		screenShader.Use();
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		//a row of pbr spheres behind the cubes
+		pbrShader.Use();
+		pbrShader.SetMat4("view", view);
+		pbrShader.SetMat4("projection", proj);
+		pbrShader.SetVec3("viewPos", camera.Position);
+		ibl.Bind(pbrShader, 3);
+		for (size_t i = 0; i < pbrMaterials.size(); ++i)
+		{
+			model = glm::mat4();
+			model = glm::translate(model, glm::vec3(-3.0f + 1.5f * i, 0.0f, -3.0f));
+			model = glm::scale(model, glm::vec3(0.5f));
+			pbrShader.SetMat4("model", model);
+			pbrMaterials[i].Bind(pbrShader, 0);
+			sphere.Draw(pbrShader);
+		}
+
+		hdr.DrawEnvironment(environmentTex, 1.0f, view, proj);
+	});
+
+	hdr.AddPasses(graph, sceneColor, ldrColor);
+
+	//post effects, the last pass draws to the default frame buffer
+	graph.AddPass("post", { ldrColor }, { RenderGraph::BACKBUFFER },
+		[&](const RenderGraph& g)
+	{
+		postChain.Present(g.Texture(ldrColor));
+	});
 
-		glBindVertexArray(0);
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+	//render loop
+	while (loop.BeginFrame(camera, deltaTime, processInput))
+	{
+		PROFILE_ZONE("frame");
+		double currentFrame = loop.Time();
+
+		if (toggledEffect >= 0 && toggledEffect < postChain.EffectCount())
+			postChain.SetEnabled(toggledEffect, !postChain.Effect(toggledEffect).enabled);
+		toggledEffect = -1;
+
+		//the graph recompiles (and reallocates its targets) only when the size changes
+		int fbWidth, fbHeight;
+		loop.Context().GetFramebufferSize(fbWidth, fbHeight);
+		graph.Resize(fbWidth, fbHeight);
+		postChain.Resize(fbWidth, fbHeight);
+
+		hdr.Update(deltaTime);
+		graph.Execute();
+
+		if (printProfile && currentFrame - lastProfilePrint > 1.0)
+		{
+			profiler.PrintTable(std::cout);
+			lastProfilePrint = currentFrame;
+		}
+		if (writeTrace)
+		{
+			profiler.WriteTrace("framebuffer_trace.json");
+			writeTrace = false;
+		}
+
+		loop.EndFrame();
 	}
 
-	glDeleteVertexArrays(1, &cubeVAO);
-	glDeleteVertexArrays(1, &planeVAO);
-	glDeleteVertexArrays(1, &screenQuadVAO);
-	glDeleteBuffers(1, &cubeVBO);
-	glDeleteBuffers(1, &planeVBO);
-	glDeleteBuffers(1, &screenQuadVBO);
+	state.DeleteVertexArray(cubeVAO);
+	state.DeleteVertexArray(planeVAO);
+	state.DeleteBuffer(cubeVBO);
+	state.DeleteBuffer(planeVBO);
+	ibl.Release();
 
-	glfwTerminate();
 	return 0;
 }
 
+Mesh CreateSphere(int segments)
+{
+	const float pi = 3.14159265f;
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	for (int y = 0; y <= segments; ++y)
+	{
+		for (int x = 0; x <= segments; ++x)
+		{
+			float u = (float)x / segments;
+			float v = (float)y / segments;
+			Vertex vertex;
+			vertex.Normal = glm::vec3(std::cos(u * 2.0f * pi) * std::sin(v * pi), std::cos(v * pi), std::sin(u * 2.0f * pi) * std::sin(v * pi));
+			vertex.Position = vertex.Normal;
+			vertex.TexCoords = glm::vec2(u, v);
+			vertices.push_back(vertex);
+		}
+	}
+	for (int y = 0; y < segments; ++y)
+	{
+		for (int x = 0; x < segments; ++x)
+		{
+			GLuint i0 = y * (segments + 1) + x;
+			GLuint i1 = i0 + segments + 1;
+			indices.insert(indices.end(), { i0, i1, i0 + 1, i0 + 1, i1, i1 + 1 });
+		}
+	}
+	return Mesh(vertices, indices, std::vector<Texture>());
+}
+
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_F) == GLFW_PRESS)
 	{
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_L) == GLFW_PRESS)
 	{
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 	}
@@ -344,4 +394,14 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
 	camera.ProcessMouseScroll(xoffset, yoffset);
+}
+
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+	if (action == GLFW_PRESS && key >= GLFW_KEY_1 && key <= GLFW_KEY_9)
+		toggledEffect = key - GLFW_KEY_1;
+	if (action == GLFW_PRESS && key == GLFW_KEY_P)
+		printProfile = !printProfile;
+	if (action == GLFW_PRESS && key == GLFW_KEY_T)
+		writeTrace = true;
 }
\ No newline at end of file
@@ -1,17 +1,26 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
-
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
+#include "CascadedShadowMap.h"
+#include "ShadowAtlas.h"
+#include "DepthPrepass.h"
+#include "DemoLoop.h"
+
+#include <cmath>
 #include <iostream>
+#include <random>
+#include <vector>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
@@ -21,18 +30,34 @@ float mixFactor = 0.2f;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
 
 bool firstMouse = true;
 
+const int pointLightNum = 1024;
+
+//G toggles between clustered forward and deferred shading
+bool deferredShading = false;
+//P cycles the forward depth prepass between auto, on and off
+PrepassMode prepassMode = PrepassMode::AUTO;
+
 void processInput(GLFWwindow* window);
 
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
 
+//distance where a light of this peak intensity falls below 5/256, nothing past it is visible
+float AttenuationRange(float intensity, float constant, float linear, float quadratic)
+{
+	float c = constant - intensity*256.0f / 5.0f;
+	if (quadratic <= 0.0f)
+		return linear > 0.0f ? -c / linear : 100.0f;
+	return (-linear + sqrt(linear*linear - 4.0f*quadratic*c)) / (2.0f*quadratic);
+}
+
 class DirectionalLight
 {
 public:
@@ -42,6 +67,11 @@ public:
 
 	}
 
+	const glm::vec3& GetDirection() const
+	{
+		return _direction;
+	}
+
 	void SetShader(Shader& shader) const
 	{
 		shader.SetVec3(_name + ".direction", _direction);
@@ -83,6 +113,46 @@ public:
 
 	}
 
+	void SetPos(const glm::vec3& pos)
+	{
+		_position = pos;
+	}
+
+	const glm::vec3& GetPos() const
+	{
+		return _position;
+	}
+
+	const glm::vec3& GetColor() const
+	{
+		return _color;
+	}
+
+	float Radius() const
+	{
+		glm::vec3 peak = glm::max(_diffuse, _specular)*_color;
+		return AttenuationRange(glm::max(glm::max(peak.r, peak.g), peak.b), _constant, _linear, _quadratic);
+	}
+
+	ShadowLightDesc ShadowDesc() const
+	{
+		return { ShadowLightType::POINT, _position, glm::vec3(0.0f), 0.0f, Radius() };
+	}
+
+	ClusterLight ToClusterLight() const
+	{
+		ClusterLight light;
+		light.position = _position;
+		light.radius = Radius();
+		light.ambient = _ambient*_color;
+		light.constant = _constant;
+		light.diffuse = _diffuse*_color;
+		light.linear = _linear;
+		light.specular = _specular*_color;
+		light.quadratic = _quadratic;
+		return light;
+	}
+
 	void SetShader(Shader& shader) const
 	{
 		shader.SetVec3(_name + ".position", _position);
@@ -146,6 +216,13 @@ public:
 		_direction = dir;
 	}
 
+	ShadowLightDesc ShadowDesc() const
+	{
+		glm::vec3 peak = glm::max(_diffuse, _specular)*_color;
+		float radius = AttenuationRange(glm::max(glm::max(peak.r, peak.g), peak.b), _constant, _linear, _quadratic);
+		return { ShadowLightType::SPOT, _position, _direction, _outterCutOff, radius };
+	}
+
 	void SetShader(Shader& shader) const
 	{
 		shader.SetVec3(_name + ".position", _position);
@@ -175,46 +252,31 @@ private:
 };
 
 
-int main()
+int main(int argc, char** argv)
 {
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "GinatOpenGL", nullptr, nullptr);
-	if (!window)
-	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "GinatOpenGL";
+	//4.1 renders point light shadows in one pass, 3.3 falls back to a pass per cube face
+	loopSettings.context.majorVersion = 4;
+	loopSettings.context.minorVersion = 1;
+	loopSettings.scene = "GiantOpenGL";
+	loopSettings.benchmarkPath = Benchmark::OrbitPath(glm::vec3(0.0f, 0.0f, -5.0f), 9.0f, 2.0f);
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwMakeContextCurrent(window);
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
-		return -1;
-	}
-	
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-		{
-			glViewport(0, 0, width, height);
-		});
-
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	loop.AttachInput(mouse_callback, scroll_callback, key_callback);
 
 	//lode shader file and compile
 	Shader shader("../../Shaders/Colors/colors_vert.glsl", "../../Shaders/Colors/colors_frag.glsl");
 	Shader lampShader("../../Shaders/Colors/lamp_vert.glsl", "../../Shaders/Colors/lamp_frag.glsl");
+	Shader gBufferShader("../../Shaders/Colors/colors_vert.glsl", "../../Shaders/Deferred/gbuffer_frag.glsl");
 	//vertices
 	GLfloat vertices[] = {
 		// positions          // normals           // texture coords
@@ -275,29 +337,13 @@ int main()
 		glm::vec3(-1.3f,  1.0f, -1.5f)
 	};
 
-	glm::vec3 pointLightsPos[4] = 
-	{
-		glm::vec3(0.7f,  0.2f,  2.0f),
-		glm::vec3(2.3f, -3.3f, -4.0f),
-		glm::vec3(-4.0f,  2.0f, -12.0f),
-		glm::vec3(0.0f,  0.0f, -3.0f)
-	};
-
-	glm::vec3 pointLightColor[4] =
-	{
-		glm::vec3(1.0f, 1.0f, 1.0f),
-		glm::vec3(1.0f, 0.0f, 0.0f),
-		glm::vec3(0.0f, 1.0f, 0.0f),
-		glm::vec3(0.0f, 0.0f, 1.0f)
-	};
-
 	//gen VAO, VBO
 	GLuint VAO, VBO;
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	state.BindVertexArray(VAO);
 
 	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
 	//layout
@@ -308,18 +354,35 @@ int main()
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(2);
 	// note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	state.BindBuffer(GL_ARRAY_BUFFER, 0);
 
 	GLuint lampVAO;
 	glGenVertexArrays(1, &lampVAO);
-	glBindVertexArray(lampVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	state.BindVertexArray(lampVAO);
+	state.BindBuffer(GL_ARRAY_BUFFER, VBO);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(0));
 	glEnableVertexAttribArray(0);
 
+	//positions only, tightly packed for the depth prepass and the shadow passes
+	GLfloat positions[36 * 3];
+	for (int i = 0; i < 36; ++i)
+	{
+		positions[i * 3 + 0] = vertices[i * 8 + 0];
+		positions[i * 3 + 1] = vertices[i * 8 + 1];
+		positions[i * 3 + 2] = vertices[i * 8 + 2];
+	}
+	GLuint depthVAO, depthVBO;
+	glGenVertexArrays(1, &depthVAO);
+	state.BindVertexArray(depthVAO);
+	glGenBuffers(1, &depthVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, depthVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (void*)(0));
+	glEnableVertexAttribArray(0);
+
 	// You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
 	// VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-	glBindVertexArray(0);
+	state.BindVertexArray(0);
 
 	//Create and load texture
 	GLuint tex1 = LoadTextureFromFile("container2.png", "../../Resources/Textures");
@@ -335,34 +398,31 @@ int main()
 										glm::vec3(0.4f, 0.4f, 0.4f), 
 										glm::vec3(0.5f, 0.5f, 0.5f));
 	dirLight.SetShader(shader);
-	//PointLight
-	PointLight pointLights[4] = {
-		PointLight("pointLights[0]", pointLightColor[0], pointLightsPos[0],
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.8f, 0.8f, 0.8f),
-		glm::vec3(1.0f, 1.0f, 1.0f),
-		1.0f, 0.09f, 0.032f),
-		PointLight("pointLights[1]", pointLightColor[1], pointLightsPos[1],
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.8f, 0.8f, 0.8f),
-		glm::vec3(1.0f, 1.0f, 1.0f),
-		1.0f, 0.09f, 0.032f),
-		PointLight("pointLights[2]", pointLightColor[2], pointLightsPos[2],
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.8f, 0.8f, 0.8f),
-		glm::vec3(1.0f, 1.0f, 1.0f),
-		1.0f, 0.09f, 0.032f),
-		PointLight("pointLights[3]", pointLightColor[3], pointLightsPos[3],
-		glm::vec3(0.05f, 0.05f, 0.05f),
-		glm::vec3(0.8f, 0.8f, 0.8f),
-		glm::vec3(1.0f, 1.0f, 1.0f),
-		1.0f, 0.09f, 0.032f),
-	};
-	for (int i = 0; i < 4; ++i)
+	//PointLight, lots of small lights orbiting around the cubes
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<PointLight> pointLights;
+	std::vector<glm::vec3> pointLightsCenter;
+	std::vector<float> pointLightsPhase;
+	for (int i = 0; i < pointLightNum; ++i)
 	{
-		pointLights[i].SetShader(shader);
+		glm::vec3 color = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.1f));
+		glm::vec3 center(unit(rng)*14.0f - 7.0f, unit(rng)*10.0f - 5.0f, unit(rng)*20.0f - 16.0f);
+		pointLights.push_back(PointLight("", color, center,
+			glm::vec3(0.0f, 0.0f, 0.0f),
+			glm::vec3(0.8f, 0.8f, 0.8f),
+			glm::vec3(1.0f, 1.0f, 1.0f),
+			1.0f, 0.7f, 1.8f));
+		pointLightsCenter.push_back(center);
+		pointLightsPhase.push_back(unit(rng)*6.2831853f);
 	}
-	
+
+	ClusteredLighting clusteredLighting;
+	std::vector<ClusterLight> clusterLights(pointLightNum);
+	//what the froxels were built for, they only change with the zoom or a resize
+	float clusterFov = 0.0f;
+	int clusterWidth = 0, clusterHeight = 0;
+
 	SpotLight spotLight("spotLight", glm::vec3(1.0f, 1.0f, 1.0f), camera.Position, camera.Front,
 		glm::vec3(0.0f, 0.0f, 0.0f),
 		glm::vec3(1.0f, 1.0f, 1.0f),
@@ -370,116 +430,309 @@ int main()
 		1.0f, 0.09f, 0.032f, glm::cos(glm::radians(12.5)), glm::cos(glm::radians(15.0f)));
 	spotLight.SetShader(shader);
 
-	glEnable(GL_DEPTH_TEST);
+	//shadows, the cubes and the floor are the casters, the floor never moves
+	CascadedShadowMap shadowMap("../../Shaders/Shadow");
+	const unsigned int floorCaster = 10;
+	std::vector<ShadowCaster> casters(11);
+	std::vector<glm::mat4> casterModels(11);
+	for (int i = 0; i < 10; ++i)
+	{
+		casters[i] = { cubePositions[i], 0.87f, 0 };
+	}
+	casters[floorCaster] = { glm::vec3(0.0f, -5.0f, -6.0f), 21.3f, 0 };
+	casterModels[floorCaster] = glm::scale(glm::translate(glm::mat4(), casters[floorCaster].center), glm::vec3(30.0f, 0.2f, 30.0f));
 
-	//render loop
-	while (!glfwWindowShouldClose(window))
+	//local light shadows, the spot light and four bigger point lights share one atlas
+	ShadowAtlas shadowAtlas("../../Shaders/Shadow");
+	glm::vec3 shadowPointLightsPos[4] =
+	{
+		glm::vec3(0.7f,  0.2f,  2.0f),
+		glm::vec3(2.3f, -3.3f, -4.0f),
+		glm::vec3(-4.0f,  2.0f, -12.0f),
+		glm::vec3(0.0f,  0.0f, -3.0f)
+	};
+	glm::vec3 shadowPointLightsColor[4] =
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+		glm::vec3(1.0f, 1.0f, 1.0f),
+		glm::vec3(1.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f)
+	};
+	std::vector<PointLight> shadowPointLights;
+	int shadowPointLightsId[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		shadowPointLights.push_back(PointLight("shadowPointLights[" + std::to_string(i) + "]", shadowPointLightsColor[i], shadowPointLightsPos[i],
+			glm::vec3(0.05f, 0.05f, 0.05f),
+			glm::vec3(0.8f, 0.8f, 0.8f),
+			glm::vec3(1.0f, 1.0f, 1.0f),
+			1.0f, 0.35f, 0.44f));
+		shadowPointLights[i].SetShader(shader);
+		shadowPointLightsId[i] = shadowAtlas.AddLight(shadowPointLights[i].ShadowDesc());
+	}
+	int spotLightShadowId = shadowAtlas.AddLight(spotLight.ShadowDesc());
 
-		processInput(window);
+	DepthPrepass prepass("../../Shaders/Prepass/depth_vert.glsl", "../../Shaders/Prepass/depth_frag.glsl");
+	double lastPrepassReport = 0.0;
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+	//deferred path
+	gBufferShader.Use();
+	gBufferShader.SetInt("material.diffuseMap", 0);
+	gBufferShader.SetInt("material.specularMap", 1);
+
+	DeferredRenderer deferred("../../Shaders/Deferred");
+	deferred.ScreenShader().Use();
+	dirLight.SetShader(deferred.ScreenShader());
+	for (int i = 0; i < 4; ++i)
+	{
+		shadowPointLights[i].SetShader(deferred.ScreenShader());
+	}
+
+	state.Enable(GL_DEPTH_TEST);
+
+	//render loop
+	while (loop.BeginFrame(camera, deltaTime, processInput))
+	{
+		double currentFrame = loop.Time();
+		//the point lights orbit all the time, on demand pacing draws every frame
+		loop.Clock().Invalidate();
+		GPUProfiler& profiler = loop.Profiler();
+
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+		int fbWidth, fbHeight;
+		loop.Context().GetFramebufferSize(fbWidth, fbHeight);
+
 		glm::mat4 view = camera.GetViewMatrix();
 		glm::mat4 proj;
 		proj = glm::perspective(glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
-		shader.SetMat4("projection", proj);
 
-		glBindVertexArray(lampVAO);
+		//move the lights, the orbit is wrapped in double before it becomes a float so it stays smooth
+		//however long the demo runs; cos, sin and sin(1.3x) all repeat after 20 pi
+		float orbit = (float)std::fmod(currentFrame*0.5, 20.0*3.14159265358979);
+		for (int i = 0; i < pointLightNum; ++i)
+		{
+			float phase = pointLightsPhase[i] + orbit;
+			pointLights[i].SetPos(pointLightsCenter[i] + glm::vec3(cos(phase), sin(phase*1.3f)*0.5f, sin(phase))*1.5f);
+			clusterLights[i] = pointLights[i].ToClusterLight();
+		}
+
+		spotLight.SetPos(camera.Position);
+		spotLight.SetDir(camera.Front);
+
+		//the first cube spins, everything else is static and stays in the cached cascades
+		float spin = (float)std::fmod(currentFrame*30.0, 360.0);
+		for (int i = 0; i < 10; ++i)
+		{
+			float angle = 20.0f*i + (i == 0 ? spin : 0.0f);
+			casterModels[i] = glm::rotate(glm::translate(glm::mat4(), cubePositions[i]), glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+		}
+		++casters[0].version;
+
+		profiler.BeginScope("shadows");
+		state.BindVertexArray(depthVAO);
+		shadowMap.Update(view, glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, dirLight.GetDirection());
+		auto drawCaster = [&](Shader& depthShader, unsigned int caster)
+		{
+			depthShader.SetMat4("model", casterModels[caster]);
+			glDrawArrays(GL_TRIANGLES, 0, 36);
+		};
+		shadowMap.Render(casters, drawCaster);
+		shadowAtlas.SetLight(spotLightShadowId, spotLight.ShadowDesc());
+		shadowAtlas.Update(camera.Position, glm::radians(camera.Fov), fbHeight, casters, drawCaster);
+		profiler.EndScope();
+		state.Viewport(0, 0, fbWidth, fbHeight);
+
+		state.BindTextureUnit(0, GL_TEXTURE_2D, tex1);
+		state.BindTextureUnit(1, GL_TEXTURE_2D, tex2);
+		state.BindVertexArray(VAO);
+
+		profiler.BeginScope(deferredShading ? "deferred" : "forward");
+		if (deferredShading)
+		{
+			deferred.Resize(fbWidth, fbHeight);
+			deferred.BeginGeometry();
+
+			gBufferShader.Use();
+			gBufferShader.SetMat4("view", view);
+			gBufferShader.SetMat4("projection", proj);
+			for (unsigned int i = 0; i < casterModels.size(); ++i)
+			{
+				gBufferShader.SetMat4("model", casterModels[i]);
+				glDrawArrays(GL_TRIANGLES, 0, 36);
+			}
+
+			deferred.ScreenShader().Use();
+			spotLight.SetShader(deferred.ScreenShader());
+			shadowMap.Bind(deferred.ScreenShader(), 3);
+			shadowAtlas.Bind(deferred.ScreenShader(), 4);
+			shadowAtlas.SetSpotUniforms(deferred.ScreenShader(), "spotLight", spotLightShadowId);
+			for (int i = 0; i < 4; ++i)
+			{
+				shadowAtlas.SetPointUniforms(deferred.ScreenShader(), "shadowPointLights[" + std::to_string(i) + "]", shadowPointLightsId[i]);
+			}
+			deferred.LightScreen(view, proj, camera.Position, 32.0f);
+			deferred.LightVolumes(clusterLights, view, proj, camera.Position, 32.0f);
+			deferred.BeginForward();
+		}
+		else
+		{
+			if (camera.Fov != clusterFov || fbWidth != clusterWidth || fbHeight != clusterHeight)
+			{
+				clusteredLighting.SetProjection(glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
+				clusterFov = camera.Fov;
+				clusterWidth = fbWidth;
+				clusterHeight = fbHeight;
+			}
+			clusteredLighting.Update(clusterLights, view);
+
+			shader.Use();
+			shader.SetMat4("projection", proj);
+			shader.SetVec3("viewPos", camera.Position);
+			shader.SetMat4("view", view);
+			shader.SetVec3("material.specular", glm::vec3(0.5f, 0.5f, 0.5f));
+			shader.SetFloat("material.shininess", 32.0f);
+			spotLight.SetShader(shader);
+			clusteredLighting.Bind(shader, 2, fbWidth, fbHeight);
+			shadowMap.Bind(shader, 5);
+			shadowAtlas.Bind(shader, 6);
+			shadowAtlas.SetSpotUniforms(shader, "spotLight", spotLightShadowId);
+			for (int i = 0; i < 4; ++i)
+			{
+				shadowAtlas.SetPointUniforms(shader, "shadowPointLights[" + std::to_string(i) + "]", shadowPointLightsId[i]);
+			}
+
+			prepass.SetMode(prepassMode);
+			if (prepass.BeginFrame(fbWidth, fbHeight))
+			{
+				Shader& depthShader = prepass.BeginDepth();
+				depthShader.SetMat4("view", view);
+				depthShader.SetMat4("projection", proj);
+				state.BindVertexArray(depthVAO);
+				for (unsigned int i = 0; i < casterModels.size(); ++i)
+				{
+					depthShader.SetMat4("model", casterModels[i]);
+					glDrawArrays(GL_TRIANGLES, 0, 36);
+				}
+				prepass.EndDepth();
+				state.BindVertexArray(VAO);
+			}
+
+			shader.Use();
+			prepass.BeginColor();
+			for (unsigned int i = 0; i < casterModels.size(); ++i)
+			{
+				shader.SetMat4("model", casterModels[i]);
+				glDrawArrays(GL_TRIANGLES, 0, 36);
+			}
+			prepass.EndColor();
+
+			if (loop.GLStats() && currentFrame - lastPrepassReport > 2.0)
+			{
+				const DepthPrepass::Stats& stats = prepass.GetStats();
+				std::cout << "Prepass: " << (prepass.Enabled() ? "on" : "off") << ", overdraw " << stats.overdraw
+					<< ", depth " << stats.depthMs << " ms, color " << stats.colorMs << " ms" << std::endl;
+				lastPrepassReport = currentFrame;
+			}
+		}
+
+		profiler.EndScope();
+
+		profiler.BeginScope("lamps");
+		state.BindVertexArray(lampVAO);
 		lampShader.Use();
 		
 		lampShader.SetMat4("view", view);
 		lampShader.SetMat4("projection", proj);
 
+		for (int i = 0; i < pointLightNum; ++i)
+		{
+			glm::mat4 lampModel;
+			lampModel = glm::translate(lampModel, pointLights[i].GetPos());
+			lampModel = glm::scale(lampModel, glm::vec3(0.05f));
+			lampShader.SetMat4("model", lampModel);
+			lampShader.SetVec3("color", pointLights[i].GetColor());
+			glDrawArrays(GL_TRIANGLES, 0, 36);
+		}
 		for (int i = 0; i < 4; ++i)
 		{
 			glm::mat4 lampModel;
-			lampModel = glm::translate(lampModel, pointLightsPos[i]);
+			lampModel = glm::translate(lampModel, shadowPointLights[i].GetPos());
 			lampModel = glm::scale(lampModel, glm::vec3(0.2f));
 			lampShader.SetMat4("model", lampModel);
-			lampShader.SetVec3("color", pointLightColor[i]);
+			lampShader.SetVec3("color", shadowPointLights[i].GetColor());
 			glDrawArrays(GL_TRIANGLES, 0, 36);
 		}
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, tex1);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, tex2);
+		profiler.EndScope();
 
-		glBindVertexArray(VAO);
-		shader.Use();
-
-		shader.SetVec3("viewPos", camera.Position);
-		shader.SetMat4("view", view);
-		shader.SetVec3("material.specular", glm::vec3(0.5f, 0.5f, 0.5f));
-		shader.SetFloat("material.shininess", 32.0f);
-
-		spotLight.SetPos(camera.Position);
-		spotLight.SetDir(camera.Front);
-		spotLight.SetShader(shader);
-
-		for (int i = 0; i < 10; ++i)
+		if (deferredShading)
 		{
-			glm::mat4 model;
-			model = glm::translate(model, cubePositions[i]);
-			model = glm::rotate(model, glm::radians(20.0f*i), glm::vec3(1.0f, 0.3f, 0.5f));
-			shader.SetMat4("model", model);
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+			deferred.Present();
 		}
 
-		
-
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		loop.EndFrame();
 	}
 
-	glfwTerminate();
 	return 0;
 }
 
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
 	{
 		if (mixFactor <= 1.0f)
 		{
 			mixFactor += 0.001f;
 		}
 	}
-	else if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
 	{
 		if (mixFactor >= 0.0f)
 		{
 			mixFactor -= 0.001f;
 		}
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
 }
 
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+	if (key == GLFW_KEY_G && action == GLFW_PRESS)
+	{
+		deferredShading = !deferredShading;
+		std::cout << "Shading: " << (deferredShading ? "deferred" : "clustered forward") << std::endl;
+	}
+	else if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		const char* names[3] = { "off", "on", "auto" };
+		prepassMode = (PrepassMode)(((int)prepassMode + 1) % 3);
+		std::cout << "Depth prepass: " << names[(int)prepassMode] << std::endl;
+	}
+}
+
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 {
 	if (firstMouse)
@@ -1,15 +1,18 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
+#include "DemoLoop.h"
+#include "LateLatch.h"
+#include "DepthPrepass.h"
 
 #include <iostream>
 
@@ -21,7 +24,6 @@ float mixFactor = 0.2f;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
@@ -33,120 +35,144 @@ void processInput(GLFWwindow* window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
 
-int main()
+int main(int argc, char** argv)
 {
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "ModelTest", nullptr, nullptr);
-	if (!window)
-	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "ModelTest";
+	//4.5 for the bindless path, 3.3 is enough for the bound unit path
+	loopSettings.context.majorVersion = 4;
+	loopSettings.context.minorVersion = 5;
+	loopSettings.scene = "ModelTest";
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwMakeContextCurrent(window);
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
-		return -1;
-	}
+	loop.AttachInput(mouse_callback, scroll_callback, nullptr);
 
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-	{
-		glViewport(0, 0, width, height);
-	});
-
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	//bindless materials when available, otherwise textures packed into shared arrays
+	//so the meshes only differ by layer uniform
+	BindlessTextureManager bindless;
+	bool useBindless = bindless.Init(loop.Context().ProcAddress());
 
 	//lode shader file and compile
-	Shader shader("../../Shaders/ModelTest/vert.glsl", "../../Shaders/ModelTest/frag.glsl");
+	Shader shader("../../Shaders/ModelTest/vert.glsl",
+		useBindless ? "../../Shaders/ModelTest/frag_bindless.glsl" : "../../Shaders/ModelTest/frag_array.glsl");
 
-	glEnable(GL_DEPTH_TEST);
+	state.Enable(GL_DEPTH_TEST);
 
-	Model nanosuit("../../Resources/Objects/nanosuit/nanosuit.obj");
+	Model nanosuit("../../Resources/Objects/nanosuit/nanosuit.obj", !useBindless);
+	nanosuit.MakeBindless(bindless);
 
-	//render loop
-	while (!glfwWindowShouldClose(window))
+	//view and projection come from a uniform block, --late-latch rewrites it right before the swap
+	LateLatch latch(LateLatch::ParseArgs(argc, argv));
+	latch.BindProgram(shader.shaderProgram);
+	auto cameraMatrices = []()
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+		LateLatch::Matrices matrices;
+		matrices.view = camera.GetViewMatrix();
+		matrices.projection = glm::perspective(glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
+		return matrices;
+	};
+
+	//the depth pass draws the position stream only (Model::DrawDepth)
+	DepthPrepass prepass("../../Shaders/ModelTest/depth_vert.glsl", "../../Shaders/Prepass/depth_frag.glsl");
+	latch.BindProgram(prepass.DepthShader().shaderProgram);
+	//a flush between the two passes would leave them on different cameras and GL_EQUAL would drop pixels
+	if (latch.Enabled())
+		prepass.SetMode(PrepassMode::OFF);
 
-		processInput(window);
+	//render loop
+	while (loop.BeginFrame(camera, deltaTime, processInput))
+	{
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		shader.Use();
+		latch.BeginFrame(cameraMatrices());
 
-		glm::mat4 view = camera.GetViewMatrix();
-		shader.SetMat4("view", view);
-		glm::mat4 proj;
-		proj = glm::perspective(glm::radians(camera.Fov), (float)screenWidth / (float)screenHeight, 0.1f, 100.0f);
-		shader.SetMat4("projection", proj);
-		
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(0.0f, -1.75f, 0.0f)); 
 		model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));	
-		shader.SetMat4("model", model);
 
+		int fbWidth, fbHeight;
+		loop.Context().GetFramebufferSize(fbWidth, fbHeight);
+		if (prepass.BeginFrame(fbWidth, fbHeight))
+		{
+			Shader& depthShader = prepass.BeginDepth();
+			depthShader.SetMat4("model", model);
+			nanosuit.DrawDepth();
+			prepass.EndDepth();
+		}
+
+		shader.Use();
+		shader.SetMat4("model", model);
+		prepass.BeginColor();
 		nanosuit.Draw(shader);
+		prepass.EndColor();
+		if (useBindless)
+		{
+			bindless.EndFrame();
+		}
 
+		//the mouse moved while the frame was recorded, the draws have not run yet;
+		//benchmark and replay frames keep the camera they were scripted with
+		if (latch.Enabled() && !loop.Scripted())
+		{
+			loop.Context().PollEvents();
+			latch.Latch(cameraMatrices());
+		}
+		else
+		{
+			latch.Latch();
+		}
 
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		loop.EndFrame();
 	}
 
-	glfwTerminate();
 	return 0;
 }
 
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
 	{
 		if (mixFactor <= 1.0f)
 		{
 			mixFactor += 0.001f;
 		}
 	}
-	else if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
 	{
 		if (mixFactor >= 0.0f)
 		{
 			mixFactor -= 0.001f;
 		}
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
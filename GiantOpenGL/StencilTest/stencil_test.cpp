@@ -1,18 +1,18 @@
 #include "glad/glad.h"
 #include "glfw3.h"
 
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 #include "stb_image.h"
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
+#include "DemoLoop.h"
 
 #include <iostream>
-#include <direct.h>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
@@ -20,7 +20,6 @@ const int screenHeight = 600;
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 float lastX = 400.0f;
 float lastY = 300.0f;
@@ -32,48 +31,28 @@ void processInput(GLFWwindow* window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* windwo, double xoffset, double yoffset);
 
-int main()
+int main(int argc, char** argv)
 {
-	//init glfw
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//create windwow
-	GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "StencilTest", nullptr, nullptr);
-	if (!window)
-	{
-		std::cout << "Failed to create glfw window" << std::endl;
-		glfwTerminate();
+	//window or headless context, --gl-trace, --benchmark, --record/--replay and --pacing, see DemoLoop
+	DemoLoop::Settings loopSettings;
+	loopSettings.context.width = screenWidth;
+	loopSettings.context.height = screenHeight;
+	loopSettings.context.title = "StencilTest";
+	loopSettings.scene = "StencilTest";
+	DemoLoop loop(argc, argv, loopSettings);
+	if (!loop.Valid())
 		return -1;
-	}
 
-	glfwMakeContextCurrent(window);
+	//all binds and enables go through the cache so unchanged state never reaches the driver
+	GLStateCache& state = GLStateCache::Get();
 
-	//init glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to init glad" << std::endl;
-		return -1;
-	}
-
-	glfwSetFramebufferSizeCallback(window,
-		[](GLFWwindow* win, int width, int height)
-	{
-		glViewport(0, 0, width, height);
-	});
-
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+	loop.AttachInput(mouse_callback, scroll_callback, nullptr);
 
 	//lode shader file and compile
 	Shader shader("../../Shaders/StencilTest/vert.glsl", "../../Shaders/StencilTest/frag.glsl");
 	Shader outlineShader("../../Shaders/StencilTest/vert.glsl", "../../Shaders/StencilTest/outline_frag.glsl");
 
-	glEnable(GL_DEPTH_TEST);
+	state.Enable(GL_DEPTH_TEST);
 	//glDepthFunc(GL_ALWAYS);
 
 	GLfloat cubeVertices[] = {
@@ -134,10 +113,10 @@ int main()
 
 	GLuint cubeVAO, cubeVBO;
 	glGenVertexArrays(1, &cubeVAO);
-	glBindVertexArray(cubeVAO);
+	state.BindVertexArray(cubeVAO);
 
 	glGenBuffers(1, &cubeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, cubeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -147,10 +126,10 @@ int main()
 
 	GLuint planeVAO, planeVBO;
 	glGenVertexArrays(1, &planeVAO);
-	glBindVertexArray(planeVAO);
+	state.BindVertexArray(planeVAO);
 
 	glGenBuffers(1, &planeVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
+	state.BindBuffer(GL_ARRAY_BUFFER, planeVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
@@ -158,7 +137,7 @@ int main()
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
 
-	glBindVertexArray(0);
+	state.BindVertexArray(0);
 
 	GLuint cubeTex = LoadTextureFromFile("marble.jpg", "../../Resources/Textures");
 	GLuint planeTex = LoadTextureFromFile("metal.png", "../../Resources/Textures");
@@ -170,15 +149,10 @@ int main()
 	shader.SetFloat("far", 100.0f);
 
 	//render loop
-	while (!glfwWindowShouldClose(window))
+	while (loop.BeginFrame(camera, deltaTime, processInput))
 	{
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-
-		processInput(window);
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		state.ClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 		shader.Use();
@@ -190,23 +164,22 @@ int main()
 		shader.SetMat4("projection", proj);
 
 		//plane
-		glDisable(GL_STENCIL_TEST);
+		state.Disable(GL_STENCIL_TEST);
 		//glStencilMask(0x00);
 		shader.Use();
-		glBindVertexArray(planeVAO);
-		glBindTexture(GL_TEXTURE_2D, planeTex);
+		state.BindVertexArray(planeVAO);
+		state.BindTexture(GL_TEXTURE_2D, planeTex);
 		shader.SetMat4("model", glm::mat4());
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
-		glEnable(GL_STENCIL_TEST);
-		glStencilFunc(GL_ALWAYS, 1, 0xff);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-		glStencilMask(0xff);
+		state.Enable(GL_STENCIL_TEST);
+		state.StencilFunc(GL_ALWAYS, 1, 0xff);
+		state.StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+		state.StencilMask(0xff);
 
 		//cube and stencil
-		glBindVertexArray(cubeVAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, cubeTex);
+		state.BindVertexArray(cubeVAO);
+		state.BindTextureUnit(0, GL_TEXTURE_2D, cubeTex);
 		glm::mat4 model;
 		model = glm::translate(model, glm::vec3(-1.0f, 0.01f, -1.0f));
 		shader.SetMat4("model", model);
@@ -217,8 +190,8 @@ int main()
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 		
 		// outline
-		glStencilFunc(GL_NOTEQUAL, 1, 0xff);
-		glStencilMask(0x00);
+		state.StencilFunc(GL_NOTEQUAL, 1, 0xff);
+		state.StencilMask(0x00);
 		outlineShader.Use();
 		outlineShader.SetMat4("view", view);
 		outlineShader.SetMat4("projection", proj);
@@ -234,36 +207,35 @@ int main()
 		outlineShader.SetMat4("model", model);
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 
-		glBindVertexArray(0);
-		glStencilMask(0xff); // must set 0xff here, if not, clear stencil buffer will fail
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		state.BindVertexArray(0);
+		state.StencilMask(0xff); // must set 0xff here, if not, clear stencil buffer will fail
+		loop.EndFrame();
 	}
 
-	glfwTerminate();
 	return 0;
 }
 
 void processInput(GLFWwindow* window)
 {
 	float cameraSpeed = 2.5f*deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	if (InputRecorder::GetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
-		glfwSetWindowShouldClose(window, true);
+		if (window)
+			glfwSetWindowShouldClose(window, true);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::FORWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::BACKWARD, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::LEFT, deltaTime);
 	}
-	else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (InputRecorder::GetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 	{
 		camera.ProcessKeyboard(CameraMovement::RIGHT, deltaTime);
 	}
@@ -0,0 +1,92 @@
+#include "glad/glad.h"
+#include "glfw3.h"
+
+#include "GLContext.h"
+#include "GLStateCache.h"
+#include "GLTraceReplay.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+//Replays a trace recorded with --gl-trace (see GLTrace) without the demo that recorded it:
+//	TraceReplay file.gltrace [--loops=N] [--finish] [--report=file.json] [--window] [--capture=last.ppm]
+//Headless by default, on a framebuffer the size the trace was recorded at, and as fast as the driver goes.
+//--loops runs the recorded frames N times, --finish waits for the gpu at the end of every frame so the frame
+//times cover it, --report writes frame times and per entry point call times as json, --window shows the frames.
+int main(int argc, char** argv)
+{
+	std::string tracePath;
+	std::string reportFile;
+	int loops = 1;
+	bool finish = false;
+	bool showWindow = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 8, "--loops=") == 0)
+			loops = std::max(std::atoi(arg.c_str() + 8), 1);
+		else if (arg == "--finish")
+			finish = true;
+		else if (arg.compare(0, 9, "--report=") == 0)
+			reportFile = arg.substr(9);
+		else if (arg == "--window")
+			showWindow = true;
+		else if (arg.compare(0, 2, "--") != 0)
+			tracePath = arg;
+	}
+	if (tracePath.empty())
+	{
+		std::cout << "usage: TraceReplay file.gltrace [--loops=N] [--finish] [--report=file.json] [--window] [--capture=last.ppm]" << std::endl;
+		return -1;
+	}
+
+	GLTraceReplay replay;
+	if (!replay.Load(tracePath))
+		return -1;
+	const GLTraceReplay::Header& header = replay.GetHeader();
+
+	GLContext::Settings contextSettings;
+	contextSettings.width = header.width > 0 ? header.width : 800;
+	contextSettings.height = header.height > 0 ? header.height : 600;
+	contextSettings.title = "TraceReplay";
+	contextSettings.backend = GLContext::Backend::HEADLESS;
+	contextSettings = GLContext::ParseArgs(argc, argv, contextSettings);
+	if (showWindow)
+		contextSettings.backend = GLContext::Backend::WINDOW;
+	//the trace decides when the run is over
+	contextSettings.headlessFrames = std::numeric_limits<int>::max();
+
+	GLContext context(contextSettings);
+	if (!context.Valid())
+		return -1;
+	if (context.Window())
+		glfwSwapInterval(0);
+
+	std::cout << "TraceReplay: " << tracePath << ", " << header.frames << " frames from frame " << header.startFrame
+		<< ", recorded on " << header.renderer << ", replaying on " << (const char*)glGetString(GL_RENDERER) << std::endl;
+	replay.Setup(GLStateCache::Get().DefaultFramebuffer());
+	for (int loop = 0; loop < loops && !context.ShouldClose(); ++loop)
+	{
+		replay.Rewind();
+		while (!context.ShouldClose() && replay.Frame(finish))
+		{
+			context.SwapBuffers();
+			context.PollEvents();
+		}
+	}
+	replay.Print(std::cout);
+	if (!reportFile.empty())
+		replay.WriteReport(reportFile);
+
+	if (!contextSettings.captureFile.empty())
+	{
+		//the replay went around the cache, and may have left a pack buffer bound
+		GLStateCache::Get().Invalidate();
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		context.SaveFrame(contextSettings.captureFile);
+	}
+	return 0;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+in vec2 TexCoords;
+
+layout(location = 0) out vec4 Accum;
+layout(location = 1) out float Weight;
+
+uniform sampler2D texture1;
+
+void main()
+{
+    vec4 color = texture(texture1, TexCoords);
+
+    // depth weight from McGuire & Bavoil, eq. 10: favours near and opaque surfaces
+    // and stays inside half float range when many layers overlap
+    float a = color.a;
+    float w = clamp(pow(min(1.0f, a * 10.0f) + 0.01f, 3.0f) * 1e8 * pow(1.0f - gl_FragCoord.z * 0.9f, 3.0f), 1e-2, 3e3);
+
+    Accum = vec4(color.rgb * a * w, a);
+    Weight = a * w;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 330 core
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D accumTex;
+uniform sampler2D weightTex;
+
+void main()
+{
+    vec4 accum = texture(accumTex, TexCoords);
+    float revealage = accum.a;
+    if(revealage >= 1.0f) // nothing transparent covers this pixel
+        discard;
+
+    float weight = texture(weightTex, TexCoords).r;
+    vec3 average = accum.rgb / max(weight, 1e-5);
+
+    // blended with SRC_ALPHA, ONE_MINUS_SRC_ALPHA: average*(1-revealage) + opaque*revealage
+    FragColor = vec4(average, 1.0f - revealage);
+}
\ No newline at end of file
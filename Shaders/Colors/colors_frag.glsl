@@ -19,6 +19,48 @@ struct DirectionalLight
 
 uniform DirectionalLight dirLight;
 
+//cascaded shadow map of the directional light, see CascadedShadowMap.h
+uniform sampler2DArrayShadow shadowMap;
+uniform int cascadeCount;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform float cascadeTexelSize[4];
+
+float CalcDirectionalShadow(vec3 fragPos, vec3 normal, float viewDepth)
+{
+    if(viewDepth >= cascadeSplits[cascadeCount - 1])
+    {
+        return 1.0f;    // past the shadow distance
+    }
+    int cascade = cascadeCount - 1;
+    for(int i = cascadeCount - 2; i >= 0; --i)
+    {
+        if(viewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+        }
+    }
+
+    //normal offset by about a texel of the chosen cascade instead of a large constant bias
+    vec4 lightPos = lightSpaceMatrices[cascade] * vec4(fragPos + normal * cascadeTexelSize[cascade] * 1.5f, 1.0f);
+    vec3 coord = lightPos.xyz / lightPos.w * 0.5f + 0.5f;
+    if(coord.z > 1.0f)
+    {
+        return 1.0f;
+    }
+
+    vec2 texelSize = 1.0f / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0f;
+    for(int x = -1; x <= 1; ++x)
+    {
+        for(int y = -1; y <= 1; ++y)
+        {
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texelSize, float(cascade), coord.z));
+        }
+    }
+    return lit / 9.0f;
+}
+
 struct PointLight
 {
     vec3 position;
@@ -32,8 +74,16 @@ struct PointLight
     float quadratic;
 };
 
-#define POINT_LIGHT_NUM 4
-uniform PointLight pointLights[POINT_LIGHT_NUM];
+//clustered point lights, see ClusteredLighting.h for the buffer layout
+uniform samplerBuffer clusterLights;
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterIndices;
+uniform ivec3 clusterDims;
+uniform vec2 clusterTileSize;
+uniform float clusterSliceScale;
+uniform float clusterSliceBias;
+
+uniform mat4 view;
 
 struct SpotLight
 {
@@ -49,10 +99,100 @@ struct SpotLight
     float constant;
     float linear;
     float quadratic;
+
+    bool shadowValid;
+    mat4 shadowMatrix;
+    vec4 shadowRect;
 };
 
 uniform SpotLight spotLight;
 
+//the few point lights that cast shadows, the clustered ones do not
+struct ShadowPointLight
+{
+    vec3 position;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    bool shadowValid;
+    vec4 shadowRects[6];
+    float shadowNear;
+    float shadowFar;
+};
+
+#define SHADOW_POINT_LIGHT_NUM 4
+uniform ShadowPointLight shadowPointLights[SHADOW_POINT_LIGHT_NUM];
+
+//shadow atlas of the spot light and the shadowed point lights, see ShadowAtlas.h
+uniform sampler2DShadow shadowAtlas;
+
+const vec3 cubeFaceForward[6] = vec3[6](vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f),
+                                        vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f));
+const vec3 cubeFaceUp[6] = vec3[6](vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f),
+                                   vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f));
+
+float SampleShadowAtlas(vec4 rect, vec2 uv, float depth)
+{
+    //2x2 taps on top of the hardware compare, kept a texel and a half inside the tile
+    vec2 texelSize = 1.0f / vec2(textureSize(shadowAtlas, 0));
+    vec2 lo = rect.xy + texelSize * 1.5f;
+    vec2 hi = rect.xy + rect.zw - texelSize * 1.5f;
+    vec2 center = rect.xy + uv * rect.zw;
+    float lit = 0.0f;
+    for(int x = 0; x < 2; ++x)
+    {
+        for(int y = 0; y < 2; ++y)
+        {
+            vec2 tap = clamp(center + (vec2(x, y) - 0.5f) * texelSize, lo, hi);
+            lit += texture(shadowAtlas, vec3(tap, depth));
+        }
+    }
+    return lit * 0.25f;
+}
+
+float CalcSpotShadow(SpotLight light, vec3 fragPos, vec3 normal)
+{
+    if(!light.shadowValid)
+    {
+        return 1.0f;
+    }
+    vec4 lightPos = light.shadowMatrix * vec4(fragPos + normal * 0.02f, 1.0f);
+    vec3 coord = lightPos.xyz / lightPos.w * 0.5f + 0.5f;
+    if(any(lessThan(coord, vec3(0.0f))) || any(greaterThan(coord, vec3(1.0f))))
+    {
+        return 1.0f;
+    }
+    return SampleShadowAtlas(light.shadowRect, coord.xy, coord.z);
+}
+
+float CalcPointShadow(ShadowPointLight light, vec3 fragPos, vec3 normal)
+{
+    if(!light.shadowValid)
+    {
+        return 1.0f;
+    }
+    //pick the cube face like a cube map lookup would, then project with that face's 90 degree frustum
+    vec3 d = fragPos + normal * 0.03f - light.position;
+    vec3 a = abs(d);
+    int face = a.x >= a.y && a.x >= a.z ? (d.x > 0.0f ? 0 : 1) : (a.y >= a.z ? (d.y > 0.0f ? 2 : 3) : (d.z > 0.0f ? 4 : 5));
+    vec3 forward = cubeFaceForward[face];
+    vec3 up = cubeFaceUp[face];
+    vec3 right = cross(forward, up);
+
+    float w = dot(forward, d);
+    vec2 ndc = vec2(dot(right, d), dot(up, d)) / w;
+    float n = light.shadowNear;
+    float f = light.shadowFar;
+    float z = ((f + n) / (f - n) * w - 2.0f * f * n / (f - n)) / w;
+    return SampleShadowAtlas(light.shadowRects[face], ndc * 0.5f + 0.5f, z * 0.5f + 0.5f);
+}
+
 struct Material
 {
     sampler2D diffuseMap;
@@ -62,31 +202,31 @@ struct Material
 
 uniform Material material;
 
-vec3 CalcDirectionalLightColor(DirectionalLight light, Material mat, vec3 normal, vec3 viewDir)
+vec3 CalcDirectionalLightColor(DirectionalLight light, Material mat, vec3 normal, vec3 viewDir, float shadow)
 {
     //ambient
     vec3 albedo = texture(mat.diffuseMap, TexCoord).rgb;
     vec3 ambient = albedo * light.ambient;
     //diffuse
     vec3 lightDir = normalize(-light.direction);
-    float diff = max(dot(lightDir, viewDir), 0.0f);
+    float diff = max(dot(normal, lightDir), 0.0f);
     vec3 diffuse = diff * albedo * light.diffuse;
     //specular
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0f), mat.shininess);
     vec3 specular = spec * texture(mat.specularMap, TexCoord).rgb * light.specular;
 
-    return ambient + diffuse + specular;
+    return ambient + (diffuse + specular) * shadow;
 }
 
-vec3 CalcPointLightColor(PointLight light, Material mat, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcPointLightColor(PointLight light, Material mat, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow)
 {
     //ambient
     vec3 albedo = texture(mat.diffuseMap, TexCoord).rgb;
     vec3 ambient = albedo * light.ambient;
     //diffuse
     vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(lightDir, viewDir), 0.0f);
+    float diff = max(dot(normal, lightDir), 0.0f);
     vec3 diffuse = diff * albedo * light.diffuse;
     //specular
     vec3 reflectDir = reflect(-lightDir, normal);
@@ -99,10 +239,10 @@ vec3 CalcPointLightColor(PointLight light, Material mat, vec3 normal, vec3 fragP
     diffuse *= attenuation;
     specular *= attenuation;
 
-    return ambient + diffuse + specular;
+    return ambient + (diffuse + specular) * shadow;
 }
 
-vec3 CalcSpotLightColor(SpotLight light, Material mat, vec3 normal, vec3 fragPos, vec3 viewDir)
+vec3 CalcSpotLightColor(SpotLight light, Material mat, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow)
 {
     //ambient
     vec3 albedo = texture(mat.diffuseMap, TexCoord).rgb;
@@ -127,7 +267,44 @@ vec3 CalcSpotLightColor(SpotLight light, Material mat, vec3 normal, vec3 fragPos
     diffuse *= attenuation*intensity;
     specular *= attenuation*intensity;
 
-    return ambient + diffuse + specular;
+    return ambient + (diffuse + specular) * shadow;
+}
+
+vec3 CalcClusterLightsColor(Material mat, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    float depth = -(view * vec4(fragPos, 1.0f)).z;
+    ivec3 cluster;
+    cluster.xy = ivec2(gl_FragCoord.xy / clusterTileSize);
+    cluster.z = int(log(depth) * clusterSliceScale - clusterSliceBias);
+    cluster = clamp(cluster, ivec3(0), clusterDims - 1);
+
+    int clusterIndex = (cluster.z * clusterDims.y + cluster.y) * clusterDims.x + cluster.x;
+    uvec2 range = texelFetch(clusterGrid, clusterIndex).xy;
+
+    vec3 result = vec3(0.0f);
+    for(uint i = 0u; i < range.y; ++i)
+    {
+        int lightIndex = int(texelFetch(clusterIndices, int(range.x + i)).r) * 4;
+        vec4 posRadius = texelFetch(clusterLights, lightIndex);
+        vec4 ambientConstant = texelFetch(clusterLights, lightIndex + 1);
+        vec4 diffuseLinear = texelFetch(clusterLights, lightIndex + 2);
+        vec4 specularQuadratic = texelFetch(clusterLights, lightIndex + 3);
+
+        PointLight light;
+        light.position = posRadius.xyz;
+        light.ambient = ambientConstant.rgb;
+        light.diffuse = diffuseLinear.rgb;
+        light.specular = specularQuadratic.rgb;
+        light.constant = ambientConstant.w;
+        light.linear = diffuseLinear.w;
+        light.quadratic = specularQuadratic.w;
+
+        //fade to zero at the cull radius so lights do not pop at cluster borders
+        float distanceToLight = length(light.position - fragPos);
+        float window = clamp(1.0f - pow(distanceToLight / posRadius.w, 4.0f), 0.0f, 1.0f);
+        result += CalcPointLightColor(light, mat, normal, fragPos, viewDir, 1.0f) * window * window;
+    }
+    return result;
 }
 
 void main()
@@ -135,12 +312,17 @@ void main()
     vec3 normal = normalize(Normal);
     vec3 viewDir = normalize(viewPos - FragPos);
 
-    vec3 result = CalcDirectionalLightColor(dirLight, material, normal, viewDir);
-    for(int i = 0; i < POINT_LIGHT_NUM; ++i)
+    float viewDepth = -(view * vec4(FragPos, 1.0f)).z;
+    float shadow = CalcDirectionalShadow(FragPos, normal, viewDepth);
+    vec3 result = CalcDirectionalLightColor(dirLight, material, normal, viewDir, shadow);
+    result += CalcClusterLightsColor(material, normal, FragPos, viewDir);
+    for(int i = 0; i < SHADOW_POINT_LIGHT_NUM; ++i)
     {
-        result += CalcPointLightColor(pointLights[i], material, normal, FragPos, viewDir);
-    } 
-    
-    result += CalcSpotLightColor(spotLight, material, normal, FragPos, viewDir);
+        ShadowPointLight light = shadowPointLights[i];
+        PointLight pointLight = PointLight(light.position, light.ambient, light.diffuse, light.specular, light.constant, light.linear, light.quadratic);
+        result += CalcPointLightColor(pointLight, material, normal, FragPos, viewDir, CalcPointShadow(light, FragPos, normal));
+    }
+
+    result += CalcSpotLightColor(spotLight, material, normal, FragPos, viewDir, CalcSpotShadow(spotLight, FragPos, normal));
     FragColor = vec4(result, 1.0f);
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+//the depth prepass computes gl_Position the same way
+invariant gl_Position;
+
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0f);
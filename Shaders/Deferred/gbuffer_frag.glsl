@@ -0,0 +1,36 @@
+#version 330 core
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoord;
+
+layout(location = 0) out vec4 gAlbedoSpec;
+layout(location = 1) out vec2 gNormal;
+
+struct Material
+{
+    sampler2D diffuseMap;
+    sampler2D specularMap;
+    float shininess;
+};
+
+uniform Material material;
+
+//octahedral mapping, a unit normal in two channels
+vec2 EncodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 oct = n.xy;
+    if(n.z < 0.0f)
+    {
+        oct = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return oct;
+}
+
+void main()
+{
+    gAlbedoSpec.rgb = texture(material.diffuseMap, TexCoord).rgb;
+    gAlbedoSpec.a = texture(material.specularMap, TexCoord).r;
+    gNormal = EncodeNormal(normalize(Normal));
+}
\ No newline at end of file
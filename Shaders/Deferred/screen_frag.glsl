@@ -0,0 +1,238 @@
+#version 330 core
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 view;
+uniform mat4 invViewProjection;
+uniform vec3 viewPos;
+uniform float shininess;
+
+struct DirectionalLight
+{
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+uniform DirectionalLight dirLight;
+
+//cascaded shadow map of the directional light, see CascadedShadowMap.h
+uniform sampler2DArrayShadow shadowMap;
+uniform int cascadeCount;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform float cascadeTexelSize[4];
+
+float CalcDirectionalShadow(vec3 fragPos, vec3 normal, float viewDepth)
+{
+    if(viewDepth >= cascadeSplits[cascadeCount - 1])
+    {
+        return 1.0f;    // past the shadow distance
+    }
+    int cascade = cascadeCount - 1;
+    for(int i = cascadeCount - 2; i >= 0; --i)
+    {
+        if(viewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+        }
+    }
+
+    //normal offset by about a texel of the chosen cascade instead of a large constant bias
+    vec4 lightPos = lightSpaceMatrices[cascade] * vec4(fragPos + normal * cascadeTexelSize[cascade] * 1.5f, 1.0f);
+    vec3 coord = lightPos.xyz / lightPos.w * 0.5f + 0.5f;
+    if(coord.z > 1.0f)
+    {
+        return 1.0f;
+    }
+
+    vec2 texelSize = 1.0f / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0f;
+    for(int x = -1; x <= 1; ++x)
+    {
+        for(int y = -1; y <= 1; ++y)
+        {
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texelSize, float(cascade), coord.z));
+        }
+    }
+    return lit / 9.0f;
+}
+
+struct SpotLight
+{
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    bool shadowValid;
+    mat4 shadowMatrix;
+    vec4 shadowRect;
+};
+
+uniform SpotLight spotLight;
+
+//the few point lights that cast shadows, the clustered ones do not
+struct ShadowPointLight
+{
+    vec3 position;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    bool shadowValid;
+    vec4 shadowRects[6];
+    float shadowNear;
+    float shadowFar;
+};
+
+#define SHADOW_POINT_LIGHT_NUM 4
+uniform ShadowPointLight shadowPointLights[SHADOW_POINT_LIGHT_NUM];
+
+//shadow atlas of the spot light and the shadowed point lights, see ShadowAtlas.h
+uniform sampler2DShadow shadowAtlas;
+
+const vec3 cubeFaceForward[6] = vec3[6](vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f),
+                                        vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f));
+const vec3 cubeFaceUp[6] = vec3[6](vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f),
+                                   vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f));
+
+float SampleShadowAtlas(vec4 rect, vec2 uv, float depth)
+{
+    //2x2 taps on top of the hardware compare, kept a texel and a half inside the tile
+    vec2 texelSize = 1.0f / vec2(textureSize(shadowAtlas, 0));
+    vec2 lo = rect.xy + texelSize * 1.5f;
+    vec2 hi = rect.xy + rect.zw - texelSize * 1.5f;
+    vec2 center = rect.xy + uv * rect.zw;
+    float lit = 0.0f;
+    for(int x = 0; x < 2; ++x)
+    {
+        for(int y = 0; y < 2; ++y)
+        {
+            vec2 tap = clamp(center + (vec2(x, y) - 0.5f) * texelSize, lo, hi);
+            lit += texture(shadowAtlas, vec3(tap, depth));
+        }
+    }
+    return lit * 0.25f;
+}
+
+float CalcSpotShadow(SpotLight light, vec3 fragPos, vec3 normal)
+{
+    if(!light.shadowValid)
+    {
+        return 1.0f;
+    }
+    vec4 lightPos = light.shadowMatrix * vec4(fragPos + normal * 0.02f, 1.0f);
+    vec3 coord = lightPos.xyz / lightPos.w * 0.5f + 0.5f;
+    if(any(lessThan(coord, vec3(0.0f))) || any(greaterThan(coord, vec3(1.0f))))
+    {
+        return 1.0f;
+    }
+    return SampleShadowAtlas(light.shadowRect, coord.xy, coord.z);
+}
+
+float CalcPointShadow(ShadowPointLight light, vec3 fragPos, vec3 normal)
+{
+    if(!light.shadowValid)
+    {
+        return 1.0f;
+    }
+    //pick the cube face like a cube map lookup would, then project with that face's 90 degree frustum
+    vec3 d = fragPos + normal * 0.03f - light.position;
+    vec3 a = abs(d);
+    int face = a.x >= a.y && a.x >= a.z ? (d.x > 0.0f ? 0 : 1) : (a.y >= a.z ? (d.y > 0.0f ? 2 : 3) : (d.z > 0.0f ? 4 : 5));
+    vec3 forward = cubeFaceForward[face];
+    vec3 up = cubeFaceUp[face];
+    vec3 right = cross(forward, up);
+
+    float w = dot(forward, d);
+    vec2 ndc = vec2(dot(right, d), dot(up, d)) / w;
+    float n = light.shadowNear;
+    float f = light.shadowFar;
+    float z = ((f + n) / (f - n) * w - 2.0f * f * n / (f - n)) / w;
+    return SampleShadowAtlas(light.shadowRects[face], ndc * 0.5f + 0.5f, z * 0.5f + 0.5f);
+}
+
+vec3 DecodeNormal(vec2 oct)
+{
+    vec3 n = vec3(oct, 1.0f - abs(oct.x) - abs(oct.y));
+    if(n.z < 0.0f)
+    {
+        n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    if(depth == 1.0f)
+    {
+        discard;    // background keeps the clear color
+    }
+
+    vec4 worldPos = invViewProjection * vec4(vec3(TexCoords, depth) * 2.0f - 1.0f, 1.0f);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+    vec4 albedoSpec = texture(gAlbedoSpec, TexCoords);
+    vec3 albedo = albedoSpec.rgb;
+    vec3 specularColor = vec3(albedoSpec.a);
+    vec3 normal = DecodeNormal(texture(gNormal, TexCoords).xy);
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    //directional
+    vec3 lightDir = normalize(-dirLight.direction);
+    float diff = max(dot(normal, lightDir), 0.0f);
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0f), shininess);
+    float shadow = CalcDirectionalShadow(fragPos, normal, -(view * vec4(fragPos, 1.0f)).z);
+    vec3 result = albedo * dirLight.ambient + (diff * albedo * dirLight.diffuse + spec * specularColor * dirLight.specular) * shadow;
+
+    //spot
+    lightDir = normalize(spotLight.position - fragPos);
+    float distanceToLight = length(spotLight.position - fragPos);
+    diff = max(dot(normal, lightDir), 0.0f);
+    reflectDir = reflect(-lightDir, normal);
+    spec = pow(max(dot(reflectDir, viewDir), 0.0f), shininess);
+    float theta = dot(lightDir, -spotLight.direction);
+    float intensity = clamp((theta - spotLight.outerCutOff)/(spotLight.cutOff - spotLight.outerCutOff), 0.0f, 1.0f);
+    float attenuation = 1.0f/(spotLight.constant + spotLight.linear * distanceToLight + spotLight.quadratic * distanceToLight * distanceToLight);
+    shadow = CalcSpotShadow(spotLight, fragPos, normal);
+    result += (albedo * spotLight.ambient + (diff * albedo * spotLight.diffuse + spec * specularColor * spotLight.specular) * shadow) * attenuation * intensity;
+
+    //shadowed point lights, few enough to run for every pixel
+    for(int i = 0; i < SHADOW_POINT_LIGHT_NUM; ++i)
+    {
+        ShadowPointLight light = shadowPointLights[i];
+        lightDir = normalize(light.position - fragPos);
+        distanceToLight = length(light.position - fragPos);
+        diff = max(dot(normal, lightDir), 0.0f);
+        reflectDir = reflect(-lightDir, normal);
+        spec = pow(max(dot(viewDir, reflectDir), 0.0f), shininess);
+        attenuation = 1.0f/(light.constant + light.linear * distanceToLight + light.quadratic * distanceToLight * distanceToLight);
+        shadow = CalcPointShadow(light, fragPos, normal);
+        result += (albedo * light.ambient + (diff * albedo * light.diffuse + spec * specularColor * light.specular) * shadow) * attenuation;
+    }
+
+    FragColor = vec4(result, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#version 330 core
+
+flat in vec4 PosRadius;
+flat in vec4 AmbientConstant;
+flat in vec4 DiffuseLinear;
+flat in vec4 SpecularQuadratic;
+
+out vec4 FragColor;
+
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 invViewProjection;
+uniform vec2 screenSize;
+uniform vec3 viewPos;
+uniform float shininess;
+
+vec3 DecodeNormal(vec2 oct)
+{
+    vec3 n = vec3(oct, 1.0f - abs(oct.x) - abs(oct.y));
+    if(n.z < 0.0f)
+    {
+        n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    vec2 texCoords = gl_FragCoord.xy / screenSize;
+    float depth = texture(gDepth, texCoords).r;
+    vec4 worldPos = invViewProjection * vec4(vec3(texCoords, depth) * 2.0f - 1.0f, 1.0f);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+
+    float distanceToLight = length(PosRadius.xyz - fragPos);
+    if(distanceToLight > PosRadius.w)
+    {
+        discard;    // inside the volume on screen but not in 3d
+    }
+
+    vec4 albedoSpec = texture(gAlbedoSpec, texCoords);
+    vec3 albedo = albedoSpec.rgb;
+    vec3 normal = DecodeNormal(texture(gNormal, texCoords).xy);
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    //ambient
+    vec3 ambient = albedo * AmbientConstant.rgb;
+    //diffuse
+    vec3 lightDir = normalize(PosRadius.xyz - fragPos);
+    float diff = max(dot(normal, lightDir), 0.0f);
+    vec3 diffuse = diff * albedo * DiffuseLinear.rgb;
+    //specular
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0f), shininess);
+    vec3 specular = spec * albedoSpec.a * SpecularQuadratic.rgb;
+
+    float attenuation = 1.0f/(AmbientConstant.w + DiffuseLinear.w * distanceToLight + SpecularQuadratic.w * distanceToLight * distanceToLight);
+    float window = clamp(1.0f - pow(distanceToLight / PosRadius.w, 4.0f), 0.0f, 1.0f);
+    attenuation *= window * window;
+
+    FragColor = vec4((ambient + diffuse + specular) * attenuation, 1.0f);
+}
\ No newline at end of file
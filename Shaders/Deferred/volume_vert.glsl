@@ -0,0 +1,25 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+//per instance, same layout as ClusterLight
+layout(location = 1) in vec4 aPosRadius;
+layout(location = 2) in vec4 aAmbientConstant;
+layout(location = 3) in vec4 aDiffuseLinear;
+layout(location = 4) in vec4 aSpecularQuadratic;
+
+flat out vec4 PosRadius;
+flat out vec4 AmbientConstant;
+flat out vec4 DiffuseLinear;
+flat out vec4 SpecularQuadratic;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * view * vec4(aPosRadius.xyz + aPos * aPosRadius.w, 1.0f);
+    PosRadius = aPosRadius;
+    AmbientConstant = aAmbientConstant;
+    DiffuseLinear = aDiffuseLinear;
+    SpecularQuadratic = aSpecularQuadratic;
+}
\ No newline at end of file
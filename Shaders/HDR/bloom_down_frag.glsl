@@ -0,0 +1,38 @@
+#version 330 core
+
+// dual filter downsample: the center plus four diagonal bilinear taps one source texel out,
+// each tap already averages a 2x2 block so 5 fetches cover a 4x4 footprint
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D sourceTex;
+uniform bool prefilter;		// first level only, keep what is brighter than the threshold
+uniform float threshold;
+uniform float knee;
+
+vec3 Prefilter(vec3 color)
+{
+    // quadratic soft knee around the threshold instead of a hard cut
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - threshold + knee, 0.0f, 2.0f * knee);
+    soft = soft * soft / (4.0f * knee + 0.00001f);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 0.00001f);
+    return color * contribution;
+}
+
+void main()
+{
+    vec2 texel = 1.0f / vec2(textureSize(sourceTex, 0));
+    vec3 color = texture(sourceTex, TexCoords).rgb * 4.0f;
+    color += texture(sourceTex, TexCoords + vec2(-texel.x, -texel.y)).rgb;
+    color += texture(sourceTex, TexCoords + vec2( texel.x, -texel.y)).rgb;
+    color += texture(sourceTex, TexCoords + vec2(-texel.x,  texel.y)).rgb;
+    color += texture(sourceTex, TexCoords + vec2( texel.x,  texel.y)).rgb;
+    color *= 0.125f;
+
+    if(prefilter)
+        color = Prefilter(color);
+    FragColor = vec4(color, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 330 core
+
+// dual filter upsample: four edge taps and four diagonal taps (twice the weight) around the pixel,
+// added onto the level below by the blend state so every level keeps its own contribution
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D sourceTex;
+
+void main()
+{
+    vec2 texel = 1.0f / vec2(textureSize(sourceTex, 0));
+    vec3 color = vec3(0.0f);
+    color += texture(sourceTex, TexCoords + vec2(-texel.x, 0.0f)).rgb;
+    color += texture(sourceTex, TexCoords + vec2( texel.x, 0.0f)).rgb;
+    color += texture(sourceTex, TexCoords + vec2(0.0f, -texel.y)).rgb;
+    color += texture(sourceTex, TexCoords + vec2(0.0f,  texel.y)).rgb;
+    color += texture(sourceTex, TexCoords + vec2(-texel.x, -texel.y) * 0.5f).rgb * 2.0f;
+    color += texture(sourceTex, TexCoords + vec2( texel.x, -texel.y) * 0.5f).rgb * 2.0f;
+    color += texture(sourceTex, TexCoords + vec2(-texel.x,  texel.y) * 0.5f).rgb * 2.0f;
+    color += texture(sourceTex, TexCoords + vec2( texel.x,  texel.y) * 0.5f).rgb * 2.0f;
+    FragColor = vec4(color / 12.0f, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#version 430 core
+
+// reduces the histogram to the mean log luminance, eases the stored average towards it and clears the bins
+
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) buffer Histogram
+{
+    uint bins[256];
+};
+
+layout(r32f) uniform image2D luminanceImage;
+
+uniform uint sampleCount;
+uniform float minLogLuminance;
+uniform float logLuminanceRange;
+uniform float adaptation;	// 1 - exp(-dt * speed)
+
+shared float weighted[256];
+
+void main()
+{
+    uint index = gl_LocalInvocationIndex;
+    uint count = bins[index];
+    weighted[index] = float(count) * float(index);
+    bins[index] = 0u;
+    barrier();
+
+    for(uint stride = 128u; stride > 0u; stride >>= 1)
+    {
+        if(index < stride)
+            weighted[index] += weighted[index + stride];
+        barrier();
+    }
+
+    if(index == 0u)
+    {
+        // count is bin 0 here, black pixels stay out of the mean
+        float meanBin = weighted[0] / max(float(sampleCount) - float(count), 1.0f) - 1.0f;
+        float target = exp2(meanBin / 254.0f * logLuminanceRange + minLogLuminance);
+        float current = imageLoad(luminanceImage, ivec2(0)).r;
+        imageStore(luminanceImage, ivec2(0), vec4(current + (target - current) * adaptation));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#version 430 core
+
+// log luminance histogram, one sample per 2x2 block of the hdr scene
+// bin 0 takes (near) black pixels, bins 1..255 span [minLogLuminance, minLogLuminance + logLuminanceRange]
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+uniform sampler2D sceneTex;
+uniform float minLogLuminance;
+uniform float inverseLogLuminanceRange;
+
+layout(std430, binding = 0) buffer Histogram
+{
+    uint bins[256];
+};
+
+shared uint localBins[256];
+
+void main()
+{
+    // counts go to shared memory first, one global atomic per bin and group
+    uint index = gl_LocalInvocationIndex;
+    localBins[index] = 0u;
+    barrier();
+
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy) * 2;
+    if(all(lessThan(texel, textureSize(sceneTex, 0))))
+    {
+        vec3 color = texelFetch(sceneTex, texel, 0).rgb;
+        float luminance = dot(color, vec3(0.2126f, 0.7152f, 0.0722f));
+        uint bin = 0u;
+        if(luminance > 0.0001f)
+        {
+            float position = clamp((log2(luminance) - minLogLuminance) * inverseLogLuminanceRange, 0.0f, 1.0f);
+            bin = uint(position * 254.0f + 1.0f);
+        }
+        atomicAdd(localBins[bin], 1u);
+    }
+    barrier();
+
+    atomicAdd(bins[index], localBins[index]);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec3 ViewDir;
+
+out vec4 FragColor;
+
+uniform sampler2D environmentMap;	// equirectangular, linear hdr
+uniform float environmentIntensity;
+
+const vec2 invAtan = vec2(0.1591f, 0.3183f);
+
+void main()
+{
+    vec3 dir = normalize(ViewDir);
+    vec2 uv = vec2(atan(dir.z, dir.x), asin(dir.y)) * invAtan + 0.5f;
+    FragColor = vec4(texture(environmentMap, uv).rgb * environmentIntensity, 1.0f);
+}
\ No newline at end of file
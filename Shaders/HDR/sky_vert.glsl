@@ -0,0 +1,15 @@
+#version 330 core
+
+// fullscreen quad on the far plane, the view ray is rebuilt per corner
+layout(location = 0) in vec2 aPos;
+
+out vec3 ViewDir;
+
+uniform mat4 inverseViewProjection;	// projection * view without the translation, inverted
+
+void main()
+{
+    gl_Position = vec4(aPos, 1.0f, 1.0f);
+    vec4 world = inverseViewProjection * vec4(aPos, 1.0f, 1.0f);
+    ViewDir = world.xyz / world.w;
+}
\ No newline at end of file
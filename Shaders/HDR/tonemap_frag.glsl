@@ -0,0 +1,39 @@
+#version 330 core
+
+// the only pass that touches the full resolution hdr image after the scene:
+// bloom add, exposure and tonemap in one go, written straight to an 8 bit target.
+// The target is plain RGBA8 read by the post process chain, so the sRGB encode happens here
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D sceneTex;
+uniform sampler2D bloomTex;
+uniform sampler2D luminanceTex;	// 1x1, adapted average luminance
+uniform float bloomIntensity;
+uniform float exposureKey;
+
+// Narkowicz 2015, fitted ACES filmic curve
+vec3 ACESFilm(vec3 x)
+{
+    return clamp((x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f), 0.0f, 1.0f);
+}
+
+// exact piecewise curve, 8 bits are too few to store linear values without banding in the darks
+vec3 LinearToSRGB(vec3 x)
+{
+    vec3 low = x * 12.92f;
+    vec3 high = 1.055f * pow(x, vec3(1.0f / 2.4f)) - 0.055f;
+    return mix(high, low, vec3(lessThanEqual(x, vec3(0.0031308f))));
+}
+
+void main()
+{
+    vec3 color = texture(sceneTex, TexCoords).rgb;
+    color += texture(bloomTex, TexCoords).rgb * bloomIntensity;
+
+    float averageLuminance = texelFetch(luminanceTex, ivec2(0), 0).r;
+    float exposure = exposureKey / max(averageLuminance, 0.0001f);
+    FragColor = vec4(LinearToSRGB(ACESFilm(color * exposure)), 1.0f);
+}
\ No newline at end of file
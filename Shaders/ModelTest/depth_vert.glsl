@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+//the same block as vert.glsl
+layout(std140) uniform LateLatch
+{
+    mat4 latchedView;
+    mat4 latchedProjection;
+};
+
+//must match vert.glsl bit for bit, the color pass depth tests with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = latchedProjection * latchedView * model * vec4(aPos, 1.0f);
+}
\ No newline at end of file
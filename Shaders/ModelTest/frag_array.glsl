@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+// packed material textures, see TexturePacker: one array binding shared by every mesh
+uniform sampler2DArray texture_diffuse1;
+uniform int texture_diffuse1_layer;
+uniform vec4 texture_diffuse1_rect;
+
+void main()
+{
+    vec2 uv = texture_diffuse1_rect.xy + TexCoords * texture_diffuse1_rect.zw;
+    FragColor = vec4(texture(texture_diffuse1, vec3(uv, texture_diffuse1_layer)).rgb, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 450 core
+#extension GL_ARB_bindless_texture : require
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+// two handles per material: diffuse, specular. see Model::MakeBindless
+layout(std430, binding = 0) readonly buffer Materials
+{
+    uvec2 handles[];
+};
+
+uniform int materialIndex;
+
+void main()
+{
+    sampler2D diffuseMap = sampler2D(handles[2 * materialIndex]);
+    FragColor = vec4(texture(diffuseMap, TexCoords).rgb, 1.0f);
+}
\ No newline at end of file
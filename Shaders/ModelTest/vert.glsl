@@ -8,12 +8,20 @@ out vec3 Normal;
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+//written by LateLatch, as late as right before the frame is submitted
+layout(std140) uniform LateLatch
+{
+    mat4 latchedView;
+    mat4 latchedProjection;
+};
+
+//depth_vert.glsl lays down the prepass depth, GL_EQUAL needs the same positions
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+    gl_Position = latchedProjection * latchedView * model * vec4(aPos, 1.0f);
 
     Normal = mat3(transpose(inverse( model))) * aNormal;
     TexCoords = aTexCoords;
@@ -0,0 +1,76 @@
+#version 330 core
+
+in vec3 WorldPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D albedoMap;
+uniform sampler2D normalMap;
+uniform sampler2D ormMap;		// r = ao, g = roughness, b = metallic, packed by LoadPBRMaterial
+
+//baked by IBLBaker
+uniform vec3 irradianceSH[9];
+uniform samplerCube specularMap;
+uniform float specularMips;
+uniform sampler2D brdfLUT;
+
+uniform vec3 viewPos;
+
+//tangent frame from screen space derivatives, the meshes carry no tangents
+vec3 PerturbNormal(vec3 n, vec3 p, vec2 uv)
+{
+    vec3 tangentNormal = texture(normalMap, uv).xyz * 2.0f - 1.0f;
+
+    vec3 dp1 = dFdx(p);
+    vec3 dp2 = dFdy(p);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, n);
+    vec3 dp1perp = cross(n, dp1);
+    vec3 t = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 b = dp2perp * duv1.y + dp1perp * duv2.y;
+    float invmax = inversesqrt(max(dot(t, t), dot(b, b)));
+    return normalize(mat3(t * invmax, b * invmax, n) * tangentNormal);
+}
+
+//irradiance / pi, the coefficients already hold the cosine convolution
+vec3 IrradianceSH(vec3 n)
+{
+    return irradianceSH[0] * 0.282095f
+        + irradianceSH[1] * 0.488603f * n.y
+        + irradianceSH[2] * 0.488603f * n.z
+        + irradianceSH[3] * 0.488603f * n.x
+        + irradianceSH[4] * 1.092548f * n.x * n.y
+        + irradianceSH[5] * 1.092548f * n.y * n.z
+        + irradianceSH[6] * 0.315392f * (3.0f * n.z * n.z - 1.0f)
+        + irradianceSH[7] * 1.092548f * n.x * n.z
+        + irradianceSH[8] * 0.546274f * (n.x * n.x - n.y * n.y);
+}
+
+void main()
+{
+    vec3 albedo = texture(albedoMap, TexCoords).rgb;
+    vec3 orm = texture(ormMap, TexCoords).rgb;
+    float ao = orm.r;
+    float roughness = orm.g;
+    float metallic = orm.b;
+
+    vec3 N = PerturbNormal(normalize(Normal), WorldPos, TexCoords);
+    vec3 V = normalize(viewPos - WorldPos);
+    vec3 R = reflect(-V, N);
+    float NdotV = max(dot(N, V), 0.0f);
+
+    vec3 F0 = mix(vec3(0.04f), albedo, metallic);
+    vec3 F = F0 + (max(vec3(1.0f - roughness), F0) - F0) * pow(1.0f - NdotV, 5.0f);
+    vec3 kD = (1.0f - F) * (1.0f - metallic);
+
+    vec3 diffuse = max(IrradianceSH(N), 0.0f) * albedo;
+    vec3 prefiltered = textureLod(specularMap, R, roughness * (specularMips - 1.0f)).rgb;
+    vec2 brdf = texture(brdfLUT, vec2(NdotV, roughness)).rg;
+    vec3 specular = prefiltered * (F * brdf.x + brdf.y);
+
+    FragColor = vec4((kD * diffuse + specular) * ao, 1.0f);
+}
\ No newline at end of file
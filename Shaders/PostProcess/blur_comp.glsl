@@ -0,0 +1,54 @@
+#version 430 core
+
+// separable gaussian for radii too wide for the linear sampled fragment pass
+// one work group filters GROUP_SIZE texels of one row (blurAxis = (1, 0)) or column (blurAxis = (0, 1)),
+// the texels it needs are fetched once into shared memory and every invocation sums from there
+
+#define GROUP_SIZE 128
+#define MAX_RADIUS 64
+
+layout(local_size_x = GROUP_SIZE) in;
+
+uniform sampler2D sourceTex;
+layout(rgba16f) uniform writeonly image2D targetImage;
+
+uniform ivec2 blurAxis;
+uniform int blurRadius;
+uniform float blurWeights[MAX_RADIUS + 1];
+
+shared vec4 cache[GROUP_SIZE + 2 * MAX_RADIUS];
+
+ivec2 ToTexel(int along, int across)
+{
+    return blurAxis * along + (ivec2(1) - blurAxis) * across;
+}
+
+void main()
+{
+    ivec2 size = textureSize(sourceTex, 0);
+    int extent = blurAxis.x == 1 ? size.x : size.y;
+    int across = int(gl_WorkGroupID.y);
+    int groupStart = int(gl_WorkGroupID.x) * GROUP_SIZE;
+    int localIndex = int(gl_LocalInvocationID.x);
+
+    // the group window plus blurRadius apron texels on each side, clamped at the edges
+    int count = GROUP_SIZE + 2 * blurRadius;
+    for(int i = localIndex; i < count; i += GROUP_SIZE)
+    {
+        int along = clamp(groupStart - blurRadius + i, 0, extent - 1);
+        cache[i] = texelFetch(sourceTex, ToTexel(along, across), 0);
+    }
+    barrier();
+
+    int along = groupStart + localIndex;
+    if(along >= extent)
+        return;
+
+    int center = localIndex + blurRadius;
+    vec4 color = cache[center] * blurWeights[0];
+    for(int i = 1; i <= blurRadius; ++i)
+    {
+        color += (cache[center - i] + cache[center + i]) * blurWeights[i];
+    }
+    imageStore(targetImage, ToTexel(along, across), color);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+// per-pixel effects, spliced into post_frag.glsl by PostProcessChain (no #version here)
+// the chain generates ApplyColor() from the enabled effects, colorParams[i] belongs to the i-th call
+
+uniform float colorParams[8];
+
+vec3 Inversion(vec3 color)
+{
+    return vec3(1.0f) - color;
+}
+
+vec3 Grayscale(vec3 color)
+{
+    float average = 0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b;
+    return vec3(average);
+}
+
+vec3 Tonemap(vec3 color, float exposure)
+{
+    return vec3(1.0f) - exp(-color * exposure);
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#version 330 core
+
+// one post process pass, PostProcessChain inserts after the version line:
+//     #define PASS_COPY, PASS_KERNEL or PASS_BLUR, color_ops.glsl and the generated ApplyColor()
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D sourceTex;
+
+// PASS_KERNEL, row major with the top row first
+uniform float kernel[9];
+
+// PASS_BLUR, linear sampled gaussian: tap i fetches both sides at blurOffsets[i] texels,
+// the bilinear filter blends the two discrete texels between them
+uniform vec2 blurStep;
+uniform int blurTaps;
+uniform float blurOffsets[16];
+uniform float blurWeights[16];
+
+vec3 Sample()
+{
+#if defined(PASS_KERNEL)
+    // constant offsets, no texcoord math in front of the fetches
+    vec3 color = vec3(0.0f);
+    color += textureOffset(sourceTex, TexCoords, ivec2(-1,  1)).rgb * kernel[0];
+    color += textureOffset(sourceTex, TexCoords, ivec2( 0,  1)).rgb * kernel[1];
+    color += textureOffset(sourceTex, TexCoords, ivec2( 1,  1)).rgb * kernel[2];
+    color += textureOffset(sourceTex, TexCoords, ivec2(-1,  0)).rgb * kernel[3];
+    color += texture(sourceTex, TexCoords).rgb * kernel[4];
+    color += textureOffset(sourceTex, TexCoords, ivec2( 1,  0)).rgb * kernel[5];
+    color += textureOffset(sourceTex, TexCoords, ivec2(-1, -1)).rgb * kernel[6];
+    color += textureOffset(sourceTex, TexCoords, ivec2( 0, -1)).rgb * kernel[7];
+    color += textureOffset(sourceTex, TexCoords, ivec2( 1, -1)).rgb * kernel[8];
+    return color;
+#elif defined(PASS_BLUR)
+    vec3 color = texture(sourceTex, TexCoords).rgb * blurWeights[0];
+    for(int i = 1; i < blurTaps; ++i)
+    {
+        vec2 offset = blurStep * blurOffsets[i];
+        color += (texture(sourceTex, TexCoords + offset).rgb + texture(sourceTex, TexCoords - offset).rgb) * blurWeights[i];
+    }
+    return color;
+#else
+    return texture(sourceTex, TexCoords).rgb;
+#endif
+}
+
+void main()
+{
+    FragColor = vec4(ApplyColor(Sample()), 1.0f);
+}
\ No newline at end of file
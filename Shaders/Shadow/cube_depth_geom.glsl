@@ -0,0 +1,21 @@
+#version 410 core
+
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 18) out;
+
+uniform mat4 faceMatrices[6];
+
+//one input triangle to all six cube faces, viewport i + 1 holds face i's atlas tile
+void main()
+{
+    for(int face = 0; face < 6; ++face)
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            gl_ViewportIndex = face + 1;
+            gl_Position = faceMatrices[face] * gl_in[i].gl_Position;
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+}
\ No newline at end of file
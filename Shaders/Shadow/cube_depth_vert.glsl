@@ -0,0 +1,10 @@
+#version 410 core
+
+layout(location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+void main()
+{
+    gl_Position = model * vec4(aPos, 1.0f);    // world space, the geometry stage projects per face
+}
\ No newline at end of file